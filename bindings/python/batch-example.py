@@ -0,0 +1,18 @@
+import sys
+import pysurvive
+
+ctx = pysurvive.init(sys.argv)
+
+if ctx is None: # implies -help or similiar
+    exit(-1)
+
+batch = pysurvive.Batch(ctx)
+
+while pysurvive.poll(ctx) == 0:
+    data = batch.drain()
+    if len(data.imu):
+        print("%d poses, %d imu samples, %d angles; mean gyro %s" %
+              (len(data.poses), len(data.imu), len(data.angles), data.imu['gyro'].mean(axis=0)))
+
+batch.close()
+pysurvive.close(ctx)
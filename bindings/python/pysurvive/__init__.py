@@ -75,6 +75,59 @@ def install_sync_fn(ctx, fn):
 def install_sweep_angle_fn(ctx, fn):
     install_generic_process(ctx, fn, default_sweep_angle_process, pysurvive_generated.install_sweep_angle_fn, sweep_angle_process_func)
 
+def _batch_dtypes():
+    import numpy as np
+    # Mirrors the structs in survive_batch.h
+    pose = np.dtype([('object', 'S8'), ('time', '<f8'), ('timecode', '<u4'), ('reserved', '<u4'),
+                     ('pos', '<f8', 3), ('rot', '<f8', 4)], align=True)
+    imu = np.dtype([('object', 'S8'), ('time', '<f8'), ('timecode', '<u4'), ('mask', '<i4'),
+                    ('accel', '<f8', 3), ('gyro', '<f8', 3), ('mag', '<f8', 3), ('id', '<i4'), ('reserved', '<i4')],
+                   align=True)
+    angle = np.dtype([('object', 'S8'), ('time', '<f8'), ('timecode', '<u4'), ('sensor_id', '<i4'), ('lh', '<i4'),
+                      ('plane', '<i4'), ('length', '<f8'), ('angle', '<f8')], align=True)
+    assert (pose.itemsize, imu.itemsize, angle.itemsize) == \
+           (ctypes.sizeof(SurviveBatchPose), ctypes.sizeof(SurviveBatchIMU), ctypes.sizeof(SurviveBatchAngle))
+    return pose, imu, angle
+
+class BatchData:
+    def __init__(self, poses, imu, angles, dropped):
+        self.poses = poses
+        self.imu = imu
+        self.angles = angles
+        self.dropped = dropped
+
+class Batch:
+    """
+    Collects poses, IMU samples and angles on the C side, so that one drain() hands back thousands of events as numpy
+    structured arrays instead of calling into Python per event. The arrays are views of libsurvive's memory; they are
+    only valid until the next drain(), so copy anything that needs to live longer.
+    """
+    def __init__(self, ctx, capacity=1 << 16):
+        import numpy
+        self.np = numpy
+        self.pose_dtype, self.imu_dtype, self.angle_dtype = _batch_dtypes()
+        self.ctx = ctx
+        self.ptr = batch_create(ctx, capacity)
+
+    def _view(self, ptr, cnt, dtype):
+        if cnt == 0:
+            return self.np.zeros(0, dtype)
+        buffer = (ctypes.c_char * (cnt * dtype.itemsize)).from_address(ctypes.cast(ptr, ctypes.c_void_p).value)
+        return self.np.frombuffer(buffer, dtype)
+
+    def drain(self):
+        data = batch_drain(self.ptr).contents
+        return BatchData(self._view(data.poses, data.pose_cnt, self.pose_dtype),
+                         self._view(data.imu, data.imu_cnt, self.imu_dtype),
+                         self._view(data.angles, data.angle_cnt, self.angle_dtype),
+                         data.dropped)
+
+    def close(self):
+        """Must be called before the context is closed"""
+        if self.ptr:
+            batch_free(self.ptr)
+            self.ptr = None
+
 def configs(ctx, name, method=SC_GET, default=None):
     return pysurvive_generated.configs(ctx, name, method, default)
 
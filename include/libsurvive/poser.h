@@ -31,6 +31,8 @@ typedef struct
 	poser_pose_func poseproc;
 	poser_lighthouse_pose_func lighthouseposeproc;
 	void *userdata;
+	// Host time the originating packet arrived, when 'latency-trace' is on; 0 otherwise
+	double arrival_time;
 } PoserData;
 
 SURVIVE_EXPORT int32_t PoserData_size(const PoserData *poser_data);
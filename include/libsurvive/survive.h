@@ -21,18 +21,33 @@ extern "C" {
 #endif
 
 
+/**
+ * The last readings of one sensor from one lighthouse. A light event only touches the entry it lands in.
+ */
+typedef struct SurviveSensorActivationsEntry {
+	// Valid for gen2; somewhat different meaning though -- refers to angle of the rotor when the sweep happened.
+	FLT angles[2];				  // 2 Axes (Angles in LH space)
+	survive_timecode timecode[2]; // Timecode per axis in ticks
+
+	// Valid only for Gen1
+	survive_timecode lengths[2]; // Timecode per axis in ticks
+} SurviveSensorActivationsEntry;
+
 /**
  * This struct encodes what the last effective angles seen on a sensor were, and when they occured.
+ *
+ * The entries are stored lighthouse-major and only span the sensors and lighthouses that have been seen so far, so
+ * they are allocated when the first light comes in and grow a handful of times after that. A zeroed struct is a valid
+ * empty one. Use SurviveSensorActivations_copy rather than assigning one to another, and
+ * SurviveSensorActivations_dtor to release one that isn't part of an object.
  */
 typedef struct SurviveSensorActivations_s {
 	int lh_gen;
 
-	// Valid for gen2; somewhat different meaning though -- refers to angle of the rotor when the sweep happened.
-	FLT angles[SENSORS_PER_OBJECT][NUM_GEN2_LIGHTHOUSES][2];				// 2 Axes (Angles in LH space)
-	survive_timecode timecode[SENSORS_PER_OBJECT][NUM_GEN2_LIGHTHOUSES][2]; // Timecode per axis in ticks
-
-	// Valid only for Gen1
-	survive_timecode lengths[SENSORS_PER_OBJECT][NUM_GEN1_LIGHTHOUSES][2]; // Timecode per axis in ticks
+	// [lh * sensor_cnt + sensor]; read through SurviveSensorActivations_entry
+	SurviveSensorActivationsEntry *entries;
+	uint8_t sensor_cnt;
+	uint8_t lh_cnt;
 
 	uint32_t rollover_count;
 	size_t imu_init_cnt;
@@ -42,12 +57,56 @@ typedef struct SurviveSensorActivations_s {
 	FLT accel[3];
 	FLT gyro[3];
 	FLT mag[3];
+
+	// Changes bigger than these count as movement; taken from the owning object's config
+	FLT move_threshold_gyro;
+	FLT move_threshold_acc;
+	FLT move_threshold_ang;
+
+	// Every (entry, axis) slot that has seen a reading, linked from the most to the least recent timecode. Links are
+	// stored as slot + 1 so that zero means 'none'. Both arrays live in the same allocation as the entries.
+	uint16_t fresh_head;
+	uint16_t *fresh_next;
+	uint16_t *fresh_prev;
 } SurviveSensorActivations;
 
+/**
+ * What SurviveSensorActivations_entry returns for a sensor or lighthouse that hasn't been seen: NAN angles and zero
+ * timecodes and lengths.
+ */
+SURVIVE_IMPORT extern const SurviveSensorActivationsEntry SurviveSensorActivations_empty_entry;
+
+static inline const SurviveSensorActivationsEntry *
+SurviveSensorActivations_entry(const SurviveSensorActivations *self, uint32_t sensor_idx, int lh) {
+	if (sensor_idx >= self->sensor_cnt || lh < 0 || lh >= self->lh_cnt)
+		return &SurviveSensorActivations_empty_entry;
+	return &self->entries[lh * self->sensor_cnt + sensor_idx];
+}
+
+typedef struct SurviveSensorActivationsReading {
+	uint8_t sensor_idx;
+	uint8_t lh;
+	uint8_t axis;
+} SurviveSensorActivationsReading;
+
 struct PoserDataLight;
 struct PoserDataIMU;
 
 SURVIVE_EXPORT void SurviveSensorActivations_ctor(SurviveObject *so, SurviveSensorActivations *self);
+SURVIVE_EXPORT void SurviveSensorActivations_dtor(SurviveSensorActivations *self);
+
+/**
+ * Makes 'dst', which must already be constructed, a deep copy of 'src'. Reuses the storage of 'dst' when it is big
+ * enough.
+ */
+SURVIVE_EXPORT void SurviveSensorActivations_copy(SurviveSensorActivations *dst, const SurviveSensorActivations *src);
+
+/**
+ * Returns the entry for the given sensor and lighthouse for writing, growing the storage to cover it if needed. Call
+ * SurviveSensorActivations_reindex after filling in entries this way.
+ */
+SURVIVE_EXPORT SurviveSensorActivationsEntry *SurviveSensorActivations_entry_for_write(SurviveSensorActivations *self,
+																					   uint32_t sensor_idx, int lh);
 
 /**
  * Adds a lightData packet to the table.
@@ -74,6 +133,22 @@ SURVIVE_EXPORT bool SurviveSensorActivations_isReadingValid(const SurviveSensorA
 SURVIVE_EXPORT bool SurviveSensorActivations_isPairValid(const SurviveSensorActivations *self, survive_timecode tolerance,
 										  survive_timecode timecode_now, uint32_t sensor_idx, int lh);
 
+/**
+ * Fills `readings` with every reading for which SurviveSensorActivations_isReadingValid would return true, most recent
+ * first, and returns how many there were. Only the live readings are visited, so this is much cheaper than checking
+ * every sensor, lighthouse and axis.
+ */
+SURVIVE_EXPORT size_t SurviveSensorActivations_fresh_readings(const SurviveSensorActivations *self,
+															  survive_timecode tolerance, survive_timecode timecode_now,
+															  SurviveSensorActivationsReading *readings,
+															  size_t max_readings);
+
+/**
+ * Rebuilds the fresh reading index from the entries. Only needed when those are filled in directly instead of through
+ * the SurviveSensorActivations_add functions.
+ */
+SURVIVE_EXPORT void SurviveSensorActivations_reindex(SurviveSensorActivations *self);
+
 /**
  * Returns the amount of time stationary
  */
@@ -135,6 +210,8 @@ struct SurviveObject {
 
 	void *PoserFnData; // Initialized to zero, configured by poser, can be anything the poser wants.
 	PoserCB PoserFn;
+	struct survive_poser_worker *poser_worker; // Iff 'poser-threads' is set; see survive_poser_worker.h
+	struct survive_latency_tracer *latency; // Iff 'latency-trace' is set; see survive_latency.h
 	// Device-specific information about the location of the sensors.  This data will be used by the poser.
 	// These are stored in the IMU's coordinate frame so that posers don't have to do a ton of manipulation
 	// to do sensor fusion.
@@ -154,6 +231,8 @@ struct SurviveObject {
 	int8_t oldcode;
 	int8_t sync_set_number; // 0 = master, 1 = slave, -1 = fault.
 	int8_t did_handle_ootx; // If unset, will send lightcap data for sync pulses next time a sensor is hit.
+	// Lightcap counts used to tell gen 1 from gen 2 while ctx->lh_version is still -1
+	uint16_t gen_detect_pulse_cnt, gen_detect_total_cnt;
 	survive_timecode last_time_between_sync[NUM_GEN2_LIGHTHOUSES];
 	survive_timecode last_sync_time[NUM_GEN2_LIGHTHOUSES];
 	survive_timecode last_sync_length[NUM_GEN1_LIGHTHOUSES];
@@ -194,6 +273,13 @@ SURVIVE_EXPORT const bool survive_object_charging(SurviveObject *so);
 
 SURVIVE_EXPORT const SurvivePose *survive_object_pose(SurviveObject *so);
 
+/**
+ * Fills 'stats' with how old data was when it reached 'stage' for this object. Returns false if 'latency-trace' is off.
+ */
+SURVIVE_EXPORT bool survive_object_latency(const SurviveObject *so, SurviveLatencyStage stage,
+										   SurviveLatencyStats *stats);
+SURVIVE_EXPORT const char *survive_latency_stage_str(SurviveLatencyStage stage);
+
 SURVIVE_EXPORT int8_t survive_object_sensor_ct(SurviveObject *so);
 SURVIVE_EXPORT const FLT *survive_object_sensor_locations(SurviveObject *so);
 SURVIVE_EXPORT const FLT *survive_object_sensor_normals(SurviveObject *so);
@@ -357,6 +443,23 @@ SURVIVE_EXPORT void survive_close(SurviveContext *ctx);
 SURVIVE_EXPORT void survive_get_ctx_lock(SurviveContext *ctx);
 SURVIVE_EXPORT void survive_release_ctx_lock(SurviveContext *ctx);
 
+// Guards ctx->bsd against concurrent updates when posers run on their own threads. Writers take the bsd lock, which
+// excludes everyone else; solves only read, so they share the read side. Neither side can be taken recursively.
+SURVIVE_EXPORT void survive_get_bsd_lock(SurviveContext *ctx);
+SURVIVE_EXPORT void survive_release_bsd_lock(SurviveContext *ctx);
+SURVIVE_EXPORT void survive_get_bsd_read_lock(SurviveContext *ctx);
+SURVIVE_EXPORT void survive_release_bsd_read_lock(SurviveContext *ctx);
+
+/**
+ * Latency tracing. Drivers stamp the host time a raw packet arrived with survive_latency_packet_begin before handing
+ * its contents to the context, and clear it with survive_latency_packet_end afterwards; both need the context lock.
+ * Stamping is only worth the clock read when survive_latency_enabled is true.
+ */
+SURVIVE_EXPORT bool survive_latency_enabled(const SurviveContext *ctx);
+SURVIVE_EXPORT void survive_latency_packet_begin(SurviveContext *ctx, double arrival_time);
+SURVIVE_EXPORT void survive_latency_packet_end(SurviveContext *ctx);
+SURVIVE_EXPORT double survive_latency_packet_arrival(const SurviveContext *ctx);
+
 SURVIVE_EXPORT SurviveObject *survive_get_so_by_name(SurviveContext *ctx, const char *name);
 
 // Utilitiy functions.
@@ -376,11 +479,31 @@ SURVIVE_EXPORT FLT survive_configf(SurviveContext *ctx, const char *tag, char fl
 SURVIVE_EXPORT uint32_t survive_configi(SurviveContext *ctx, const char *tag, char flags, uint32_t def);
 SURVIVE_EXPORT const char *survive_configs(SurviveContext *ctx, const char *tag, char flags, const char *def);
 
+/**
+ * Binds 'var' to the tag; it is set to the current value now and rewritten, converted to its type, whenever the
+ * value in effect changes. Reading it is then as cheap as reading any variable, so this is the way to use config
+ * values in hot paths. Detach before 'var' goes away.
+ */
 SURVIVE_EXPORT void survive_attach_configi(SurviveContext *ctx, const char *tag, int * var );
 SURVIVE_EXPORT void survive_attach_configf(SurviveContext *ctx, const char *tag, FLT * var );
 SURVIVE_EXPORT void survive_attach_configs(SurviveContext *ctx, const char *tag, char * var );
 SURVIVE_EXPORT void survive_detach_config(SurviveContext *ctx, const char *tag, void * var );
 
+/**
+ * Calls 'fn' after every change to the value in effect for 'tag', whether it comes from the command line, a
+ * survive_config call or survive_config_reload. It runs on the thread making the change.
+ */
+SURVIVE_EXPORT void survive_config_subscribe(SurviveContext *ctx, const char *tag, survive_config_change_fn fn,
+											 void *user);
+SURVIVE_EXPORT void survive_config_unsubscribe(SurviveContext *ctx, const char *tag, survive_config_change_fn fn,
+											   void *user);
+
+/**
+ * Reads the config file again, notifying anything attached or subscribed to the values that changed. Values given on
+ * the command line still take precedence. Call this with the context lock held.
+ */
+SURVIVE_EXPORT void survive_config_reload(SurviveContext *ctx);
+
 SURVIVE_EXPORT int8_t survive_get_bsd_idx(SurviveContext *ctx, survive_channel channel);
 
 #define STATIC_CONFIG_ITEM(variable, name, type, description, default_value)                                           \
@@ -458,6 +581,31 @@ SURVIVE_EXPORT void survive_add_driver(SurviveContext *ctx, void *payload, Devic
 						DeviceDriverMagicCb magic);
 SURVIVE_EXPORT char *survive_export_config(SurviveObject *so);
 
+/**
+ * Output listeners see the poses, velocities, button events, calibrated IMU samples and angles the context reports.
+ * They are called from the default process functions -- so they keep working under user hooks that chain to those --
+ * from whichever thread reported the data. Any callback may be left null. Listeners are identified by 'user' for
+ * removal.
+ *
+ * 'angle' covers both generations: 'lh' is the lighthouse index, 'plane' the sweep axis and 'length' is 0 for gen 2.
+ */
+typedef struct SurviveOutputListener {
+	void *user;
+	void (*pose)(void *user, SurviveObject *so, survive_timecode timecode, const SurvivePose *pose);
+	void (*velocity)(void *user, SurviveObject *so, survive_timecode timecode, const SurviveVelocity *velocity);
+	void (*button)(void *user, SurviveObject *so, uint8_t eventType, uint8_t buttonId, uint8_t axis1Id,
+				   uint16_t axis1Val, uint8_t axis2Id, uint16_t axis2Val);
+	void (*imu)(void *user, SurviveObject *so, int mask, const FLT *accelgyromag, survive_timecode timecode, int id);
+	void (*angle)(void *user, SurviveObject *so, int sensor_id, survive_timecode timecode, int lh, int plane,
+				  FLT length, FLT angle);
+} SurviveOutputListener;
+
+SURVIVE_EXPORT void survive_add_output_listener(SurviveContext *ctx, const SurviveOutputListener *listener);
+/**
+ * Once this returns, no callback of the listener is running or will run again.
+ */
+SURVIVE_EXPORT void survive_remove_output_listener(SurviveContext *ctx, void *user);
+
 // This is the disambiguator function, for taking light timing and figuring out place-in-sweep for a given photodiode.
 SURVIVE_EXPORT uint8_t survive_map_sensor_id(SurviveObject *so, uint8_t reported_id);
 SURVIVE_EXPORT void handle_lightcap(SurviveObject *so, const LightcapElement *le);
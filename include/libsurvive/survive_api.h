@@ -85,12 +85,34 @@ SURVIVE_EXPORT const SurviveSimpleObject *survive_simple_get_next_updated(Surviv
 SURVIVE_EXPORT survive_timecode survive_simple_object_get_latest_pose(const SurviveSimpleObject *sao,
 																	  SurvivePose *pose);
 
+/**
+ * Current time on the clock used by survive_simple_object_get_pose_at, in seconds. Follows the recording during
+ * playback.
+ */
+SURVIVE_EXPORT FLT survive_simple_run_time(const SurviveSimpleContext *actx);
+
+/**
+ * Gets the pose of a tracked object at 'time' (see survive_simple_run_time). Times covered by recent solves are
+ * interpolated; later times are extrapolated from the newest pose and velocity, up to 100ms ahead. Meant for render
+ * loops asking for the pose at display time; it never waits on the poll thread.
+ *
+ * Returns false, and leaves 'pose' alone, if the object isn't tracked or has no pose yet.
+ */
+SURVIVE_EXPORT bool survive_simple_object_get_pose_at(const SurviveSimpleObject *sao, FLT time, SurvivePose *pose);
+
 /**
  * Gets the velocity of a given object
  */
 SURVIVE_EXPORT survive_timecode survive_simple_object_get_latest_velocity(const SurviveSimpleObject *sao,
 																		  SurviveVelocity *pose);
 
+/**
+ * Gets how old data was when it reached 'stage' for the given object; see 'latency-trace'. Returns false if tracing is
+ * off or the object isn't a tracked device.
+ */
+SURVIVE_EXPORT bool survive_simple_object_get_latency(const SurviveSimpleObject *sao, SurviveLatencyStage stage,
+													  SurviveLatencyStats *stats);
+
 /**
  * Gets the null terminated name of the object.
  */
@@ -112,6 +134,19 @@ SURVIVE_EXPORT bool survive_simple_wait_for_update(SurviveSimpleContext *actx);
 SURVIVE_EXPORT enum SurviveSimpleEventType survive_simple_next_event(SurviveSimpleContext *actx,
 																	 SurviveSimpleEvent *event);
 
+/**
+ * Drains up to 'max_events' pending events into 'events' and returns how many were written. Events are never
+ * overwritten; if the application falls very far behind new events are dropped instead, see
+ * survive_simple_get_dropped_event_count.
+ */
+SURVIVE_EXPORT size_t survive_simple_next_events(SurviveSimpleContext *actx, SurviveSimpleEvent *events,
+												 size_t max_events);
+
+/**
+ * Number of events dropped because the event queue was full.
+ */
+SURVIVE_EXPORT uint32_t survive_simple_get_dropped_event_count(const SurviveSimpleContext *actx);
+
 SURVIVE_EXPORT enum SurviveSimpleObject_type survive_simple_object_get_type(const struct SurviveSimpleObject *sao);
 
 /**
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "survive_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Collects poses, IMU samples and angles into preallocated arrays of plain structs, so bindings can take thousands of
+ * events per call instead of being called back once per event. The structs have a fixed layout -- doubles regardless
+ * of FLT, natural alignment and no hidden padding -- so they can be mapped directly as numpy structured arrays.
+ *
+ * There are two sets of arrays. Events go into one while the caller reads the other; survive_batch_drain swaps them.
+ * Events that arrive while the filling set is full are counted and dropped.
+ */
+typedef struct SurviveBatchPose {
+	char object[8];
+	double time; // survive_run_time when the event was reported
+	uint32_t timecode;
+	uint32_t reserved;
+	double pos[3];
+	double rot[4];
+} SurviveBatchPose;
+
+typedef struct SurviveBatchIMU {
+	char object[8];
+	double time;
+	uint32_t timecode;
+	int32_t mask;
+	double accel[3];
+	double gyro[3];
+	double mag[3];
+	int32_t id;
+	int32_t reserved;
+} SurviveBatchIMU;
+
+// Gen 1 and gen 2 angles alike; 'lh' is the lighthouse index, 'length' is 0 for gen 2
+typedef struct SurviveBatchAngle {
+	char object[8];
+	double time;
+	uint32_t timecode;
+	int32_t sensor_id;
+	int32_t lh;
+	int32_t plane;
+	double length;
+	double angle;
+} SurviveBatchAngle;
+
+typedef struct SurviveBatchData {
+	const SurviveBatchPose *poses;
+	size_t pose_cnt;
+	const SurviveBatchIMU *imu;
+	size_t imu_cnt;
+	const SurviveBatchAngle *angles;
+	size_t angle_cnt;
+
+	// Events that didn't fit since the previous drain
+	size_t dropped;
+} SurviveBatchData;
+
+typedef struct SurviveBatch SurviveBatch;
+
+/**
+ * Starts collecting events from 'ctx', up to 'capacity' of each kind between drains. Collection relies on the
+ * default process functions, so it sees everything unless a user hook doesn't chain to the default.
+ */
+SURVIVE_EXPORT SurviveBatch *survive_batch_create(SurviveContext *ctx, size_t capacity);
+
+/**
+ * Stops collecting; must be called before the context is closed.
+ */
+SURVIVE_EXPORT void survive_batch_free(SurviveBatch *batch);
+
+/**
+ * Returns everything collected since the previous drain. The arrays stay valid, and unchanged, until the next call.
+ */
+SURVIVE_EXPORT const SurviveBatchData *survive_batch_drain(SurviveBatch *batch);
+
+#ifdef __cplusplus
+};
+#endif
@@ -41,6 +41,11 @@ typedef struct {
 
 	mp_config *cfg;
 
+	// When set, residuals and jacobians for problems with at least parallel_threshold measurements are split over
+	// this pool. survive_optimizer_run fills these in from 'optimizer-parallel-threshold' if they are left unset.
+	struct survive_parallel_pool *parallel_pool;
+	size_t parallel_threshold;
+
 	struct {
 		uint32_t dropped_data_cnt;
 	} stats;
@@ -116,6 +121,25 @@ SURVIVE_EXPORT FLT survive_optimizer_current_norm(const survive_optimizer *optim
 
 SURVIVE_EXPORT mp_config *survive_optimizer_precise_config();
 
+/**
+ * A solution only makes sense if the first pose sits in front of every camera that saw it. meas_for_lhs holds the
+ * measurement count per camera; cameras with none are skipped. Pass NULL to check every solved camera.
+ */
+SURVIVE_EXPORT bool survive_optimizer_cameras_face_object(survive_optimizer *opt, const size_t *meas_for_lhs);
+
+/**
+ * Optimizer settings taken from a context's config. Each context reads them once, the first time it needs them, and
+ * keeps them with the context.
+ */
+typedef struct survive_optimizer_settings {
+	mp_config cfg;
+	bool use_pose_solver;
+	int parallel_threshold;
+} survive_optimizer_settings;
+
+SURVIVE_EXPORT void survive_optimizer_settings_init(SurviveContext *ctx, survive_optimizer_settings *settings);
+SURVIVE_EXPORT const survive_optimizer_settings *survive_get_optimizer_settings(SurviveContext *ctx);
+
 SURVIVE_EXPORT int survive_optimizer_nonfixed_cnt(const survive_optimizer *optimizer);
 
 SURVIVE_EXPORT void survive_optimizer_get_nonfixed(const survive_optimizer *optimizer, double *params);
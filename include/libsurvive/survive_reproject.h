@@ -45,6 +45,31 @@ typedef void (*survive_reproject_axisangle_full_jac_obj_pose_fn_t)(FLT *out, con
 typedef survive_reproject_axisangle_axis_jacob_fn_t survive_reproject_axisangle_full_jac_lh_pose_fn_t;
 typedef survive_reproject_axisangle_full_jac_obj_pose_fn_t survive_reproject_axisangle_axis_jacob_lh_pose_fn_t;
 
+/**
+ * Evaluates the reprojection and its jacobians wrt the object and lighthouse poses in one pass. 'out' gets the two
+ * angles, then the 2x6 jacobian wrt obj2world, then the 2x6 jacobian wrt world2lh, each laid out like the separate
+ * axis angle jacobian functions.
+ */
+typedef survive_reproject_axisangle_full_jac_obj_pose_fn_t survive_reproject_axisangle_with_jacs_fn_t;
+
+// Batches are transformed into the lighthouse frame this many points at a time
+#define SURVIVE_REPROJECT_BATCH_CHUNK 32
+
+/**
+ * Batched versions of the above that work on n sensors at once. Sensor positions are given in the object frame as
+ * separate x, y and z arrays. The XY batch takes the object's pose in the lighthouse frame and writes one angle per
+ * sensor into out_x and out_y. The jacobian batches write each sensor's jacobian laid out exactly as the single point
+ * function does; at a stride of 2 * 7 for the quaternion forms and 2 * 6 for the axis angle forms.
+ */
+typedef void (*survive_reproject_xy_batch_fn_t)(const BaseStationCal *bcal, const SurvivePose *obj2lh, size_t n,
+												const FLT *x, const FLT *y, const FLT *z, FLT *out_x, FLT *out_y);
+typedef void (*survive_reproject_full_jac_obj_pose_batch_fn_t)(FLT *out, const SurvivePose *obj2world,
+															   const SurvivePose *world2lh, const BaseStationCal *bcal,
+															   size_t n, const FLT *x, const FLT *y, const FLT *z);
+typedef void (*survive_reproject_axisangle_full_jac_obj_pose_batch_fn_t)(
+	FLT *out, const LinmathAxisAnglePose *obj2world, const LinmathAxisAnglePose *world2lh, const BaseStationCal *bcal,
+	size_t n, const FLT *x, const FLT *y, const FLT *z);
+
 typedef struct survive_reproject_model_t {
 	survive_reproject_xy_fn_t reprojectXY;
 	survive_reproject_axis_fn_t reprojectAxisFn[2];
@@ -60,6 +85,12 @@ typedef struct survive_reproject_model_t {
 
 	survive_reproject_axisangle_full_jac_lh_pose_fn_t reprojectAxisAngleFullJacLhPose;
 	survive_reproject_axisangle_axis_jacob_lh_pose_fn_t reprojectAxisAngleAxisJacobLhPoseFn[2];
+
+	survive_reproject_axisangle_with_jacs_fn_t reprojectAxisAngleWithJacs;
+
+	survive_reproject_xy_batch_fn_t reprojectXYBatch;
+	survive_reproject_full_jac_obj_pose_batch_fn_t reprojectFullJacObjPoseBatch;
+	survive_reproject_axisangle_full_jac_obj_pose_batch_fn_t reprojectAxisAngleFullJacObjPoseBatch;
 } survive_reproject_model_t;
 
 SURVIVE_IMPORT extern const survive_reproject_model_t survive_reproject_model;
@@ -68,6 +99,25 @@ SURVIVE_EXPORT FLT survive_reproject_axis_x(const BaseStationCal *bcal, LinmathV
 SURVIVE_EXPORT FLT survive_reproject_axis_y(const BaseStationCal *bcal, LinmathVec3d const ptInLh);
 
 SURVIVE_EXPORT void survive_reproject_xy(const BaseStationCal *bcal, LinmathVec3d const ptInLh, SurviveAngleReading out);
+
+/**
+ * Applies 'pose' to n points given as separate x, y and z arrays. Uses AVX2 or NEON when the build targets them.
+ */
+SURVIVE_EXPORT void survive_apply_pose_to_points(const SurvivePose *pose, size_t n, const FLT *x, const FLT *y,
+												 const FLT *z, FLT *out_x, FLT *out_y, FLT *out_z);
+
+SURVIVE_EXPORT void survive_reproject_xy_batch(const BaseStationCal *bcal, const SurvivePose *obj2lh, size_t n,
+											   const FLT *x, const FLT *y, const FLT *z, FLT *out_x, FLT *out_y);
+SURVIVE_EXPORT void survive_reproject_full_jac_obj_pose_batch(FLT *out, const SurvivePose *obj2world,
+															  const SurvivePose *world2lh, const BaseStationCal *bcal,
+															  size_t n, const FLT *x, const FLT *y, const FLT *z);
+SURVIVE_EXPORT void survive_reproject_axisangle_full_jac_obj_pose_batch(FLT *out, const LinmathAxisAnglePose *obj2world,
+																		const LinmathAxisAnglePose *world2lh,
+																		const BaseStationCal *bcal, size_t n,
+																		const FLT *x, const FLT *y, const FLT *z);
+SURVIVE_EXPORT void survive_reproject_axisangle_with_jacs(FLT *out, const LinmathAxisAnglePose *obj2world,
+														  const FLT *pt, const LinmathAxisAnglePose *world2lh,
+														  const BaseStationCal *bcal);
 SURVIVE_EXPORT void survive_reproject_from_pose(const SurviveContext *ctx, int lighthouse, const SurvivePose *world2lh,
 								 LinmathVec3d const ptInWorld, SurviveAngleReading out);
 
@@ -25,6 +25,20 @@ SURVIVE_EXPORT FLT survive_reproject_axis_y_gen2(const BaseStationCal *bcal, Lin
 
 SURVIVE_EXPORT void survive_reproject_xy_gen2(const BaseStationCal *bcal, LinmathVec3d const ptInLh,
 											  SurviveAngleReading out);
+SURVIVE_EXPORT void survive_reproject_xy_gen2_batch(const BaseStationCal *bcal, const SurvivePose *obj2lh, size_t n,
+													const FLT *x, const FLT *y, const FLT *z, FLT *out_x, FLT *out_y);
+SURVIVE_EXPORT void survive_reproject_full_jac_obj_pose_gen2_batch(FLT *out, const SurvivePose *obj2world,
+																   const SurvivePose *world2lh,
+																   const BaseStationCal *bcal, size_t n, const FLT *x,
+																   const FLT *y, const FLT *z);
+SURVIVE_EXPORT void survive_reproject_axisangle_full_jac_obj_pose_gen2_batch(FLT *out,
+																			 const LinmathAxisAnglePose *obj2world,
+																			 const LinmathAxisAnglePose *world2lh,
+																			 const BaseStationCal *bcal, size_t n,
+																			 const FLT *x, const FLT *y, const FLT *z);
+SURVIVE_EXPORT void survive_reproject_axisangle_with_jacs_gen2(FLT *out, const LinmathAxisAnglePose *obj2world,
+															   const FLT *pt, const LinmathAxisAnglePose *world2lh,
+															   const BaseStationCal *bcal);
 SURVIVE_EXPORT void survive_reproject_from_pose_gen2(const SurviveContext *ctx, int lighthouse,
 													 const SurvivePose *world2lh, LinmathVec3d const ptInWorld,
 													 SurviveAngleReading out);
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "survive.h"
+#include "survive_optimizer.h"
+#include "survive_reproject.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Sparse bundle adjustment of lighthouse poses and calibration against many captured poses of one object.
+ *
+ * Every measurement depends on exactly one object pose and one lighthouse, so the normal equations are block sparse:
+ * a 6x6 block per object pose, coupled only to the lighthouse parameters. Each step eliminates the object poses via
+ * the Schur complement, solves the small dense system over the lighthouse parameters, and back substitutes the pose
+ * updates. Time is linear in the number of measurements; memory is linear in the number of poses and quadratic only
+ * in the number of free lighthouse parameters. The dense survive_optimizer equivalent is cubic in the pose count.
+ *
+ * Jacobians for the calibration are numeric. Some parameters can't be told apart from the data: for gen 2, a phase
+ * offset common to both axes is exactly a rotation of the lighthouse, so don't refine phase with a free pose.
+ *
+ * Object poses and lighthouses are parameterized as axis angle poses internally, just like survive_optimizer.
+ */
+
+// Bit for a BaseStationCal field in survive_sba::cal_mask
+#define SURVIVE_SBA_CAL(field) (1u << (offsetof(BaseStationCal, field) / sizeof(FLT)))
+
+typedef struct survive_sba {
+	const survive_reproject_model_t *reprojectModel;
+
+	// Sensor positions in the object frame; 3 per sensor
+	const FLT *sensor_locations;
+
+	// obj2world of every captured pose; refined in place
+	SurvivePose *poses;
+	size_t poseCnt;
+
+	// 'object' is the index into poses. Measurements must be sorted by it.
+	const survive_optimizer_measurement *measurements;
+	size_t measurementsCnt;
+
+	// lh2world, as in BaseStationData::Pose, and calibration per lighthouse; both refined in place
+	int lighthouseCnt;
+	SurvivePose lighthouses[NUM_GEN2_LIGHTHOUSES];
+	BaseStationCal fcal[NUM_GEN2_LIGHTHOUSES][2];
+
+	// Bitmask of lighthouses whose pose isn't refined. Fix at least one; otherwise the solution can drift freely.
+	uint32_t fixed_lighthouses;
+	// Which calibration fields to refine, for both axes of every lighthouse; see SURVIVE_SBA_CAL
+	uint32_t cal_mask;
+
+	// 0 picks the defaults; 50 iterations and a relative tolerance of 1e-10
+	int max_iterations;
+	FLT ftol;
+} survive_sba;
+
+typedef struct survive_sba_result {
+	// Sum of the squared deviates, weighted the same way survive_optimizer weighs them
+	FLT orignorm;
+	FLT bestnorm;
+	int iterations;
+	// Poses that didn't have enough measurements to solve for and were left as is
+	size_t skipped_poses;
+} survive_sba_result;
+
+/**
+ * Runs Levenberg-Marquardt until converged. Returns the number of accepted steps, or -1 if the input is invalid.
+ */
+SURVIVE_EXPORT int survive_sba_run(survive_sba *sba, survive_sba_result *result);
+
+#ifdef __cplusplus
+}
+#endif
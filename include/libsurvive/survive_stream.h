@@ -0,0 +1,117 @@
+#pragma once
+
+#include "survive_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Wire format of the pose stream published by the 'stream' driver, and a client to read it.
+ *
+ * Every frame is a SURVIVE_STREAM_HEADER_SIZE byte header followed by a body whose size depends on the type. All
+ * values are little endian and poses are sent as 32 bit floats:
+ *
+ *   0  uint8   type
+ *   1  uint8   version
+ *   2  uint16  size of the whole frame
+ *   4  uint32  sequence number
+ *   8  double  survive_run_time of the server when the frame was made
+ *   16 char[8] codename of the object, null padded
+ *
+ * Each TCP connection and the multicast group have their own sequence, which counts every frame meant for that
+ * destination -- including ones dropped because the destination couldn't keep up -- so gaps show up as loss.
+ *
+ * TCP clients get every object until they send their first SUBSCRIBE frame; after that only the objects they have
+ * subscribed to. SUBSCRIBE frames are a bare header naming the object. Multicast receivers filter locally.
+ */
+#define SURVIVE_STREAM_VERSION 1
+#define SURVIVE_STREAM_HEADER_SIZE 24
+#define SURVIVE_STREAM_MAX_FRAME_SIZE 64
+#define SURVIVE_STREAM_OBJECT_LEN 8
+
+typedef enum SurviveStreamFrameType {
+	SURVIVE_STREAM_NONE = 0,
+	SURVIVE_STREAM_POSE,
+	SURVIVE_STREAM_VELOCITY,
+	SURVIVE_STREAM_BUTTON,
+	SURVIVE_STREAM_SUBSCRIBE,
+	SURVIVE_STREAM_TYPE_MAX
+} SurviveStreamFrameType;
+
+typedef struct SurviveStreamButton {
+	uint8_t event_type;
+	uint8_t button_id;
+	uint8_t axis1_id;
+	uint8_t axis2_id;
+	uint16_t axis1_val;
+	uint16_t axis2_val;
+} SurviveStreamButton;
+
+typedef struct SurviveStreamFrame {
+	SurviveStreamFrameType type;
+	uint32_t seq;
+	double time;
+	char object[SURVIVE_STREAM_OBJECT_LEN + 1];
+
+	survive_timecode timecode;
+	union {
+		SurvivePose pose;
+		SurviveVelocity velocity;
+		SurviveStreamButton button;
+	} body; // Which member is set depends on 'type'
+} SurviveStreamFrame;
+
+/**
+ * Size on the wire of a frame of the given type, or 0 for unknown types.
+ */
+SURVIVE_EXPORT size_t survive_stream_frame_size(SurviveStreamFrameType type);
+
+/**
+ * Writes 'frame' into 'buffer'. Returns the number of bytes written, or 0 if it doesn't fit or has an unknown type.
+ */
+SURVIVE_EXPORT size_t survive_stream_encode(const SurviveStreamFrame *frame, uint8_t *buffer, size_t len);
+
+/**
+ * Reads one frame from the start of 'buffer'. Returns the number of bytes it took up, 0 if 'buffer' doesn't hold a
+ * whole frame yet, and -1 if the data isn't a frame. Frames of unknown type are consumed with type
+ * SURVIVE_STREAM_NONE so that newer servers don't break older clients.
+ */
+SURVIVE_EXPORT int survive_stream_decode(SurviveStreamFrame *frame, const uint8_t *buffer, size_t len);
+
+typedef struct SurviveStreamClient SurviveStreamClient;
+
+/**
+ * Connects to the TCP port of a stream server. Returns 0 on failure.
+ */
+SURVIVE_EXPORT SurviveStreamClient *survive_stream_connect(const char *host, uint16_t port);
+
+/**
+ * Joins the multicast group a stream server publishes to. Returns 0 on failure.
+ */
+SURVIVE_EXPORT SurviveStreamClient *survive_stream_join(const char *group, uint16_t port);
+
+/**
+ * Limits the frames survive_stream_read returns to the given object; may be called more than once. Over TCP this
+ * is also sent to the server so unwanted objects don't use up bandwidth. Returns 0 on success.
+ */
+SURVIVE_EXPORT int survive_stream_subscribe(SurviveStreamClient *client, const char *object);
+
+/**
+ * Waits up to 'timeout_ms' for the next frame; negative waits forever. Returns 1 if 'frame' was filled in, 0 on
+ * timeout and -1 once the connection is gone.
+ */
+SURVIVE_EXPORT int survive_stream_read(SurviveStreamClient *client, SurviveStreamFrame *frame, int timeout_ms);
+
+/**
+ * Number of frames the sequence numbers say were lost so far.
+ */
+SURVIVE_EXPORT uint32_t survive_stream_dropped(const SurviveStreamClient *client);
+
+SURVIVE_EXPORT void survive_stream_close(SurviveStreamClient *client);
+
+#ifdef __cplusplus
+};
+#endif
@@ -104,7 +104,26 @@ typedef enum {
 	SURVIVE_LOG_LEVEL_INFO = 2,
 } SurviveLogLevel;
 
+// Points along the processing pipeline at which 'latency-trace' measures the age of the data
+typedef enum SurviveLatencyStage {
+	SURVIVE_LATENCY_LIGHTCAP,	   // Raw light event decoded from the packet
+	SURVIVE_LATENCY_DISAMBIGUATOR, // Light event attributed to a lighthouse and axis
+	SURVIVE_LATENCY_ANGLE,		   // Angle handed to the poser
+	SURVIVE_LATENCY_POSER,		   // Poser started on the data
+	SURVIVE_LATENCY_POSE,		   // Pose reported
+	SURVIVE_LATENCY_STAGE_COUNT
+} SurviveLatencyStage;
+
+// Time since the originating packet arrived on the host, in seconds
+typedef struct SurviveLatencyStats {
+	uint32_t count;
+	FLT p50;
+	FLT p99;
+	FLT max;
+} SurviveLatencyStats;
+
 typedef void (*survive_driver_fn)();
+typedef void (*survive_config_change_fn)(SurviveContext *ctx, const char *tag, void *user);
 
 typedef int (*printf_process_func)(SurviveContext *ctx, const char *format, ...);
 typedef void (*log_process_func)(SurviveContext *ctx, SurviveLogLevel logLevel, const char *fault);
@@ -112,8 +112,6 @@ void (*json_begin_object)(char* tag) = NULL;
 void (*json_end_object)() = NULL;
 void (*json_tag_value)(char* tag, char** values, uint8_t count) = NULL;
 
-uint32_t JSON_STRING_LEN;
-
 char* load_file_to_mem(const char* path) {
 	FILE * f = fopen( path, "r" );
 	if (f==NULL) return NULL;
@@ -139,7 +137,8 @@ static char* substr(const char* str, uint32_t start, uint32_t end, uint32_t npos
 	return x;
 }
 
-static uint16_t json_load_array(const char* JSON_STRING, jsmntok_t* tokens, uint16_t size, char* tag) {
+static uint16_t json_load_array(const char *JSON_STRING, uint32_t JSON_STRING_LEN, jsmntok_t *tokens, uint16_t size,
+							   char *tag, const json_load_callbacks *cb) {
 	jsmntok_t* t = tokens;
 	uint16_t i = 0;
 
@@ -151,20 +150,20 @@ static uint16_t json_load_array(const char* JSON_STRING, jsmntok_t* tokens, uint
 		values[i] = substr(JSON_STRING, t->start, t->end, JSON_STRING_LEN);
 	}
 
-	if (json_tag_value != NULL) json_tag_value(tag, values, (uint8_t)i);
+	if (cb->tag_value != NULL) cb->tag_value(cb->user, tag, values, (uint8_t)i);
 
 	for (i=0;i<size;++i) free(values[i]);
 
 	return size;
 }
 
-void json_load_file(const char* path) {
+void json_load_file_cb(const char *path, const json_load_callbacks *cb) {
 	uint32_t i = 0;
 
 	char* JSON_STRING = load_file_to_mem(path);
 	if (JSON_STRING==NULL) return;
 
-	JSON_STRING_LEN = (uint32_t)strlen(JSON_STRING);
+	uint32_t JSON_STRING_LEN = (uint32_t)strlen(JSON_STRING);
 
 	jsmn_parser parser;
 	jsmn_init(&parser);
@@ -188,20 +187,21 @@ void json_load_file(const char* path) {
 		char* value = substr(JSON_STRING, value_t->start, value_t->end, JSON_STRING_LEN);
 
 		if (value_t->type == JSMN_ARRAY) {
-			i += json_load_array(JSON_STRING, tokens+i+2,value_t->size, tag); //look at array children
+			i += json_load_array(JSON_STRING, JSON_STRING_LEN, tokens + i + 2, value_t->size, tag,
+								 cb); // look at array children
 		} else if (value_t->type == JSMN_OBJECT) {
-			if (json_begin_object != NULL) json_begin_object(tag);
+			if (cb->begin_object != NULL) cb->begin_object(cb->user, tag);
 			children = (int16_t)(value_t->size +1); //+1 to account for this loop where we are not yed parsing children
 //			i += decode_jsmn_object(JSON_STRING, tokens+i+2,value_t->size);
 		}
 		else {
-			if (json_tag_value != NULL) json_tag_value(tag, &value, 1);
+			if (cb->tag_value != NULL) cb->tag_value(cb->user, tag, &value, 1);
 		}
 
 		if (children>=0) children--;
 		if (children == 0) {
 			children = -1;
-			if (json_end_object!=NULL) json_end_object();
+			if (cb->end_object != NULL) cb->end_object(cb->user);
 		}
 
 //		printf("%d %s \n", value_t->type, tag);
@@ -286,3 +286,20 @@ int parse_int_array(char *str, const jsmntok_t *token, int **f, uint8_t count) {
 
 	return count;
 }
+
+static void json_global_begin_object(void *user, char *tag) {
+	if (json_begin_object != NULL) json_begin_object(tag);
+}
+static void json_global_end_object(void *user) {
+	if (json_end_object != NULL) json_end_object();
+}
+static void json_global_tag_value(void *user, char *tag, char **values, uint8_t count) {
+	if (json_tag_value != NULL) json_tag_value(tag, values, count);
+}
+
+void json_load_file(const char* path) {
+	json_load_callbacks cb = {.begin_object = json_global_begin_object,
+							  .end_object = json_global_end_object,
+							  .tag_value = json_global_tag_value};
+	json_load_file_cb(path, &cb);
+}
@@ -21,8 +21,19 @@ int parse_int_array_in_place(char *str, const jsmntok_t *token, int *values, uin
 int parse_int_array(char *str, const jsmntok_t *token, int **values, uint8_t count);
 
 void json_load_file(const char* path);
+char *load_file_to_mem(const char *path);
 extern void (*json_begin_object)(char* tag);
 extern void (*json_end_object)();
 extern void (*json_tag_value)(char* tag, char** values, uint8_t count);
 
+// Same as json_load_file, but reports to the given callbacks instead of the globals above, so it can run on several
+// threads at once.
+typedef struct json_load_callbacks {
+	void *user;
+	void (*begin_object)(void *user, char *tag);
+	void (*end_object)(void *user);
+	void (*tag_value)(void *user, char *tag, char **values, uint8_t count);
+} json_load_callbacks;
+void json_load_file_cb(const char *path, const json_load_callbacks *cb);
+
 #endif
@@ -135,7 +135,7 @@ static void redraw(SurviveContext *ctx) {
 			int v_cnt[2] = {0};
 			for (int sensor = 0; sensor < so->sensor_ct; sensor++) {
 				for (int axis = 0; axis < 2; axis++) {
-					FLT f = so->activations.angles[sensor][lh][axis];
+					FLT f = SurviveSensorActivations_entry(&so->activations, sensor, lh)->angles[axis];
 					if (!isnan(f)) {
 						v_cnt[axis]++;
 						v[axis] += f;
@@ -167,7 +167,7 @@ static void redraw(SurviveContext *ctx) {
 
 				bool allNans = true;
 				for (int axis = 0; axis < 2 && allNans; axis++) {
-					FLT f = so->activations.angles[sensor][lh][axis];
+					FLT f = SurviveSensorActivations_entry(&so->activations, sensor, lh)->angles[axis];
 					allNans &= isnan(f);
 				}
 
@@ -186,7 +186,7 @@ static void redraw(SurviveContext *ctx) {
 				print_int(time_stats[i][lh][sensor].hit_count);
 				print(time_stats[i][lh][sensor].hz);
 				for (int axis = 0; axis < 2; axis++) {
-					FLT f = so->activations.angles[sensor][lh][axis];
+					FLT f = SurviveSensorActivations_entry(&so->activations, sensor, lh)->angles[axis];
 					process_reading(i, lh, sensor, axis, f);
 					print(f);
 				}
@@ -1,5 +1,7 @@
 #include "barycentric_svd.h"
+#include "float.h"
 #include "math.h"
+#include "string.h"
 #include "stdbool.h"
 #include "stdio.h"
 #include "stdlib.h"
@@ -80,6 +82,8 @@ void bc_svd_bc_svd(bc_svd *self, void *user, bc_svd_fill_M_fn fillFn, const Linm
 	self->setup.obj_pts = obj_pts;
 	self->setup.alphas = SV_CALLOC(obj_cnt, sizeof(self->setup.alphas[0]));
 	self->object_pts_in_camera = SV_CALLOC(obj_cnt, sizeof(self->setup.alphas[0]));
+	self->meas_angles = SV_CALLOC(obj_cnt * 2, sizeof(double));
+	self->meas_weights = SV_CALLOC(obj_cnt * 2, sizeof(double));
 
 	bc_svd_choose_control_points(self);
 	bc_svd_compute_barycentric_coordinates(self);
@@ -88,7 +92,8 @@ void bc_svd_bc_svd(bc_svd *self, void *user, bc_svd_fill_M_fn fillFn, const Linm
 void bc_svd_dtor(bc_svd *self) {
 	free(self->setup.alphas);
 	free(self->object_pts_in_camera);
-	free(self->meas);
+	free(self->meas_angles);
+	free(self->meas_weights);
 }
 
 double bc_svd_compute_R_and_t(bc_svd *self, const double *ut, const double *betas, double R[3][3], double t[3]);
@@ -108,7 +113,76 @@ void bc_svd_compute_rho(bc_svd *self, double *rho) {
 	rho[5] = dist2(self->setup.control_points[2], self->setup.control_points[3]);
 }
 
-void bc_svd_reset_correspondences(bc_svd *self) { self->meas_cnt = 0; }
+void bc_svd_reset_correspondences(bc_svd *self) {
+	self->meas_cnt = 0;
+	self->meas_weight = 0;
+	memset(self->MtM, 0, sizeof(self->MtM));
+	memset(self->err_MtM, 0, sizeof(self->err_MtM));
+	memset(self->col_cnt, 0, sizeof(self->col_cnt));
+	memset(self->meas_weights, 0, self->setup.obj_cnt * 2 * sizeof(double));
+}
+
+// Adds the row of M, and the row of the reprojection error, for one angle with the given weight. A negative weight
+// takes back what the same positive weight added.
+static void bc_svd_accumulate(bc_svd *self, size_t idx, int axis, double angle, double weight) {
+	double eq[3] = {NAN, NAN, NAN};
+	self->setup.fillFn(self->setup.user, eq, axis, angle);
+	assert(!isnan(eq[0]) && !isnan(eq[1]) && !isnan(eq[2]));
+
+	const double *as = self->setup.alphas[idx];
+	const double *pw = self->setup.obj_pts[idx];
+
+	// The error row is laid out like [R | t] row by row, so that the error is row . [R | t]
+	double M[12], err[12];
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 3; j++) {
+			M[i * 3 + j] = eq[j] * as[i];
+		}
+	}
+	for (int j = 0; j < 3; j++) {
+		for (int k = 0; k < 3; k++) {
+			err[j * 4 + k] = eq[j] * pw[k];
+		}
+		err[j * 4 + 3] = eq[j];
+	}
+
+	for (int i = 0; i < 12; i++) {
+		if (M[i] != 0.0)
+			self->col_cnt[i] += weight > 0 ? 1 : -1;
+
+		for (int j = i; j < 12; j++) {
+			self->MtM[i * 12 + j] += weight * M[i] * M[j];
+			self->err_MtM[i * 12 + j] += weight * err[i] * err[j];
+		}
+	}
+
+	self->meas_weight += weight;
+	if (weight > 0)
+		self->meas_cnt++;
+	else
+		self->meas_cnt--;
+}
+
+static void bc_svd_take_back(bc_svd *self, size_t idx, int axis) {
+	double *weight = &self->meas_weights[idx * 2 + axis];
+	if (*weight == 0)
+		return;
+
+	bc_svd_accumulate(self, idx, axis, self->meas_angles[idx * 2 + axis], -*weight);
+	*weight = 0;
+
+	// Clear out whatever rounding is left over rather than let it build up
+	if (self->meas_cnt == 0)
+		bc_svd_reset_correspondences(self);
+}
+
+// Replaces whatever correspondence the axis had with one at full weight
+static void bc_svd_put(bc_svd *self, size_t idx, int axis, double angle) {
+	bc_svd_take_back(self, idx, axis);
+	bc_svd_accumulate(self, idx, axis, angle, 1);
+	self->meas_angles[idx * 2 + axis] = angle;
+	self->meas_weights[idx * 2 + axis] = 1;
+}
 
 void bc_svd_add_correspondence(bc_svd *self, size_t idx, double u, double v) {
 	if (isnan(u) && isnan(v)) {
@@ -125,26 +199,113 @@ void bc_svd_add_correspondence(bc_svd *self, size_t idx, double u, double v) {
 		if (isnan(angle))
 			continue;
 
-		if (self->meas_space <= self->meas_cnt) {
-			self->meas_space = self->meas_space * 2 + 1;
-			self->meas = SV_REALLOC(self->meas, sizeof(self->meas[0]) * self->meas_space);
+		bc_svd_put(self, idx, i, angle);
+	}
+}
+
+void bc_svd_remove_correspondence(bc_svd *self, size_t idx, double u, double v) {
+	for (int i = 0; i < 2; i++) {
+		if (!isnan(i == 0 ? u : v))
+			bc_svd_take_back(self, idx, i);
+	}
+}
+
+void bc_svd_update_correspondence(bc_svd *self, size_t idx, double u, double v) {
+	for (int i = 0; i < 2; i++) {
+		double angle = i == 0 ? u : v;
+		if (isnan(angle)) {
+			bc_svd_take_back(self, idx, i);
+		} else if (self->meas_weights[idx * 2 + i] == 0 || self->meas_angles[idx * 2 + i] != angle) {
+			bc_svd_put(self, idx, i, angle);
 		}
+	}
+}
 
-		self->meas[self->meas_cnt] = (bc_svd_meas_t){.angle = angle, .axis = i, .obj_idx = idx};
+// Below this a correspondence adds next to nothing to the solve, but would still count towards covering its columns
+#define BC_SVD_MIN_WEIGHT 1e-3
 
-		self->meas_cnt++;
+void bc_svd_decay_correspondences(bc_svd *self, double factor) {
+	self->meas_weight *= factor;
+	for (int i = 0; i < 12 * 12; i++) {
+		self->MtM[i] *= factor;
+		self->err_MtM[i] *= factor;
+	}
+
+	for (size_t i = 0; i < self->setup.obj_cnt * 2; i++) {
+		self->meas_weights[i] *= factor;
+		if (self->meas_weights[i] != 0 && self->meas_weights[i] < BC_SVD_MIN_WEIGHT)
+			bc_svd_take_back(self, i / 2, i % 2);
 	}
 }
 
-void bc_svd_fill_M(bc_svd *self, CvMat *_M, const int row, const double *as, int axis, double angle) {
-	double *M = _M->data.db + row * 12;
+// Cyclic Jacobi eigen decomposition of the symmetric matrix whose upper triangle is in 'A'. Fills d with the
+// eigenvalues in decreasing order and the rows of ut with their eigenvectors; which for the positive semi-definite
+// MtM is exactly what cvSVD gives with CV_SVD_U_T.
+static void bc_svd_eigen_12x12(const double *A, double *d, double *ut) {
+	double a[12][12], v[12][12] = {0};
+	double norm = 0;
+	for (int i = 0; i < 12; i++) {
+		v[i][i] = 1;
+		for (int j = i; j < 12; j++) {
+			a[i][j] = a[j][i] = A[i * 12 + j];
+			norm += (i == j ? 1 : 2) * A[i * 12 + j] * A[i * 12 + j];
+		}
+	}
 
-	double eq[3] = {NAN, NAN, NAN};
-	self->setup.fillFn(self->setup.user, eq, axis, angle);
+	for (int sweep = 0; sweep < 50; sweep++) {
+		double off = 0;
+		for (int p = 0; p < 12; p++)
+			for (int q = p + 1; q < 12; q++)
+				off += a[p][q] * a[p][q];
+		if (off <= DBL_EPSILON * DBL_EPSILON * norm)
+			break;
 
-	for (int i = 0; i < 4; i++) {
-		for (int j = 0; j < 3; j++) {
-			M[i * 3 + j] = eq[j] * as[i];
+		for (int p = 0; p < 12; p++) {
+			for (int q = p + 1; q < 12; q++) {
+				if (a[p][q] == 0.0)
+					continue;
+
+				double theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+				double t = (theta >= 0 ? 1. : -1.) / (fabs(theta) + hypot(theta, 1));
+				double c = 1. / sqrt(t * t + 1), s = t * c;
+
+				for (int k = 0; k < 12; k++) {
+					double akp = a[k][p], akq = a[k][q];
+					a[k][p] = c * akp - s * akq;
+					a[k][q] = s * akp + c * akq;
+				}
+				for (int k = 0; k < 12; k++) {
+					double apk = a[p][k], aqk = a[q][k];
+					a[p][k] = c * apk - s * aqk;
+					a[q][k] = s * apk + c * aqk;
+				}
+				a[p][q] = a[q][p] = 0;
+
+				for (int k = 0; k < 12; k++) {
+					double vkp = v[k][p], vkq = v[k][q];
+					v[k][p] = c * vkp - s * vkq;
+					v[k][q] = s * vkp + c * vkq;
+				}
+			}
+		}
+	}
+
+	int order[12];
+	for (int i = 0; i < 12; i++) {
+		order[i] = i;
+	}
+	for (int i = 1; i < 12; i++) {
+		for (int j = i; j > 0 && a[order[j]][order[j]] > a[order[j - 1]][order[j - 1]]; j--) {
+			int tmp = order[j];
+			order[j] = order[j - 1];
+			order[j - 1] = tmp;
+		}
+	}
+
+	for (int i = 0; i < 12; i++) {
+		d[i] = a[order[i]][order[i]];
+		for (int k = 0; k < 12; k++) {
+			ut[i * 12 + k] = v[k][order[i]];
 		}
 	}
 }
@@ -262,21 +423,12 @@ void compute_A_and_b_gauss_newton(const double *l_6x10, const double *rho, doubl
 }
 
 void qr_solve(CvMat *A, CvMat *b, CvMat *X) {
-	static int max_nr = 0;
-	static double *A1, *A2;
-
 	const int nr = A->rows;
 	const int nc = A->cols;
 
-	if (max_nr != 0 && max_nr < nr) {
-		free(A1);
-		free(A2);
-	}
-	if (max_nr < nr) {
-		max_nr = nr;
-		A1 = SV_MALLOC(sizeof(double) * nr);
-		A2 = SV_MALLOC(sizeof(double) * nr);
-	}
+	// Only ever 6x4, so scratch lives on the stack rather than in buffers shared by every caller
+	double *A1 = alloca(sizeof(double) * nr);
+	double *A2 = alloca(sizeof(double) * nr);
 
 	double *pA = A->data.db, *ppAkk = pA;
 	for (int k = 0; k < nc; k++) {
@@ -437,46 +589,14 @@ void copy_R_and_t(const double R_src[3][3], const double t_src[3], double R_dst[
 	}
 }
 
-#ifdef USE_DOUBLE
-#define SURVIVE_CV_F CV_64F
-#else
-#define SURVIVE_CV_F CV_32F
-#endif
-
-#define CREATE_STACK_MAT(name, rows, cols)                                                                             \
-	FLT *_##name = alloca(rows * cols * sizeof(FLT));                                                                  \
-	CvMat name = cvMat(rows, cols, SURVIVE_CV_F, _##name);
-
 double bc_svd_compute_pose(bc_svd *self, double R[3][3], double t[3]) {
-	CREATE_STACK_MAT(M, self->meas_cnt, 12);
-	bool colCovered[12] = { 0 };
-	for (int i = 0; i < self->meas_cnt; i++) {
-		size_t obj_pt_idx = self->meas[i].obj_idx;
-		bc_svd_fill_M(self, &M, i, self->setup.alphas[obj_pt_idx], self->meas[i].axis, self->meas[i].angle);
-
-		double *_M = M.data.db + i * 12;
-		for (int j = 0; j < 12; j++) {
-			assert(!isnan(_M[j]));
-			if (_M[j] != 0.0)
-				colCovered[j] = true;
-		}
-	}
-
 	for (int j = 0; j < 12; j++) {
-		if (colCovered[j] == false)
+		if (self->col_cnt[j] <= 0)
 			return -1;
 	}
 
-	double mtm[12 * 12], d[12], ut[12 * 12];
-	CvMat MtM = cvMat(12, 12, CV_64F, mtm);
-	CvMat D = cvMat(12, 1, CV_64F, d);
-	CvMat Ut = cvMat(12, 12, CV_64F, ut);
-
-	cvMulTransposed(&M, &MtM, 1, 0, 1);
-
-	cvSVD(&MtM, &D, &Ut, 0, CV_SVD_MODIFY_A | CV_SVD_U_T);
-
-	assert(Ut.data.db == ut);
+	double d[12], ut[12 * 12];
+	bc_svd_eigen_12x12(self->MtM, d, ut);
 
 	double l_6x10[6 * 10], rho[6];
 	CvMat L_6x10 = cvMat(6, 10, CV_64F, l_6x10);
@@ -514,23 +634,24 @@ double bc_svd_compute_pose(bc_svd *self, double R[3][3], double t[3]) {
 }
 
 static double bc_svd_reprojection_error(bc_svd *self, const double R[3][3], const double t[3]) {
-	double sum2 = 0.0;
-
-	for (int i = 0; i < self->meas_cnt; i++) {
-		size_t obj_idx = self->meas[i].obj_idx;
-		const double *pw = self->setup.obj_pts[obj_idx];
-		double Xc = dot(R[0], pw) + t[0];
-		double Yc = dot(R[1], pw) + t[1];
-		double Zc = dot(R[2], pw) + t[2];
-
-		double eq[3];
+	double x[12];
+	for (int j = 0; j < 3; j++) {
+		for (int k = 0; k < 3; k++) {
+			x[j * 4 + k] = R[j][k];
+		}
+		x[j * 4 + 3] = t[j];
+	}
 
-		self->setup.fillFn(self->setup.user, eq, self->meas[i].axis, self->meas[i].angle);
-		double rerr = eq[0] * Xc + eq[1] * Yc + eq[2] * Zc;
-		sum2 += rerr * rerr;
+	// Sum of the squared errors is x' * err_MtM * x
+	double sum2 = 0.0;
+	for (int i = 0; i < 12; i++) {
+		sum2 += self->err_MtM[i * 12 + i] * x[i] * x[i];
+		for (int j = i + 1; j < 12; j++) {
+			sum2 += 2 * self->err_MtM[i * 12 + j] * x[i] * x[j];
+		}
 	}
 
-	return sqrt(sum2) / self->meas_cnt;
+	return sqrt(fmax(sum2, 0)) / self->meas_weight;
 }
 
 void bc_svd_estimate_R_and_t(bc_svd *self, double R[3][3], double t[3]) {
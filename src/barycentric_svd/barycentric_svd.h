@@ -24,17 +24,22 @@ typedef struct {
 	void *user;
 } bc_svd_setup;
 
-typedef struct {
-	int obj_idx;
-	int axis;
-	FLT angle;
-} bc_svd_meas_t;
-
 typedef struct {
 	bc_svd_setup setup;
 
-	size_t meas_space, meas_cnt;
-	bc_svd_meas_t *meas; // [meas_cnt]
+	// Correspondences are only kept as their normal equations, so solving doesn't depend on how many were added.
+	// MtM is the upper triangle of the 12x12 barycentric system; err_MtM is the same for the plane equations against
+	// the [R | t] of a candidate pose, which gives its reprojection error.
+	size_t meas_cnt;
+	double meas_weight;
+	double MtM[12 * 12];
+	double err_MtM[12 * 12];
+	int col_cnt[12]; // [number of correspondences touching each column of M]
+
+	// Angle and current weight of the correspondence on each sensor axis, so one can be taken back exactly however
+	// much it has decayed since. A weight of 0 means there is none.
+	double *meas_angles;  // [obj_cnt * 2]
+	double *meas_weights; // [obj_cnt * 2]
 
 	LinmathPoint3d *object_pts_in_camera; // [obj_cnt]
 	LinmathPoint3d control_points_in_camera[4];
@@ -44,7 +49,16 @@ void bc_svd_bc_svd(bc_svd *self, void *user, bc_svd_fill_M_fn fillFn, const Linm
 void bc_svd_dtor(bc_svd *self);
 
 void bc_svd_reset_correspondences(bc_svd *self);
+// Either angle can be NAN to leave that axis alone; an axis that already has a correspondence gets the new one instead
 void bc_svd_add_correspondence(bc_svd *self, size_t idx, double u, double v);
+// Takes back the correspondences on each axis where u or v isn't NAN, at whatever weight they have decayed to
+void bc_svd_remove_correspondence(bc_svd *self, size_t idx, double u, double v);
+// Brings the correspondences for idx in line with u and v, leaving axes whose angle hasn't changed alone. A NAN takes
+// back what that axis had.
+void bc_svd_update_correspondence(bc_svd *self, size_t idx, double u, double v);
+// Scales the weight of everything added so far by 'factor', for aging out older correspondences. Ones that decay to
+// next to nothing are dropped.
+void bc_svd_decay_correspondences(bc_svd *self, double factor);
 
 double bc_svd_compute_pose(bc_svd *self, double R[3][3], double t[3]);
 void relative_error(double *rot_err, double *transl_err, const double Rtrue[3][3], const double ttrue[3],
@@ -67,6 +67,11 @@ void DisambiguatorCharles(SurviveObject *so, LightcapElement *le) {
 
 	// int32_t deltat = (uint32_t)le->timestamp - (uint32_t)so->last_master_time;
 
+	// Signal to destroy self; there is no state to clean up
+	if (le == 0) {
+		return;
+	}
+
 	if (le->sensor_id > SENSORS_PER_OBJECT) {
 		return;
 	}
@@ -123,15 +123,11 @@ const LighthouseStateParameters LS_Params[LS_END + 1] = {
 static inline int LSParam_acode(enum LighthouseState s) { return LS_Params[s].acode; }
 
 static int LSParam_offset_for_state(enum LighthouseState s) {
-	static int offsets[LS_END + 1] = {-1};
-	if (offsets[0] == -1) {
-		int offset = 0;
-		for (int i = 0; i < LS_END + 1; i++) {
-			offsets[i] = offset;
-			offset += LS_Params[i].window;
-		}
+	int offset = 0;
+	for (int i = 0; i < s; i++) {
+		offset += LS_Params[i].window;
 	}
-	return offsets[s];
+	return offset;
 }
 
 static enum LighthouseState LighthouseState_findByOffset(int offset, int *error) {
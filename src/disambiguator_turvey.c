@@ -207,34 +207,7 @@ static void handle_lightcap2_process_sweep_data(SurviveObject *so) {
 			}
 		}
 
-		int allZero = 1;
-		for (int q = 0; q < 32; q++)
-			if (lcd->sweep.sweep_len[q] != 0)
-				allZero = 0;
-		// if (!allZero)
-		//	printf("a[%d]l[%d] ", lcd->per_sweep.activeAcode & 5,  lcd->per_sweep.activeLighthouse);
 		for (int i = 0; i < SENSORS_PER_OBJECT; i++) {
-
-			{
-				static int counts[SENSORS_PER_OBJECT][2] = {0};
-				(void)counts;
-
-				//				if (lcd->per_sweep.activeLighthouse == 0 && !allZero)
-				if (lcd->per_sweep.activeLighthouse > -1 && !allZero) {
-					if (lcd->sweep.sweep_len[i] != 0) {
-						// printf("%d  ", i);
-						// counts[i][lcd->per_sweep.activeAcode & 1] ++;
-					} else {
-						counts[i][lcd->per_sweep.activeAcode & 1] = 0;
-					}
-
-					// if (counts[i][0] > 10 && counts[i][1] > 10)
-					//{
-					// printf("%d(%d,%d), ", i, counts[i][0], counts[i][1]);
-					//}
-				}
-			}
-
 			if (lcd->sweep.sweep_len[i] != 0) // if the sensor was hit, process it
 			{
 				// printf("%4d\n", lcd->sweep.sweep_len[i]);
@@ -439,6 +412,13 @@ static void handle_lightcap2_sweep(SurviveObject *so, LightcapElement *le) {
 void DisambiguatorTurvey(SurviveObject *so, LightcapElement *le) {
 	SurviveContext *ctx = so->ctx;
 
+	// Signal to destroy self
+	if (le == 0) {
+		free(so->disambiguator_data);
+		so->disambiguator_data = 0;
+		return;
+	}
+
 	if (so->disambiguator_data == NULL) {
 		fprintf(stderr, "Initializing Disambiguator Data\n");
 		so->disambiguator_data = SV_MALLOC(sizeof(lightcap2_data));
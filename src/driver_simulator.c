@@ -18,61 +18,113 @@
 
 STATIC_CONFIG_ITEM(Simulator_DRIVER_ENABLE, "simulator", 'i', "Load a Simulator driver for testing.", 0)
 STATIC_CONFIG_ITEM(Simulator_TIME, "simulator-time", 'f', "Seconds to run simulator for.", 0.0)
+STATIC_CONFIG_ITEM(Simulator_TIME_FACTOR, "time-factor", 'f', "Slow the simulator down by this factor.", 1.0)
+STATIC_CONFIG_ITEM(Simulator_ATTRACTORS, "attractors", 'i', "Number of points the simulated object is pulled towards.",
+				   3)
+STATIC_CONFIG_ITEM(Simulator_OBJECTS, "simulator-objects", 'i', "Number of objects to simulate.", 1)
+STATIC_CONFIG_ITEM(Simulator_LIGHTHOUSES, "simulator-lighthouses", 'i',
+				   "Number of lighthouses to simulate; 0 uses the configured ones, or 2 if there are none.", 0)
+STATIC_CONFIG_ITEM(Simulator_DEVICE_CONFIG, "simulator-device-config", 's',
+				   "Device config file for every simulated object; by default each gets a random sensor layout.", "")
+STATIC_CONFIG_ITEM(Simulator_NO_SLEEP, "simulator-no-sleep", 'i',
+				   "Generate data as fast as it is consumed instead of following the wall clock.", 0)
+STATIC_CONFIG_ITEM(Simulator_SENSOR_NOISE, "simulator-sensor-noise", 'f',
+				   "Standard deviation of angle noise, in radians.", 0.)
+STATIC_CONFIG_ITEM(Simulator_IMU_NOISE, "simulator-imu-noise", 'f',
+				   "Standard deviation of accelerometer (g) and gyro (rad/s) noise.", 0.)
+STATIC_CONFIG_ITEM(Simulator_DROPOUT, "simulator-dropout", 'f', "Chance that any single light or IMU reading is lost.",
+				   0.)
+STATIC_CONFIG_ITEM(Simulator_OCCLUSION, "simulator-occlusion", 'f',
+				   "Times per second an object loses sight of any given lighthouse.", 0.)
+STATIC_CONFIG_ITEM(Simulator_OCCLUSION_TIME, "simulator-occlusion-time", 'f', "Seconds an occlusion lasts.", .25)
+
+typedef struct SimulatedObject {
+	SurviveObject *so;
+	char gt_name[32];
+
+	SurvivePose position;
+	SurviveVelocity velocity;
+
+	FLT time_last_imu;
+
+	// No light from a lighthouse reaches the object until this time
+	FLT occluded_until[NUM_GEN2_LIGHTHOUSES];
+} SimulatedObject;
 
 struct SurviveDriverSimulator {
 	int lh_version;
 	SurviveContext *ctx;
-	SurviveObject *so;
 
 	BaseStationData bsd[NUM_GEN2_LIGHTHOUSES];
+	int lh_cnt;
 
-	SurvivePose position;
-	SurviveVelocity velocity;
+	SimulatedObject *objects;
+	size_t object_cnt;
 
-	FLT time_last_imu;
 	FLT time_last_light;
 	FLT time_last_iterate;
+	FLT time_between_pulses;
 
 	FLT timestart;
 	FLT current_timestamp;
 	int acode;
+
+	// Attached to their config values, since they are read every step
+	FLT time_factor;
+	FLT run_time;
+	int attractor_cnt;
+	int report_in_imu;
+	FLT sensor_noise;
+	FLT imu_noise;
+	FLT dropout;
+	FLT occlusion;
+	FLT occlusion_time;
+
+	bool no_sleep;
+	double realtime_start;
+	FLT last_time;
+	uint32_t rand_state;
+	uint64_t noise_state;
 };
 typedef struct SurviveDriverSimulator SurviveDriverSimulator;
 
-static double timestamp_in_s() {
-	static double start_time_s = 0;
-	if (start_time_s == 0.)
-		start_time_s = OGGetAbsoluteTime();
-	return OGGetAbsoluteTime() - start_time_s;
+static double timestamp_in_s(SurviveDriverSimulator *driver) { return OGGetAbsoluteTime() - driver->realtime_start; }
+
+// The simulated device comes from the driver's own generator so that simulators running side by side in different
+// contexts neither share nor race on rand()'s state
+#define SIMULATOR_RAND_MAX 0x7fff
+static int simulator_rand(SurviveDriverSimulator *driver) {
+	driver->rand_state = driver->rand_state * 1103515245u + 12345u;
+	return (driver->rand_state >> 16) & SIMULATOR_RAND_MAX;
 }
 
-static int Simulator_poll(struct SurviveContext *ctx, void *_driver) {
-	SurviveDriverSimulator *driver = _driver;
-	static FLT last_time = 0;
-	FLT realtime = timestamp_in_s();
-	
-	FLT timefactor = linmath_max(survive_configf(ctx, "time-factor", SC_GET, 1.), .00001);
-	// FLT timestamp = timestamp_in_s() / timefactor;
-	FLT timestep = 0.001;
+// Noise, dropout and occlusion have a generator of their own, so turning them on leaves the simulated devices and
+// their paths as they were
+static double simulator_uniform(SurviveDriverSimulator *driver) {
+	driver->noise_state ^= driver->noise_state >> 12;
+	driver->noise_state ^= driver->noise_state << 25;
+	driver->noise_state ^= driver->noise_state >> 27;
+	return ((driver->noise_state * 2685821657736338717ull) >> 11) * (1. / 9007199254740992.);
+}
 
-	while (last_time != 0 && last_time + timefactor * timestep > realtime) {
-		survive_release_ctx_lock(ctx);
-		OGUSleep((timefactor * timestep + realtime - last_time) * 1e6);
-		survive_get_ctx_lock(ctx);
-		realtime = timestamp_in_s();
-	}
-	last_time = realtime;
+static double simulator_gaussian(SurviveDriverSimulator *driver) {
+	double u = 1. - simulator_uniform(driver), v = simulator_uniform(driver);
+	return sqrt(-2. * log(u)) * cos(2. * LINMATHPI * v);
+}
 
-	FLT timestamp = (driver->current_timestamp += timestep);
-	FLT time_between_imu = 1. / driver->so->imu_freq;
-	FLT time_between_pulses = 0.00833333333;
-	FLT time_between_gt = time_between_imu;
+static bool simulator_dropped(SurviveDriverSimulator *driver) {
+	return driver->dropout > 0 && simulator_uniform(driver) < driver->dropout;
+}
+
+static void simulated_object_step(SurviveDriverSimulator *driver, SimulatedObject *obj, FLT timestamp,
+								  FLT time_diff, bool light_step) {
+	SurviveContext *ctx = driver->ctx;
+	SurviveObject *so = obj->so;
+	FLT time_between_imu = 1. / so->imu_freq;
 	bool isIniting = timestamp < 2;
 
 	bool update_gt = false;
 
-	FLT t = (timestamp - driver->timestart);
-
 	// SurvivePose accel = {.Pos = {cos(t * 3) * 4, cos(t * 2) * 3, cos(t * 4) * 2},
 	//					 .Rot = {10 + cos(t) * 2, cos(t), sin(t), (cos(t) + sin(t))}};
 
@@ -80,14 +132,14 @@ static int Simulator_poll(struct SurviveContext *ctx, void *_driver) {
 	SurviveVelocity accel = {0};
 
 	LinmathVec3d attractors[] = {{1, 1, 1}, {-1, 0, 1}, {0, -1, .5}};
-	size_t attractor_cnt = survive_configi(ctx, "attractors", SC_GET, sizeof(attractors) / sizeof(LinmathVec3d));
+	size_t attractor_cnt = driver->attractor_cnt;
 	if (attractor_cnt > sizeof(attractors) / sizeof(LinmathVec3d)) {
 		attractor_cnt = sizeof(attractors) / sizeof(LinmathVec3d);
 	}
 
 	for (int i = 0; isIniting == false && i < attractor_cnt; i++) {
 		LinmathVec3d acc;
-		sub3d(acc, attractors[i], driver->position.Pos);
+		sub3d(acc, attractors[i], obj->position.Pos);
 		FLT r = norm3d(acc);
 		scale3d(acc, acc, 1. / r / r);
 		add3d(accel.Pos, accel.Pos, acc);
@@ -98,7 +150,7 @@ static int Simulator_poll(struct SurviveContext *ctx, void *_driver) {
 	// quatrotatevector(accel.Pos, accel.Rot, accel.Pos);
 	survive_timecode timecode = (survive_timecode)round(timestamp * 48000000.);
 
-	if (timestamp > time_between_imu + driver->time_last_imu) {
+	if (timestamp > time_between_imu + obj->time_last_imu) {
 		update_gt = true;
 		// ( SurviveObject * so, int mask, FLT * accelgyro, survive_timecode timecode, int id );
 		FLT accelgyro[9] = {0, 0, 9.8066, // Acc
@@ -110,56 +162,82 @@ static int Simulator_poll(struct SurviveContext *ctx, void *_driver) {
 
 		if (!isIniting) {
 			LinmathQuat q;
-			quatgetconjugate(q, driver->position.Rot);
+			quatgetconjugate(q, obj->position.Rot);
 			quatrotatevector(accelgyro, q, accelgyro);
 
-			quatrotatevector(accelgyro + 3, q, driver->velocity.AxisAngleRot);
+			quatrotatevector(accelgyro + 3, q, obj->velocity.AxisAngleRot);
 		}
 
-		ctx->imuproc(driver->so, 3, accelgyro, timecode, 0);
+		if (driver->imu_noise > 0) {
+			for (int i = 0; i < 6; i++)
+				accelgyro[i] += driver->imu_noise * simulator_gaussian(driver);
+		}
+
+		if (!simulator_dropped(driver))
+			ctx->imuproc(so, 3, accelgyro, timecode, 0);
 
-		driver->time_last_imu = timestamp - 1e-10;
+		obj->time_last_imu = timestamp - 1e-10;
 	}
 
-	if (timestamp > time_between_pulses + driver->time_last_light) {
+	if (light_step) {
 		update_gt = true;
 		int lh = driver->acode >> 1;
-		for (int idx = 0; idx < driver->so->sensor_ct; idx++) {
-			FLT *pt = driver->so->sensor_locations + idx * 3;
+		assert(so->sensor_ct <= SENSORS_PER_OBJECT);
+
+		// Each lighthouse comes around twice every cycle, once per axis
+		FLT occlusion_chance = driver->occlusion * driver->time_between_pulses * driver->lh_cnt;
+		if (driver->occlusion > 0 && obj->occluded_until[lh] <= timestamp &&
+			simulator_uniform(driver) < occlusion_chance) {
+			obj->occluded_until[lh] = timestamp + driver->occlusion_time;
+		}
+		bool occluded = obj->occluded_until[lh] > timestamp;
+
+		SurvivePose world2lh = InvertPoseRtn(&driver->bsd[lh].Pose);
+		SurvivePose obj2lh;
+		ApplyPoseToPose(&obj2lh, &world2lh, &obj->position);
+		SurvivePose obj2lhRot = {.Rot = {obj2lh.Rot[0], obj2lh.Rot[1], obj2lh.Rot[2], obj2lh.Rot[3]}};
+
+		FLT pts[3][SENSORS_PER_OBJECT], normals[3][SENSORS_PER_OBJECT];
+		for (int idx = 0; idx < so->sensor_ct; idx++) {
+			for (int j = 0; j < 3; j++) {
+				pts[j][idx] = so->sensor_locations[idx * 3 + j];
+				normals[j][idx] = so->sensor_normals[idx * 3 + j];
+			}
+		}
 
-			LinmathVec3d ptInWorld;
-			LinmathVec3d normalInWorld;
-			ApplyPoseToPoint(ptInWorld, &driver->position, pt);
-			quatrotatevector(normalInWorld, driver->position.Rot, driver->so->sensor_normals + idx * 3);
+		FLT ptsInLh[3][SENSORS_PER_OBJECT], normalsInLh[3][SENSORS_PER_OBJECT];
+		survive_apply_pose_to_points(&obj2lh, so->sensor_ct, pts[0], pts[1], pts[2], ptsInLh[0], ptsInLh[1],
+									 ptsInLh[2]);
+		survive_apply_pose_to_points(&obj2lhRot, so->sensor_ct, normals[0], normals[1], normals[2], normalsInLh[0],
+									 normalsInLh[1], normalsInLh[2]);
 
-			SurvivePose world2lh = InvertPoseRtn(&driver->bsd[lh].Pose);
-			LinmathPoint3d ptInLh;
-			LinmathVec3d normalInLh;
-			ApplyPoseToPoint(ptInLh, &world2lh, ptInWorld);
-			quatrotatevector(normalInLh, world2lh.Rot, normalInWorld);
+		const survive_reproject_model_t *model =
+			driver->lh_version == 0 ? &survive_reproject_model : &survive_reproject_gen2_model;
+		FLT angs[2][SENSORS_PER_OBJECT];
+		model->reprojectXYBatch(driver->bsd[lh].fcal, &obj2lh, so->sensor_ct, pts[0], pts[1], pts[2], angs[0],
+								angs[1]);
+
+		for (int idx = 0; !occluded && idx < so->sensor_ct; idx++) {
+			LinmathPoint3d ptInLh = {ptsInLh[0][idx], ptsInLh[1][idx], ptsInLh[2][idx]};
+			LinmathVec3d normalInLh = {normalsInLh[0][idx], normalsInLh[1][idx], normalsInLh[2][idx]};
 
-			SurviveAngleReading ang;
 			if (ptInLh[2] < 0) {
 				LinmathVec3d dirLh;
 				normalize3d(dirLh, ptInLh);
 				scale3d(dirLh, dirLh, -1);
 				FLT facingness = dot3d(normalInLh, dirLh);
-				if (facingness > 0) {
+				if (facingness > 0 && !simulator_dropped(driver)) {
+					FLT ang = angs[driver->acode & 1][idx];
+					if (driver->sensor_noise > 0)
+						ang += driver->sensor_noise * simulator_gaussian(driver);
 
 					if (driver->lh_version == 0) {
-						survive_reproject_xy(driver->bsd[lh].fcal, ptInLh, ang);
-						// ang[0] += .001 * rand() / RAND_MAX;
-						// ang[1] += .001 * rand() / RAND_MAX;
 						// SurviveObject * so, int sensor_id, int acode, survive_timecode timecode, FLT length, FLT
 						// angle, uint32_t lh);
 						int acode = (lh << 2) + (driver->acode & 1);
-						ctx->angleproc(driver->so, idx, acode, timecode, .006, ang[driver->acode & 1], lh);
+						ctx->angleproc(so, idx, acode, timecode, .006, ang, lh);
 					} else {
-						survive_reproject_xy_gen2(driver->bsd[lh].fcal, ptInLh, ang);
-						// double r1 = (rand() / (double)RAND_MAX);
-						// if (r1 < .50)
-						ctx->sweep_angleproc(driver->so, driver->bsd[lh].mode, idx, timecode, driver->acode & 1,
-											 ang[driver->acode & 1]);
+						ctx->sweep_angleproc(so, driver->bsd[lh].mode, idx, timecode, driver->acode & 1, ang);
 					}
 				}
 			}
@@ -167,67 +245,111 @@ static int Simulator_poll(struct SurviveContext *ctx, void *_driver) {
 
 		if (driver->lh_version == 0) {
 			int acode = (lh << 2) + (driver->acode & 1);
-			ctx->lightproc(driver->so, -3, acode, 0, timecode, 100, lh);
-			driver->acode = (driver->acode + 1) % 4;
+			ctx->lightproc(so, -3, acode, 0, timecode, 100, lh);
 		} else {
-			ctx->syncproc(driver->so, driver->bsd[lh].mode, timecode, false, false);
-			driver->acode = (driver->acode + 1) % 4;
+			ctx->syncproc(so, driver->bsd[lh].mode, timecode, false, false);
 		}
-
-		driver->time_last_light = timestamp;
 	}
 
 	if (update_gt) {
-		static int report_in_imu = -1;
-		if (report_in_imu == -1) {
-			survive_attach_configi(driver->so->ctx, "report-in-imu", &report_in_imu);
-		}
-
 		SurvivePose head2world;
-		if (!report_in_imu) {
-			ApplyPoseToPose(&head2world, &driver->position, &driver->so->head2imu);
+		if (!driver->report_in_imu) {
+			ApplyPoseToPose(&head2world, &obj->position, &so->head2imu);
 		} else {
-			head2world = driver->position;
+			head2world = obj->position;
 		}
 
-		survive_default_external_pose_process(ctx, "Sim_GT", &head2world);
-		survive_default_external_velocity_process(ctx, "Sim_GT", &driver->velocity);
-	}
-
-	if (driver->time_last_iterate == 0) {
-		driver->time_last_iterate = timestamp;
-		driver->timestart = timestamp;
-		return 0;
+		ctx->external_poseproc(ctx, obj->gt_name, &head2world);
+		ctx->external_velocityproc(ctx, obj->gt_name, &obj->velocity);
 	}
-	FLT time_diff = timestamp - driver->time_last_iterate;
-	// SV_INFO("%.013f", time_diff);
-	driver->time_last_iterate = timestamp;
 
-	if (!isIniting) {
+	if (!isIniting && time_diff > 0) {
 		SurviveVelocity velGain;
 		scale3d(velGain.Pos, accel.Pos, time_diff);
 		scale3d(velGain.AxisAngleRot, accel.AxisAngleRot, time_diff);
 
-		add3d(driver->velocity.Pos, driver->velocity.Pos, velGain.Pos);
-		add3d(driver->velocity.AxisAngleRot, velGain.AxisAngleRot, driver->velocity.AxisAngleRot);
+		add3d(obj->velocity.Pos, obj->velocity.Pos, velGain.Pos);
+		add3d(obj->velocity.AxisAngleRot, velGain.AxisAngleRot, obj->velocity.AxisAngleRot);
 
 		SurviveVelocity posGain;
-		scale3d(posGain.Pos, driver->velocity.Pos, time_diff);
-		scale3d(posGain.AxisAngleRot, driver->velocity.AxisAngleRot, time_diff);
+		scale3d(posGain.Pos, obj->velocity.Pos, time_diff);
+		scale3d(posGain.AxisAngleRot, obj->velocity.AxisAngleRot, time_diff);
 
-		add3d(driver->position.Pos, driver->position.Pos, posGain.Pos);
+		add3d(obj->position.Pos, obj->position.Pos, posGain.Pos);
 		LinmathQuat r;
 		quatfromaxisanglemag(r, posGain.AxisAngleRot);
-		quatrotateabout(driver->position.Rot, r, driver->position.Rot);
+		quatrotateabout(obj->position.Rot, r, obj->position.Rot);
+	}
+}
+
+static int simulator_step(struct SurviveContext *ctx, void *_driver) {
+	SurviveDriverSimulator *driver = _driver;
+	FLT last_time = driver->last_time;
+	FLT realtime = timestamp_in_s(driver);
+	
+	FLT timefactor = linmath_max(driver->time_factor, .00001);
+	// FLT timestamp = timestamp_in_s() / timefactor;
+	FLT timestep = 0.001;
+
+	while (!driver->no_sleep && last_time != 0 && last_time + timefactor * timestep > realtime) {
+		survive_release_ctx_lock(ctx);
+		OGUSleep((timefactor * timestep + realtime - last_time) * 1e6);
+		survive_get_ctx_lock(ctx);
+		realtime = timestamp_in_s(driver);
+	}
+	driver->last_time = realtime;
+
+	// Everything generated in this step counts as one packet arriving now
+	survive_latency_packet_begin(ctx, survive_latency_enabled(ctx) ? OGGetAbsoluteTime() : 0);
+
+	FLT timestamp = (driver->current_timestamp += timestep);
+	bool light_step = timestamp > driver->time_between_pulses + driver->time_last_light;
+
+	// Nothing moves on the very first step; it only sets the clock going
+	FLT time_diff = driver->time_last_iterate == 0 ? 0 : timestamp - driver->time_last_iterate;
+	if (driver->time_last_iterate == 0) {
+		driver->timestart = timestamp;
 	}
+	driver->time_last_iterate = timestamp;
 
-	FLT time = survive_configf(ctx, "simulator-time", SC_GET, 0);
+	for (size_t i = 0; i < driver->object_cnt; i++) {
+		simulated_object_step(driver, &driver->objects[i], timestamp, time_diff, light_step);
+	}
+
+	if (light_step) {
+		driver->acode = (driver->acode + 1) % (2 * driver->lh_cnt);
+		driver->time_last_light = timestamp;
+	}
+
+	FLT time = driver->run_time;
 	if (timestamp - driver->timestart > time && time > 0)
 		return 1;
 
 	return 0;
 }
 
+static int Simulator_poll(struct SurviveContext *ctx, void *_driver) {
+	int rtn = simulator_step(ctx, _driver);
+	survive_latency_packet_end(ctx);
+	return rtn;
+}
+
+static int Simulator_close(struct SurviveContext *ctx, void *_driver) {
+	SurviveDriverSimulator *driver = _driver;
+	survive_detach_config(ctx, "time-factor", &driver->time_factor);
+	survive_detach_config(ctx, "simulator-time", &driver->run_time);
+	survive_detach_config(ctx, "attractors", &driver->attractor_cnt);
+	survive_detach_config(ctx, "report-in-imu", &driver->report_in_imu);
+	survive_detach_config(ctx, "simulator-sensor-noise", &driver->sensor_noise);
+	survive_detach_config(ctx, "simulator-imu-noise", &driver->imu_noise);
+	survive_detach_config(ctx, "simulator-dropout", &driver->dropout);
+	survive_detach_config(ctx, "simulator-occlusion", &driver->occlusion);
+	survive_detach_config(ctx, "simulator-occlusion-time", &driver->occlusion_time);
+	free(driver->objects);
+	free(driver);
+	return 0;
+}
+
 const BaseStationData simulated_bsd[2] = {
 	{.PositionSet = 1,
 	 .BaseStationID = 0,
@@ -241,17 +363,36 @@ const BaseStationData simulated_bsd[2] = {
 	 .OOTXSet = 1},
 };
 
-int DriverRegSimulator(SurviveContext *ctx) {
-	SurviveDriverSimulator *sp = SV_CALLOC(1, sizeof(SurviveDriverSimulator));
-	sp->ctx = ctx;
-	sp->position.Rot[0] = 1;
+// Any lighthouses past the first two stand in a ring around the tracked volume, looking down into it
+static void simulated_lighthouse_pose(SurvivePose *pose, int lh, int lh_cnt) {
+	if (lh < 2) {
+		*pose = simulated_bsd[lh].Pose;
+		return;
+	}
 
-	SV_INFO("Setting up Simulator driver.");
+	FLT ang = LINMATHPI / 2. + 2. * LINMATHPI * (lh - 2) / (lh_cnt - 2);
+	*pose = (SurvivePose){.Pos = {3 * cos(ang), 3 * sin(ang), 2}};
 
-	int use_lh2 = survive_configi(ctx, "lhv2-experimental", SC_GET, 0);
+	LinmathVec3d fwd = {0, 0, -1}, dir = {0, 0, .5};
+	sub3d(dir, dir, pose->Pos);
+	normalize3d(dir, dir);
+	quatfrom2vectors(pose->Rot, fwd, dir);
+}
+
+static void simulated_object_init(SurviveDriverSimulator *sp, SimulatedObject *obj, int idx,
+								  const char *device_config) {
+	SurviveContext *ctx = sp->ctx;
+
+	char name[8];
+	snprintf(name, sizeof(name), "SM%d", idx);
+	if (idx == 0) {
+		strcpy(obj->gt_name, "Sim_GT");
+	} else {
+		snprintf(obj->gt_name, sizeof(obj->gt_name), "Sim_GT%d", idx);
+	}
 
 	// Create a new SurviveObject...
-	SurviveObject *device = survive_create_device(ctx, "SIM", sp, "SM0", 0);
+	SurviveObject *device = survive_create_device(ctx, "SIM", sp, name, 0);
 	device->sensor_ct = 20;
 
 	device->head2imu.Rot[0] = 1;
@@ -259,104 +400,178 @@ int DriverRegSimulator(SurviveContext *ctx) {
 	device->imu2trackref.Rot[0] = 1;
 
 	// for (int i = 0; i < 4; i++)
-	//	sp->position.Rot[i] = 1;
-	sp->position.Rot[0] = 2;
+	//	obj->position.Rot[i] = 1;
+	obj->position.Rot[0] = 2;
 
-	quatnormalize(sp->position.Rot, sp->position.Rot);
+	quatnormalize(obj->position.Rot, obj->position.Rot);
 
-	size_t attractor_cnt = survive_configi(ctx, "attractors", SC_GET, 1);
-	if (attractor_cnt) {
+	if (sp->attractor_cnt) {
 		for (int i = 0; i < 3; i++)
-			sp->velocity.Pos[i] = 2. * rand() / RAND_MAX - 1.;
-
+			obj->velocity.Pos[i] = 2. * simulator_rand(sp) / SIMULATOR_RAND_MAX - 1.;
 	}
 
-	sp->velocity.AxisAngleRot[0] = .5;
-	sp->velocity.AxisAngleRot[1] = .5;
-	sp->velocity.AxisAngleRot[2] = .5;
+	obj->velocity.AxisAngleRot[0] = .5;
+	obj->velocity.AxisAngleRot[1] = .5;
+	obj->velocity.AxisAngleRot[2] = .5;
 
 	cstring cfg = {0};
-	cstring loc = {0}, nor_buf = {0};
-
-	FLT r = .1;
-	srand(42);
-	
-	for (int i = 0; i < ctx->activeLighthouses; i++) {
-		sp->bsd[i] = ctx->bsd[i];
-		if (!ctx->bsd[i].PositionSet) {
-			sp->bsd[i].Pose = simulated_bsd[i].Pose;
+	if (device_config) {
+		str_append(&cfg, device_config);
+	} else {
+		cstring loc = {0}, nor_buf = {0};
+
+		FLT r = .1;
+
+		for (int i = 0; i < device->sensor_ct; i++) {
+			FLT azi = simulator_rand(sp);
+			FLT pol = simulator_rand(sp);
+			LinmathVec3d normals, locations;
+			normals[0] = locations[0] = r * cos(azi) * sin(pol);
+			normals[1] = locations[1] = r * sin(azi) * sin(pol);
+			normals[2] = locations[2] = r * cos(pol);
+			normalize3d(normals, normals);
+
+			char buffer[1024] = {0};
+			sprintf(buffer, "[%f, %f, %f],\n", locations[0], locations[1], locations[2]);
+			str_append(&loc, buffer);
+
+			sprintf(buffer, "[%f, %f, %f],\n", normals[0], normals[1], normals[2]);
+			str_append(&nor_buf, buffer);
 		}
+		nor_buf.d[nor_buf.length - 2] = 0;
+		loc.d[loc.length - 2] = 0;
 
-		// if(use_lh2 && i > 0)
-		// ctx->bsd[i].PositionSet = false;
-
-		ctx->bsd_map[ctx->bsd[i].mode] = i;
-	}
-	// ctx->bsd[0].Pose = sp->bsd[0].Pose;
-	// ctx->bsd[0].PositionSet = 1;
+		double trackref_from_head[7], trackref_from_imu[7];
+		for (int i = 0; i < 7; i++) {
+			trackref_from_head[i] = .1 * ((double)simulator_rand(sp) / SIMULATOR_RAND_MAX - .5);
+		}
+		for (int i = 0; i < 7; i++) {
+			trackref_from_imu[i] = .1 * ((double)simulator_rand(sp) / SIMULATOR_RAND_MAX - .5);
+		}
 
-	for (int i = 0; i < device->sensor_ct; i++) {
-		FLT azi = rand();
-		FLT pol = rand();
-		LinmathVec3d normals, locations;
-		normals[0] = locations[0] = r * cos(azi) * sin(pol);
-		normals[1] = locations[1] = r * sin(azi) * sin(pol);
-		normals[2] = locations[2] = r * cos(pol);
-		normalize3d(normals, normals);
-
-		char buffer[1024] = { 0 };
-		sprintf(buffer, "[%f, %f, %f],\n", locations[0], locations[1], locations[2]);
-		str_append(&loc, buffer);
-
-		sprintf(buffer, "[%f, %f, %f],\n", normals[0], normals[1], normals[2]);
-		str_append(&nor_buf, buffer);
+		quatnormalize(trackref_from_head, trackref_from_head);
+		quatnormalize(trackref_from_imu, trackref_from_imu);
+
+		char buffer[1024] = {0};
+		sprintf(buffer,
+				"\"trackref_from_head\": [%f, %f, %f, %f, %f, %f, %f], \n"
+				"\"trackref_from_imu\": [%f, %f, %f, %f, %f, %f, %f], \n",
+				trackref_from_head[0], trackref_from_head[1], trackref_from_head[2], trackref_from_head[3],
+				trackref_from_head[4], trackref_from_head[5], trackref_from_head[6], trackref_from_imu[0],
+				trackref_from_imu[1], trackref_from_imu[2], trackref_from_imu[3], trackref_from_imu[4],
+				trackref_from_imu[5], trackref_from_imu[6]);
+
+		str_append(&cfg, "{\n");
+		str_append(&cfg, buffer);
+		str_append(&cfg, "     \"lighthouse_config\": {\n");
+		str_append(&cfg, "          \"modelNormals\": [\n");
+		str_append(&cfg, nor_buf.d);
+		str_append(&cfg, "          ],\n");
+		str_append(&cfg, "          \"modelPoints\": [\n");
+		str_append(&cfg, loc.d);
+		str_append(&cfg, "          ]\n");
+		str_append(&cfg, "     }\n");
+		str_append(&cfg, "}\n");
+
+		str_free(&loc);
+		str_free(&nor_buf);
 	}
-	nor_buf.d[nor_buf.length - 2] = 0;
-	loc.d[loc.length - 2] = 0;
-
-	double trackref_from_head[] = {rand(), rand(), rand(), rand(), rand(), rand(), rand()};
-	double trackref_from_imu[] = {rand(), rand(), rand(), rand(), rand(), rand(), rand()};
-	for (int i = 0; i < 7; i++) {
-		trackref_from_head[i] = .1 * (trackref_from_head[i] / RAND_MAX - .5);
-		trackref_from_imu[i] = .1 * (trackref_from_imu[i] / RAND_MAX - .5);
-	}
-
-	quatnormalize(trackref_from_head, trackref_from_head);
-	quatnormalize(trackref_from_imu, trackref_from_imu);
-
-	char buffer[1024] = {0};
-	sprintf(buffer,
-			"\"trackref_from_head\": [%f, %f, %f, %f, %f, %f, %f], \n"
-			"\"trackref_from_imu\": [%f, %f, %f, %f, %f, %f, %f], \n",
-			trackref_from_head[0], trackref_from_head[1], trackref_from_head[2], trackref_from_head[3],
-			trackref_from_head[4], trackref_from_head[5], trackref_from_head[6], trackref_from_imu[0],
-			trackref_from_imu[1], trackref_from_imu[2], trackref_from_imu[3], trackref_from_imu[4],
-			trackref_from_imu[5], trackref_from_imu[6]);
-
-	str_append(&cfg, "{\n");
-	str_append(&cfg, buffer);
-	str_append(&cfg, "     \"lighthouse_config\": {\n");
-	str_append(&cfg, "          \"modelNormals\": [\n");
-	str_append(&cfg, nor_buf.d);
-	str_append(&cfg, "          ],\n");
-	str_append(&cfg, "          \"modelPoints\": [\n");
-	str_append(&cfg, loc.d);
-	str_append(&cfg, "          ]\n");
-	str_append(&cfg, "     }\n");
-	str_append(&cfg, "}\n");
 	device->timebase_hz = 48000000;
 	device->imu_freq = 1000.0f;
 
+	// The object keeps the config string
 	ctx->configproc(device, cfg.d, strlen(cfg.d));
 
-	str_free(&loc);
-	str_free(&nor_buf);
+	// Spread the extra objects out so they don't all start in the same place
+	if (idx > 0) {
+		for (int i = 0; i < 3; i++)
+			obj->position.Pos[i] = .5 * (2. * simulator_rand(sp) / SIMULATOR_RAND_MAX - 1.);
+	}
 
-	sp->so = device;
+	obj->so = device;
 	survive_add_object(ctx, device);
+}
+
+int DriverRegSimulator(SurviveContext *ctx) {
+	SurviveDriverSimulator *sp = SV_CALLOC(1, sizeof(SurviveDriverSimulator));
+	sp->ctx = ctx;
+	sp->realtime_start = OGGetAbsoluteTime();
+	sp->rand_state = 42;
+	sp->noise_state = 0x9E3779B97F4A7C15ull;
+
+	SV_INFO("Setting up Simulator driver.");
+
+	int use_lh2 = survive_configi(ctx, "lhv2-experimental", SC_GET, 0);
 	sp->lh_version = use_lh2 ? 1 : 0;
 
-	survive_add_driver(ctx, sp, Simulator_poll, 0, 0);
+	const char *device_config_path = survive_configs(ctx, "simulator-device-config", SC_GET, "");
+	char *device_config = 0;
+	if (device_config_path && device_config_path[0]) {
+		device_config = load_file_to_mem(device_config_path);
+		if (device_config == 0) {
+			SV_ERROR(SURVIVE_ERROR_INVALID_CONFIG, "Could not read simulator device config '%s'", device_config_path);
+			free(sp);
+			return SURVIVE_ERROR_INVALID_CONFIG;
+		}
+	}
+
+	survive_attach_configf(ctx, "time-factor", &sp->time_factor);
+	survive_attach_configf(ctx, "simulator-time", &sp->run_time);
+	survive_attach_configi(ctx, "attractors", &sp->attractor_cnt);
+	survive_attach_configi(ctx, "report-in-imu", &sp->report_in_imu);
+	survive_attach_configf(ctx, "simulator-sensor-noise", &sp->sensor_noise);
+	survive_attach_configf(ctx, "simulator-imu-noise", &sp->imu_noise);
+	survive_attach_configf(ctx, "simulator-dropout", &sp->dropout);
+	survive_attach_configf(ctx, "simulator-occlusion", &sp->occlusion);
+	survive_attach_configf(ctx, "simulator-occlusion-time", &sp->occlusion_time);
+
+	// Without the wall clock to follow, the context shouldn't wait between polls either
+	sp->no_sleep = survive_configi(ctx, "simulator-no-sleep", SC_GET, 0) != 0;
+	if (sp->no_sleep) {
+		ctx->poll_min_time_ms = 0;
+	}
+
+	sp->lh_cnt = survive_configi(ctx, "simulator-lighthouses", SC_GET, 0);
+	if (sp->lh_cnt <= 0) {
+		sp->lh_cnt = ctx->activeLighthouses > 0 ? ctx->activeLighthouses : 2;
+	}
+	int max_lh_cnt = use_lh2 ? NUM_GEN2_LIGHTHOUSES : NUM_GEN1_LIGHTHOUSES;
+	if (sp->lh_cnt > max_lh_cnt) {
+		SV_WARN("Simulator can only run %d gen %d lighthouses", max_lh_cnt, use_lh2 ? 2 : 1);
+		sp->lh_cnt = max_lh_cnt;
+	}
+
+	// Every lighthouse axis is swept at 60hz, so more lighthouses means more data
+	sp->time_between_pulses = 0.00833333333 * 2 / (sp->lh_cnt > 2 ? sp->lh_cnt : 2);
+
+	for (int i = 0; i < sp->lh_cnt; i++) {
+		if (i < ctx->activeLighthouses) {
+			sp->bsd[i] = ctx->bsd[i];
+			if (!ctx->bsd[i].PositionSet) {
+				simulated_lighthouse_pose(&sp->bsd[i].Pose, i, sp->lh_cnt);
+			}
+
+			// if(use_lh2 && i > 0)
+			// ctx->bsd[i].PositionSet = false;
+
+			ctx->bsd_map[ctx->bsd[i].mode] = i;
+		} else {
+			// The pipeline finds these on its own, like it would real ones
+			sp->bsd[i].mode = i;
+			simulated_lighthouse_pose(&sp->bsd[i].Pose, i, sp->lh_cnt);
+		}
+	}
+	// ctx->bsd[0].Pose = sp->bsd[0].Pose;
+	// ctx->bsd[0].PositionSet = 1;
+
+	sp->object_cnt = linmath_imax(survive_configi(ctx, "simulator-objects", SC_GET, 1), 1);
+	sp->objects = SV_CALLOC(sp->object_cnt, sizeof(SimulatedObject));
+	for (size_t i = 0; i < sp->object_cnt; i++) {
+		simulated_object_init(sp, &sp->objects[i], i, device_config);
+	}
+	free(device_config);
+
+	survive_add_driver(ctx, sp, Simulator_poll, Simulator_close, 0);
 	return 0;
 }
 
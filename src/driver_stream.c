@@ -0,0 +1,352 @@
+// All MIT/x11 Licensed Code in this file may be relicensed freely under the GPL
+// or LGPL licenses.
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "os_generic.h"
+#include "survive_config.h"
+#include "survive_stream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <survive.h>
+
+STATIC_CONFIG_ITEM(STREAM_ENABLE, "stream", 'i',
+				   "Publish poses, velocities and button events as a binary stream. See survive_stream.h.", 0)
+STATIC_CONFIG_ITEM(STREAM_TCP_PORT, "stream-tcp-port", 'i', "TCP port to serve the stream on. 0 disables.", 2335)
+STATIC_CONFIG_ITEM(STREAM_MULTICAST, "stream-multicast", 's', "Multicast group to publish the stream to.", 0)
+STATIC_CONFIG_ITEM(STREAM_MULTICAST_PORT, "stream-multicast-port", 'i', "Port to publish the multicast stream to.",
+				   2336)
+STATIC_CONFIG_ITEM(STREAM_CLIENT_BUFFER, "stream-client-buffer", 'i',
+				   "Bytes queued for a slow TCP client before frames for it are dropped.", 16384)
+
+#define STREAM_MAX_CLIENTS 32
+#define STREAM_MAX_SUBSCRIPTIONS 32
+
+typedef struct stream_client {
+	int sock;
+	uint32_t seq;
+	size_t dropped;
+
+	// Bytes the socket wouldn't take yet. Frames that don't fit are dropped whole, so a client that can't keep up
+	// sees a gap in the sequence rather than stalling the publisher or everyone else.
+	uint8_t *queue;
+	size_t head, cnt;
+
+	uint8_t rx[SURVIVE_STREAM_MAX_FRAME_SIZE * 4];
+	size_t rx_len;
+
+	char subscriptions[STREAM_MAX_SUBSCRIPTIONS][SURVIVE_STREAM_OBJECT_LEN + 1];
+	size_t subscription_cnt;
+} stream_client;
+
+typedef struct SurviveDriverStream {
+	SurviveContext *ctx;
+	og_mutex_t lock;
+
+	int listen_sock;
+	size_t queue_capacity;
+	stream_client clients[STREAM_MAX_CLIENTS];
+
+	int multicast_sock;
+	struct sockaddr_in multicast_addr;
+	uint32_t multicast_seq;
+	size_t multicast_dropped;
+} SurviveDriverStream;
+
+static void set_nonblocking(int sock) { fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK); }
+
+static void client_close(SurviveDriverStream *driver, stream_client *client) {
+	SurviveContext *ctx = driver->ctx;
+	SV_INFO("Stream client %d disconnected; %d frames dropped", client->sock, (int)client->dropped);
+	close(client->sock);
+	free(client->queue);
+	memset(client, 0, sizeof(*client));
+	client->sock = -1;
+}
+
+// Sends what is queued for the client; false if the connection is gone
+static bool client_flush(SurviveDriverStream *driver, stream_client *client) {
+	while (client->cnt) {
+		size_t contiguous = driver->queue_capacity - client->head;
+		if (contiguous > client->cnt)
+			contiguous = client->cnt;
+
+		ssize_t sent = send(client->sock, client->queue + client->head, contiguous, MSG_DONTWAIT | MSG_NOSIGNAL);
+		if (sent < 0) {
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		}
+		client->head = (client->head + sent) % driver->queue_capacity;
+		client->cnt -= sent;
+	}
+	return true;
+}
+
+static bool client_wants(const stream_client *client, const char *object) {
+	if (client->subscription_cnt == 0) {
+		return true;
+	}
+	for (size_t i = 0; i < client->subscription_cnt; i++) {
+		if (strcmp(client->subscriptions[i], object) == 0)
+			return true;
+	}
+	return false;
+}
+
+static void client_send(SurviveDriverStream *driver, stream_client *client, SurviveStreamFrame *frame) {
+	frame->seq = client->seq++;
+
+	uint8_t buffer[SURVIVE_STREAM_MAX_FRAME_SIZE];
+	size_t len = survive_stream_encode(frame, buffer, sizeof(buffer));
+
+	if (!client_flush(driver, client)) {
+		client_close(driver, client);
+		return;
+	}
+	if (client->cnt + len > driver->queue_capacity) {
+		client->dropped++;
+		return;
+	}
+
+	size_t offset = 0;
+	if (client->cnt == 0) {
+		ssize_t sent = send(client->sock, buffer, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+		if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+			client_close(driver, client);
+			return;
+		}
+		offset = sent > 0 ? sent : 0;
+	}
+
+	for (; offset < len; offset++) {
+		client->queue[(client->head + client->cnt++) % driver->queue_capacity] = buffer[offset];
+	}
+}
+
+static void publish(SurviveDriverStream *driver, SurviveObject *so, SurviveStreamFrame *frame) {
+	frame->time = survive_run_time(driver->ctx);
+	strncpy(frame->object, so->codename, SURVIVE_STREAM_OBJECT_LEN);
+
+	OGLockMutex(driver->lock);
+	for (size_t i = 0; i < STREAM_MAX_CLIENTS; i++) {
+		stream_client *client = &driver->clients[i];
+		if (client->sock >= 0 && client_wants(client, frame->object)) {
+			client_send(driver, client, frame);
+		}
+	}
+
+	if (driver->multicast_sock >= 0) {
+		frame->seq = driver->multicast_seq++;
+
+		uint8_t buffer[SURVIVE_STREAM_MAX_FRAME_SIZE];
+		size_t len = survive_stream_encode(frame, buffer, sizeof(buffer));
+		if (sendto(driver->multicast_sock, buffer, len, MSG_DONTWAIT | MSG_NOSIGNAL,
+				   (struct sockaddr *)&driver->multicast_addr, sizeof(driver->multicast_addr)) != (ssize_t)len) {
+			driver->multicast_dropped++;
+		}
+	}
+	OGUnlockMutex(driver->lock);
+}
+
+static void stream_pose(void *user, SurviveObject *so, survive_timecode timecode, const SurvivePose *pose) {
+	SurviveStreamFrame frame = {.type = SURVIVE_STREAM_POSE, .timecode = timecode, .body.pose = *pose};
+	publish(user, so, &frame);
+}
+
+static void stream_velocity(void *user, SurviveObject *so, survive_timecode timecode,
+							const SurviveVelocity *velocity) {
+	SurviveStreamFrame frame = {.type = SURVIVE_STREAM_VELOCITY, .timecode = timecode, .body.velocity = *velocity};
+	publish(user, so, &frame);
+}
+
+static void stream_button(void *user, SurviveObject *so, uint8_t eventType, uint8_t buttonId, uint8_t axis1Id,
+						  uint16_t axis1Val, uint8_t axis2Id, uint16_t axis2Val) {
+	SurviveStreamFrame frame = {.type = SURVIVE_STREAM_BUTTON,
+								.body.button = {.event_type = eventType,
+											   .button_id = buttonId,
+											   .axis1_id = axis1Id,
+											   .axis2_id = axis2Id,
+											   .axis1_val = axis1Val,
+											   .axis2_val = axis2Val}};
+	publish(user, so, &frame);
+}
+
+static void accept_clients(SurviveDriverStream *driver) {
+	SurviveContext *ctx = driver->ctx;
+
+	int sock;
+	while ((sock = accept(driver->listen_sock, 0, 0)) >= 0) {
+		stream_client *client = 0;
+		for (size_t i = 0; i < STREAM_MAX_CLIENTS && client == 0; i++) {
+			if (driver->clients[i].sock < 0)
+				client = &driver->clients[i];
+		}
+		if (client == 0) {
+			SV_WARN("Stream has no room for another client");
+			close(sock);
+			continue;
+		}
+
+		set_nonblocking(sock);
+		int nodelay = 1;
+		setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+		client->sock = sock;
+		client->queue = SV_MALLOC(driver->queue_capacity);
+		SV_INFO("Stream client %d connected", sock);
+	}
+}
+
+// Clients only ever send SUBSCRIBE frames
+static bool read_client(SurviveDriverStream *driver, stream_client *client) {
+	while (true) {
+		ssize_t rd = recv(client->sock, client->rx + client->rx_len, sizeof(client->rx) - client->rx_len,
+						  MSG_DONTWAIT);
+		if (rd == 0) {
+			return false;
+		}
+		if (rd < 0) {
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		}
+		client->rx_len += rd;
+
+		SurviveStreamFrame frame;
+		int used;
+		size_t offset = 0;
+		while ((used = survive_stream_decode(&frame, client->rx + offset, client->rx_len - offset)) > 0) {
+			offset += used;
+			if (frame.type == SURVIVE_STREAM_SUBSCRIBE && client->subscription_cnt < STREAM_MAX_SUBSCRIPTIONS) {
+				strcpy(client->subscriptions[client->subscription_cnt++], frame.object);
+			}
+		}
+		if (used < 0) {
+			return false;
+		}
+		memmove(client->rx, client->rx + offset, client->rx_len - offset);
+		client->rx_len -= offset;
+	}
+}
+
+static int stream_poll(struct SurviveContext *ctx, void *_driver) {
+	SurviveDriverStream *driver = _driver;
+
+	OGLockMutex(driver->lock);
+	if (driver->listen_sock >= 0) {
+		accept_clients(driver);
+	}
+
+	for (size_t i = 0; i < STREAM_MAX_CLIENTS; i++) {
+		stream_client *client = &driver->clients[i];
+		if (client->sock >= 0 && (!read_client(driver, client) || !client_flush(driver, client))) {
+			client_close(driver, client);
+		}
+	}
+	OGUnlockMutex(driver->lock);
+
+	return 0;
+}
+
+static int stream_close(struct SurviveContext *ctx, void *_driver) {
+	SurviveDriverStream *driver = _driver;
+
+	survive_remove_output_listener(ctx, driver);
+
+	for (size_t i = 0; i < STREAM_MAX_CLIENTS; i++) {
+		if (driver->clients[i].sock >= 0)
+			client_close(driver, &driver->clients[i]);
+	}
+	if (driver->listen_sock >= 0) {
+		close(driver->listen_sock);
+	}
+	if (driver->multicast_sock >= 0) {
+		SV_INFO("Stream sent %u multicast frames; %d dropped", driver->multicast_seq, (int)driver->multicast_dropped);
+		close(driver->multicast_sock);
+	}
+
+	OGDeleteMutex(driver->lock);
+	free(driver);
+	return 0;
+}
+
+static int open_listen_socket(SurviveContext *ctx, int port) {
+	int sock = socket(AF_INET, SOCK_STREAM, 0);
+	if (sock < 0) {
+		return -1;
+	}
+
+	int reuse = 1;
+	setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	struct sockaddr_in addr = {0};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = htons(port);
+
+	if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(sock, 5) < 0) {
+		SV_WARN("Could not listen for stream clients on port %d: %s", port, strerror(errno));
+		close(sock);
+		return -1;
+	}
+
+	set_nonblocking(sock);
+	SV_INFO("Serving stream on TCP port %d", port);
+	return sock;
+}
+
+static int open_multicast_socket(SurviveDriverStream *driver, const char *group, int port) {
+	SurviveContext *ctx = driver->ctx;
+	int sock = socket(AF_INET, SOCK_DGRAM, 0);
+	if (sock < 0) {
+		return -1;
+	}
+
+	driver->multicast_addr.sin_family = AF_INET;
+	driver->multicast_addr.sin_addr.s_addr = inet_addr(group);
+	driver->multicast_addr.sin_port = htons(port);
+
+	SV_INFO("Publishing stream to %s:%d", group, port);
+	return sock;
+}
+
+int DriverRegStream(SurviveContext *ctx) {
+	SurviveDriverStream *driver = SV_NEW(SurviveDriverStream);
+	driver->ctx = ctx;
+	driver->lock = OGCreateMutex();
+	driver->queue_capacity = survive_configi(ctx, STREAM_CLIENT_BUFFER_TAG, SC_GET, 16384);
+	if (driver->queue_capacity < SURVIVE_STREAM_MAX_FRAME_SIZE) {
+		driver->queue_capacity = SURVIVE_STREAM_MAX_FRAME_SIZE;
+	}
+	for (size_t i = 0; i < STREAM_MAX_CLIENTS; i++) {
+		driver->clients[i].sock = -1;
+	}
+
+	int port = survive_configi(ctx, STREAM_TCP_PORT_TAG, SC_GET, 2335);
+	driver->listen_sock = port > 0 ? open_listen_socket(ctx, port) : -1;
+
+	const char *group = survive_configs(ctx, STREAM_MULTICAST_TAG, SC_GET, 0);
+	driver->multicast_sock =
+		group && *group
+			? open_multicast_socket(driver, group, survive_configi(ctx, STREAM_MULTICAST_PORT_TAG, SC_GET, 2336))
+			: -1;
+
+	if (driver->listen_sock < 0 && driver->multicast_sock < 0) {
+		SV_WARN("Stream has neither a TCP port nor a multicast group to publish to");
+		OGDeleteMutex(driver->lock);
+		free(driver);
+		return SURVIVE_DRIVER_ERROR;
+	}
+
+	SurviveOutputListener listener = {
+		.user = driver, .pose = stream_pose, .velocity = stream_velocity, .button = stream_button};
+	survive_add_output_listener(ctx, &listener);
+	survive_add_driver(ctx, driver, stream_poll, stream_close, 0);
+	return SURVIVE_DRIVER_PASSIVE;
+}
+
+REGISTER_LINKTIME(DriverRegStream)
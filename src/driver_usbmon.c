@@ -400,13 +400,6 @@ const char *requestTypeToStr(uint8_t requestType) {
 	return "<unknown>";
 }
 
-static double timestamp_in_s() {
-	static double start_time_s = 0;
-	if (start_time_s == 0.)
-		start_time_s = OGGetAbsoluteTime();
-	return OGGetAbsoluteTime() - start_time_s;
-}
-
 static double survive_usbmon_playback_run_time(const SurviveContext *ctx, void *_driver) {
 	SurviveDriverUSBMon *driver = _driver;
 	return driver->time_now;
@@ -422,7 +415,7 @@ void *pcap_thread_fn(void *_driver) {
 
 	SV_INFO("Pcap thread started");
 	double start_time = 0;
-	double real_time_start = timestamp_in_s();
+	double real_time_start = OGGetAbsoluteTime();
 	while (driver->keepRunning && ctx->currentError == SURVIVE_OK) {
 		int result = pcap_next_ex(driver->pcap, &pkthdr, (const uint8_t **)&usbp);
 		switch (result) {
@@ -447,14 +440,14 @@ void *pcap_thread_fn(void *_driver) {
 				if (start_time == 0) {
 					start_time = make_time(0, usbp);
 				}
-				double this_real_time = timestamp_in_s();
+				double this_real_time = OGGetAbsoluteTime() - real_time_start;
 				double this_time = make_time(start_time, usbp);
 				if (driver->playback_factor > 0.) {
 					double next_time_s_scaled = this_time * driver->playback_factor;
 					while (this_real_time < next_time_s_scaled) {
 						int sleep_time_ms = 1 + (next_time_s_scaled - this_real_time) * 1000.;
 						OGUSleep(sleep_time_ms * 1000);
-						this_real_time = timestamp_in_s();
+						this_real_time = OGGetAbsoluteTime() - real_time_start;
 					}
 				}
 				driver->time_now = this_time;
@@ -26,6 +26,7 @@
 #endif
 
 #include "json_helpers.h"
+#include "survive_atomic.h"
 #include "survive_config.h"
 #include "survive_default_devices.h"
 
@@ -385,6 +386,16 @@ struct SurviveUSBInfo {
 	bool tryConfigLoad;
 };
 
+// Must be a power of two
+#define SURVIVE_USB_PACKET_QUEUE_SIZE 4096
+
+typedef struct SurviveUSBPacket {
+	SurviveUSBInterface *iface;
+	int length;
+	double arrival_time;
+	uint8_t data[INTBUFFSIZE];
+} SurviveUSBPacket;
+
 struct SurviveViveData {
 	SurviveContext *ctx;
 	size_t udev_cnt;
@@ -392,6 +403,23 @@ struct SurviveViveData {
 	struct libusb_context *usbctx;
 	size_t read_count;
 	int seconds_per_hz_output;
+	// When the usb rate stats were last printed
+	double hz_output_start;
+	int hz_output_seconds;
+	int transfers_per_interface;
+
+	// With libusb, a dedicated thread handles USB events and copies every completed report into this queue; the
+	// processing thread drains it and runs the parsers. Reports are only dropped if the queue fills up.
+	og_thread_t usb_thread;
+	og_thread_t processing_thread;
+	uint32_t usb_thread_running;
+	uint32_t processing_running;
+	og_mutex_t packet_queue_lock;
+	og_sema_t packets_available;
+	uint32_t packet_queue_head;
+	uint32_t packet_queue_tail;
+	uint32_t packets_dropped;
+	SurviveUSBPacket *packet_queue;
 
 	int cnt_per_device_type[sizeof(KnownDeviceTypes) / sizeof(KnownDeviceTypes[0])];
 	int hmd_mainboard_index;
@@ -505,7 +533,9 @@ void survive_data_cb_locked(SurviveUSBInterface *si);
 void survive_data_cb(SurviveUSBInterface *si) {
 	SurviveContext *ctx = si->ctx;
 	survive_get_ctx_lock(ctx);
+	survive_latency_packet_begin(ctx, si->packet_time);
 	survive_data_cb_locked(si);
+	survive_latency_packet_end(ctx);
 	survive_release_ctx_lock(ctx);
 }
 
@@ -551,22 +581,32 @@ static int AttachInterface(SurviveViveData *sv, struct SurviveUSBInfo *usbObject
 	}
 #endif
 #else
-	struct libusb_transfer *tx = iface->transfer = libusb_alloc_transfer(0);
-	// printf( "%p %d %p %p\n", iface, which_interface_am_i, tx, devh );
-	SV_VERBOSE(50, "Attaching %s(0x%x) for %s", hname, endpoint_num, assocobj ? assocobj->codename : "(unknown)");
+	SV_VERBOSE(50, "Attaching %s(0x%x) for %s with %d transfers", hname, endpoint_num,
+			   assocobj ? assocobj->codename : "(unknown)", sv->transfers_per_interface);
 
-	if (!iface->transfer) {
-		SV_ERROR(SURVIVE_ERROR_HARWARE_FAULT, "Error: failed on libusb_alloc_transfer for %s", hname);
-		return 4;
-	}
+	iface->transfer_retired = OGCreateSema();
 
-	libusb_fill_interrupt_transfer(tx, devh, endpoint_num, iface->buffer, INTBUFFSIZE, handle_transfer, iface, 0);
+	// Several transfers stay queued so the endpoint is never idle while a completed one is being handled
+	for (int i = 0; i < sv->transfers_per_interface; i++) {
+		struct libusb_transfer *tx = libusb_alloc_transfer(0);
+		if (!tx) {
+			SV_ERROR(SURVIVE_ERROR_HARWARE_FAULT, "Error: failed on libusb_alloc_transfer for %s", hname);
+			return 4;
+		}
 
-	int rc = libusb_submit_transfer(tx);
-	if (rc) {
-		SV_ERROR(SURVIVE_ERROR_HARWARE_FAULT, "Error: Could not submit transfer for %s 0x%02x (Code %d, %s)", hname,
-				 endpoint_num, rc, libusb_error_name(rc));
-		return 6;
+		libusb_fill_interrupt_transfer(tx, devh, endpoint_num, SV_MALLOC(INTBUFFSIZE), INTBUFFSIZE, handle_transfer,
+									   iface, 0);
+		tx->flags = LIBUSB_TRANSFER_FREE_BUFFER;
+		iface->transfers[iface->transfer_cnt++] = tx;
+
+		survive_atomic_fetch_add_u32(&iface->active_transfers, 1);
+		int rc = libusb_submit_transfer(tx);
+		if (rc) {
+			survive_atomic_fetch_add_u32(&iface->active_transfers, (uint32_t)-1);
+			SV_ERROR(SURVIVE_ERROR_HARWARE_FAULT, "Error: Could not submit transfer for %s 0x%02x (Code %d, %s)",
+					 hname, endpoint_num, rc, libusb_error_name(rc));
+			return 6;
+		}
 	}
 #endif
 	return 0;
@@ -790,21 +830,21 @@ void survive_vive_usb_close(SurviveViveData *sv) {
 }
 
 STATIC_CONFIG_ITEM(SECONDS_PER_HZ_OUTPUT, "usb-hz-output", 'i', "Seconds between outputing usb stats", -1)
+STATIC_CONFIG_ITEM(USB_TRANSFERS, "usb-transfers", 'i', "Number of transfers kept queued per usb interface", 4)
 int survive_vive_usb_poll(SurviveContext *ctx, void *v) {
 	SurviveViveData *sv = v;
 	sv->read_count++;
 
-	static double start = 0;
-	static int seconds = 0;
-	if(start == 0)
-		start = OGGetAbsoluteTime();
+	if (sv->hz_output_start == 0)
+		sv->hz_output_start = OGGetAbsoluteTime();
 
 	double now = OGGetAbsoluteTime();
+	double start = sv->hz_output_start;
 	int now_seconds = (int)(now - start);
-	bool print = sv->seconds_per_hz_output > 0 && now_seconds > (seconds + sv->seconds_per_hz_output);
-	
+	bool print = sv->seconds_per_hz_output > 0 && now_seconds > (sv->hz_output_seconds + sv->seconds_per_hz_output);
+
 	if (print) {
-		seconds = now_seconds;
+		sv->hz_output_seconds = now_seconds;
 		size_t total_packets = 0;
 		for (int i = 0; i < sv->udev_cnt; i++) {
 			if (sv->udev[i].so == 0)
@@ -820,7 +860,10 @@ int survive_vive_usb_poll(SurviveContext *ctx, void *v) {
 		}
 
 		SV_INFO("Total                  %4zu packets (%6.2f hz)", total_packets, total_packets / (now - start));
-		start = now;
+		if (sv->packets_dropped) {
+			SV_INFO("Dropped                %4u packets", sv->packets_dropped);
+		}
+		sv->hz_output_start = now;
 	}
 
 	for (int i = 0; i < sv->udev_cnt; i++) {
@@ -863,16 +906,6 @@ int survive_vive_usb_poll(SurviveContext *ctx, void *v) {
 	OGUSleep(1);
 	return 0;
 #endif
-#else
-	// int r = libusb_handle_events(sv->usbctx);
-	struct timeval tv = {.tv_usec = 10 * 1000};
-	survive_release_ctx_lock(ctx);
-	int r = libusb_handle_events_timeout(sv->usbctx, &tv);
-	survive_get_ctx_lock(ctx);
-
-	if (r) {
-		SV_ERROR(SURVIVE_ERROR_HARWARE_FAULT, "Libusb poll failed. %d (%s)", r, libusb_error_name(r));
-	}
 #endif
 	return 0;
 }
@@ -2820,6 +2853,12 @@ static int LoadConfig(SurviveViveData *sv, struct SurviveUSBInfo *usbInfo, int i
 
 int survive_vive_close(SurviveContext *ctx, void *driver) {
 	SurviveViveData *sv = driver;
+
+	// The processing thread takes the context lock for every packet
+	survive_release_ctx_lock(ctx);
+	survive_usb_stop_processing(sv);
+	survive_get_ctx_lock(ctx);
+
 	for (int i = 0; i < sv->udev_cnt; i++) {
 		survive_close_usb_device(&sv->udev[i]);
 	}
@@ -2838,6 +2877,12 @@ int DriverRegHTCVive(SurviveContext *ctx) {
 	}
 	sv->ctx = ctx;
 
+	sv->transfers_per_interface = survive_configi(ctx, USB_TRANSFERS_TAG, SC_GET, 4);
+	if (sv->transfers_per_interface < 1)
+		sv->transfers_per_interface = 1;
+	if (sv->transfers_per_interface > MAX_TRANSFERS_PER_INTERFACE)
+		sv->transfers_per_interface = MAX_TRANSFERS_PER_INTERFACE;
+
 #ifdef _WIN32
 	CreateDirectoryA("calinfo", NULL);
 #elif defined WINDOWS
@@ -2862,6 +2907,7 @@ int DriverRegHTCVive(SurviveContext *ctx) {
 	}
 
 	if (sv->udev_cnt) {
+		survive_usb_start_threads(sv);
 		survive_add_driver(ctx, sv, survive_vive_usb_poll, survive_vive_close, survive_vive_send_magic);
 	} else {
 		SV_INFO("No USB devices detected");
@@ -2881,8 +2927,10 @@ int DriverRegHTCVive(SurviveContext *ctx) {
 	sv->uiface[USB_DEV_TRACKER1_LIGHTCAP].actual_len = 64;
 */
 #endif
+#ifdef HIDAPI
 	// Note: don't sleep for HTCVive, the handle_events call can block
 	ctx->poll_min_time_ms = 0;
+#endif
 
 	return 0;
 fail_gracefully:
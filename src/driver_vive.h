@@ -30,6 +30,9 @@ enum USB_DEV_t {
 };
 
 #define MAX_INTERFACES_PER_DEVICE 8
+// Upper bound for 'usb-transfers'
+#define MAX_TRANSFERS_PER_INTERFACE 16
+
 enum USB_IF_t {
 	USB_IF_HMD_HEADSET_INFO = 1,
 	USB_IF_HMD_IMU,
@@ -83,12 +86,19 @@ typedef struct SurviveUSBInterface {
 	og_thread_t servicethread;
 #endif
 #else
-	struct libusb_transfer *transfer;
+	struct libusb_transfer *transfers[MAX_TRANSFERS_PER_INTERFACE];
+	size_t transfer_cnt;
+	// Transfers submitted and not yet retired; shutdown waits for this to reach zero
+	uint32_t active_transfers;
+	// Posted each time a transfer retires
+	og_sema_t transfer_retired;
 #endif
 	struct SurviveUSBInfo *usbInfo;
 	SurviveObject *assoc_obj;
 	int actual_len;
 	uint8_t buffer[INTBUFFSIZE];
+	// Host time 'buffer' arrived, if latency tracing is on
+	double packet_time;
 	usb_callback cb;
 	int which_interface_am_i; // for indexing into uiface
 	const char *hname;		  // human-readable names
@@ -31,6 +31,7 @@ static void *HAPIReceiver(void *v) {
 
 	if ((iface->actual_len = hid_read(*hp, iface->buffer, sizeof(iface->buffer))) > 0) {
 		// if( iface->actual_len  == 52 ) continue;
+		iface->packet_time = survive_latency_enabled(iface->sv->ctx) ? OGGetAbsoluteTime() : 0;
 		iface->packet_count++;
 		survive_data_cb(iface);
 	}
@@ -114,6 +115,8 @@ static int survive_open_usb_device(SurviveViveData *sv, survive_usb_device_t d,
 	return 0;
 }
 static void setup_hotplug(SurviveViveData *sv) {}
+static void survive_usb_start_threads(SurviveViveData *sv) {}
+static void survive_usb_stop_processing(SurviveViveData *sv) {}
 
 static inline void survive_close_usb_device(struct SurviveUSBInfo *usbInfo) {
 	for (int j = 0; j < 8; j++) {
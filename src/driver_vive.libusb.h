@@ -62,6 +62,11 @@ typedef libusb_device *survive_usb_device_t;
 typedef libusb_device **survive_usb_devices_t;
 
 static int survive_usb_subsystem_init(SurviveViveData *sv) {
+	// Transfers can complete as soon as interfaces are attached, so the queue has to exist first
+	sv->packet_queue = SV_CALLOC(SURVIVE_USB_PACKET_QUEUE_SIZE, sizeof(SurviveUSBPacket));
+	sv->packet_queue_lock = OGCreateMutex();
+	sv->packets_available = OGCreateSema();
+
 	int rtn = libusb_init(&sv->usbctx);
 #if LIBUSB_API_VERSION < 0x01000106
 	libusb_set_debug(NULL, LIBUSB_LOG_LEVEL_WARNING);
@@ -153,29 +158,131 @@ cleanup_and_rtn:
 	return ret;
 }
 
+static void queue_packet(SurviveUSBInterface *iface, const uint8_t *data, int length) {
+	SurviveViveData *sv = iface->sv;
+
+	// Events are normally handled on the USB thread, but synchronous control transfers on other threads can complete
+	// interrupt transfers too
+	OGLockMutex(sv->packet_queue_lock);
+	uint32_t head = sv->packet_queue_head;
+	if (head - survive_atomic_load_u32(&sv->packet_queue_tail) >= SURVIVE_USB_PACKET_QUEUE_SIZE) {
+		sv->packets_dropped++;
+		OGUnlockMutex(sv->packet_queue_lock);
+		return;
+	}
+
+	SurviveUSBPacket *packet = &sv->packet_queue[head & (SURVIVE_USB_PACKET_QUEUE_SIZE - 1)];
+	packet->iface = iface;
+	packet->length = length > INTBUFFSIZE ? INTBUFFSIZE : length;
+	packet->arrival_time = survive_latency_enabled(sv->ctx) ? OGGetAbsoluteTime() : 0;
+	memcpy(packet->data, data, packet->length);
+	survive_atomic_store_u32(&sv->packet_queue_head, head + 1);
+	OGUnlockMutex(sv->packet_queue_lock);
+
+	OGUnlockSema(sv->packets_available);
+}
+
+static void retire_transfer(SurviveUSBInterface *iface) {
+	survive_atomic_fetch_add_u32(&iface->active_transfers, (uint32_t)-1);
+	OGUnlockSema(iface->transfer_retired);
+}
+
 static void handle_transfer(struct libusb_transfer *transfer) {
 	SurviveUSBInterface *iface = transfer->user_data;
+	SurviveContext *ctx = iface->ctx;
 	if (iface->shutdown) {
-		SurviveContext *ctx = iface->ctx;
 		SV_VERBOSE(100, "Cleaning up transfer on %d %s", iface->which_interface_am_i, iface->hname);
-		iface->ctx = 0;
+		retire_transfer(iface);
 		return;
 	}
 
-	SurviveContext *ctx = iface->ctx;
-
 	if (transfer->status != LIBUSB_TRANSFER_COMPLETED) {
 		SV_ERROR(SURVIVE_ERROR_HARWARE_FAULT, "Transfer problem %s %d with %s", libusb_error_name(transfer->status),
 				 transfer->status, iface->hname);
+		retire_transfer(iface);
 		return;
 	}
 
-	iface->actual_len = transfer->actual_length;
-	iface->cb(iface);
-	iface->packet_count++;
+	queue_packet(iface, transfer->buffer, transfer->actual_length);
 
 	if (libusb_submit_transfer(transfer)) {
 		SV_ERROR(SURVIVE_ERROR_HARWARE_FAULT, "Error resubmitting transfer for %s", iface->hname);
+		retire_transfer(iface);
+	} else if (iface->shutdown) {
+		// Shutdown started after the check above; its cancel may have missed this transfer
+		libusb_cancel_transfer(transfer);
+	}
+}
+
+static void *usb_event_thread(void *_sv) {
+	SurviveViveData *sv = _sv;
+	SurviveContext *ctx = sv->ctx;
+
+	while (survive_atomic_load_u32(&sv->usb_thread_running)) {
+		struct timeval tv = {.tv_usec = 10 * 1000};
+		int r = libusb_handle_events_timeout_completed(sv->usbctx, &tv, 0);
+		if (r && r != LIBUSB_ERROR_INTERRUPTED) {
+			SV_ERROR(SURVIVE_ERROR_HARWARE_FAULT, "Libusb poll failed. %d (%s)", r, libusb_error_name(r));
+		}
+	}
+
+	return 0;
+}
+
+static void *usb_processing_thread(void *_sv) {
+	SurviveViveData *sv = _sv;
+
+	while (true) {
+		OGLockSema(sv->packets_available);
+
+		uint32_t tail = sv->packet_queue_tail;
+		if (tail == survive_atomic_load_u32(&sv->packet_queue_head)) {
+			if (!survive_atomic_load_u32(&sv->processing_running)) {
+				break;
+			}
+			continue;
+		}
+
+		// The callbacks parse from the interface's own buffer
+		const SurviveUSBPacket *packet = &sv->packet_queue[tail & (SURVIVE_USB_PACKET_QUEUE_SIZE - 1)];
+		SurviveUSBInterface *iface = packet->iface;
+		if (!iface->shutdown) {
+			memcpy(iface->buffer, packet->data, packet->length);
+			iface->actual_len = packet->length;
+			iface->packet_time = packet->arrival_time;
+			iface->cb(iface);
+			iface->packet_count++;
+		}
+		survive_atomic_store_u32(&sv->packet_queue_tail, tail + 1);
+	}
+
+	return 0;
+}
+
+static void survive_usb_start_threads(SurviveViveData *sv) {
+	sv->usb_thread_running = 1;
+	sv->processing_running = 1;
+	sv->usb_thread = OGCreateThread(usb_event_thread, sv);
+	OGNameThread(sv->usb_thread, "usb events");
+	sv->processing_thread = OGCreateThread(usb_processing_thread, sv);
+	OGNameThread(sv->processing_thread, "usb processing");
+}
+
+// Must be called without the context lock
+static void survive_usb_stop_processing(SurviveViveData *sv) {
+	if (sv->processing_thread == 0) {
+		return;
+	}
+
+	// The USB thread keeps running so transfers can still be cancelled
+	survive_atomic_store_u32(&sv->processing_running, 0);
+	OGUnlockSema(sv->packets_available);
+	OGJoinThread(sv->processing_thread);
+	sv->processing_thread = 0;
+
+	SurviveContext *ctx = sv->ctx;
+	if (sv->packets_dropped) {
+		SV_WARN("Dropped %u usb packets because processing fell behind", sv->packets_dropped);
 	}
 }
 
@@ -187,13 +294,26 @@ static inline void survive_close_usb_device(struct SurviveUSBInfo *usbInfo) {
 	for (int j = 0; j < usbInfo->interface_cnt; j++) {
 		SurviveUSBInterface *iface = &usbInfo->interfaces[j];
 		SV_INFO("Cleaning up interface on %d %s", iface->which_interface_am_i, iface->hname);
-		libusb_cancel_transfer(usbInfo->interfaces[j].transfer);
-		while (usbInfo->interfaces[j].ctx) {
+		for (size_t k = 0; k < iface->transfer_cnt; k++) {
+			libusb_cancel_transfer(iface->transfers[k]);
+		}
+
+		// The USB thread retires the cancelled transfers. Transfers that failed earlier posted too, so the count is
+		// what decides when to stop.
+		while (survive_atomic_load_u32(&iface->active_transfers)) {
 			survive_release_ctx_lock(ctx);
-			libusb_handle_events(usbInfo->viveData->usbctx);
+			OGLockSema(iface->transfer_retired);
 			survive_get_ctx_lock(ctx);
 		}
-		libusb_free_transfer(usbInfo->interfaces[j].transfer);
+
+		for (size_t k = 0; k < iface->transfer_cnt; k++) {
+			libusb_free_transfer(iface->transfers[k]);
+		}
+		iface->transfer_cnt = 0;
+		if (iface->transfer_retired) {
+			OGDeleteSema(iface->transfer_retired);
+			iface->transfer_retired = 0;
+		}
 
 		libusb_release_interface(usbInfo->handle, j);
 	}
@@ -201,4 +321,21 @@ static inline void survive_close_usb_device(struct SurviveUSBInfo *usbInfo) {
 	libusb_close(usbInfo->handle);
 }
 
-void survive_usb_close(SurviveViveData *sv) { libusb_exit(sv->usbctx); }
+void survive_usb_close(SurviveViveData *sv) {
+	survive_usb_stop_processing(sv);
+
+	if (sv->usb_thread) {
+		survive_atomic_store_u32(&sv->usb_thread_running, 0);
+		OGJoinThread(sv->usb_thread);
+		sv->usb_thread = 0;
+	}
+
+	libusb_exit(sv->usbctx);
+
+	if (sv->packet_queue) {
+		OGDeleteSema(sv->packets_available);
+		OGDeleteMutex(sv->packet_queue_lock);
+		free(sv->packet_queue);
+		sv->packet_queue = 0;
+	}
+}
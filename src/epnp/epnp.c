@@ -29,6 +29,7 @@
 #include "stdbool.h"
 #include "stdio.h"
 #include "stdlib.h"
+#include <malloc.h>
 #include <survive.h>
 
 #pragma GCC diagnostic ignored "-Wpedantic"
@@ -312,21 +313,12 @@ void compute_A_and_b_gauss_newton(const double *l_6x10, const double *rho, doubl
 }
 
 void qr_solve(CvMat *A, CvMat *b, CvMat *X) {
-	static int max_nr = 0;
-	static double *A1, *A2;
-
 	const int nr = A->rows;
 	const int nc = A->cols;
 
-	if (max_nr != 0 && max_nr < nr) {
-		free(A1);
-		free(A2);
-	}
-	if (max_nr < nr) {
-		max_nr = nr;
-		A1 = SV_MALLOC(sizeof(double) * nr);
-		A2 = SV_MALLOC(sizeof(double) * nr);
-	}
+	// Per call scratch; A is small and solves from different contexts can run at the same time
+	double *A1 = alloca(sizeof(double) * nr);
+	double *A2 = alloca(sizeof(double) * nr);
 
 	double *pA = A->data.db, *ppAkk = pA;
 	for (int k = 0; k < nc; k++) {
@@ -96,6 +96,13 @@ struct lfsr_lookup_t *lfsr_lookup_ctor(lfsr_poly_t p) {
 	return lookup;
 }
 
+void lfsr_lookup_dtor(struct lfsr_lookup_t *lookup) {
+	if (lookup == 0)
+		return;
+	free(lookup->table);
+	free(lookup);
+}
+
 uint32_t lfsr_lookup_query(struct lfsr_lookup_t *lookup, uint32_t q) {
 	uint32_t mask = (1 << (lookup->order)) - 1;
 	return lookup->table[q & mask];
@@ -33,4 +33,5 @@ uint8_t lfsr_order(lfsr_poly_t v);
 
 struct lfsr_lookup_t;
 struct lfsr_lookup_t *lfsr_lookup_ctor(lfsr_poly_t p);
+void lfsr_lookup_dtor(struct lfsr_lookup_t *lookup);
 uint32_t lfsr_lookup_query(struct lfsr_lookup_t *lookup, uint32_t q);
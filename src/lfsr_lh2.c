@@ -1,4 +1,5 @@
 #include "lfsr_lh2.h"
+#include "survive_atomic.h"
 #ifndef _MSC_VER
 #include "alloca.h"
 #define clz(x) __builtin_clz(x)
@@ -60,12 +61,20 @@ lfsr_poly_t poly_pairs[32] = {
 	0x0001CB8D,
 };
 
-struct lfsr_lookup_t *poly_pair_lookups[32] = {0};
-static void init_lookups() {
-	if (poly_pair_lookups[0] == 0) {
-		for (int i = 0; i < 32; i++)
-			poly_pair_lookups[i] = lfsr_lookup_ctor(poly_pairs[i]);
+// Shared by every context and never changed once built. Whoever needs one first builds it; if two threads race, the
+// loser throws its copy away.
+static struct lfsr_lookup_t *poly_pair_lookups[32] = {0};
+static struct lfsr_lookup_t *get_lookup(int i) {
+	struct lfsr_lookup_t *lookup = survive_atomic_load_ptr((void **)&poly_pair_lookups[i]);
+	if (lookup == 0) {
+		void *expected = 0;
+		lookup = lfsr_lookup_ctor(poly_pairs[i]);
+		if (!survive_atomic_cas_ptr((void **)&poly_pair_lookups[i], &expected, lookup)) {
+			lfsr_lookup_dtor(lookup);
+			lookup = expected;
+		}
 	}
+	return lookup;
 }
 
 static uint32_t find_possible_polys(uint32_t sample, uint32_t mask, uint32_t *timings, uint32_t *reconstructed_sample) {
@@ -96,7 +105,7 @@ static uint32_t find_possible_polys(uint32_t sample, uint32_t mask, uint32_t *ti
 				fprintf(stderr, "Error for %d was %d %x %x %x\n", i, error, final_state & mask, sample & mask, mask);
 			rtn ^= (1 << i);
 		} else {
-			timings[i] = lfsr_lookup_query(poly_pair_lookups[i], state) - offset;
+			timings[i] = lfsr_lookup_query(get_lookup(i), state) - offset;
 			reconstructed_sample[i] = final_state;
 			fprintf(stderr, "Timing for %d was %u\n", i, timings[i]);
 		}
@@ -107,7 +116,6 @@ static uint32_t find_possible_polys(uint32_t sample, uint32_t mask, uint32_t *ti
 
 survive_channel survive_decipher_channel(const uint32_t *sample, const uint32_t *mask, const uint32_t *times,
 										 uint32_t *output, size_t count) {
-	init_lookups();
 	uint32_t possible_polys = 0xFFFFFFFF;
 	uint32_t *timings = alloca(32 * sizeof(uint32_t) * count);
 	uint32_t *recon_samples = alloca(32 * sizeof(uint32_t) * count);
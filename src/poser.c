@@ -8,6 +8,8 @@
 #define _USE_MATH_DEFINES // for C
 #include <math.h>
 #include <poser.h>
+#include "survive_latency.h"
+#include "survive_poser_worker.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -45,13 +47,12 @@ void PoserData_poser_pose_func(PoserData *poser_data, SurviveObject *so, const S
 			return;
 		}
 	}
+	survive_latency_mark(so, SURVIVE_LATENCY_POSE, poser_data->arrival_time);
+
 	if (poser_data->poseproc) {
 		poser_data->poseproc(so, PoserData_timecode(poser_data), imu2world, poser_data->userdata);
 	} else {
-		static int report_in_imu = -1;
-		if (report_in_imu == -1) {
-			report_in_imu = survive_configi(so->ctx, REPORT_IN_IMU_TAG, SC_GET, 0);
-		}
+		bool report_in_imu = survive_configi(so->ctx, REPORT_IN_IMU_TAG, SC_GET, 0);
 
 		SurvivePose head2world;
 		so->OutPoseIMU = *imu2world;
@@ -64,13 +65,17 @@ void PoserData_poser_pose_func(PoserData *poser_data, SurviveObject *so, const S
 		for (int i = 0; i < 7; i++)
 			assert(!isnan(((double *)imu2world)[i]));
 		SV_VERBOSE(500, "Object %s has pose " SurvivePose_format, so->codename, SURVIVE_POSE_EXPAND(head2world));
+		survive_poser_output_begin(so);
 		so->ctx->poseproc(so, PoserData_timecode(poser_data), &head2world);
+		survive_poser_output_end(so);
 	}
 }
 void PoserData_poser_pose_func_with_velocity(PoserData *poser_data, SurviveObject *so, const SurvivePose *imu2world,
 											 const SurviveVelocity *velocity) {
 	PoserData_poser_pose_func(poser_data, so, imu2world);
+	survive_poser_output_begin(so);
 	so->ctx->velocityproc(so, PoserData_timecode(poser_data), velocity);
+	survive_poser_output_end(so);
 }
 
 void PoserData_lighthouse_pose_func(PoserData *poser_data, SurviveObject *so, uint8_t lighthouse,
@@ -177,7 +182,9 @@ void PoserData_lighthouse_pose_func(PoserData *poser_data, SurviveObject *so, ui
 		for (int i = 0; i < 7; i++)
 			assert(!isnan(((double *)&lighthouse2world)[i]));
 
+		survive_poser_output_begin(so);
 		so->ctx->lighthouse_poseproc(so->ctx, lighthouse, &lighthouse2world, &obj2world);
+		survive_poser_output_end(so);
 	}
 }
 
@@ -241,31 +248,42 @@ void PoserData_lighthouse_poses_func(PoserData *poser_data, SurviveObject *so, S
 }
 void PoserDataFullScene2Activations(const PoserDataFullScene *pdfs, SurviveSensorActivations *activations) {
 	SurviveSensorActivations_ctor(0, activations);
-	for (int i = 0; i < SENSORS_PER_OBJECT * NUM_GEN1_LIGHTHOUSES * 2; i++) {
-		double length = ((double *)pdfs->lengths)[i] * 48000000;
-		if (length > 0)
-			((survive_timecode *)activations->lengths)[i] = (survive_timecode)length;
-	}
+	for (int lh = 0; lh < NUM_GEN2_LIGHTHOUSES; lh++) {
+		for (int sensor = 0; sensor < SENSORS_PER_OBJECT; sensor++) {
+			const FLT *angles = pdfs->angles[sensor][lh];
+			const FLT *lengths = lh < NUM_GEN1_LIGHTHOUSES ? pdfs->lengths[sensor][lh] : 0;
+			bool hasLength = lengths && (lengths[0] > 0 || lengths[1] > 0);
+			if (isnan(angles[0]) && isnan(angles[1]) && !hasLength)
+				continue;
 
-	for (int i = 0; i < SENSORS_PER_OBJECT * NUM_GEN2_LIGHTHOUSES * 2; i++) {
-		((double *)activations->angles)[i] = ((double *)pdfs->angles)[i];
+			// Only the slots that have data get an entry, so the activations stay sized to what was seen
+			SurviveSensorActivationsEntry *entry = SurviveSensorActivations_entry_for_write(activations, sensor, lh);
+			for (int axis = 0; axis < 2; axis++) {
+				entry->angles[axis] = angles[axis];
+				if (lengths && lengths[axis] * 48000000 > 0)
+					entry->lengths[axis] = (survive_timecode)(lengths[axis] * 48000000);
+			}
+		}
 	}
 
 	memcpy(activations->accel, pdfs->lastimu.accel, sizeof(activations->accel));
 	memcpy(activations->gyro, pdfs->lastimu.gyro, sizeof(activations->gyro));
 	memcpy(activations->mag, pdfs->lastimu.mag, sizeof(activations->mag));
+
+	SurviveSensorActivations_reindex(activations);
 }
 
 SURVIVE_EXPORT void Activations2PoserDataFullScene(const struct SurviveSensorActivations_s *activations,
 												   PoserDataFullScene *pdfs) {
-	for (int i = 0; i < SENSORS_PER_OBJECT * NUM_GEN1_LIGHTHOUSES * 2; i++) {
-		survive_timecode length = ((survive_timecode *)activations->lengths)[i];
-		if (length > 0)
-			((double *)pdfs->lengths)[i] = length / 48000000.;
-	}
-
-	for (int i = 0; i < SENSORS_PER_OBJECT * NUM_GEN2_LIGHTHOUSES * 2; i++) {
-		((double *)pdfs->angles)[i] = ((double *)activations->angles)[i];
+	for (int sensor = 0; sensor < SENSORS_PER_OBJECT; sensor++) {
+		for (int lh = 0; lh < NUM_GEN2_LIGHTHOUSES; lh++) {
+			const SurviveSensorActivationsEntry *entry = SurviveSensorActivations_entry(activations, sensor, lh);
+			for (int axis = 0; axis < 2; axis++) {
+				pdfs->angles[sensor][lh][axis] = entry->angles[axis];
+				if (lh < NUM_GEN1_LIGHTHOUSES && entry->lengths[axis] > 0)
+					pdfs->lengths[sensor][lh][axis] = entry->lengths[axis] / 48000000.;
+			}
+		}
 	}
 
 	memcpy(pdfs->lastimu.accel, activations->accel, sizeof(activations->accel));
@@ -16,7 +16,8 @@ typedef struct {
 	FLT max_error_obj;
 	FLT max_error_cal;
 
-	bc_svd bc;
+	// Kept per lighthouse so each solve only has to fold in the readings that changed since the last one
+	bc_svd bc[NUM_GEN2_LIGHTHOUSES];
 } PoserDataSVD;
 
 static void survive_fill_m(void *user, double *eq, int axis, FLT angle) {
@@ -64,7 +65,9 @@ static void survive_fill_m(void *user, double *eq, int axis, FLT angle) {
 }
 
 static void PoserDataSVD_destroy(PoserDataSVD *dd) {
-	bc_svd_dtor(&dd->bc);
+	for (int lh = 0; lh < NUM_GEN2_LIGHTHOUSES; lh++) {
+		bc_svd_dtor(&dd->bc[lh]);
+	}
 	survive_detach_config(dd->so->ctx, "max-error", &dd->max_error_obj);
 	survive_detach_config(dd->so->ctx, "max-cal-error", &dd->max_error_cal);
 	free(dd);
@@ -78,24 +81,26 @@ static PoserDataSVD *PoserDataSVD_new(SurviveObject *so) {
 	survive_attach_configf(so->ctx, "max-error", &rtn->max_error_obj);
 	survive_attach_configf(so->ctx, "max-cal-error", &rtn->max_error_cal);
 
-	bc_svd_bc_svd(&rtn->bc, so, survive_fill_m, (LinmathPoint3d *)so->sensor_locations, so->sensor_ct);
+	for (int lh = 0; lh < NUM_GEN2_LIGHTHOUSES; lh++) {
+		bc_svd_bc_svd(&rtn->bc[lh], so, survive_fill_m, (LinmathPoint3d *)so->sensor_locations, so->sensor_ct);
+	}
 
 	return rtn;
 }
 
-static SurvivePose solve_correspondence(PoserDataSVD *dd, bool cameraToWorld) {
+static SurvivePose solve_correspondence(PoserDataSVD *dd, bc_svd *bc, bool cameraToWorld) {
 	SurviveObject *so = dd->so;
 	SurvivePose rtn = {0};
 	SurviveContext *ctx = so->ctx;
 	// std::cerr << "Solving for " << cal_imagePoints.size() << " correspondents" << std::endl;
-	if (dd->bc.meas_cnt <= 6) {
-		SV_WARN("Can't solve for only %u points\n", (int)dd->bc.meas_cnt);
+	if (bc->meas_cnt <= 6) {
+		SV_WARN("Can't solve for only %u points\n", (int)bc->meas_cnt);
 		return rtn;
 	}
 
 	double r[3][3];
 
-	double err = bc_svd_compute_pose(&dd->bc, r, rtn.Pos);
+	double err = bc_svd_compute_pose(bc, r, rtn.Pos);
 	if (err < 0) {
 		return rtn;
 	}
@@ -105,7 +110,7 @@ static SurvivePose solve_correspondence(PoserDataSVD *dd, bool cameraToWorld) {
 
 	// Super degenerate inputs will project us basically right in the camera. Detect and reject
 	if (err > 1 || magnitude3d(rtn.Pos) < 0.25 || magnitude3d(rtn.Pos) > 25) {
-		SV_VERBOSE(200, "pose is degenerate %d %f %f", (int)dd->bc.meas_cnt, err, magnitude3d(rtn.Pos));
+		SV_VERBOSE(200, "pose is degenerate %d %f %f", (int)bc->meas_cnt, err, magnitude3d(rtn.Pos));
 		return rtn;
 	}
 
@@ -115,7 +120,7 @@ static SurvivePose solve_correspondence(PoserDataSVD *dd, bool cameraToWorld) {
 	FLT allowable_error = (cameraToWorld ? (dd->max_error_cal) : dd->max_error_obj) * 10.0;
 	if (allowable_error < err) {
 		if (cameraToWorld) {
-			SV_WARN("Camera reprojection error was too high: %f for %d meas", err, (int)dd->bc.meas_cnt);
+			SV_WARN("Camera reprojection error was too high: %f for %d meas", err, (int)bc->meas_cnt);
 		}
 		return rtn;
 	}
@@ -172,19 +177,20 @@ static int solve_fullscene(PoserDataSVD *dd, PoserDataFullScene *pdfs) {
 			continue;
 		}
 
-		bc_svd_reset_correspondences(&dd->bc);
+		bc_svd *bc = &dd->bc[lh];
+		bc_svd_reset_correspondences(bc);
 		for (size_t i = 0; i < so->sensor_ct; i++) {
 			FLT *_ang = pdfs->angles[i][lh];
-			bc_svd_add_correspondence(&dd->bc, i, (_ang[0]), (_ang[1]));
+			bc_svd_add_correspondence(bc, i, (_ang[0]), (_ang[1]));
 		}
 
 		SurviveContext *ctx = so->ctx;
-		if (dd->bc.meas_cnt <= 8) {
+		if (bc->meas_cnt <= 8) {
 			continue;
 		}
 
-		SV_INFO("Solving for %d correspondents on lh %d", (int)dd->bc.meas_cnt, lh);
-		lh2objects[lh] = solve_correspondence(dd, true);
+		SV_INFO("Solving for %d correspondents on lh %d", (int)bc->meas_cnt, lh);
+		lh2objects[lh] = solve_correspondence(dd, bc, true);
 	}
 
 	PoserData_lighthouse_poses_func(&pdfs->hdr, so, lh2objects, so->ctx->activeLighthouses, 0);
@@ -194,7 +200,6 @@ static int solve_fullscene(PoserDataSVD *dd, PoserDataFullScene *pdfs) {
 
 static void add_correspondences(SurviveObject *so, bc_svd *bc, uint32_t timecode, int lh) {
 	SurviveSensorActivations *scene = &so->activations;
-	bc_svd_reset_correspondences(bc);
 
 	bool isStationary = SurviveSensorActivations_stationary_time(scene) > so->timebase_hz;
 	survive_timecode sensor_time_window =
@@ -207,12 +212,12 @@ static void add_correspondences(SurviveObject *so, bc_svd *bc, uint32_t timecode
 				SurviveSensorActivations_isReadingValid(scene, sensor_time_window, timecode, sensor_idx, lh, axis);
 
 			if (isReadingValue) {
-				angles[axis] = scene->angles[sensor_idx][lh][axis];
+				angles[axis] = SurviveSensorActivations_entry(scene, sensor_idx, lh)->angles[axis];
 			}
 		}
 
 		survive_apply_bsd_calibration(so->ctx, lh, angles, angles);
-		bc_svd_add_correspondence(bc, sensor_idx, (angles[0]), (angles[1]));
+		bc_svd_update_correspondence(bc, sensor_idx, (angles[0]), (angles[1]));
 	}
 }
 
@@ -248,16 +253,17 @@ int PoserBaryCentricSVD(SurviveObject *so, PoserData *pd) {
 			for (int lh = 0; lh < so->ctx->activeLighthouses; lh++) {
 				if (so->ctx->bsd[lh].PositionSet) {
 					hasLighthousePoses = true;
-					add_correspondences(so, &dd->bc, lightData->hdr.timecode, lh);
+					bc_svd *bc = &dd->bc[lh];
+					add_correspondences(so, bc, lightData->hdr.timecode, lh);
 
-					if (dd->bc.meas_cnt >= dd->required_meas) {
+					if (bc->meas_cnt >= dd->required_meas) {
 
-						SurvivePose obj2Lh = solve_correspondence(dd, false);
+						SurvivePose obj2Lh = solve_correspondence(dd, bc, false);
 						if (quatmagnitude(obj2Lh.Rot) != 0) {
 							SurvivePose *lh2world = &so->ctx->bsd[lh].Pose;
 
 							ApplyPoseToPose(&objs2world[lh], lh2world, &obj2Lh);
-							meas[lh] = dd->bc.meas_cnt;
+							meas[lh] = bc->meas_cnt;
 						}
 					}
 				} else {
@@ -295,10 +301,11 @@ int PoserBaryCentricSVD(SurviveObject *so, PoserData *pd) {
 			int solved = 0;
 			for (int lh = 0; lh < ctx->activeLighthouses; lh++) {
 				if (!so->ctx->bsd[lh].PositionSet && so->ctx->bsd[lh].OOTXSet) {
-					add_correspondences(so, &dd->bc, lightData->hdr.timecode, lh);
+					bc_svd *bc = &dd->bc[lh];
+					add_correspondences(so, bc, lightData->hdr.timecode, lh);
 
-					if (dd->bc.meas_cnt >= dd->required_meas) {
-						SurvivePose lh2obj = solve_correspondence(dd, true);
+					if (bc->meas_cnt >= dd->required_meas) {
+						SurvivePose lh2obj = solve_correspondence(dd, bc, true);
 						if (quatmagnitude(lh2obj.Rot) != 0) {
 							solved++;
 							SV_VERBOSE(5,
@@ -310,7 +317,7 @@ int PoserBaryCentricSVD(SurviveObject *so, PoserData *pd) {
 								ApplyPoseToPose(&lh2world[lh], &obj2world, &lh2obj);
 						}
 					} else {
-						SV_WARN("Couldn't solve for LH %d with %d measures", lh, (int)dd->bc.meas_cnt);
+						SV_WARN("Couldn't solve for LH %d with %d measures", lh, (int)bc->meas_cnt);
 					}
 				}
 			}
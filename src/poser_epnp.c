@@ -108,7 +108,7 @@ static void add_correspondences(SurviveObject *so, epnp *pnp, SurviveSensorActiv
 	for (size_t sensor_idx = 0; sensor_idx < so->sensor_ct; sensor_idx++) {
 		if (SurviveSensorActivations_isPairValid(scene, SurviveSensorActivations_default_tolerance * 4, timecode,
 												 sensor_idx, lh)) {
-			FLT *_angles = scene->angles[sensor_idx][lh];
+			const FLT *_angles = SurviveSensorActivations_entry(scene, sensor_idx, lh)->angles;
 			FLT angles[2];
 			survive_apply_bsd_calibration(so->ctx, lh, _angles, angles);
 
@@ -140,9 +140,7 @@ int PoserEPNP(SurviveObject *so, PoserData *pd) {
 				epnp_set_maximum_number_of_correspondences(&pnp, so->sensor_ct);
 
 				add_correspondences(so, &pnp, scene, pd->timecode, lh);
-				static int required_meas = -1;
-				if (required_meas == -1)
-					required_meas = survive_configi(so->ctx, "epnp-required-meas", SC_GET, 5);
+				int required_meas = survive_configi(so->ctx, "epnp-required-meas", SC_GET, 5);
 
 				if (pnp.number_of_correspondences >= required_meas) {
 
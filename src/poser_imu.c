@@ -17,6 +17,9 @@ int PoserIMU(SurviveObject *so, PoserData *pd) {
 	SurviveContext *ctx = so->ctx;
 	struct PoserIMUData_t *dd = so->PoserFnData;
 
+	if (pt == POSERDATA_DISASSOCIATE && dd == 0)
+		return 0;
+
 	if (!dd) {
 		so->PoserFnData = dd = SV_CALLOC(1, sizeof(struct PoserIMUData_t));
 		survive_imu_tracker_init(&dd->tracker, so);
@@ -28,7 +31,7 @@ int PoserIMU(SurviveObject *so, PoserData *pd) {
 			FLT difference = (SurviveSensorActivations_difference(&so->activations, &dd->previous_sweep));
 			if (pdl->lh == 0) {
 				if (pdl->sensor_id == -3 &&
-                    memcmp(&so->activations, &dd->previous_sweep, sizeof(so->activations)) != 0 && !isnan(difference)) {
+                    so->activations.last_light != dd->previous_sweep.last_light && !isnan(difference)) {
                     //SV_INFO("Light diff %.8f %u", difference * 10e5, pdl->timecode % 1600000);
                     if(difference * 10e5 < .01) {
                         const FLT R[] = {difference * 10e6, 1000000000000.};
@@ -36,7 +39,7 @@ int PoserIMU(SurviveObject *so, PoserData *pd) {
 						survive_imu_tracker_integrate_velocity(&dd->tracker, pdl->hdr.timecode, R, &v);
 					}
                 }
-                dd->previous_sweep = so->activations;
+                SurviveSensorActivations_copy(&dd->previous_sweep, &so->activations);
             }
 			break;
 		}
@@ -76,6 +79,12 @@ int PoserIMU(SurviveObject *so, PoserData *pd) {
 		// SV_GENERAL_ERROR("IMU drift");
 		return 0;
 	}
+	case POSERDATA_DISASSOCIATE: {
+		SurviveSensorActivations_dtor(&dd->previous_sweep);
+		free(dd);
+		so->PoserFnData = 0;
+		return 0;
+	}
 	}
 	return -1;
 }
@@ -5,6 +5,7 @@
 #include "mpfit/mpfit.h"
 #include "poser.h"
 #include "survive_imu.h"
+#include "survive_poser_worker.h"
 #include <survive.h>
 
 #include "assert.h"
@@ -36,8 +37,12 @@ STATIC_CONFIG_ITEM(SENSOR_VARIANCE, "sensor-variance", 'f', "Base variance for e
 STATIC_CONFIG_ITEM(DISABLE_LIGHTHOUSE, "disable-lighthouse", 'i', "Disable given lighthouse from tracking", -1)
 STATIC_CONFIG_ITEM(RUN_EVERY_N_SYNCS, "syncs-per-run", 'i', "Number of sync pulses before running optimizer", 1)
 STATIC_CONFIG_ITEM(RUN_POSER_ASYNC, "poser-async", 'i', "Run the poser in it's own thread", 0)
+STATIC_CONFIG_ITEM(POSER_ASYNC_DEADLINE, "poser-async-deadline", 'f',
+				   "Drop async solves that wait longer than this many seconds for a thread. 0 disables.", 0.)
 
 STATIC_CONFIG_ITEM(PRECISE_POSE, "precise", 'i', "Always calculate precise pose", 0)
+STATIC_CONFIG_ITEM(LH_SOLVE_STARTS, "mpfit-lh-starts", 'i',
+				   "Number of differently seeded lighthouse solves to run in parallel during calibration", 4)
 
 typedef struct MPFITStats {
 	int meas_failures;
@@ -50,13 +55,6 @@ typedef struct MPFITStats {
 	int dropped_data;
 } MPFITStats;
 
-typedef struct MPFITGlobalData {
-	size_t instances;
-	MPFITStats stats;
-} MPFITGlobalData;
-
-static MPFITGlobalData g;
-
 typedef struct MPFITData {
 	GeneralOptimizerData opt;
 
@@ -69,6 +67,7 @@ typedef struct MPFITData {
   int syncs_per_run;
   int run_async;
   int syncs_per_run_cnt;
+  int lh_solve_starts;
 
   FLT sensor_variance;
   FLT sensor_variance_per_second;
@@ -80,6 +79,9 @@ typedef struct MPFITData {
 
   const char *serialize_prefix;
   MPFITStats stats;
+  // Totals of the instances in this context that went away before this one; the last one prints them
+  MPFITStats departed_stats;
+  int failure_count;
 
   struct survive_async_optimizer *async_optimizer;
 } MPFITData;
@@ -95,6 +97,15 @@ static size_t remove_lh_from_meas(survive_optimizer_measurement *meas, size_t me
 	return rtn;
 }
 
+static int compare_readings_by_lh(const void *_a, const void *_b) {
+	const SurviveSensorActivationsReading *a = _a, *b = _b;
+	if (a->lh != b->lh)
+		return a->lh - b->lh;
+	if (a->sensor_idx != b->sensor_idx)
+		return a->sensor_idx - b->sensor_idx;
+	return a->axis - b->axis;
+}
+
 static size_t construct_input_from_scene(const MPFITData *d, size_t timecode, const SurviveSensorActivations *scene,
 										 size_t *meas_for_lhs, survive_optimizer_measurement *meas) {
 	size_t rtn = 0;
@@ -105,7 +116,20 @@ static size_t construct_input_from_scene(const MPFITData *d, size_t timecode, co
 	survive_timecode sensor_time_window = isStationary ? (so->timebase_hz) : d->sensor_time_window;
 
 	const bool force_pair = false;
+
+	// Only look at the live readings, grouped by lighthouse in the same order the full sweep used to visit them
+	SurviveSensorActivationsReading readings[SENSORS_PER_OBJECT * NUM_GEN2_LIGHTHOUSES * 2];
+	size_t reading_cnt = SurviveSensorActivations_fresh_readings(scene, sensor_time_window, timecode, readings,
+																 sizeof(readings) / sizeof(readings[0]));
+	qsort(readings, reading_cnt, sizeof(readings[0]), compare_readings_by_lh);
+
+	size_t reading_idx = 0;
 	for (uint8_t lh = 0; lh < ctx->activeLighthouses; lh++) {
+		size_t lh_begin = reading_idx;
+		while (reading_idx < reading_cnt && readings[reading_idx].lh == lh) {
+			reading_idx++;
+		}
+
 		if (d->disable_lighthouse == lh) {
 			continue;
 		}
@@ -122,30 +146,30 @@ static size_t construct_input_from_scene(const MPFITData *d, size_t timecode, co
 		size_t candidate_meas = 10;
 
 		size_t meas_for_lh = 0;
-		for (uint8_t sensor = 0; sensor < so->sensor_ct; sensor++) {
-			for (uint8_t axis = 0; axis < 2; axis++) {
-				bool isReadingValue =
-					SurviveSensorActivations_isReadingValid(scene, sensor_time_window, timecode, sensor, lh, axis);
-				if (force_pair) {
-					isReadingValue =
-						SurviveSensorActivations_isPairValid(scene, sensor_time_window, timecode, sensor, lh);
-				}
-				if (isReadingValue) {
-					const double *a = scene->angles[sensor][lh];
-					meas->object = 0;
-					meas->axis = axis;
-					meas->value = a[axis];
-					meas->sensor_idx = sensor;
-					meas->lh = lh;
-					survive_timecode diff = survive_timecode_difference(timecode, scene->timecode[sensor][lh][axis]);
-					meas->variance =
-						d->sensor_variance + diff * d->sensor_variance_per_second / (double)so->timebase_hz;
-					// SV_INFO("Adding meas %d %d %d %f", lh, sensor, axis, meas->value);
-					meas++;
-					rtn++;
-					meas_for_lh++;
-				}
+		for (size_t i = lh_begin; i < reading_idx; i++) {
+			uint8_t sensor = readings[i].sensor_idx;
+			uint8_t axis = readings[i].axis;
+			if (sensor >= so->sensor_ct) {
+				continue;
 			}
+
+			if (force_pair &&
+				!SurviveSensorActivations_isPairValid(scene, sensor_time_window, timecode, sensor, lh)) {
+				continue;
+			}
+
+			const SurviveSensorActivationsEntry *entry = SurviveSensorActivations_entry(scene, sensor, lh);
+			meas->object = 0;
+			meas->axis = axis;
+			meas->value = entry->angles[axis];
+			meas->sensor_idx = sensor;
+			meas->lh = lh;
+			survive_timecode diff = survive_timecode_difference(timecode, entry->timecode[axis]);
+			meas->variance = d->sensor_variance + diff * d->sensor_variance_per_second / (double)so->timebase_hz;
+			// SV_INFO("Adding meas %d %d %d %f", lh, sensor, axis, meas->value);
+			meas++;
+			rtn++;
+			meas_for_lh++;
 		}
 		if (meas_for_lhs) {
 			meas_for_lhs[lh] = meas_for_lh;
@@ -169,7 +193,6 @@ static bool find_cameras_invalid_starting_condition(MPFITData *d, size_t meas_si
 }
 
 static bool invalid_starting_condition(MPFITData *d, size_t meas_size, const size_t *meas_for_lhs) {
-	static int failure_count = 500;
 	struct SurviveObject *so = d->opt.so;
 
 	size_t meas_size_known_lh = 0;
@@ -183,17 +206,17 @@ static bool invalid_starting_condition(MPFITData *d, size_t meas_size, const siz
 	}
 
 	if (meas_size_known_lh < d->required_meas) {
-		if (failure_count++ == 500) {
+		if (d->failure_count++ == 500) {
 			SurviveContext *ctx = so->ctx;
 			SV_INFO("Can't solve for position with just %u measurements", (unsigned int)meas_size_known_lh);
-			failure_count = 0;
+			d->failure_count = 0;
 		}
 		if (meas_size_known_lh < d->required_meas) {
 			d->stats.meas_failures++;
 		}
 		return true;
 	}
-	failure_count = 0;
+	d->failure_count = 0;
 	return false;
 }
 
@@ -516,6 +539,83 @@ static FLT run_mpfit_find_3d_structure(MPFITData *d, PoserDataLight *pdl, Surviv
 	return handle_optimizer_results(&mpfitctx, res, &result, &user_data, out);
 }
 
+/**
+ * A single seed for the lighthouse solve can land in the wrong basin -- most often with a lighthouse mirrored around
+ * the object or rolled upside down -- and then calibration has to start over with a new scene. So the seed is
+ * expanded into several starting points which are solved in parallel, each in its own optimizer:
+ *
+ *  0: The seed as is
+ *  1: Every lighthouse rotated 180 degrees around the vertical axis through the object
+ *  2: Every lighthouse rolled 180 degrees around its own optical axis
+ *  3+: Small deterministic perturbations of the seed
+ */
+typedef struct mpfit_lh_start {
+	survive_optimizer opt;
+	mp_result result;
+	int res;
+	og_thread_t thread;
+} mpfit_lh_start;
+
+static void *mpfit_lh_start_thread(void *user) {
+	mpfit_lh_start *start = user;
+	start->res = survive_optimizer_run(&start->opt, &start->result);
+	return 0;
+}
+
+static FLT mpfit_lh_start_rand(uint32_t *state) {
+	*state = *state * 1664525u + 1013904223u;
+	return (*state >> 8) / (FLT)(1u << 24) * 2. - 1.;
+}
+
+static void mpfit_lh_start_seed(survive_optimizer *opt, int idx, const size_t *meas_for_lhs) {
+	const LinmathQuat half_turn = {0, 0, 0, 1};
+	const SurvivePose *obj = survive_optimizer_get_pose(opt);
+	SurvivePose *cameras = survive_optimizer_get_camera(opt);
+	uint32_t rand_state = idx;
+
+	for (int lh = 0; lh < opt->cameraLength; lh++) {
+		if (meas_for_lhs[lh] == 0 || quatiszero(cameras[lh].Rot))
+			continue;
+
+		SurvivePose lh2world = InvertPoseRtn(&cameras[lh]);
+		LinmathVec3d fromObj;
+		sub3d(fromObj, lh2world.Pos, obj->Pos);
+
+		LinmathQuat around_obj = {1, 0, 0, 0};
+		if (idx == 1) {
+			quatcopy(around_obj, half_turn);
+		} else if (idx == 2) {
+			quatrotateabout(lh2world.Rot, lh2world.Rot, half_turn);
+		} else if (idx > 2) {
+			LinmathAxisAngle perturb = {.3 * mpfit_lh_start_rand(&rand_state), .3 * mpfit_lh_start_rand(&rand_state),
+										.3 * mpfit_lh_start_rand(&rand_state)};
+			quatfromaxisangle(around_obj, perturb, norm3d(perturb));
+			scale3d(fromObj, fromObj, 1 + .2 * mpfit_lh_start_rand(&rand_state));
+		}
+
+		quatrotatevector(fromObj, around_obj, fromObj);
+		add3d(lh2world.Pos, obj->Pos, fromObj);
+		quatrotateabout(lh2world.Rot, around_obj, lh2world.Rot);
+
+		cameras[lh] = InvertPoseRtn(&lh2world);
+	}
+}
+
+static void mpfit_lh_start_init(mpfit_lh_start *start, const survive_optimizer *seed) {
+	start->opt = *seed;
+	start->opt.parameters = 0;
+	start->opt.parameters_info = 0;
+	start->opt.measurements = 0;
+	SURVIVE_OPTIMIZER_SETUP_HEAP_BUFFERS(start->opt);
+
+	size_t par_count = survive_optimizer_get_parameters_count(seed);
+	size_t sensor_cnt = seed->so ? seed->so->sensor_ct : 32;
+	memcpy(start->opt.parameters, seed->parameters, par_count * sizeof(FLT));
+	memcpy(start->opt.parameters_info, seed->parameters_info, par_count * sizeof(struct mp_par_struct));
+	memcpy(start->opt.measurements, seed->measurements,
+		   seed->poseLength * sizeof(survive_optimizer_measurement) * 2 * sensor_cnt * NUM_GEN2_LIGHTHOUSES);
+}
+
 static FLT run_mpfit_find_cameras(MPFITData *d, PoserDataFullScene *pdfs) {
 	SurviveObject *so = d->opt.so;
 
@@ -539,6 +639,7 @@ static FLT run_mpfit_find_cameras(MPFITData *d, PoserDataFullScene *pdfs) {
 
 	size_t meas_for_lhs[NUM_GEN2_LIGHTHOUSES] = {0};
 	size_t meas_size = construct_input_from_scene(d, 0, &activations, meas_for_lhs, mpfitctx.measurements);
+	SurviveSensorActivations_dtor(&activations);
 
 	if (mpfitctx.current_bias > 0) {
 		meas_size += 7;
@@ -566,10 +667,15 @@ static FLT run_mpfit_find_cameras(MPFITData *d, PoserDataFullScene *pdfs) {
 			pdfs->hdr = hdr;
 		} else {
 			SV_INFO("Not using a seed poser for MPFIT; results will likely be way off");
+			// Other solves may be reading ctx->bsd; writers need the context lock and the bsd lock
+			survive_poser_output_begin(so);
+			survive_get_bsd_lock(ctx);
 			for (int i = 0; i < so->ctx->activeLighthouses; i++) {
 				so->ctx->bsd[i].Pose = (SurvivePose){0};
 				so->ctx->bsd[i].Pose.Rot[0] = 1.;
 			}
+			survive_release_bsd_lock(ctx);
+			survive_poser_output_end(so);
 		}
 	}
 
@@ -581,16 +687,52 @@ static FLT run_mpfit_find_cameras(MPFITData *d, PoserDataFullScene *pdfs) {
 		}
 	}
 
-	mp_result result = {0};
-
 	mpfitctx.initialPose.Rot[0] = 1;
 
 	serialize_mpfit(d, &mpfitctx);
-	int res = survive_optimizer_run(&mpfitctx, &result);
+
+	int start_cnt = d->lh_solve_starts > 1 ? d->lh_solve_starts : 1;
+	mpfit_lh_start *starts = SV_CALLOC(start_cnt, sizeof(mpfit_lh_start));
+	starts[0].opt = mpfitctx;
+	for (int i = 1; i < start_cnt; i++) {
+		mpfit_lh_start_init(&starts[i], &mpfitctx);
+		mpfit_lh_start_seed(&starts[i].opt, i, meas_for_lhs);
+		starts[i].thread = OGCreateThread(mpfit_lh_start_thread, &starts[i]);
+	}
+	mpfit_lh_start_thread(&starts[0]);
+
+	int best = -1;
+	for (int i = 0; i < start_cnt; i++) {
+		if (i > 0)
+			OGJoinThread(starts[i].thread);
+
+		if (starts[i].res <= 0 || (start_cnt > 1 && !survive_optimizer_cameras_face_object(&starts[i].opt, meas_for_lhs)))
+			continue;
+		if (best == -1 || starts[i].result.bestnorm < starts[best].result.bestnorm)
+			best = i;
+	}
+
+	SurviveContext *ctx = so->ctx;
+	// The other starts only get to replace the seed's solution; a converged seed is kept just as it is without them
+	if (best == -1 && starts[0].res > 0) {
+		SV_WARN("No lighthouse solve puts the object in front of every lighthouse; keeping the seed's solution");
+		best = 0;
+	}
+	if (best > 0) {
+		SV_INFO("Lighthouse solve from start %d of %d beat the seed (%f vs %f)", best, start_cnt,
+				starts[best].result.bestnorm, starts[0].res > 0 ? starts[0].result.bestnorm : -1.);
+		memcpy(cameras, survive_optimizer_get_camera(&starts[best].opt), sizeof(SurvivePose) * mpfitctx.cameraLength);
+	}
+
+	mp_result result = starts[best > 0 ? best : 0].result;
+	int res = best >= 0 ? starts[best].res : starts[0].res;
+	for (int i = 1; i < start_cnt; i++) {
+		SURVIVE_OPTIMIZER_CLEANUP_HEAP_BUFFERS(starts[i].opt);
+	}
+	free(starts);
 
 	double rtn = -1;
 	bool status_failure = res <= 0;
-	SurviveContext *ctx = so->ctx;
 
 	if (!status_failure) {
 		general_optimizer_data_record_success(&d->opt, result.bestnorm);
@@ -633,12 +775,38 @@ static inline void print_stats(SurviveContext *ctx, MPFITStats *stats) {
 	}
 }
 
+static void add_stats(MPFITStats *dst, const MPFITStats *src) {
+	dst->dropped_data += src->dropped_data;
+	dst->total_fev += src->total_fev;
+	dst->total_runs += src->total_runs;
+	dst->sum_errors += src->sum_errors;
+	dst->meas_failures += src->meas_failures;
+	dst->total_iterations += src->total_iterations;
+	dst->sum_origerrors += src->sum_origerrors;
+	for (int i = 0; i < sizeof(dst->status_cnts) / sizeof(int); i++) {
+		dst->status_cnts[i] += src->status_cnts[i];
+	}
+}
+
+int PoserMPFIT(SurviveObject *so, PoserData *pd);
+
+// Another object in the same context still running this poser, if any
+static MPFITData *other_instance(SurviveObject *so) {
+	for (int i = 0; i < so->ctx->objs_ct; i++) {
+		SurviveObject *other = so->ctx->objs[i];
+		if (other != so && other->PoserFn == PoserMPFIT && other->PoserFnData) {
+			return other->PoserFnData;
+		}
+	}
+	return 0;
+}
+
 int PoserMPFIT(SurviveObject *so, PoserData *pd) {
 	SurviveContext *ctx = so->ctx;
 	if (so->PoserFnData == 0) {
 		so->PoserFnData = SV_CALLOC(1, sizeof(MPFITData));
-		g.instances++;
 		MPFITData *d = so->PoserFnData;
+		d->failure_count = 500;
 
 		general_optimizer_data_init(&d->opt, so);
 		survive_imu_tracker_init(&d->tracker, so);
@@ -649,8 +817,10 @@ int PoserMPFIT(SurviveObject *so, PoserData *pd) {
 		d->required_meas = survive_configi(ctx, "required-meas", SC_GET, 8);
 		d->syncs_per_run = survive_configi(ctx, "syncs-per-run", SC_GET, 1);
 		d->run_async = survive_configi(ctx, RUN_POSER_ASYNC_TAG, SC_GET, 0);
+		d->lh_solve_starts = survive_configi(ctx, LH_SOLVE_STARTS_TAG, SC_GET, 0);
 		if (d->run_async) {
-			d->async_optimizer = survive_async_init(async_optimizer_cb);
+			d->async_optimizer = survive_async_init(ctx, async_optimizer_cb);
+			d->async_optimizer->deadline = survive_configf(ctx, POSER_ASYNC_DEADLINE_TAG, SC_GET, 0);
 		}
 		d->sensor_time_window = survive_configi(ctx, "time-window", SC_GET, SurviveSensorActivations_default_tolerance);
 		d->use_jacobian_function_obj = survive_configi(ctx, "use-jacobian-function", SC_GET, 1);
@@ -716,28 +886,30 @@ int PoserMPFIT(SurviveObject *so, PoserData *pd) {
 			print_stats(ctx, &d->stats);
 
 			if (d->async_optimizer) {
-				SV_INFO("\tjobs submitted     %lu", d->async_optimizer->submitted);
-				SV_INFO("\tjobs completed     %lu", d->async_optimizer->completed);
+				const survive_async_optimizer_stats *stats = &d->async_optimizer->stats;
+				size_t started = stats->completed + stats->expired;
+				SV_INFO("\tjobs submitted     %lu", stats->submitted);
+				SV_INFO("\tjobs completed     %lu", stats->completed);
+				SV_INFO("\tjobs coalesced     %lu", stats->coalesced);
+				SV_INFO("\tjobs expired       %lu", stats->expired);
+				SV_INFO("\tavg queue depth    %f", stats->queue_depth_sum / (FLT)stats->submitted);
+				SV_INFO("\tmax queue depth    %lu", stats->queue_depth_max);
+				SV_INFO("\tavg wait time      %fms", 1000. * stats->wait_time_sum / started);
+				SV_INFO("\tmax wait time      %fms", 1000. * stats->wait_time_max);
+				SV_INFO("\tavg solve time     %fms", 1000. * stats->solve_time_sum / stats->completed);
+				SV_INFO("\tmax solve time     %fms", 1000. * stats->solve_time_max);
 			}
 		}
 
-		g.stats.dropped_data += d->stats.dropped_data;
-		g.stats.total_fev += d->stats.total_fev;
-		g.stats.total_runs += d->stats.total_runs;
-		g.stats.sum_errors += d->stats.sum_errors;
-		g.stats.meas_failures += d->stats.meas_failures;
-		g.stats.total_iterations += d->stats.total_iterations;
-		g.stats.sum_origerrors += d->stats.sum_origerrors;
-		for (int i = 0; i < sizeof(d->stats.status_cnts) / sizeof(int); i++) {
-			g.stats.status_cnts[i] += d->stats.status_cnts[i];
-		}
+		MPFITStats *totals = &d->departed_stats;
+		add_stats(totals, &d->stats);
 
-		g.instances--;
-		if (ctx->log_level >= 1) {
-			if (g.instances == 0) {
-				SV_INFO("MPFIT overall stats:");
-				print_stats(ctx, &g.stats);
-			}
+		MPFITData *survivor = other_instance(so);
+		if (survivor) {
+			add_stats(&survivor->departed_stats, totals);
+		} else if (ctx->log_level >= 1) {
+			SV_INFO("MPFIT overall stats:");
+			print_stats(ctx, totals);
 		}
 		general_optimizer_data_dtor(&d->opt);
 		survive_imu_tracker_free(&d->tracker);
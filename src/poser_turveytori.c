@@ -14,6 +14,7 @@
 #else
 #include <malloc.h> //for alloca
 #include <survive_reproject.h>
+#include "survive_poser_worker.h"
 
 #endif
 
@@ -1633,7 +1634,9 @@ static void QuickPose(SurviveObject *so, PoserData *pd, SurvivePose *additionalT
 
 			//printf("P&O: [% 08.8f,% 08.8f,% 08.8f] [% 08.8f,% 08.8f,% 08.8f,% 08.8f]\n", pos[0], pos[1], pos[2], quat[0], quat[1], quat[2], quat[3]);
 			if (so->ctx->poseproc) {
+				survive_poser_output_begin(so);
 				so->ctx->poseproc(so, lh, &pose);
+				survive_poser_output_end(so);
 			}
 
 			if (ttDebug) printf("!\n");
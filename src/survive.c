@@ -14,7 +14,13 @@
 #include "os_generic.h"
 #include "survive_config.h"
 #include "survive_default_devices.h"
+#include "survive_latency.h"
+#include "survive_async_optimizer.h"
+#include "survive_optimizer.h"
+#include "survive_parallel.h"
+#include "survive_atomic.h"
 #include "survive_playback.h"
+#include "survive_poser_worker.h"
 
 #include <stdarg.h>
 
@@ -37,6 +43,8 @@ STATIC_CONFIG_ITEM(CONFIG_F_OOTX, "force-ootx", 'i', "Forces ootx capture even i
 STATIC_CONFIG_ITEM(CONFIG_LIGHTHOUSE_COUNT, "lighthousecount", 'i', "How many lighthouses to look for.", 0)
 STATIC_CONFIG_ITEM(LIGHTHOUSE_GEN, "lighthouse-gen", 'i',
 				   "Which lighthouse gen to use -- 1 for LH1, 2 for LH2, 0 (default) for auto-detect", 0)
+STATIC_CONFIG_ITEM(LATENCY_TRACE, "latency-trace", 'i',
+				   "Track how old data is at each processing stage; reported on close and per object", 0)
 
 #ifdef WIN32
 #define RUNTIME_SYMNUM
@@ -224,8 +232,34 @@ SURVIVE_EXPORT int8_t survive_get_bsd_idx(SurviveContext *ctx, survive_channel c
 
 struct SurviveContext_private {
 	og_sema_t poll_sema;
+
+	// Reader/writer lock over ctx->bsd, built from a mutex and a condition variable. Waiting writers hold off new
+	// readers, so a driver thread updating a lighthouse never queues behind a stream of solves.
+	og_mutex_t bsd_lock;
+	og_cv_t bsd_changed;
+	uint32_t bsd_readers;
+	uint32_t bsd_writers_waiting;
+	bool bsd_writing;
 	survive_run_time_fn runTimeFn;
 	void *runTimeFnUser;
+
+	// Guards creating either pool, and reading the optimizer settings
+	og_mutex_t optimizer_pool_lock;
+	survive_optimizer_pool *optimizer_pool;
+	survive_parallel_pool *parallel_pool;
+	survive_optimizer_settings *optimizer_settings;
+	survive_poser_pool *poser_pool;
+
+	// Absolute time survive_run_time counts from, unless a driver installed its own clock
+	double start_time_s;
+
+	bool latency_trace;
+	// Arrival time of the packet being processed, 0 outside of a packet; guarded by the context lock
+	double packet_arrival_time;
+
+	og_mutex_t output_listener_lock;
+	SurviveOutputListener *output_listeners;
+	uint32_t output_listener_cnt;
 };
 
 void survive_get_ctx_lock(SurviveContext *ctx) {
@@ -240,6 +274,140 @@ void survive_release_ctx_lock(SurviveContext *ctx) {
 	OGUnlockSema(pctx->poll_sema);
 	// SV_VERBOSE(100, "Signaled on %lx", pthread_self());
 }
+void survive_get_bsd_lock(SurviveContext *ctx) {
+	struct SurviveContext_private *pctx = ctx->private_members;
+	OGLockMutex(pctx->bsd_lock);
+	pctx->bsd_writers_waiting++;
+	while (pctx->bsd_writing || pctx->bsd_readers) {
+		OGWaitCond(pctx->bsd_changed, pctx->bsd_lock);
+	}
+	pctx->bsd_writers_waiting--;
+	pctx->bsd_writing = true;
+	OGUnlockMutex(pctx->bsd_lock);
+}
+void survive_release_bsd_lock(SurviveContext *ctx) {
+	struct SurviveContext_private *pctx = ctx->private_members;
+	OGLockMutex(pctx->bsd_lock);
+	pctx->bsd_writing = false;
+	OGBroadcastCond(pctx->bsd_changed);
+	OGUnlockMutex(pctx->bsd_lock);
+}
+void survive_get_bsd_read_lock(SurviveContext *ctx) {
+	struct SurviveContext_private *pctx = ctx->private_members;
+	OGLockMutex(pctx->bsd_lock);
+	while (pctx->bsd_writing || pctx->bsd_writers_waiting) {
+		OGWaitCond(pctx->bsd_changed, pctx->bsd_lock);
+	}
+	pctx->bsd_readers++;
+	OGUnlockMutex(pctx->bsd_lock);
+}
+void survive_release_bsd_read_lock(SurviveContext *ctx) {
+	struct SurviveContext_private *pctx = ctx->private_members;
+	OGLockMutex(pctx->bsd_lock);
+	if (--pctx->bsd_readers == 0) {
+		OGBroadcastCond(pctx->bsd_changed);
+	}
+	OGUnlockMutex(pctx->bsd_lock);
+}
+survive_optimizer_pool *survive_get_optimizer_pool(SurviveContext *ctx) {
+	struct SurviveContext_private *pctx = ctx->private_members;
+	OGLockMutex(pctx->optimizer_pool_lock);
+	if (pctx->optimizer_pool == 0) {
+		pctx->optimizer_pool = survive_optimizer_pool_create(ctx, 0);
+	}
+	OGUnlockMutex(pctx->optimizer_pool_lock);
+	return pctx->optimizer_pool;
+}
+survive_parallel_pool *survive_get_parallel_pool(SurviveContext *ctx) {
+	struct SurviveContext_private *pctx = ctx->private_members;
+	OGLockMutex(pctx->optimizer_pool_lock);
+	if (pctx->parallel_pool == 0) {
+		pctx->parallel_pool = survive_parallel_pool_create(ctx, 0);
+	}
+	OGUnlockMutex(pctx->optimizer_pool_lock);
+	return pctx->parallel_pool;
+}
+const survive_optimizer_settings *survive_get_optimizer_settings(SurviveContext *ctx) {
+	struct SurviveContext_private *pctx = ctx->private_members;
+	OGLockMutex(pctx->optimizer_pool_lock);
+	if (pctx->optimizer_settings == 0) {
+		survive_optimizer_settings *settings = SV_NEW(survive_optimizer_settings);
+		survive_optimizer_settings_init(ctx, settings);
+		pctx->optimizer_settings = settings;
+	}
+	OGUnlockMutex(pctx->optimizer_pool_lock);
+	return pctx->optimizer_settings;
+}
+
+bool survive_latency_enabled(const SurviveContext *ctx) {
+	const struct SurviveContext_private *pctx = ctx->private_members;
+	return pctx->latency_trace;
+}
+void survive_latency_packet_begin(SurviveContext *ctx, double arrival_time) {
+	struct SurviveContext_private *pctx = ctx->private_members;
+	pctx->packet_arrival_time = arrival_time;
+}
+void survive_latency_packet_end(SurviveContext *ctx) {
+	struct SurviveContext_private *pctx = ctx->private_members;
+	pctx->packet_arrival_time = 0;
+}
+double survive_latency_packet_arrival(const SurviveContext *ctx) {
+	const struct SurviveContext_private *pctx = ctx->private_members;
+	return pctx->packet_arrival_time;
+}
+
+void survive_add_output_listener(SurviveContext *ctx, const SurviveOutputListener *listener) {
+	struct SurviveContext_private *pctx = ctx->private_members;
+	OGLockMutex(pctx->output_listener_lock);
+	pctx->output_listeners =
+		SV_REALLOC(pctx->output_listeners, sizeof(SurviveOutputListener) * (pctx->output_listener_cnt + 1));
+	pctx->output_listeners[pctx->output_listener_cnt] = *listener;
+	survive_atomic_store_u32(&pctx->output_listener_cnt, pctx->output_listener_cnt + 1);
+	OGUnlockMutex(pctx->output_listener_lock);
+}
+void survive_remove_output_listener(SurviveContext *ctx, void *user) {
+	struct SurviveContext_private *pctx = ctx->private_members;
+	OGLockMutex(pctx->output_listener_lock);
+	for (uint32_t i = 0; i < pctx->output_listener_cnt; i++) {
+		if (pctx->output_listeners[i].user == user) {
+			pctx->output_listeners[i--] = pctx->output_listeners[pctx->output_listener_cnt - 1];
+			survive_atomic_store_u32(&pctx->output_listener_cnt, pctx->output_listener_cnt - 1);
+		}
+	}
+	OGUnlockMutex(pctx->output_listener_lock);
+}
+
+// The lock is only taken when someone is listening, so the common case costs a load
+#define FOR_EACH_OUTPUT_LISTENER(ctx, fn, ...)                                                                         \
+	struct SurviveContext_private *pctx = (ctx)->private_members;                                                      \
+	if (survive_atomic_load_u32(&pctx->output_listener_cnt) == 0)                                                      \
+		return;                                                                                                        \
+	OGLockMutex(pctx->output_listener_lock);                                                                           \
+	for (uint32_t i = 0; i < pctx->output_listener_cnt; i++) {                                                         \
+		const SurviveOutputListener *l = &pctx->output_listeners[i];                                                   \
+		if (l->fn)                                                                                                     \
+			l->fn(l->user, __VA_ARGS__);                                                                               \
+	}                                                                                                                  \
+	OGUnlockMutex(pctx->output_listener_lock);
+
+void survive_output_listeners_pose(SurviveObject *so, survive_timecode timecode, const SurvivePose *pose) {
+	FOR_EACH_OUTPUT_LISTENER(so->ctx, pose, so, timecode, pose);
+}
+void survive_output_listeners_velocity(SurviveObject *so, survive_timecode timecode, const SurviveVelocity *velocity) {
+	FOR_EACH_OUTPUT_LISTENER(so->ctx, velocity, so, timecode, velocity);
+}
+void survive_output_listeners_button(SurviveObject *so, uint8_t eventType, uint8_t buttonId, uint8_t axis1Id,
+									 uint16_t axis1Val, uint8_t axis2Id, uint16_t axis2Val) {
+	FOR_EACH_OUTPUT_LISTENER(so->ctx, button, so, eventType, buttonId, axis1Id, axis1Val, axis2Id, axis2Val);
+}
+void survive_output_listeners_imu(SurviveObject *so, int mask, const FLT *accelgyromag, survive_timecode timecode,
+								  int id) {
+	FOR_EACH_OUTPUT_LISTENER(so->ctx, imu, so, mask, accelgyromag, timecode, id);
+}
+void survive_output_listeners_angle(SurviveObject *so, int sensor_id, survive_timecode timecode, int lh, int plane,
+									FLT length, FLT angle) {
+	FOR_EACH_OUTPUT_LISTENER(so->ctx, angle, so, sensor_id, timecode, lh, plane, length, angle);
+}
 
 SurviveContext *survive_init_internal(int argc, char *const *argv, void *userData, log_process_func log_func) {
 	int i;
@@ -259,7 +427,12 @@ SurviveContext *survive_init_internal(int argc, char *const *argv, void *userDat
 
 	struct SurviveContext_private *pctx = ctx->private_members = SV_CALLOC(1, sizeof(struct SurviveContext_private));
 
+	pctx->start_time_s = OGGetAbsoluteTime();
 	pctx->poll_sema = OGCreateSema();
+	pctx->bsd_lock = OGCreateMutex();
+	pctx->bsd_changed = OGCreateConditionVariable();
+	pctx->optimizer_pool_lock = OGCreateMutex();
+	pctx->output_listener_lock = OGCreateMutex();
 
 	for (int i = 0; i < NUM_GEN2_LIGHTHOUSES; i++) {
 		ctx->bsd[i].mode = -1;
@@ -391,6 +564,8 @@ SurviveContext *survive_init_internal(int argc, char *const *argv, void *userDat
 	config_read(ctx, init_config);
 	ctx->activeLighthouses = 0;
 
+	pctx->latency_trace = survive_configi(ctx, LATENCY_TRACE_TAG, SC_GET, 0);
+
 	for (int i = 0; i < NUM_GEN2_LIGHTHOUSES; i++) {
 		if (config_read_lighthouse(ctx->lh_config, &(ctx->bsd[i]), i)) {
 			if (ctx->bsd[i].mode >= 0 && ctx->bsd[i].mode < 16)
@@ -502,6 +677,7 @@ static inline SurviveDeviceDriverReturn callDriver(SurviveContext *ctx, const ch
 	return r;
 }
 int survive_startup(SurviveContext *ctx) {
+	struct SurviveContext_private *pctx = ctx->private_members;
 	ctx->state = SURVIVE_RUNNING;
 
 	survive_install_recording(ctx);
@@ -564,8 +740,10 @@ int survive_startup(SurviveContext *ctx) {
 	SV_INFO("%s", buffer);
 
 	// Apply poser to objects.
+	pctx->poser_pool = survive_poser_pool_create(ctx);
 	for (int i = 0; i < ctx->objs_ct; i++) {
 		ctx->objs[i]->PoserFn = PreferredPoserCB;
+		survive_poser_worker_start(pctx->poser_pool, ctx->objs[i]);
 	}
 
 	// saving the config extra to make sure that the user has a config file they can change.
@@ -618,6 +796,7 @@ int survive_startup(SurviveContext *ctx) {
 
 void survive_default_new_object_process(SurviveObject *so) {}
 int survive_add_object(SurviveContext *ctx, SurviveObject *obj) {
+	struct SurviveContext_private *pctx = ctx->private_members;
 	SV_INFO("Adding tracked object %s from %s", obj->codename, obj->drivername);
 	int oldct = ctx->objs_ct;
 	ctx->objs = SV_REALLOC(ctx->objs, sizeof(SurviveObject *) * (oldct + 1));
@@ -625,8 +804,14 @@ int survive_add_object(SurviveContext *ctx, SurviveObject *obj) {
 	ctx->objs_ct = oldct + 1;
 
 	ctx->new_objectproc(obj);
+	if (pctx->latency_trace && obj->latency == 0) {
+		obj->latency = survive_latency_tracer_create();
+	}
 	PoserCB PreferredPoserCB = (PoserCB)GetDriverByConfig(ctx, "Poser", "poser", "MPFIT");
 	obj->PoserFn = PreferredPoserCB;
+	if (ctx->state == SURVIVE_RUNNING) {
+		survive_poser_worker_start(pctx->poser_pool, obj);
+	}
 
 	return 0;
 }
@@ -655,6 +840,9 @@ void survive_remove_object(SurviveContext *ctx, SurviveObject *obj) {
 	ctx->objs[ctx->objs_ct] = 0;
 
 	SV_INFO("Removing tracked object %s from %s", obj->codename, obj->drivername);
+	survive_poser_worker_stop(obj);
+	survive_latency_tracer_free(obj->latency);
+	SurviveSensorActivations_dtor(&obj->activations);
 	free(obj);
 }
 
@@ -700,15 +888,20 @@ int survive_haptic(SurviveObject *so, uint8_t reserved, uint16_t pulseHigh, uint
 }
 
 void survive_close(SurviveContext *ctx) {
+	struct SurviveContext_private *pctx = ctx->private_members;
 	const char *DriverName;
 	int r = 0;
 
+	// Contexts can be closed without ever being started, e.g. when only their config is used
+	bool started = ctx->state != SURVIVE_STOPPED;
 	ctx->state = SURVIVE_CLOSING;
 
 	// unlock/ post to button service semaphore so the thread can kill itself
-	OGUnlockSema(ctx->buttonQueue.buttonservicesem);
-	OGJoinThread(ctx->buttonservicethread);
-	OGDeleteSema(ctx->buttonQueue.buttonservicesem);
+	if (started) {
+		OGUnlockSema(ctx->buttonQueue.buttonservicesem);
+		OGJoinThread(ctx->buttonservicethread);
+		OGDeleteSema(ctx->buttonQueue.buttonservicesem);
+	}
 
 	while ((DriverName = GetDriverNameMatching("DriverUnreg", r++))) {
 		DeviceDriver dd = (DeviceDriver)GetDriver(DriverName);
@@ -718,12 +911,16 @@ void survive_close(SurviveContext *ctx) {
 	}
 
 	for (int i = 0; i < ctx->objs_ct; i++) {
+		survive_poser_worker_stop(ctx->objs[i]);
+
 		PoserData pd;
 		pd.pt = POSERDATA_DISASSOCIATE;
 		if (ctx->objs[i]->PoserFn)
 			ctx->objs[i]->PoserFn(ctx->objs[i], &pd);
+		survive_latency_report(ctx->objs[i]);
 		ctx->lightcapproc(ctx->objs[i], 0);
 	}
+	survive_poser_pool_free(pctx->poser_pool);
 
 	config_save(ctx, survive_configs(ctx, "configfile", SC_GET, "config.json"));
 
@@ -741,14 +938,22 @@ void survive_close(SurviveContext *ctx) {
 		survive_destroy_device(ctx->objs[i]);
 	}
 
+	survive_optimizer_pool_free(pctx->optimizer_pool);
+	survive_parallel_pool_free(pctx->parallel_pool);
+	free(pctx->optimizer_settings);
+
 	destroy_config_group(ctx->global_config_values);
 	destroy_config_group(ctx->temporary_config_values);
 
 	for (int lh = 0; lh < NUM_GEN2_LIGHTHOUSES; lh++)
 		destroy_config_group(ctx->lh_config + lh);
 
-	struct SurviveContext_private *pctx = ctx->private_members;
 	OGDeleteSema(pctx->poll_sema);
+	OGDeleteConditionVariable(pctx->bsd_changed);
+	OGDeleteMutex(pctx->bsd_lock);
+	OGDeleteMutex(pctx->optimizer_pool_lock);
+	OGDeleteMutex(pctx->output_listener_lock);
+	free(pctx->output_listeners);
 	free(pctx);
 
 	free(ctx->objs);
@@ -760,7 +965,7 @@ void survive_close(SurviveContext *ctx) {
 	free(ctx->temporary_config_values);
 	free(ctx->lh_config);
 	free(ctx->calptr);
-	free(ctx->recptr);
+	survive_free_recording(ctx);
 
 	free(ctx);
 }
@@ -899,20 +1104,13 @@ inline void survive_apply_ang_velocity(LinmathQuat out, const SurviveAngularVelo
 	quatrotateabout(out, rot_change, t0);
 }
 
-static double timestamp_in_s() {
-	static double start_time_s = 0;
-	if (start_time_s == 0.)
-		start_time_s = OGGetAbsoluteTime();
-	return OGGetAbsoluteTime() - start_time_s;
-}
-
 double survive_run_time(const SurviveContext *ctx) {
 	struct SurviveContext_private *pctx = ctx->private_members;
 	if (pctx->runTimeFn) {
 		return pctx->runTimeFn(ctx, pctx->runTimeFnUser);
 	}
 
-	return timestamp_in_s();
+	return OGGetAbsoluteTime() - pctx->start_time_s;
 }
 
 void survive_install_run_time_fn(SurviveContext *ctx, survive_run_time_fn fn, void *user) {
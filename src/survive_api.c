@@ -8,6 +8,7 @@
 #include "stdio.h"
 #include "string.h"
 #include "survive.h"
+#include "survive_atomic.h"
 
 struct SurviveExternalObject {
 	SurvivePose pose;
@@ -19,6 +20,36 @@ struct SurviveLighthouseData {
 	char serial_number[16];
 };
 
+/**
+ * Recent poses of a tracked object, for survive_simple_object_get_pose_at. Only the pose and velocity callbacks write
+ * to it, and they are serialized by poll_mutex; readers copy it out under a sequence counter and retry if a write
+ * overlapped, so queries never wait on the poll thread.
+ *
+ * Samples are placed on the survive_run_time clock when their callback runs, less how far their timecode trails the
+ * newest one seen for the object. Solves that finish late -- async light solves behind IMU updates -- land at the
+ * time their data is from rather than when they completed.
+ */
+#define POSE_HISTORY_SIZE 32
+// Queries further past the newest pose than this get the pose at this horizon
+#define POSE_HISTORY_MAX_EXTRAPOLATION 0.1
+
+typedef struct SurviveSimplePoseSample {
+	FLT time;
+	SurvivePose pose;
+	SurvivePose imu2world;
+	SurviveVelocity velocity;
+} SurviveSimplePoseSample;
+
+typedef struct SurviveSimplePoseHistory {
+	uint32_t seq; // Odd while a write is in progress
+	uint32_t cnt;
+	SurviveSimplePoseSample samples[POSE_HISTORY_SIZE];
+
+	// Writer only
+	survive_timecode newest_timecode;
+	SurviveVelocity velocity;
+} SurviveSimplePoseHistory;
+
 struct SurviveSimpleObject {
 	struct SurviveSimpleContext *actx;
 
@@ -33,6 +64,9 @@ struct SurviveSimpleObject {
 	char name[32];
 	bool has_update;
 
+	// Tracked objects only
+	SurviveSimplePoseHistory *pose_history;
+
 	SurviveSimpleObject *next;
 };
 
@@ -41,7 +75,34 @@ struct SurviveSimpleObjectList {
 	SurviveSimpleObject *head, *tail;
 };
 
-#define MAX_EVENT_SIZE 64
+/**
+ * Events go through a single producer / single consumer queue made of linked blocks. Producers are serialized by
+ * poll_mutex, which they hold anyway; consumers are serialized by their own mutex so draining events never contends
+ * with the poll thread. The queue grows a block at a time up to MAX_EVENT_CNT pending events, past which new events
+ * are dropped and counted.
+ */
+#define EVENT_BLOCK_SIZE 64
+#define MAX_EVENT_CNT (1 << 16)
+
+typedef struct SurviveSimpleEventBlock {
+	struct SurviveSimpleEventBlock *next;
+	uint32_t write_idx; // Published by the producer
+	struct SurviveSimpleEvent events[EVENT_BLOCK_SIZE];
+} SurviveSimpleEventBlock;
+
+typedef struct SurviveSimpleEventQueue {
+	// Producer side
+	SurviveSimpleEventBlock *tail;
+	uint32_t produced;
+	uint32_t dropped;
+
+	// Consumer side
+	og_mutex_t consumer_lock;
+	SurviveSimpleEventBlock *head;
+	uint32_t read_idx;
+	uint32_t consumed;
+} SurviveSimpleEventQueue;
+
 struct SurviveSimpleContext {
 	SurviveContext *ctx;
 	SurviveSimpleLogFn log_fn;
@@ -51,9 +112,7 @@ struct SurviveSimpleContext {
 	og_mutex_t poll_mutex;
 	og_cv_t update_cv;
 
-	size_t events_cnt;
-	size_t event_next_write;
-	struct SurviveSimpleEvent events[MAX_EVENT_SIZE];
+	SurviveSimpleEventQueue events;
 
 	struct SurviveSimpleObjectList objects;
 };
@@ -70,29 +129,72 @@ static enum SurviveSimpleObject_type to_simple_type(SurviveObjectType sot) {
 	}
 }
 
-static void insert_into_event_buffer(SurviveSimpleContext *actx, const SurviveSimpleEvent *event) {
-	bool buffer_full = actx->events_cnt == MAX_EVENT_SIZE;
+static void event_queue_init(SurviveSimpleEventQueue *queue) {
+	queue->head = queue->tail = SV_NEW(SurviveSimpleEventBlock);
+	queue->consumer_lock = OGCreateMutex();
+}
 
-	actx->events[actx->event_next_write] = *event;
-	actx->event_next_write = (actx->event_next_write + 1) % MAX_EVENT_SIZE;
-	if (!buffer_full)
-		actx->events_cnt++;
+static void event_queue_free(SurviveSimpleEventQueue *queue) {
+	for (SurviveSimpleEventBlock *block = queue->head; block;) {
+		SurviveSimpleEventBlock *next = block->next;
+		free(block);
+		block = next;
+	}
+	OGDeleteMutex(queue->consumer_lock);
 }
 
-static bool pop_from_event_buffer(SurviveSimpleContext *actx, SurviveSimpleEvent *event) {
-	if (actx->events_cnt == 0)
-		return false;
+static void insert_into_event_buffer(SurviveSimpleContext *actx, const SurviveSimpleEvent *event) {
+	SurviveSimpleEventQueue *queue = &actx->events;
+	if (queue->produced - survive_atomic_load_u32(&queue->consumed) >= MAX_EVENT_CNT) {
+		survive_atomic_fetch_add_u32(&queue->dropped, 1);
+		return;
+	}
+
+	SurviveSimpleEventBlock *tail = queue->tail;
+	if (tail->write_idx == EVENT_BLOCK_SIZE) {
+		SurviveSimpleEventBlock *block = SV_NEW(SurviveSimpleEventBlock);
+		survive_atomic_store_ptr((void *volatile *)&tail->next, block);
+		queue->tail = tail = block;
+	}
 
-	size_t read_idx = (MAX_EVENT_SIZE + actx->event_next_write - actx->events_cnt) % MAX_EVENT_SIZE;
-	*event = actx->events[read_idx];
+	tail->events[tail->write_idx] = *event;
+	survive_atomic_store_u32(&tail->write_idx, tail->write_idx + 1);
+	queue->produced++;
+}
+
+// Must hold consumer_lock
+static size_t pop_from_event_buffer(SurviveSimpleContext *actx, SurviveSimpleEvent *events, size_t max_events) {
+	SurviveSimpleEventQueue *queue = &actx->events;
+	size_t cnt = 0;
+
+	while (cnt < max_events) {
+		SurviveSimpleEventBlock *head = queue->head;
+		uint32_t available = survive_atomic_load_u32(&head->write_idx);
+
+		if (queue->read_idx == EVENT_BLOCK_SIZE) {
+			// The producer only moves on once a block is full, so a full block with a next pointer is done with
+			SurviveSimpleEventBlock *next = survive_atomic_load_ptr((void *const volatile *)&head->next);
+			if (next == 0)
+				break;
+			queue->head = next;
+			queue->read_idx = 0;
+			free(head);
+			continue;
+		}
 
-	// Mark read events as invalid and assert if they are about to be passed on. This means there is a logic bug in the
-	// circular buffer
-	assert(event->event_type != -1);
-	actx->events[read_idx].event_type = -1;
+		if (queue->read_idx == available)
+			break;
 
-	actx->events_cnt--;
-	return true;
+		size_t n = available - queue->read_idx;
+		if (n > max_events - cnt)
+			n = max_events - cnt;
+		memcpy(events + cnt, head->events + queue->read_idx, n * sizeof(SurviveSimpleEvent));
+		queue->read_idx += n;
+		cnt += n;
+	}
+
+	survive_atomic_fetch_add_u32(&queue->consumed, cnt);
+	return cnt;
 }
 
 static void SurviveSimpleObjectList_add(struct SurviveSimpleObjectList *list, SurviveSimpleObject *so) {
@@ -149,6 +251,73 @@ static void external_pose_fn(SurviveContext *ctx, const char *name, const Surviv
 	so->data.seo.pose = *pose;
 	unlock_and_notify_change(actx);
 }
+static void pose_history_write_begin(SurviveSimplePoseHistory *history) {
+	survive_atomic_store_u32(&history->seq, history->seq + 1);
+	survive_atomic_fence();
+}
+static void pose_history_write_end(SurviveSimplePoseHistory *history) {
+	survive_atomic_store_u32(&history->seq, history->seq + 1);
+}
+
+static FLT pose_history_sample_time(SurviveSimplePoseHistory *history, const SurviveObject *so,
+									survive_timecode timecode) {
+	FLT now = survive_run_time(so->ctx);
+	if (history->cnt == 0) {
+		history->newest_timecode = timecode;
+		return now;
+	}
+
+	// Signed, so that solves which finish out of order and the timecode wrapping around both work out
+	int32_t delta = (int32_t)(timecode - history->newest_timecode);
+	if (delta >= 0) {
+		history->newest_timecode = timecode;
+		return now;
+	}
+
+	FLT timebase = so->timebase_hz ? so->timebase_hz : 48000000.;
+	return now + delta / timebase;
+}
+
+static void pose_history_add(SurviveSimplePoseHistory *history, const SurviveObject *so, survive_timecode timecode,
+							 const SurvivePose *pose) {
+	FLT time = pose_history_sample_time(history, so, timecode);
+
+	pose_history_write_begin(history);
+	SurviveSimplePoseSample *sample = &history->samples[history->cnt % POSE_HISTORY_SIZE];
+	sample->time = time;
+	sample->pose = *pose;
+	// Drivers that report poses directly never set the IMU pose
+	sample->imu2world = quatiszero(so->OutPoseIMU.Rot) ? *pose : so->OutPoseIMU;
+	sample->velocity = history->velocity;
+	history->cnt++;
+	pose_history_write_end(history);
+}
+
+// Velocities are reported right after the pose they go with
+static void pose_history_set_velocity(SurviveSimplePoseHistory *history, const SurviveVelocity *velocity) {
+	history->velocity = *velocity;
+	if (history->cnt == 0)
+		return;
+
+	pose_history_write_begin(history);
+	history->samples[(history->cnt - 1) % POSE_HISTORY_SIZE].velocity = *velocity;
+	pose_history_write_end(history);
+}
+
+static void pose_history_extrapolate(const SurviveSimplePoseSample *sample, FLT t, SurvivePose *pose) {
+	// Same constant velocity model the IMU tracker predicts with; it is applied to the IMU pose since that is what
+	// the velocity describes, and carried back to the reported frame afterwards
+	SurvivePose imu2world = sample->imu2world, world2imu, pose2imu;
+	InvertPose(&world2imu, &imu2world);
+	ApplyPoseToPose(&pose2imu, &world2imu, &sample->pose);
+
+	for (int i = 0; i < 3; i++)
+		imu2world.Pos[i] += sample->velocity.Pos[i] * t;
+	survive_apply_ang_velocity(imu2world.Rot, sample->velocity.AxisAngleRot, t, sample->imu2world.Rot);
+
+	ApplyPoseToPose(pose, &imu2world, &pose2imu);
+}
+
 static void pose_fn(SurviveObject *so, uint32_t timecode, SurvivePose *pose) {
 	SurviveSimpleContext *actx = so->ctx->user_ptr;
 	OGLockMutex(actx->poll_mutex);
@@ -156,9 +325,24 @@ static void pose_fn(SurviveObject *so, uint32_t timecode, SurvivePose *pose) {
 
 	struct SurviveSimpleObject *sao = so->user_ptr;
 	sao->has_update = true;
+	if (sao->pose_history) {
+		pose_history_add(sao->pose_history, so, timecode, pose);
+	}
 	unlock_and_notify_change(actx);
 }
 
+static void velocity_fn(SurviveObject *so, uint32_t timecode, const SurviveVelocity *velocity) {
+	SurviveSimpleContext *actx = so->ctx->user_ptr;
+	OGLockMutex(actx->poll_mutex);
+	survive_default_velocity_process(so, timecode, velocity);
+
+	struct SurviveSimpleObject *sao = so->user_ptr;
+	if (sao->pose_history) {
+		pose_history_set_velocity(sao->pose_history, velocity);
+	}
+	OGUnlockMutex(actx->poll_mutex);
+}
+
 static inline SurviveSimpleObject *create_lighthouse(SurviveSimpleContext *actx, size_t i) {
 	SurviveSimpleObject *obj = SV_CALLOC(1, sizeof(struct SurviveSimpleObject));
 	obj->data.lh.lighthouse = i;
@@ -237,6 +421,7 @@ static void new_object_fn(SurviveObject *so) {
 	obj->type = to_simple_type(so->object_type);
 	obj->actx = actx;
 	obj->data.so->user_ptr = (void *)obj;
+	obj->pose_history = SV_NEW(SurviveSimplePoseHistory);
 	strncpy(obj->name, obj->data.so->codename, sizeof(obj->name));
 
 	SurviveSimpleObjectList_add(&actx->objects, obj);
@@ -260,6 +445,7 @@ SURVIVE_EXPORT SurviveSimpleContext *survive_simple_init_with_logger(int argc, c
 	actx->ctx = ctx;
 	actx->poll_mutex = OGCreateMutex();
 	actx->update_cv = OGCreateConditionVariable();
+	event_queue_init(&actx->events);
 
 	intptr_t i = 0;
 	for (i = 0; i < ctx->activeLighthouses; i++) {
@@ -267,6 +453,7 @@ SURVIVE_EXPORT SurviveSimpleContext *survive_simple_init_with_logger(int argc, c
 	}
 
 	survive_install_pose_fn(ctx, pose_fn);
+	survive_install_velocity_fn(ctx, velocity_fn);
 	survive_install_external_pose_fn(ctx, external_pose_fn);
 	survive_install_external_velocity_fn(ctx, external_velocity_fn);
 	survive_install_button_fn(ctx, button_fn);
@@ -296,8 +483,10 @@ void survive_simple_close(SurviveSimpleContext *actx) {
 	for (struct SurviveSimpleObject *n = actx->objects.head; n;) {
 		struct SurviveSimpleObject *freeMe = n;
 		n = n->next;
+		free(freeMe->pose_history);
 		free(freeMe);
 	}
+	event_queue_free(&actx->events);
 	OGDeleteMutex(actx->poll_mutex);
 	OGJoinThread(actx->thread);
 	OGDeleteConditionVariable(actx->update_cv);
@@ -339,6 +528,65 @@ const SurviveSimpleObject *survive_simple_get_next_updated(SurviveSimpleContext
 	return 0;
 }
 
+FLT survive_simple_run_time(const SurviveSimpleContext *actx) { return survive_run_time(actx->ctx); }
+
+bool survive_simple_object_get_pose_at(const SurviveSimpleObject *sao, FLT time, SurvivePose *pose) {
+	const SurviveSimplePoseHistory *history = sao->pose_history;
+	if (history == 0) {
+		return false;
+	}
+
+	SurviveSimplePoseSample samples[POSE_HISTORY_SIZE];
+	uint32_t cnt;
+	while (true) {
+		uint32_t seq = survive_atomic_load_u32(&history->seq);
+		if (seq & 1)
+			continue;
+
+		cnt = history->cnt;
+		memcpy(samples, history->samples, sizeof(samples));
+
+		survive_atomic_fence();
+		if (survive_atomic_load_u32(&history->seq) == seq)
+			break;
+	}
+
+	if (cnt == 0) {
+		return false;
+	}
+	if (cnt > POSE_HISTORY_SIZE) {
+		cnt = POSE_HISTORY_SIZE;
+	}
+
+	// Samples aren't necessarily in time order; async solves can finish after newer IMU updates
+	const SurviveSimplePoseSample *newest = 0, *oldest = 0, *before = 0, *after = 0;
+	for (uint32_t i = 0; i < cnt; i++) {
+		const SurviveSimplePoseSample *s = &samples[i];
+		if (newest == 0 || s->time > newest->time)
+			newest = s;
+		if (oldest == 0 || s->time < oldest->time)
+			oldest = s;
+		if (s->time <= time && (before == 0 || s->time > before->time))
+			before = s;
+		if (s->time >= time && (after == 0 || s->time < after->time))
+			after = s;
+	}
+
+	if (time >= newest->time) {
+		FLT t = time - newest->time;
+		pose_history_extrapolate(newest, t > POSE_HISTORY_MAX_EXTRAPOLATION ? POSE_HISTORY_MAX_EXTRAPOLATION : t, pose);
+	} else if (before == 0) {
+		*pose = oldest->pose;
+	} else {
+		FLT span = after->time - before->time;
+		FLT t = span > 0 ? (time - before->time) / span : 0;
+		for (int i = 0; i < 3; i++)
+			pose->Pos[i] = before->pose.Pos[i] + (after->pose.Pos[i] - before->pose.Pos[i]) * t;
+		quatslerp(pose->Rot, before->pose.Rot, after->pose.Rot, t);
+	}
+	return true;
+}
+
 survive_timecode survive_simple_object_get_latest_velocity(const SurviveSimpleObject *sao, SurviveVelocity *velocity) {
 	uint32_t timecode = 0;
 	OGLockMutex(sao->actx->poll_mutex);
@@ -400,6 +648,17 @@ uint32_t survive_simple_object_get_latest_pose(const SurviveSimpleObject *sao, S
 	return timecode;
 }
 
+bool survive_simple_object_get_latency(const SurviveSimpleObject *sao, SurviveLatencyStage stage,
+									   SurviveLatencyStats *stats) {
+	switch (sao->type) {
+	case SurviveSimpleObject_HMD:
+	case SurviveSimpleObject_OBJECT:
+		return survive_object_latency(sao->data.so, stage, stats);
+	default:
+		return false;
+	}
+}
+
 const char *survive_simple_object_name(const SurviveSimpleObject *sao) { return sao->name; }
 const char *survive_simple_serial_number(const SurviveSimpleObject *sao) {
 	switch (sao->type) {
@@ -455,12 +714,21 @@ bool survive_simple_wait_for_update(SurviveSimpleContext *actx) {
 
 enum SurviveSimpleEventType survive_simple_next_event(SurviveSimpleContext *actx, SurviveSimpleEvent *event) {
 	event->event_type = SurviveSimpleEventType_None;
-	OGLockMutex(actx->poll_mutex);
-	pop_from_event_buffer(actx, event);
-	OGUnlockMutex(actx->poll_mutex);
+	survive_simple_next_events(actx, event, 1);
 	return event->event_type;
 }
 
+size_t survive_simple_next_events(SurviveSimpleContext *actx, SurviveSimpleEvent *events, size_t max_events) {
+	OGLockMutex(actx->events.consumer_lock);
+	size_t cnt = pop_from_event_buffer(actx, events, max_events);
+	OGUnlockMutex(actx->events.consumer_lock);
+	return cnt;
+}
+
+uint32_t survive_simple_get_dropped_event_count(const SurviveSimpleContext *actx) {
+	return survive_atomic_load_u32(&actx->events.dropped);
+}
+
 enum SurviveSimpleObject_type survive_simple_object_get_type(const struct SurviveSimpleObject *sao) {
 	return sao->type;
 }
@@ -1,68 +1,299 @@
 #include "survive_async_optimizer.h"
+#include "survive_atomic.h"
+#include "survive_config.h"
+#include "survive_parallel.h"
 
-static void run_buffer(survive_async_optimizer *self, uint8_t idx) {
-	struct mp_result_struct results = {0};
-	OGUnlockMutex(self->active_buffer_lock);
-	self->active_buffer = idx;
-	self->completed++;
-	int status = survive_optimizer_run(&self->buffers[idx].optimizer, &results);
-	if (self->cb) {
-		self->cb(&self->buffers[idx], status, &results);
-	}
-	self->buffer_ready[idx] = false;
-	self->active_buffer = -1;
-	OGLockMutex(self->active_buffer_lock);
+#include <assert.h>
+#include <survive.h>
+
+STATIC_CONFIG_ITEM(OPTIMIZER_THREADS, "optimizer-threads", 'i',
+				   "Number of threads in each of the optimizer thread pools. 0 picks from the number of cores.", 0)
+
+enum async_buffer_state { BUFFER_FREE = 0, BUFFER_FILLING, BUFFER_PENDING, BUFFER_RUNNING };
+
+typedef struct optimizer_pool_worker {
+	survive_optimizer_pool *pool;
+	size_t idx;
+	og_thread_t thread;
+
+	// Ring of async optimizers with a job waiting. The owner takes from the front so objects are served in order;
+	// thieves take from the back.
+	og_mutex_t lock;
+	survive_async_optimizer **items;
+	size_t head, cnt, capacity;
+
+	size_t stolen;
+} optimizer_pool_worker;
+
+struct survive_optimizer_pool {
+	SurviveContext *ctx;
+
+	size_t worker_cnt;
+	optimizer_pool_worker *workers;
+
+	og_sema_t jobs_available;
+	uint32_t running;
+	uint32_t queued;
+	uint32_t next_home;
+};
+
+static void pool_push(survive_optimizer_pool *pool, survive_async_optimizer *self) {
+	optimizer_pool_worker *w = &pool->workers[self->home_worker];
+
+	OGLockMutex(w->lock);
+	if (w->cnt == w->capacity) {
+		size_t capacity = w->capacity ? w->capacity * 2 : 16;
+		survive_async_optimizer **items = SV_MALLOC(sizeof(survive_async_optimizer *) * capacity);
+		for (size_t i = 0; i < w->cnt; i++) {
+			items[i] = w->items[(w->head + i) % w->capacity];
+		}
+		free(w->items);
+		w->items = items;
+		w->head = 0;
+		w->capacity = capacity;
+	}
+	w->items[(w->head + w->cnt) % w->capacity] = self;
+	w->cnt++;
+	OGUnlockMutex(w->lock);
+
+	survive_atomic_fetch_add_u32(&pool->queued, 1);
+	OGUnlockSema(pool->jobs_available);
 }
 
-static void *async_thread(void *param) {
-	survive_async_optimizer *self = param;
-	OGLockMutex(self->active_buffer_lock);
-	while (self->cb) {
-		for (uint8_t i = 0; i < 2; i++) {
-			if (self->buffer_ready[i]) {
-				run_buffer(self, i);
+static survive_async_optimizer *pool_take(optimizer_pool_worker *worker) {
+	survive_optimizer_pool *pool = worker->pool;
+	for (size_t i = 0; i < pool->worker_cnt; i++) {
+		optimizer_pool_worker *w = &pool->workers[(worker->idx + i) % pool->worker_cnt];
+		survive_async_optimizer *rtn = 0;
+
+		OGLockMutex(w->lock);
+		if (w->cnt > 0) {
+			if (w == worker) {
+				rtn = w->items[w->head];
+				w->head = (w->head + 1) % w->capacity;
+			} else {
+				rtn = w->items[(w->head + w->cnt - 1) % w->capacity];
+			}
+			w->cnt--;
+		}
+		OGUnlockMutex(w->lock);
+
+		if (rtn) {
+			if (w != worker)
+				worker->stolen++;
+			survive_atomic_fetch_add_u32(&pool->queued, (uint32_t)-1);
+			return rtn;
+		}
+	}
+	return 0;
+}
+
+static int pending_buffer(const survive_async_optimizer *self) {
+	for (int i = 0; i < 2; i++) {
+		if (self->buffer_state[i] == BUFFER_PENDING)
+			return i;
+	}
+	return -1;
+}
+
+static void run_job(survive_async_optimizer *self) {
+	OGLockMutex(self->lock);
+	int idx = pending_buffer(self);
+	if (idx < 0) {
+		// The job was taken back, or dropped by survive_async_free
+		self->scheduled = false;
+		OGBroadcastCond(self->unscheduled);
+		OGUnlockMutex(self->lock);
+		return;
+	}
+
+	self->buffer_state[idx] = BUFFER_RUNNING;
+	double start = OGGetAbsoluteTime();
+	FLT wait_time = start - self->submit_time[idx];
+	self->stats.wait_time_sum += wait_time;
+	if (wait_time > self->stats.wait_time_max)
+		self->stats.wait_time_max = wait_time;
+	bool expired = self->deadline > 0 && wait_time > self->deadline;
+	OGUnlockMutex(self->lock);
+
+	if (!expired) {
+		struct mp_result_struct results = {0};
+		int status = survive_optimizer_run(&self->buffers[idx].optimizer, &results);
+		if (self->cb) {
+			self->cb(&self->buffers[idx], status, &results);
+		}
+	}
+
+	OGLockMutex(self->lock);
+	if (expired) {
+		self->stats.expired++;
+	} else {
+		FLT solve_time = OGGetAbsoluteTime() - start;
+		self->stats.completed++;
+		self->stats.solve_time_sum += solve_time;
+		if (solve_time > self->stats.solve_time_max)
+			self->stats.solve_time_max = solve_time;
+	}
+	self->buffer_state[idx] = BUFFER_FREE;
+
+	// Still scheduled if a newer job came in while this one ran
+	if (pending_buffer(self) >= 0) {
+		pool_push(self->pool, self);
+	} else {
+		self->scheduled = false;
+		OGBroadcastCond(self->unscheduled);
+	}
+	OGUnlockMutex(self->lock);
+}
+
+static void *pool_worker_thread(void *_worker) {
+	optimizer_pool_worker *worker = _worker;
+	survive_optimizer_pool *pool = worker->pool;
+
+	while (true) {
+		OGLockSema(pool->jobs_available);
+
+		survive_async_optimizer *self = pool_take(worker);
+		if (self == 0) {
+			if (!survive_atomic_load_u32(&pool->running)) {
+				break;
 			}
+			continue;
 		}
 
-		OGWaitCond(self->job_available, self->active_buffer_lock);
+		run_job(self);
 	}
 
-	OGUnlockMutex(self->active_buffer_lock);
 	return 0;
 }
 
-struct survive_async_optimizer *survive_async_init(survive_async_optimizer_cb cb) {
+survive_optimizer_pool *survive_optimizer_pool_create(SurviveContext *ctx, size_t worker_cnt) {
+	if (worker_cnt == 0 && ctx) {
+		worker_cnt = survive_configi(ctx, OPTIMIZER_THREADS_TAG, SC_GET, 0);
+	}
+	if (worker_cnt == 0) {
+		worker_cnt = survive_default_thread_count();
+	}
+
+	survive_optimizer_pool *pool = SV_NEW(survive_optimizer_pool);
+	pool->ctx = ctx;
+	pool->running = 1;
+	pool->jobs_available = OGCreateSema();
+	pool->worker_cnt = worker_cnt;
+	pool->workers = SV_CALLOC(worker_cnt, sizeof(optimizer_pool_worker));
+
+	// Workers steal from each other, so every deque has to exist before any of them start
+	for (size_t i = 0; i < worker_cnt; i++) {
+		optimizer_pool_worker *w = &pool->workers[i];
+		w->pool = pool;
+		w->idx = i;
+		w->lock = OGCreateMutex();
+	}
+
+	for (size_t i = 0; i < worker_cnt; i++) {
+		optimizer_pool_worker *w = &pool->workers[i];
+		w->thread = OGCreateThread(pool_worker_thread, w);
+
+		char name[32];
+		snprintf(name, sizeof(name), "optimizer %d", (int)i);
+		OGNameThread(w->thread, name);
+	}
+
+	if (ctx) {
+		SV_VERBOSE(10, "Started optimizer pool with %d threads", (int)worker_cnt);
+	}
+	return pool;
+}
+
+size_t survive_optimizer_pool_worker_count(const survive_optimizer_pool *pool) { return pool->worker_cnt; }
+
+void survive_optimizer_pool_free(survive_optimizer_pool *pool) {
+	if (pool == 0) {
+		return;
+	}
+
+	survive_atomic_store_u32(&pool->running, 0);
+	for (size_t i = 0; i < pool->worker_cnt; i++) {
+		OGUnlockSema(pool->jobs_available);
+	}
+
+	for (size_t i = 0; i < pool->worker_cnt; i++) {
+		OGJoinThread(pool->workers[i].thread);
+	}
+
+	size_t stolen = 0;
+	for (size_t i = 0; i < pool->worker_cnt; i++) {
+		optimizer_pool_worker *w = &pool->workers[i];
+		assert(w->cnt == 0);
+		OGDeleteMutex(w->lock);
+		free(w->items);
+		stolen += w->stolen;
+	}
+
+	SurviveContext *ctx = pool->ctx;
+	if (ctx) {
+		SV_VERBOSE(10, "Optimizer pool: %d threads, %d stolen jobs", (int)pool->worker_cnt, (int)stolen);
+	}
+
+	OGDeleteSema(pool->jobs_available);
+	free(pool->workers);
+	free(pool);
+}
+
+struct survive_async_optimizer *survive_async_init_with_pool(survive_optimizer_pool *pool,
+															 survive_async_optimizer_cb cb) {
 	survive_async_optimizer *self = SV_NEW(survive_async_optimizer);
 	self->cb = cb;
-	self->active_buffer = -1;
-	self->active_buffer_lock = OGCreateMutex();
-	self->job_available = OGCreateConditionVariable();
-
-	self->async_thread = OGCreateThread(async_thread, self);
+	self->pool = pool;
+	self->home_worker = survive_atomic_fetch_add_u32(&pool->next_home, 1) % pool->worker_cnt;
+	self->lock = OGCreateMutex();
+	self->unscheduled = OGCreateConditionVariable();
 	return self;
 }
 
+struct survive_async_optimizer *survive_async_init(SurviveContext *ctx, survive_async_optimizer_cb cb) {
+	return survive_async_init_with_pool(survive_get_optimizer_pool(ctx), cb);
+}
+
 survive_async_optimizer_buffer *survive_async_optimizer_alloc_optimizer(struct survive_async_optimizer *self) {
-	OGLockMutex(self->active_buffer_lock);
-	survive_async_optimizer_buffer *rtn = 0;
-	if (self->active_buffer == 0) {
-		rtn = &self->buffers[1];
-		self->buffer_ready[1] = false;
-	} else {
-		rtn = &self->buffers[0];
-		self->buffer_ready[0] = false;
+	OGLockMutex(self->lock);
+
+	// Prefer a buffer that never made it to a worker; its job is superseded by the one being built
+	int idx = -1;
+	for (int i = 0; i < 2 && idx < 0; i++) {
+		if (self->buffer_state[i] == BUFFER_PENDING) {
+			self->stats.coalesced++;
+			idx = i;
+		}
+	}
+	for (int i = 0; i < 2 && idx < 0; i++) {
+		if (self->buffer_state[i] == BUFFER_FILLING || self->buffer_state[i] == BUFFER_FREE)
+			idx = i;
 	}
-	self->submitted++;
-	OGUnlockMutex(self->active_buffer_lock);
-	return rtn;
+	assert(idx >= 0);
+
+	self->buffer_state[idx] = BUFFER_FILLING;
+	OGUnlockMutex(self->lock);
+	return &self->buffers[idx];
 }
 
 void survive_async_optimizer_run(struct survive_async_optimizer *self, survive_async_optimizer_buffer *opt) {
-	OGLockMutex(self->active_buffer_lock);
+	OGLockMutex(self->lock);
 	uint8_t idx = opt == &self->buffers[0] ? 0 : 1;
-	self->buffer_ready[idx] = true;
-	OGSignalCond(self->job_available);
-	OGUnlockMutex(self->active_buffer_lock);
+	self->buffer_state[idx] = BUFFER_PENDING;
+	self->submit_time[idx] = OGGetAbsoluteTime();
+	self->stats.submitted++;
+
+	size_t queue_depth = survive_atomic_load_u32(&self->pool->queued);
+	self->stats.queue_depth_sum += queue_depth;
+	if (queue_depth > self->stats.queue_depth_max)
+		self->stats.queue_depth_max = queue_depth;
+
+	if (!self->scheduled) {
+		self->scheduled = true;
+		pool_push(self->pool, self);
+	}
+	OGUnlockMutex(self->lock);
 }
 
 void survive_async_free(struct survive_async_optimizer *self) {
@@ -70,15 +301,20 @@ void survive_async_free(struct survive_async_optimizer *self) {
 		return;
 	}
 
-	OGLockMutex(self->active_buffer_lock);
-	self->cb = 0;
-	OGSignalCond(self->job_available);
-	OGUnlockMutex(self->active_buffer_lock);
+	OGLockMutex(self->lock);
+	for (int i = 0; i < 2; i++) {
+		if (self->buffer_state[i] == BUFFER_PENDING)
+			self->buffer_state[i] = BUFFER_FREE;
+	}
 
-	OGJoinThread(self->async_thread);
+	// A worker still has to pop us off its deque, or is running our last job
+	while (self->scheduled) {
+		OGWaitCond(self->unscheduled, self->lock);
+	}
+	OGUnlockMutex(self->lock);
 
-	OGDeleteConditionVariable(self->job_available);
-	OGDeleteMutex(self->active_buffer_lock);
+	OGDeleteConditionVariable(self->unscheduled);
+	OGDeleteMutex(self->lock);
 
 	for (int i = 0; i < 2; i++) {
 		SURVIVE_OPTIMIZER_CLEANUP_HEAP_BUFFERS(self->buffers[i].optimizer);
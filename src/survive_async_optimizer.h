@@ -3,6 +3,16 @@
 #include <survive_optimizer.h>
 #include <survive_types.h>
 
+/**
+ * Async optimizers run their solves on a pool of worker threads shared by the whole context. Each async optimizer
+ * has two buffers: one that may be solving, and one being filled or waiting for a worker. Submitting while a job is
+ * still waiting replaces it -- the latest job wins -- so a busy pool drops stale solves instead of queueing them, and
+ * jobs from one async optimizer never run concurrently or out of order.
+ *
+ * Every worker has its own deque of async optimizers with work waiting; idle workers steal from the others.
+ */
+typedef struct survive_optimizer_pool survive_optimizer_pool;
+
 typedef struct survive_async_optimizer_buffer {
 	survive_optimizer optimizer;
 	void *user;
@@ -11,24 +21,68 @@ typedef struct survive_async_optimizer_buffer {
 typedef void (*survive_async_optimizer_cb)(struct survive_async_optimizer_buffer *buffer, int return_code,
 										   struct mp_result_struct *result);
 
+typedef struct survive_async_optimizer_stats {
+	size_t submitted;
+	size_t completed;
+	// Jobs replaced by a newer one before a worker got to them
+	size_t coalesced;
+	// Jobs dropped because they waited longer than the deadline
+	size_t expired;
+
+	// Number of async optimizers already waiting in the pool when a job was submitted
+	size_t queue_depth_sum;
+	size_t queue_depth_max;
+
+	// In seconds; wait is from submission until a worker picks the job up
+	FLT wait_time_sum;
+	FLT wait_time_max;
+	FLT solve_time_sum;
+	FLT solve_time_max;
+} survive_async_optimizer_stats;
+
 typedef struct survive_async_optimizer {
 	survive_async_optimizer_cb cb;
 	void *user;
 
-	og_thread_t async_thread;
+	survive_optimizer_pool *pool;
+	size_t home_worker;
 
-	int8_t active_buffer;
-	bool buffer_ready[2];
-	struct survive_async_optimizer_buffer buffers[2];
-	og_mutex_t active_buffer_lock;
+	// Jobs that wait longer than this many seconds are dropped without running. 0 disables.
+	FLT deadline;
 
-	og_cv_t job_available;
+	og_mutex_t lock;
+	bool scheduled;
+	// Signaled under 'lock' whenever 'scheduled' drops back to false
+	og_cv_t unscheduled;
+	uint8_t buffer_state[2];
+	double submit_time[2];
+	struct survive_async_optimizer_buffer buffers[2];
 
-	size_t submitted;
-	size_t completed;
+	survive_async_optimizer_stats stats;
 } survive_async_optimizer;
 
-SURVIVE_EXPORT struct survive_async_optimizer *survive_async_init(survive_async_optimizer_cb cb);
+/**
+ * Creates a pool with 'worker_cnt' threads; 0 reads 'optimizer-threads', and picks from the core count if that isn't
+ * set either. Normally there is no need to call this directly -- survive_async_init uses the context's pool.
+ */
+SURVIVE_EXPORT survive_optimizer_pool *survive_optimizer_pool_create(SurviveContext *ctx, size_t worker_cnt);
+/**
+ * Stops the workers. Every async optimizer using the pool must be freed first.
+ */
+SURVIVE_EXPORT void survive_optimizer_pool_free(survive_optimizer_pool *pool);
+SURVIVE_EXPORT size_t survive_optimizer_pool_worker_count(const survive_optimizer_pool *pool);
+
+/**
+ * Returns the context's pool, creating it on first use. It is freed in survive_close.
+ */
+SURVIVE_EXPORT survive_optimizer_pool *survive_get_optimizer_pool(SurviveContext *ctx);
+
+SURVIVE_EXPORT struct survive_async_optimizer *survive_async_init(SurviveContext *ctx, survive_async_optimizer_cb cb);
+SURVIVE_EXPORT struct survive_async_optimizer *survive_async_init_with_pool(survive_optimizer_pool *pool,
+																		   survive_async_optimizer_cb cb);
+/**
+ * Drops any job still waiting and blocks until a running one has finished.
+ */
 SURVIVE_EXPORT void survive_async_free(struct survive_async_optimizer *optimizer);
 
 SURVIVE_EXPORT survive_async_optimizer_buffer *
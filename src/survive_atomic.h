@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Minimal set of atomics needed for the lock-free handoffs in libsurvive. Loads are acquire, stores are release and
+ * the read-modify-write ops are sequentially consistent. survive_atomic_fence keeps the loads before it ahead of the
+ * loads after it, and likewise for stores.
+ */
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+
+#if defined(_M_ARM64) || defined(_M_ARM)
+#include <windows.h>
+// ARM reorders loads and stores freely, so ordering them takes a hardware barrier
+#define SURVIVE_ATOMIC_BARRIER() MemoryBarrier()
+#else
+// x86 never moves a load past another load or a store past another store, which is all acquire, release and
+// survive_atomic_fence need; only the compiler has to be kept from reordering them
+#define SURVIVE_ATOMIC_BARRIER() _ReadWriteBarrier()
+#endif
+
+static inline uint32_t survive_atomic_load_u32(const volatile uint32_t *p) {
+	uint32_t v = *p;
+	SURVIVE_ATOMIC_BARRIER();
+	return v;
+}
+static inline void survive_atomic_store_u32(volatile uint32_t *p, uint32_t v) {
+	SURVIVE_ATOMIC_BARRIER();
+	*p = v;
+}
+static inline uint32_t survive_atomic_fetch_add_u32(volatile uint32_t *p, uint32_t v) {
+	return (uint32_t)_InterlockedExchangeAdd((volatile long *)p, (long)v);
+}
+static inline void *survive_atomic_load_ptr(void *const volatile *p) {
+	void *v = *p;
+	SURVIVE_ATOMIC_BARRIER();
+	return v;
+}
+static inline void survive_atomic_store_ptr(void *volatile *p, void *v) {
+	SURVIVE_ATOMIC_BARRIER();
+	*p = v;
+}
+static inline bool survive_atomic_cas_u32(volatile uint32_t *p, uint32_t *expected, uint32_t desired) {
+	uint32_t prev = (uint32_t)_InterlockedCompareExchange((volatile long *)p, (long)desired, (long)*expected);
+	if (prev == *expected)
+		return true;
+	*expected = prev;
+	return false;
+}
+static inline bool survive_atomic_cas_ptr(void *volatile *p, void **expected, void *desired) {
+	void *prev = _InterlockedCompareExchangePointer(p, desired, *expected);
+	if (prev == *expected)
+		return true;
+	*expected = prev;
+	return false;
+}
+static inline void survive_atomic_fence(void) { SURVIVE_ATOMIC_BARRIER(); }
+#else
+static inline uint32_t survive_atomic_load_u32(const volatile uint32_t *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static inline void survive_atomic_store_u32(volatile uint32_t *p, uint32_t v) {
+	__atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+static inline uint32_t survive_atomic_fetch_add_u32(volatile uint32_t *p, uint32_t v) {
+	return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST);
+}
+static inline void *survive_atomic_load_ptr(void *const volatile *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static inline void survive_atomic_store_ptr(void *volatile *p, void *v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+static inline bool survive_atomic_cas_u32(volatile uint32_t *p, uint32_t *expected, uint32_t desired) {
+	return __atomic_compare_exchange_n(p, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+static inline bool survive_atomic_cas_ptr(void *volatile *p, void **expected, void *desired) {
+	return __atomic_compare_exchange_n(p, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+static inline void survive_atomic_fence(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+#endif
@@ -0,0 +1,137 @@
+#include "survive_batch.h"
+
+#include <os_generic.h>
+#include <string.h>
+#include <survive.h>
+
+typedef struct survive_batch_buffers {
+	SurviveBatchPose *poses;
+	SurviveBatchIMU *imu;
+	SurviveBatchAngle *angles;
+} survive_batch_buffers;
+
+struct SurviveBatch {
+	SurviveContext *ctx;
+	size_t capacity;
+
+	// Guards 'filling' and 'data'; the other set belongs to whoever drained it last
+	og_mutex_t lock;
+	survive_batch_buffers buffers[2];
+	int filling;
+	SurviveBatchData data[2];
+};
+
+// Points 'entry' at the next free slot of the array being filled. If it is full, the event is counted as dropped and
+// the calling listener unlocks and returns.
+#define BATCH_APPEND(batch, kind, cnt, entry)                                                                          \
+	SurviveBatchData *data = &(batch)->data[(batch)->filling];                                                         \
+	if (data->cnt >= (batch)->capacity) {                                                                              \
+		data->dropped++;                                                                                               \
+		OGUnlockMutex((batch)->lock);                                                                                  \
+		return;                                                                                                        \
+	}                                                                                                                  \
+	entry = &(batch)->buffers[(batch)->filling].kind[data->cnt++];
+
+static void batch_header(SurviveObject *so, char *object, double *time) {
+	memset(object, 0, 8);
+	memcpy(object, so->codename, strnlen(so->codename, sizeof(so->codename)));
+	*time = survive_run_time(so->ctx);
+}
+
+static void batch_pose(void *user, SurviveObject *so, survive_timecode timecode, const SurvivePose *pose) {
+	SurviveBatch *batch = user;
+	SurviveBatchPose *entry;
+
+	OGLockMutex(batch->lock);
+	BATCH_APPEND(batch, poses, pose_cnt, entry);
+	batch_header(so, entry->object, &entry->time);
+	entry->timecode = timecode;
+	entry->reserved = 0;
+	for (int i = 0; i < 3; i++)
+		entry->pos[i] = pose->Pos[i];
+	for (int i = 0; i < 4; i++)
+		entry->rot[i] = pose->Rot[i];
+	OGUnlockMutex(batch->lock);
+}
+
+static void batch_imu(void *user, SurviveObject *so, int mask, const FLT *accelgyromag, survive_timecode timecode,
+					  int id) {
+	SurviveBatch *batch = user;
+	SurviveBatchIMU *entry;
+
+	OGLockMutex(batch->lock);
+	BATCH_APPEND(batch, imu, imu_cnt, entry);
+	batch_header(so, entry->object, &entry->time);
+	entry->timecode = timecode;
+	entry->mask = mask;
+	for (int i = 0; i < 3; i++) {
+		entry->accel[i] = accelgyromag[i];
+		entry->gyro[i] = accelgyromag[3 + i];
+		entry->mag[i] = accelgyromag[6 + i];
+	}
+	entry->id = id;
+	entry->reserved = 0;
+	OGUnlockMutex(batch->lock);
+}
+
+static void batch_angle(void *user, SurviveObject *so, int sensor_id, survive_timecode timecode, int lh, int plane,
+						FLT length, FLT angle) {
+	SurviveBatch *batch = user;
+	SurviveBatchAngle *entry;
+
+	OGLockMutex(batch->lock);
+	BATCH_APPEND(batch, angles, angle_cnt, entry);
+	batch_header(so, entry->object, &entry->time);
+	entry->timecode = timecode;
+	entry->sensor_id = sensor_id;
+	entry->lh = lh;
+	entry->plane = plane;
+	entry->length = length;
+	entry->angle = angle;
+	OGUnlockMutex(batch->lock);
+}
+
+SurviveBatch *survive_batch_create(SurviveContext *ctx, size_t capacity) {
+	SurviveBatch *batch = SV_NEW(SurviveBatch);
+	batch->ctx = ctx;
+	batch->capacity = capacity;
+	batch->lock = OGCreateMutex();
+	for (int i = 0; i < 2; i++) {
+		batch->buffers[i].poses = SV_CALLOC(capacity, sizeof(SurviveBatchPose));
+		batch->buffers[i].imu = SV_CALLOC(capacity, sizeof(SurviveBatchIMU));
+		batch->buffers[i].angles = SV_CALLOC(capacity, sizeof(SurviveBatchAngle));
+	}
+
+	SurviveOutputListener listener = {.user = batch, .pose = batch_pose, .imu = batch_imu, .angle = batch_angle};
+	survive_add_output_listener(ctx, &listener);
+	return batch;
+}
+
+void survive_batch_free(SurviveBatch *batch) {
+	if (batch == 0) {
+		return;
+	}
+
+	survive_remove_output_listener(batch->ctx, batch);
+	OGDeleteMutex(batch->lock);
+	for (int i = 0; i < 2; i++) {
+		free(batch->buffers[i].poses);
+		free(batch->buffers[i].imu);
+		free(batch->buffers[i].angles);
+	}
+	free(batch);
+}
+
+const SurviveBatchData *survive_batch_drain(SurviveBatch *batch) {
+	OGLockMutex(batch->lock);
+	int drained = batch->filling;
+	batch->filling = !drained;
+	batch->data[batch->filling] = (SurviveBatchData){0};
+	OGUnlockMutex(batch->lock);
+
+	SurviveBatchData *data = &batch->data[drained];
+	data->poses = batch->buffers[drained].poses;
+	data->imu = batch->buffers[drained].imu;
+	data->angles = batch->buffers[drained].angles;
+	return data;
+}
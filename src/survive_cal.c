@@ -11,6 +11,7 @@
 
 #include "survive_cal.h"
 #include "survive_internal.h"
+#include "survive_poser_worker.h"
 #include "survive_reproject.h"
 
 #include <assert.h>
@@ -59,8 +60,6 @@ void ootx_error_clbk_d(ootx_decoder_context *ct, const char *msg) {
 
 void ootx_packet_clbk_d(ootx_decoder_context *ct, ootx_packet* packet)
 {
-	static uint8_t lighthouses_completed = 0;
-
 	SurviveContext * ctx = (SurviveContext*)(ct->user);
 	SurviveCalData * cd = ctx->calptr;
 	int id = ct->user1;
@@ -73,6 +72,7 @@ void ootx_packet_clbk_d(ootx_decoder_context *ct, ootx_packet* packet)
 	BaseStationData * b = &ctx->bsd[id];
 	//print_lighthouse_info_v6(&v6);
 
+	survive_get_bsd_lock(ctx);
 	b->BaseStationID = v6.id;
 	b->fcal[0].phase = v6.fcal_0_phase;
 	b->fcal[1].phase = v6.fcal_1_phase;
@@ -91,9 +91,10 @@ void ootx_packet_clbk_d(ootx_decoder_context *ct, ootx_packet* packet)
 	b->OOTXSet = 1;
 
 	config_set_lighthouse(ctx->lh_config,b,id);
-	lighthouses_completed++;
+	survive_release_bsd_lock(ctx);
+	cd->ootx_lighthouses_completed++;
 
-	if (lighthouses_completed >= ctx->activeLighthouses) {
+	if (cd->ootx_lighthouses_completed >= ctx->activeLighthouses) {
 		config_save(ctx, survive_configs(ctx, "configfile", SC_GET, "config.json"));
 	}
 }
@@ -648,6 +649,7 @@ static void handle_calibration( struct SurviveCalData *cd )
 
 		int r = -1;
 		if (cd->poseobjects[obj]->PoserFn) {
+			survive_poser_worker_flush(cd->poseobjects[obj]);
 			r = cd->poseobjects[obj]->PoserFn(cd->poseobjects[obj], (PoserData *)&fsd);
 		}
 
@@ -678,21 +680,31 @@ static void handle_calibration( struct SurviveCalData *cd )
 					FLT reproj_err = 0;
 					size_t cnt = 0;
 					SurviveObject *so = cd->poseobjects[obj];
-					for (size_t idx = 0; idx < so->sensor_ct; idx++) {
+
+					// The object sits at the origin while calibrating, so its sensors are already in world space
+					FLT x[SENSORS_PER_OBJECT], y[SENSORS_PER_OBJECT], z[SENSORS_PER_OBJECT];
+					FLT reproj[2][SENSORS_PER_OBJECT];
+					size_t sensor_ct = so->sensor_ct < SENSORS_PER_OBJECT ? so->sensor_ct : SENSORS_PER_OBJECT;
+					for (size_t idx = 0; idx < sensor_ct; idx++) {
+						x[idx] = so->sensor_locations[idx * 3 + 0];
+						y[idx] = so->sensor_locations[idx * 3 + 1];
+						z[idx] = so->sensor_locations[idx * 3 + 2];
+					}
+					SurvivePose world2lh = InvertPoseRtn(lhp);
+					survive_reproject_model.reprojectXYBatch(ctx->bsd[lh].fcal, &world2lh, sensor_ct, x, y, z,
+															 reproj[0], reproj[1]);
+
+					for (size_t idx = 0; idx < sensor_ct; idx++) {
 						FLT *lengths = fsd.lengths[idx][lh];
 						FLT *pt = fsd.angles[idx][lh];
 						if (lengths[0] < 0 || lengths[1] < 0)
 							continue;
 
 						cnt++;
-						FLT reproj_pt[2];
-						survive_reproject(ctx, lh, so->sensor_locations,
-										  reproj_pt);
-
 						FLT err = 0;
 						for (int dim = 0; dim < 2; dim++) {
-							err += (reproj_pt[dim] - pt[dim]) *
-								   (reproj_pt[dim] - pt[dim]);
+							err += (reproj[dim][idx] - pt[dim]) *
+								   (reproj[dim][idx] - pt[dim]);
 						}
 						reproj_err += sqrt(err);
 					}
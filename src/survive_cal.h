@@ -49,6 +49,7 @@ struct SurviveCalData
 	SurviveContext * ctx;
 	//OOTX Data is sync'd off of the sync pulses coming from the lighthouses.
 	ootx_decoder_context ootx_decoders[NUM_GEN1_LIGHTHOUSES];
+	uint8_t ootx_lighthouses_completed;
 
 	//For statistics-gathering phase. (Stage 2/3)
 	FLT all_lengths[MAX_SENSORS_TO_CAL][NUM_GEN1_LIGHTHOUSES][2][DRPTS + 1];
@@ -32,21 +32,64 @@ struct static_conf_t
 static struct static_conf_t *head = 0;
 static struct static_conf_t *tail = 0;
 
-static struct static_conf_t *find_or_create_conf_t(const char *name) {
-	struct static_conf_t *curr = head;
-	while (curr) {
-		if (strcmp(curr->name, name) == 0)
-			return curr;
-		curr = curr->next;
+// FNV-1a; used for both the static registry and the config groups
+static uint32_t config_tag_hash(const char *tag) {
+	uint32_t h = 2166136261u;
+	for (; *tag; tag++) {
+		h ^= (uint8_t)*tag;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+// Open addressed index over the static registry, rebuilt whenever it gets half full
+static struct static_conf_t **static_index = 0;
+static size_t static_index_size = 0;
+static size_t static_cnt = 0;
+
+static void static_index_insert(struct static_conf_t *conf) {
+	size_t mask = static_index_size - 1;
+	size_t slot = config_tag_hash(conf->name) & mask;
+	while (static_index[slot])
+		slot = (slot + 1) & mask;
+	static_index[slot] = conf;
+}
+
+static struct static_conf_t *find_static_conf(const char *name) {
+	if (static_index_size == 0)
+		return 0;
+
+	size_t mask = static_index_size - 1;
+	for (size_t slot = config_tag_hash(name) & mask; static_index[slot]; slot = (slot + 1) & mask) {
+		if (strcmp(static_index[slot]->name, name) == 0)
+			return static_index[slot];
 	}
+	return 0;
+}
+
+static struct static_conf_t *find_or_create_conf_t(const char *name) {
+	struct static_conf_t *curr = find_static_conf(name);
+	if (curr)
+		return curr;
 
 	curr = SV_CALLOC(1, sizeof(struct static_conf_t));
+	curr->name = name;
 	if (tail)
 		tail->next = curr;
 	if (head == 0)
 		head = curr;
-
 	tail = curr;
+	static_cnt++;
+
+	if (static_cnt * 2 > static_index_size) {
+		free(static_index);
+		static_index_size = static_index_size ? static_index_size * 2 : 256;
+		static_index = SV_CALLOC(static_index_size, sizeof(struct static_conf_t *));
+		for (struct static_conf_t *conf = head; conf; conf = conf->next)
+			static_index_insert(conf);
+	} else {
+		static_index_insert(curr);
+	}
 	return curr;
 }
 
@@ -77,13 +120,12 @@ void survive_config_bind_variable( char vt, const char * name, const char * desc
 
 int survive_print_help_for_parameter( const char * tomap )
 {
-	for (struct static_conf_t *config = head; config; config = config->next) {
-		if (strcmp(config->name, tomap) == 0) {
-			char sthelp[160];
-			snprintf(sthelp, 159, "    %s: %s [%c]", config->name, config->description, config->type);
-			fprintf( stderr, "\0337\033[1A\033[1000D%s\0338", sthelp );
-			return 1;
-		}
+	struct static_conf_t *config = find_static_conf(tomap);
+	if (config) {
+		char sthelp[160];
+		snprintf(sthelp, 159, "    %s: %s [%c]", config->name, config->description, config->type);
+		fprintf( stderr, "\0337\033[1A\033[1000D%s\0338", sthelp );
+		return 1;
 	}
 	return 0;
 }
@@ -128,11 +170,9 @@ static void PrintConfigGroup(config_group * grp, const char ** chkval, int * cvs
 						   : (ce->type == CONFIG_UINT32) ? ":int" : (ce->type == CONFIG_STRING) ? ":string" : ".");
 
 				//Try to get description from the static tags.
-
-				for (struct static_conf_t *config = head; config; config = config->next) {
-					if (strcmp(config->name, ce->tag) == 0) {
-						printf(" %s", config->description);
-					}
+				struct static_conf_t *config = find_static_conf(ce->tag);
+				if (config) {
+					printf(" %s", config->description);
 				}
 				printf( "\n" );
 			}
@@ -199,6 +239,7 @@ void survive_print_known_configs( SurviveContext * ctx, int verbose )
 }
 
 const FLT *config_set_float_a(config_group *cg, const char *tag, const FLT *values, uint8_t count);
+static void config_entry_changed(config_group *cg, config_entry *cv);
 
 void init_config_entry(config_entry *ce) {
 	ce->data = NULL;
@@ -217,6 +258,33 @@ void destroy_config_entry(config_entry *ce) {
 		free(ce->data);
 		ce->data = NULL;
 	}
+	while (ce->update_list) {
+		update_list_t *next = ce->update_list->next;
+		free(ce->update_list);
+		ce->update_list = next;
+	}
+}
+
+static void config_group_index_insert(config_group *cg, uint16_t entry_idx) {
+	uint32_t mask = cg->index_size - 1;
+	uint32_t slot = config_tag_hash(cg->config_entries[entry_idx].tag) & mask;
+	while (cg->index[slot])
+		slot = (slot + 1) & mask;
+	cg->index[slot] = entry_idx + 1;
+}
+
+// Sizes the index to keep it at most half full even once every entry is used
+static void config_group_reindex(config_group *cg) {
+	uint32_t size = 16;
+	while (size < 2u * cg->max_entries)
+		size *= 2;
+
+	free(cg->index);
+	cg->index = SV_CALLOC(size, sizeof(uint16_t));
+	cg->index_size = size;
+	for (uint16_t i = 0; i < cg->used_entries; i++) {
+		config_group_index_insert(cg, i);
+	}
 }
 
 void init_config_group(config_group *cg, uint8_t count, SurviveContext * ctx) {
@@ -225,6 +293,8 @@ void init_config_group(config_group *cg, uint8_t count, SurviveContext * ctx) {
 	cg->max_entries = count;
 	cg->config_entries = NULL;
 	cg->ctx = ctx;
+	cg->index = NULL;
+	cg->index_size = 0;
 
 	if (count == 0)
 		return;
@@ -234,6 +304,7 @@ void init_config_group(config_group *cg, uint8_t count, SurviveContext * ctx) {
 	for (i = 0; i < count; ++i) {
 		init_config_entry(cg->config_entries + i);
 	}
+	config_group_reindex(cg);
 }
 
 void destroy_config_group(config_group *cg) {
@@ -246,6 +317,7 @@ void destroy_config_group(config_group *cg) {
 	}
 
 	free(cg->config_entries);
+	free(cg->index);
 }
 
 void resize_config_group(config_group *cg, uint16_t count) {
@@ -262,6 +334,7 @@ void resize_config_group(config_group *cg, uint16_t count) {
 		}
 
 		cg->max_entries = count;
+		config_group_reindex(cg);
 	}
 }
 
@@ -372,14 +445,15 @@ void sstrcpy(char **dest, const char *src) {
 }
 
 config_entry *find_config_entry(config_group *cg, const char *tag) {
-	if (cg == NULL) {
+	if (cg == NULL || cg->index_size == 0) {
 		return NULL;
 	}
 
-	uint16_t i = 0;
-	for (i = 0; i < cg->used_entries; ++i) {
-		if (strcmp(cg->config_entries[i].tag, tag) == 0) {
-			return cg->config_entries + i;
+	uint32_t mask = cg->index_size - 1;
+	for (uint32_t slot = config_tag_hash(tag) & mask; cg->index[slot]; slot = (slot + 1) & mask) {
+		config_entry *cv = cg->config_entries + cg->index[slot] - 1;
+		if (strcmp(cv->tag, tag) == 0) {
+			return cv;
 		}
 	}
 	return NULL;
@@ -443,6 +517,8 @@ config_entry *next_unused_entry(config_group *cg, const char * tag) {
 		resize_config_group(cg, cg->max_entries + 10);
 
 	cv = cg->config_entries + cg->used_entries;
+	sstrcpy(&(cv->tag), tag);
+	config_group_index_insert(cg, cg->used_entries);
 
 	cg->used_entries++;
 
@@ -454,19 +530,17 @@ const char *config_set_str(config_group *cg, const char *tag, const char *value)
 	if (cv == NULL)
 		cv = next_unused_entry(cg,tag);
 
-	sstrcpy(&(cv->tag), tag);
+	if (value == NULL)
+		value = "";
+	bool changed = cv->type != CONFIG_STRING || strcmp(cv->data, value) != 0;
 
-	if (NULL != value) {
-		sstrcpy(&(cv->data), value);
-	} else {
-		sstrcpy(&(cv->data), "");
-	}
+	sstrcpy(&(cv->data), value);
 	cv->type = CONFIG_STRING;
 
-	update_list_t * t = cv->update_list;
-	while( t ) { *((const char **)t->value) = value; t = t->next; }
+	if (changed)
+		config_entry_changed(cg, cv);
 
-	return value;
+	return cv->data;
 }
 
 const uint32_t config_set_uint32(config_group *cg, const char *tag, const uint32_t value) {
@@ -474,12 +548,12 @@ const uint32_t config_set_uint32(config_group *cg, const char *tag, const uint32
 	if (cv == NULL)
 		cv = next_unused_entry(cg,tag);
 
-	sstrcpy(&(cv->tag), tag);
+	bool changed = cv->type != CONFIG_UINT32 || cv->numeric.i != value;
 	cv->numeric.i = value;
 	cv->type = CONFIG_UINT32;
 
-	update_list_t * t = cv->update_list;
-	while( t ) { *((uint32_t*)t->value) = value; t = t->next; }
+	if (changed)
+		config_entry_changed(cg, cv);
 
 	return value;
 }
@@ -489,13 +563,12 @@ const FLT config_set_float(config_group *cg, const char *tag, const FLT value) {
 	if (cv == NULL)
 		cv = next_unused_entry(cg,tag);
 
-	sstrcpy(&(cv->tag), tag);
+	bool changed = cv->type != CONFIG_FLOAT || cv->numeric.f != value;
 	cv->numeric.f = value;
 	cv->type = CONFIG_FLOAT;
 
-	
-	update_list_t * t = cv->update_list;
-	while( t ) { *((FLT*)t->value) = value; t = t->next; }
+	if (changed)
+		config_entry_changed(cg, cv);
 
 	return value;
 }
@@ -505,7 +578,8 @@ const FLT *config_set_float_a(config_group *cg, const char *tag, const FLT *valu
 	if (cv == NULL)
 		cv = next_unused_entry(cg,tag);
 
-	sstrcpy(&(cv->tag), tag);
+	bool changed = cv->type != CONFIG_FLOAT_ARRAY || cv->elements != count ||
+				   memcmp(cv->data, values, sizeof(FLT) * count) != 0;
 
 	char *ptr = (char *)SV_REALLOC(cv->data, sizeof(FLT) * count);
 	assert(ptr != NULL);
@@ -515,6 +589,9 @@ const FLT *config_set_float_a(config_group *cg, const char *tag, const FLT *valu
 	cv->type = CONFIG_FLOAT_ARRAY;
 	cv->elements = count;
 
+	if (changed)
+		config_entry_changed(cg, cv);
+
 	return values;
 }
 
@@ -554,9 +631,6 @@ void write_config_group(FILE *f, config_group *cg, char *tag) {
 	}
 }
 
-// struct SurviveContext;
-SurviveContext *survive_context;
-
 void config_save(SurviveContext *ctx, const char *path) {
 	uint16_t i = 0;
 
@@ -593,29 +667,36 @@ void print_json_value(char *tag, char **values, uint16_t count) {
 	}
 }
 
-config_group *cg_stack[10]; // handle 10 nested objects deep
-uint8_t cg_stack_head = 0;
+// Where config_read is in the file; one per call so that contexts can read their config concurrently
+typedef struct config_read_state {
+	SurviveContext *ctx;
+	config_group *cg_stack[10]; // handle 10 nested objects deep
+	uint8_t cg_stack_head;
+} config_read_state;
 
-void handle_config_group(char *tag) {
-	cg_stack_head++;
+static void handle_config_group(void *user, char *tag) {
+	config_read_state *state = user;
+	state->cg_stack_head++;
 	int lh_idx;
 
 	int lhMatch = sscanf(tag, "lighthouse%d", &lh_idx);
 	if (lhMatch == 1) {
-		cg_stack[cg_stack_head] = survive_context->lh_config + lh_idx;
+		state->cg_stack[state->cg_stack_head] = state->ctx->lh_config + lh_idx;
 	} else {
-		cg_stack[cg_stack_head] = survive_context->global_config_values;
+		state->cg_stack[state->cg_stack_head] = state->ctx->global_config_values;
 	}
 }
 
-void pop_config_group() { cg_stack_head--; }
+static void pop_config_group(void *user) {
+	config_read_state *state = user;
+	state->cg_stack_head--;
+}
 
-int parse_floats(char *tag, char **values, uint8_t count) {
+static int parse_floats(config_group *cg, char *tag, char **values, uint8_t count) {
 	uint16_t i = 0;
 	FLT *f;
 	f = alloca(sizeof(FLT) * count);
 	char *end = NULL;
-	config_group *cg = cg_stack[cg_stack_head];
 
 	for (i = 0; i < count; ++i) {
 
@@ -639,12 +720,11 @@ int parse_floats(char *tag, char **values, uint8_t count) {
 	return 1;
 }
 
-int parse_uint32(char *tag, char **values, uint16_t count) {
+static int parse_uint32(config_group *cg, char *tag, char **values, uint16_t count) {
 	uint16_t i = 0;
 	FLT *l;
 	l = alloca(sizeof(FLT) * count);
 	char *end = NULL;
-	config_group *cg = cg_stack[cg_stack_head];
 
 	/*
 		//look for non numeric values
@@ -669,18 +749,19 @@ int parse_uint32(char *tag, char **values, uint16_t count) {
 	return 1;
 }
 
-void handle_tag_value(char *tag, char **values, uint8_t count) {
+static void handle_tag_value(void *user, char *tag, char **values, uint8_t count) {
+	config_read_state *state = user;
 
 	// Uncomment for more debugging of input configuration.
 	// print_json_value(tag,values,count);
 
-	config_group *cg = cg_stack[cg_stack_head];
+	config_group *cg = state->cg_stack[state->cg_stack_head];
 
 	if (NULL != *values) {
-		if (parse_uint32(tag, values, count) > 0)
+		if (parse_uint32(cg, tag, values, count) > 0)
 			return; // parse integers first, stricter rules
 
-		if (parse_floats(tag, values, count) > 0)
+		if (parse_floats(cg, tag, values, count) > 0)
 			return;
 	}
 
@@ -690,19 +771,13 @@ void handle_tag_value(char *tag, char **values, uint8_t count) {
 }
 
 void config_read(SurviveContext *sctx, const char *path) {
-	survive_context = sctx;
-
-	json_begin_object = handle_config_group;
-	json_end_object = pop_config_group;
-	json_tag_value = handle_tag_value;
-
-	cg_stack[0] = sctx->global_config_values;
-
-	json_load_file(path);
+	config_read_state state = {.ctx = sctx, .cg_stack = {sctx->global_config_values}};
+	json_load_callbacks cb = {.user = &state,
+							  .begin_object = handle_config_group,
+							  .end_object = pop_config_group,
+							  .tag_value = handle_tag_value};
 
-	json_begin_object = NULL;
-	json_end_object = NULL;
-	json_tag_value = NULL;
+	json_load_file_cb(path, &cb);
 }
 
 static config_entry *sc_search(SurviveContext *ctx, const char *tag) {
@@ -747,6 +822,46 @@ static uint32_t config_entry_as_uint32_t(config_entry *entry) {
 	return 0;
 }
 
+static void config_listener_update(SurviveContext *ctx, update_list_t *t, config_entry *entry) {
+	switch (t->type) {
+	case 'i':
+		*((int *)t->value) = config_entry_as_uint32_t(entry);
+		break;
+	case 'f':
+		*((FLT *)t->value) = config_entry_as_FLT(entry);
+		break;
+	case 's':
+		strcpy(t->value, entry->type == CONFIG_STRING ? entry->data : "");
+		break;
+	default:
+		t->fn(ctx, entry->tag, t->user);
+	}
+}
+
+// Listeners on the context's values hang off whichever of the temporary or global entries existed when they were
+// added, so both are told about the value that is now in effect -- which doesn't change when a global value is set
+// underneath a temporary one.
+static void config_entry_changed(config_group *cg, config_entry *cv) {
+	SurviveContext *ctx = cg->ctx;
+	config_entry *entries[2] = {cv, 0};
+	config_entry *effective = cv;
+
+	if (ctx && (cg == ctx->temporary_config_values || cg == ctx->global_config_values)) {
+		entries[0] = find_config_entry(ctx->temporary_config_values, cv->tag);
+		entries[1] = find_config_entry(ctx->global_config_values, cv->tag);
+		effective = entries[0] ? entries[0] : entries[1];
+		if (effective != cv) {
+			return;
+		}
+	}
+
+	for (int i = 0; i < 2; i++) {
+		for (update_list_t *t = entries[i] ? entries[i]->update_list : 0; t; t = t->next) {
+			config_listener_update(ctx, t, effective);
+		}
+	}
+}
+
 bool survive_config_is_set(SurviveContext *ctx, const char *tag) {
 	config_entry *cv = sc_search(ctx, tag);
 	return cv != 0;
@@ -764,10 +879,9 @@ FLT survive_configf(SurviveContext *ctx, const char *tag, char flags, FLT def) {
 	int i;
 	if( !(flags & SC_OVERRIDE) )
 	{
-		for (struct static_conf_t *config = head; config; config = config->next) {
-			if (strcmp(tag, config->name) == 0) {
-				def = config->data_default.f;
-			}
+		struct static_conf_t *config = find_static_conf(tag);
+		if (config) {
+			def = config->data_default.f;
 		}
 	}
 
@@ -796,10 +910,9 @@ uint32_t survive_configi(SurviveContext *ctx, const char *tag, char flags, uint3
 	int i;
 	if( !(flags & SC_OVERRIDE) )
 	{
-		for (struct static_conf_t *config = head; config; config = config->next) {
-			if (strcmp(tag, config->name) == 0) {
-				def = config->data_default.i;
-			}
+		struct static_conf_t *config = find_static_conf(tag);
+		if (config) {
+			def = config->data_default.i;
 		}
 	}
 
@@ -826,16 +939,13 @@ const char *survive_configs(SurviveContext *ctx, const char *tag, char flags, co
 	int i;
 	char foundtype = 0;
 	const char * founddata = def;
-	for (struct static_conf_t *config = head; config; config = config->next) {
-		if (!config)
-			break;
-		if (strcmp(tag, config->name) == 0) {
-			founddata = config->data_default.s;
-			foundtype = config->type;
-			if( !(flags & SC_OVERRIDE) )
-			{
-				def = founddata;
-			}
+	struct static_conf_t *config = find_static_conf(tag);
+	if (config) {
+		founddata = config->data_default.s;
+		foundtype = config->type;
+		if( !(flags & SC_OVERRIDE) )
+		{
+			def = founddata;
 		}
 	}
 
@@ -863,58 +973,101 @@ const char *survive_configs(SurviveContext *ctx, const char *tag, char flags, co
 	return def;
 }
 
-static void survive_attach_config(SurviveContext *ctx, const char *tag, void * var, char type )
-{
+// Finds the entry for tag, creating it from the static default if nothing has set it yet. Tags that were never
+// registered start out as zero of 'type', or are an error if no type is given.
+static config_entry *sc_search_or_init(SurviveContext *ctx, const char *tag, char type) {
 	config_entry *cv = sc_search(ctx, tag);
-	if( !cv )
-	{
-		//Check to see if there is a static config with this value.
-		if( type == 'i' )
-		{
-			*((int*)var) = survive_configi( ctx, tag, SC_SET, 0);
-		}
-		if( type == 'f' )
-		{
-			*((FLT*)var) = survive_configf( ctx, tag, SC_SET, 0);
-		}
-		if( type == 's' )
-		{
-			const char * cv = survive_configs( ctx, tag, SC_SET, 0);
-			memcpy( var, cv, strlen(cv) );
-		}
-		cv = sc_search(ctx, tag);
-		if (!cv && ctx) {
-			SV_GENERAL_ERROR("Configuration item %s not initialized.\n", tag);
-			return;
-		}
-	} else {
-		update_list_t **ul = &cv->update_list;
-		while (*ul) {
-			if ((*ul)->value == var)
-				return;
-			ul = &((*ul)->next);
-		}
-
-		update_list_t *t = *ul = SV_MALLOC(sizeof(update_list_t));
-		t->next = 0;
-		t->value = var;
+	if (cv) {
+		return cv;
 	}
 
-	switch (type) {
+	struct static_conf_t *config = find_static_conf(tag);
+	switch (config ? config->type : type) {
 	case 'i':
-		*((int *)var) = survive_configi(ctx, tag, SC_GET, 0);
+		survive_configi(ctx, tag, SC_SET, 0);
 		break;
 	case 'f':
-		*((FLT *)var) = survive_configf(ctx, tag, SC_GET, 0);
+		survive_configf(ctx, tag, SC_SET, 0);
 		break;
-	case 's': {
-		const char *cv = survive_configs(ctx, tag, SC_SET, 0);
-		strcpy(var, cv);
+	case 's':
+		survive_configs(ctx, tag, SC_SET, 0);
 		break;
-	}
 	default:
+		SV_GENERAL_ERROR("Configuration item %s not initialized.\n", tag);
+		return 0;
+	}
+	return sc_search(ctx, tag);
+}
+
+static update_list_t *add_listener(config_entry *cv, void *var, char type, survive_config_change_fn fn, void *user) {
+	update_list_t **ul = &cv->update_list;
+	while (*ul) {
+		if ((*ul)->value == var && (*ul)->fn == fn && (*ul)->user == user)
+			return *ul;
+		ul = &((*ul)->next);
+	}
+
+	update_list_t *t = *ul = SV_NEW(update_list_t);
+	t->value = var;
+	t->type = type;
+	t->fn = fn;
+	t->user = user;
+	return t;
+}
+
+static void remove_listener(SurviveContext *ctx, const char *tag, void *var, survive_config_change_fn fn, void *user) {
+	config_entry *entries[2] = {find_config_entry(ctx->temporary_config_values, tag),
+								find_config_entry(ctx->global_config_values, tag)};
+	if (entries[0] == 0 && entries[1] == 0) {
+		SV_GENERAL_ERROR("Configuration item %s not initialized.\n", tag);
+		return;
+	}
+
+	for (int i = 0; i < 2; i++) {
+		update_list_t **ul = entries[i] ? &entries[i]->update_list : 0;
+		while (ul && *ul) {
+			if ((*ul)->value == var && (*ul)->fn == fn && (*ul)->user == user) {
+				update_list_t *v = *ul;
+				*ul = (*ul)->next;
+				free(v);
+			} else {
+				ul = &((*ul)->next);
+			}
+		}
+	}
+}
+
+static void survive_attach_config(SurviveContext *ctx, const char *tag, void * var, char type )
+{
+	if (type != 'i' && type != 'f' && type != 's') {
 		SV_GENERAL_ERROR("Unhandled config type '%c'.\n", type);
+		return;
+	}
+
+	// Without a context there is nothing to listen to; just hand back the static default
+	if (ctx == 0) {
+		switch (type) {
+		case 'i':
+			*((int *)var) = survive_configi(ctx, tag, SC_GET, 0);
+			break;
+		case 'f':
+			*((FLT *)var) = survive_configf(ctx, tag, SC_GET, 0);
+			break;
+		case 's': {
+			struct static_conf_t *config = find_static_conf(tag);
+			strcpy(var, config && config->type == 's' && config->data_default.s ? config->data_default.s : "");
+			break;
+		}
+		}
+		return;
 	}
+
+	config_entry *cv = sc_search_or_init(ctx, tag, type);
+	if (!cv) {
+		return;
+	}
+
+	config_listener_update(ctx, add_listener(cv, var, type, 0, 0), cv);
 }
 
 SURVIVE_EXPORT void survive_attach_configi(SurviveContext *ctx, const char *tag, int * var )
@@ -938,25 +1091,25 @@ SURVIVE_EXPORT void survive_detach_config(SurviveContext *ctx, const char *tag,
 		return;
 	}
 
-	config_entry *cv = sc_search(ctx, tag);
-	if( !cv )
-	{
-		SV_GENERAL_ERROR("Configuration item %s not initialized.\n", tag);
-		return;
-	}
+	remove_listener(ctx, tag, var, 0, 0);
+}
 
-	update_list_t ** ul = &cv->update_list;
-	while( *ul )
-	{
-		if( (*ul)->value == var )
-		{
-			update_list_t * v = *ul;
-			*ul = (*ul)->next;
-			free( v );
-		} else {
-			ul = &((*ul)->next);
-		}
+SURVIVE_EXPORT void survive_config_subscribe(SurviveContext *ctx, const char *tag, survive_config_change_fn fn,
+											 void *user) {
+	config_entry *cv = sc_search_or_init(ctx, tag, 0);
+	if (cv) {
+		add_listener(cv, 0, 0, fn, user);
 	}
 }
 
+SURVIVE_EXPORT void survive_config_unsubscribe(SurviveContext *ctx, const char *tag, survive_config_change_fn fn,
+											   void *user) {
+	remove_listener(ctx, tag, 0, fn, user);
+}
 
+SURVIVE_EXPORT void survive_config_reload(SurviveContext *ctx) {
+	// The path lives in a config entry, which reading the file may reallocate
+	char path[1024];
+	snprintf(path, sizeof(path), "%s", survive_configs(ctx, "configfile", SC_GET, "config.json"));
+	config_read(ctx, path);
+}
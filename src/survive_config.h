@@ -16,9 +16,14 @@ typedef enum {
 	CONFIG_FLOAT_ARRAY = 4,
 } cval_type;
 
+// Someone that wants to hear about changes to an entry; either a variable of the given type ('i', 'f' or 's') that
+// gets the new value written to it, or a callback.
 struct update_list_t_s
 {
 	void * value;
+	char type;
+	survive_config_change_fn fn;
+	void *user;
 	struct update_list_t_s * next;
 }; 
 
@@ -43,6 +48,10 @@ typedef struct config_group {
 	uint16_t	used_entries;
 	uint16_t	max_entries;
 	SurviveContext * ctx;
+
+	// Open addressed hash of config_entries by tag; each slot holds an entry index + 1, or 0 when empty.
+	uint16_t *index;
+	uint32_t index_size;
 } config_group;
 
 //extern config_group global_config_values;
@@ -1,4 +1,5 @@
 #include "survive_default_devices.h"
+#include "survive_latency.h"
 #include "assert.h"
 #include "json_helpers.h"
 #include <jsmn.h>
@@ -413,5 +414,7 @@ void survive_destroy_device(SurviveObject *so) {
 	free(so->sensor_normals);
 	free(so->conf);
 	free(so->channel_map);
+	survive_latency_tracer_free(so->latency);
+	SurviveSensorActivations_dtor(&so->activations);
 	free(so);
 }
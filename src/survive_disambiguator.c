@@ -1,5 +1,6 @@
 #include "survive.h"
 
+#include "survive_latency.h"
 #include "survive_playback.h"
 #include <assert.h>
 #include <os_generic.h>
@@ -27,23 +28,20 @@ void handle_lightcap(SurviveObject *so, const LightcapElement *_le) {
 	// reliably change to lh_version == 1. If we see 50+ lightcap packets
 	// without these gen2 packets we can just call it for gen1.
 	if (so->ctx->lh_version == -1) {
-		static size_t pulse_count = 0;
-		static size_t total_count = 0;
-
-		total_count++;
+		so->gen_detect_total_cnt++;
 
 		if (_le->length >= 0x8000) {
 			survive_notify_gen2(so, "Lightcap length >= 0x8000");
 		} else if (_le->length >= 3000 && _le->length < 6500) {
-			pulse_count++;
+			so->gen_detect_pulse_cnt++;
 			// Only look for the OOTX pulses; otherwise we get false hits and can potentially choose gen1
 			// on a gen2 system
-			if (pulse_count++ > 30) {
+			if (so->gen_detect_pulse_cnt++ > 30) {
 				survive_notify_gen1(so, "OOTX pulses detected");
 			}
 		}
 
-		if (total_count > 100) {
+		if (so->gen_detect_total_cnt > 100) {
 			survive_notify_gen2(so, "no OOTX pulses detected");
 		}
 		return;
@@ -64,5 +62,6 @@ void handle_lightcap(SurviveObject *so, const LightcapElement *_le) {
 	if (le.sensor_id == (uint8_t)-1) {
 		return;
 	}
+	survive_latency_mark_packet(so, SURVIVE_LATENCY_LIGHTCAP);
 	so->ctx->lightcapproc(so, &le);
 }
@@ -12,6 +12,11 @@ static const char *DriverNames[MAX_DRIVERS];
 static int NrDrivers;
 
 void RegisterDriver(const char *element, survive_driver_fn data) {
+	if (NrDrivers >= MAX_DRIVERS) {
+		fprintf(stderr, "Can't register %s; already have %d drivers\n", element, MAX_DRIVERS);
+		return;
+	}
+
 	Drivers[NrDrivers] = data;
 	DriverNames[NrDrivers] = element;
 	NrDrivers++;
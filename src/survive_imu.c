@@ -79,14 +79,7 @@ static void RotateAccel(LinmathVec3d rAcc, const LinmathQuat rot, const LinmathV
 
 void update_rotation_from_rotvel(FLT t, survive_kalman_state_t *k, const CvMat *H, const CvMat *K, const CvMat *x_t0,
 								 CvMat *x_t1, const FLT *z) {
-	CvMat Z = cvMat(1, k->max_dim_cnt, SURVIVE_CV_F, (void *)(z));
-
-	CREATE_STACK_MAT(y, 1, k->max_dim_cnt);
-	// y = Z - H * X_K|k-1
-	cvGEMM(H, x_t0, -1, &Z, 1, &y, 0);
-
-	// X_k|k = X_k|k-1 + K * y
-	cvGEMM(K, &y, 1, x_t0, 1, x_t1, 0);
+	survive_kalman_linear_update(t, k, H, K, x_t0, x_t1, z);
 }
 
 static void update_rotation_from_rotation(FLT t, survive_kalman_state_t *k, const CvMat *H, const CvMat *K,
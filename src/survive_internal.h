@@ -10,8 +10,8 @@
 #include <survive.h>
 
 
-//Driver registration
-#define MAX_DRIVERS 32
+//Driver registration; the test cases register through here too
+#define MAX_DRIVERS 128
 
 SURVIVE_EXPORT survive_driver_fn GetDriver(const char *name);
 SURVIVE_EXPORT const char * GetDriverNameMatching( const char * prefix, int place );
@@ -22,7 +22,17 @@ SURVIVE_EXPORT survive_driver_fn GetDriverByConfig(SurviveContext *ctx, const ch
 
 void survive_load_plugins(const char *additional_plugin_dir);
 typedef double (*survive_run_time_fn)(const SurviveContext *ctx, void *user);
-void survive_install_run_time_fn(SurviveContext *ctx, survive_run_time_fn fn, void *user);
+SURVIVE_EXPORT void survive_install_run_time_fn(SurviveContext *ctx, survive_run_time_fn fn, void *user);
+
+// Hand reported data to the output listeners; called by the default process functions
+void survive_output_listeners_pose(SurviveObject *so, survive_timecode timecode, const SurvivePose *pose);
+void survive_output_listeners_velocity(SurviveObject *so, survive_timecode timecode, const SurviveVelocity *velocity);
+void survive_output_listeners_button(SurviveObject *so, uint8_t eventType, uint8_t buttonId, uint8_t axis1Id,
+									 uint16_t axis1Val, uint8_t axis2Id, uint16_t axis2Val);
+void survive_output_listeners_imu(SurviveObject *so, int mask, const FLT *accelgyromag, survive_timecode timecode,
+								  int id);
+void survive_output_listeners_angle(SurviveObject *so, int sensor_id, survive_timecode timecode, int lh, int plane,
+									FLT length, FLT angle);
 
 #endif
 
@@ -13,6 +13,13 @@
 	FLT *_##name = alloca(rows * cols * sizeof(FLT));                                                                  \
 	CvMat name = cvMat(rows, cols, SURVIVE_CV_F, _##name);
 
+/**
+ * The IMU tracker runs filters with two and three states at IMU rate; which is far too small for a trip through
+ * cvGEMM and BLAS to make sense. Filters with up to this many states use the fixed-size kernels below, which are
+ * written out with the state count as a compile time constant and never touch the heap or alloca.
+ */
+#define SURVIVE_KALMAN_FIXED_MAX_STATES 3
+
 static void kalman_linear_predict(FLT t, const survive_kalman_state_t *k, const CvMat *x_t0_t0, CvMat *x_t0_t1) {
 	int state_cnt = k->info.state_cnt;
 	CREATE_STACK_MAT(F, state_cnt, state_cnt);
@@ -22,6 +29,116 @@ static void kalman_linear_predict(FLT t, const survive_kalman_state_t *k, const
 	cvGEMM(&F, x_t0_t0, 1, 0, 0, x_t0_t1, 0);
 }
 
+static inline void kalman_linear_predict_fixed(FLT t, const survive_kalman_state_t *k, const CvMat *x_t0_t0,
+											   CvMat *x_t0_t1, const int N) {
+	FLT F[SURVIVE_KALMAN_FIXED_MAX_STATES * SURVIVE_KALMAN_FIXED_MAX_STATES];
+	k->info.F_fn(t, F);
+
+	const int cols = x_t0_t0->cols;
+	const FLT *x0 = x_t0_t0->data.db;
+	FLT *x1 = x_t0_t1->data.db;
+
+	// X_k|k-1 = F * X_k-1|k-1
+	for (int i = 0; i < N; i++) {
+		for (int c = 0; c < cols; c++) {
+			FLT v = 0;
+			for (int j = 0; j < N; j++)
+				v += F[i * N + j] * x0[j * cols + c];
+			x1[i * cols + c] = v;
+		}
+	}
+}
+
+static void kalman_linear_predict_2(FLT t, const survive_kalman_state_t *k, const CvMat *x_t0_t0, CvMat *x_t0_t1) {
+	kalman_linear_predict_fixed(t, k, x_t0_t0, x_t0_t1, 2);
+}
+
+static void kalman_linear_predict_3(FLT t, const survive_kalman_state_t *k, const CvMat *x_t0_t0, CvMat *x_t0_t1) {
+	kalman_linear_predict_fixed(t, k, x_t0_t0, x_t0_t1, 3);
+}
+
+static inline void kalman_predict_covariance_fixed(FLT t, survive_kalman_t *k, const int N) {
+	FLT F[SURVIVE_KALMAN_FIXED_MAX_STATES * SURVIVE_KALMAN_FIXED_MAX_STATES];
+	FLT PFt[SURVIVE_KALMAN_FIXED_MAX_STATES * SURVIVE_KALMAN_FIXED_MAX_STATES];
+	FLT *P = k->P;
+	const FLT *Q_per_sec = k->Q_per_sec;
+
+	k->F_fn(t, F);
+
+	// PFt = P * F^T
+	for (int i = 0; i < N; i++) {
+		for (int j = 0; j < N; j++) {
+			FLT v = 0;
+			for (int l = 0; l < N; l++)
+				v += P[i * N + l] * F[j * N + l];
+			PFt[i * N + j] = v;
+		}
+	}
+
+	// P = F * P * F^T + Q * t
+	for (int i = 0; i < N; i++) {
+		for (int j = 0; j < N; j++) {
+			FLT v = 0;
+			for (int l = 0; l < N; l++)
+				v += F[i * N + l] * PFt[l * N + j];
+			P[i * N + j] = v + Q_per_sec[i * N + j] * t;
+		}
+	}
+}
+
+static inline void kalman_update_covariance_fixed(survive_kalman_t *k, FLT *K, const FLT *H, FLT R, const int N) {
+	FLT *P = k->P;
+
+	// PHt = P_k|k-1 * H^T; HP = H * P_k|k-1
+	FLT PHt[SURVIVE_KALMAN_FIXED_MAX_STATES], HP[SURVIVE_KALMAN_FIXED_MAX_STATES];
+	for (int i = 0; i < N; i++) {
+		FLT ph = 0, hp = 0;
+		for (int j = 0; j < N; j++) {
+			ph += P[i * N + j] * H[j];
+			hp += H[j] * P[j * N + i];
+		}
+		PHt[i] = ph;
+		HP[i] = hp;
+	}
+
+	// S = H * P_k|k-1 * H^T + R
+	FLT S = R;
+	for (int i = 0; i < N; i++)
+		S += H[i] * PHt[i];
+
+	FLT Si = S == 0 ? 1. : (1. / S);
+
+	// K = P_k|k-1*H^T*S^-1
+	for (int i = 0; i < N; i++)
+		K[i] = PHt[i] * Si;
+
+	// P_k|k = (I - K * H) * P_k|k-1 = P_k|k-1 - K * (H * P_k|k-1)
+	for (int i = 0; i < N; i++) {
+		for (int j = 0; j < N; j++)
+			P[i * N + j] -= K[i] * HP[j];
+	}
+}
+
+static void kalman_predict_covariance_2(FLT t, survive_kalman_t *k) { kalman_predict_covariance_fixed(t, k, 2); }
+static void kalman_predict_covariance_3(FLT t, survive_kalman_t *k) { kalman_predict_covariance_fixed(t, k, 3); }
+
+static void kalman_update_covariance_2(survive_kalman_t *k, FLT *K, const FLT *H, FLT R) {
+	kalman_update_covariance_fixed(k, K, H, R, 2);
+}
+static void kalman_update_covariance_3(survive_kalman_t *k, FLT *K, const FLT *H, FLT R) {
+	kalman_update_covariance_fixed(k, K, H, R, 3);
+}
+
+static void kalman_predict_covariance_generic(FLT t, survive_kalman_t *k);
+static void kalman_update_covariance_generic(survive_kalman_t *k, FLT *K, const FLT *H, FLT R);
+
+void survive_kalman_use_generic_kernels(survive_kalman_t *k) {
+	if (k->Predict_fn == kalman_linear_predict_2 || k->Predict_fn == kalman_linear_predict_3)
+		k->Predict_fn = kalman_linear_predict;
+	k->Predict_covariance_fn = kalman_predict_covariance_generic;
+	k->Update_covariance_fn = kalman_update_covariance_generic;
+}
+
 void survive_kalman_init(survive_kalman_t *k, size_t state_cnt, F_fn_t F, const FLT *Q_per_sec, FLT *P) {
 	memset(k, 0, sizeof(*k));
 
@@ -36,7 +153,22 @@ void survive_kalman_init(survive_kalman_t *k, size_t state_cnt, F_fn_t F, const
 	}
 
 	k->P[0] = 1e10;
-	k->Predict_fn = kalman_linear_predict;
+
+	switch (state_cnt) {
+	case 2:
+		k->Predict_fn = kalman_linear_predict_2;
+		k->Predict_covariance_fn = kalman_predict_covariance_2;
+		k->Update_covariance_fn = kalman_update_covariance_2;
+		break;
+	case 3:
+		k->Predict_fn = kalman_linear_predict_3;
+		k->Predict_covariance_fn = kalman_predict_covariance_3;
+		k->Update_covariance_fn = kalman_update_covariance_3;
+		break;
+	default:
+		survive_kalman_use_generic_kernels(k);
+		break;
+	}
 }
 
 void survive_kalman_free(survive_kalman_t *k) {
@@ -85,7 +217,7 @@ void print_mat(const CvMat *M) {
 	printf("\n");
 }
 
-void survive_kalman_predict_covariance(FLT t, survive_kalman_t *k) {
+static void kalman_predict_covariance_generic(FLT t, survive_kalman_t *k) {
 	int dims = k->state_cnt;
 
 	CREATE_STACK_MAT(F, dims, dims);
@@ -101,7 +233,7 @@ void survive_kalman_predict_covariance(FLT t, survive_kalman_t *k) {
 	cvGEMM(&F, &tmp, 1, &Q_per_sec, t, &Pk1_k1, 0);
 }
 
-void survive_kalman_update_covariance(FLT t, survive_kalman_t *k, FLT *_K, const FLT *_H, FLT _R) {
+static void kalman_update_covariance_generic(survive_kalman_t *k, FLT *_K, const FLT *_H, FLT _R) {
 	int dims = k->state_cnt;
 
 	CvMat Pk_k = cvMat(dims, dims, SURVIVE_CV_F, k->P);
@@ -145,8 +277,8 @@ void survive_kalman_update_covariance(FLT t, survive_kalman_t *k, FLT *_K, const
 }
 
 void survive_kalman_predict_update_covariance(FLT t, survive_kalman_t *k, FLT *K, const FLT *H, FLT R) {
-	survive_kalman_predict_covariance(t, k);
-	survive_kalman_update_covariance(t, k, K, H, R);
+	k->Predict_covariance_fn(t, k);
+	k->Update_covariance_fn(k, K, H, R);
 }
 
 static inline void survive_kalman_predict(FLT t, survive_kalman_state_t *k, const CvMat *x_t0_t0, CvMat *x_t0_t1) {
@@ -157,25 +289,48 @@ static inline void survive_kalman_predict(FLT t, survive_kalman_state_t *k, cons
 void survive_kalman_predict_update_state_extended(FLT t, survive_kalman_state_t *k, const FLT *z, const FLT *_H,
 												  Update_fn_t updateFn, FLT R) {
 	int state_cnt = k->info.state_cnt;
-	CREATE_STACK_MAT(K, state_cnt, 1);
+	FLT _K[SURVIVE_KALMAN_FIXED_MAX_STATES];
+	FLT *K_storage = state_cnt <= SURVIVE_KALMAN_FIXED_MAX_STATES ? _K : alloca(state_cnt * sizeof(FLT));
+	CvMat K = cvMat(state_cnt, 1, SURVIVE_CV_F, K_storage);
 
 	const CvMat H = cvMat(1, state_cnt, SURVIVE_CV_F, (void *)_H);
 
 	// Run predict / update; filling in K
-	survive_kalman_predict_update_covariance(t, &k->info, _K, _H, R);
+	survive_kalman_predict_update_covariance(t, &k->info, K_storage, _H, R);
 
 	// To avoid an unneeded copy, x1 here is both X_k-1|k-1 and X_k|k.
 	// x is X_k|k-1
 	CvMat x1 = cvMat(state_cnt, k->max_dim_cnt, SURVIVE_CV_F, k->state);
 
-	CREATE_STACK_MAT(x2, state_cnt, k->max_dim_cnt);
+	FLT _x2[SURVIVE_KALMAN_FIXED_MAX_STATES * 4];
+	size_t x2_cnt = state_cnt * k->max_dim_cnt;
+	FLT *x2_storage = x2_cnt <= sizeof(_x2) / sizeof(_x2[0]) ? _x2 : alloca(x2_cnt * sizeof(FLT));
+	CvMat x2 = cvMat(state_cnt, k->max_dim_cnt, SURVIVE_CV_F, x2_storage);
 	survive_kalman_predict(t, k, &x1, &x2);
 
 	updateFn(t, k, &H, &K, &x2, &x1, z);
 }
 
-static void linear_update(FLT t, survive_kalman_state_t *k, const CvMat *H, const CvMat *K, const CvMat *x_t0,
-						  CvMat *x_t1, const FLT *z) {
+void survive_kalman_linear_update(FLT t, survive_kalman_state_t *k, const CvMat *H, const CvMat *K,
+								  const CvMat *x_t0, CvMat *x_t1, const FLT *z) {
+	int state_cnt = k->info.state_cnt;
+	if (state_cnt <= SURVIVE_KALMAN_FIXED_MAX_STATES) {
+		int cols = k->max_dim_cnt;
+		const FLT *h = H->data.db, *gain = K->data.db, *x0 = x_t0->data.db;
+		FLT *x1 = x_t1->data.db;
+		for (int c = 0; c < cols; c++) {
+			// y = Z - H * X_K|k-1
+			FLT y = z[c];
+			for (int i = 0; i < state_cnt; i++)
+				y -= h[i] * x0[i * cols + c];
+
+			// X_k|k = X_k|k-1 + K * y
+			for (int i = 0; i < state_cnt; i++)
+				x1[i * cols + c] = x0[i * cols + c] + gain[i] * y;
+		}
+		return;
+	}
+
 	CvMat Z = cvMat(1, k->max_dim_cnt, SURVIVE_CV_F, (void *)(z));
 
 	CREATE_STACK_MAT(y, 1, k->max_dim_cnt);
@@ -187,22 +342,22 @@ static void linear_update(FLT t, survive_kalman_state_t *k, const CvMat *H, cons
 }
 
 void survive_kalman_predict_update_state(FLT t, survive_kalman_state_t *k, const FLT *z, const FLT *_H, FLT R) {
-	survive_kalman_predict_update_state_extended(t, k, z, _H, linear_update, R);
+	survive_kalman_predict_update_state_extended(t, k, z, _H, survive_kalman_linear_update, R);
 }
 
 void survive_kalman_predict_state(FLT t, const survive_kalman_state_t *k, size_t index, FLT *_out) {
 	int state_cnt = k->info.state_cnt;
-	CREATE_STACK_MAT(F, state_cnt, state_cnt);
-	(void)F;
+	FLT _F_fixed[SURVIVE_KALMAN_FIXED_MAX_STATES * SURVIVE_KALMAN_FIXED_MAX_STATES];
+	FLT *_F = state_cnt <= SURVIVE_KALMAN_FIXED_MAX_STATES ? _F_fixed : alloca(state_cnt * state_cnt * sizeof(FLT));
 
 	k->info.F_fn(t, _F);
 
-	CREATE_STACK_MAT(tmpOut, 1, k->max_dim_cnt);
-	CvMat x = cvMat(state_cnt, k->max_dim_cnt, SURVIVE_CV_F, k->state);
-
-	// Truncate F so that is only the 'index'nth row. This avoids unneeded multiplications / copies.
-	CvMat FTrunc = cvMat(1, state_cnt, SURVIVE_CV_F, _F + state_cnt * index);
-	cvGEMM(&FTrunc, &x, 1, 0, 0, &tmpOut, 0);
-
-	memcpy(_out, _tmpOut, sizeof(FLT) * k->dimension_cnt[index]);
+	// Only the 'index'nth row of F is needed. This avoids unneeded multiplications / copies.
+	const FLT *FRow = _F + state_cnt * index;
+	for (int c = 0; c < k->dimension_cnt[index]; c++) {
+		FLT v = 0;
+		for (int i = 0; i < state_cnt; i++)
+			v += FRow[i] * k->state[i * k->max_dim_cnt + c];
+		_out[c] = v;
+	}
 }
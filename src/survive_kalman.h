@@ -12,6 +12,10 @@ typedef void (*Update_fn_t)(FLT t, struct survive_kalman_state_s *k, const struc
 							const struct CvMat *x_t0, struct CvMat *x_t1, const FLT *z);
 typedef void (*Map_to_obs)(FLT *z_out, const FLT *f_in);
 
+struct survive_kalman_s;
+typedef void (*Predict_covariance_fn_t)(FLT t, struct survive_kalman_s *k);
+typedef void (*Update_covariance_fn_t)(struct survive_kalman_s *k, FLT *K, const FLT *H, FLT R);
+
 /**
  * https://en.wikipedia.org/wiki/Kalman_filter#Underlying_dynamical_system_model
  *
@@ -37,6 +41,10 @@ typedef struct survive_kalman_s {
 	Predict_fn_t Predict_fn;
 	Map_to_obs Map_fn;
 
+	// Covariance predict / update; picked by survive_kalman_init. Small state counts get fixed-size kernels.
+	Predict_covariance_fn_t Predict_covariance_fn;
+	Update_covariance_fn_t Update_covariance_fn;
+
 	// Added covariance per sec is time varying; but is a constant matrix that is multiplied by delta T. Process noise
 	// for these models will always have a time component essentially.
 	const FLT *Q_per_sec;
@@ -82,7 +90,7 @@ void survive_kalman_predict_update_covariance(FLT t, survive_kalman_t *k, FLT *K
  * @param index Which state vector to pull out
  * @param out Pre allocated output buffer.
  */
-void survive_kalman_predict_state(FLT t, const survive_kalman_state_t *k, size_t index, FLT *out);
+SURVIVE_EXPORT void survive_kalman_predict_state(FLT t, const survive_kalman_state_t *k, size_t index, FLT *out);
 
 /**
  * Run predict and update, also updating the state matrix.
@@ -92,14 +100,27 @@ void survive_kalman_predict_state(FLT t, const survive_kalman_state_t *k, size_t
  * @param H Input observation model
  * @param R Observation noise
  */
-void survive_kalman_predict_update_state(FLT t, survive_kalman_state_t *k, const FLT *z, const FLT *H, FLT R);
+SURVIVE_EXPORT void survive_kalman_predict_update_state(FLT t, survive_kalman_state_t *k, const FLT *z, const FLT *H,
+													   FLT R);
 void survive_kalman_predict_update_state_extended(FLT t, survive_kalman_state_t *k, const FLT *z, const FLT *H,
 												  Update_fn_t updateFn, FLT R);
 
+/**
+ * Update function for a linear observation model: X_k|k = X_k|k-1 + K * (z - H * X_k|k-1)
+ */
+void survive_kalman_linear_update(FLT t, survive_kalman_state_t *k, const struct CvMat *H, const struct CvMat *K,
+								  const struct CvMat *x_t0, struct CvMat *x_t1, const FLT *z);
+
+/**
+ * Switches 'k' over to the generic, arbitrarily sized kernels. survive_kalman_init already picks these for state
+ * counts that have no fixed-size kernel; this is mostly useful for testing and benchmarking.
+ */
+SURVIVE_EXPORT void survive_kalman_use_generic_kernels(survive_kalman_t *k);
+
 void survive_kalman_init(survive_kalman_t *k, size_t state_cnt, F_fn_t F, const FLT *Q_per_sec, FLT *P);
 void survive_kalman_free(survive_kalman_t *k);
-void survive_kalman_state_init(survive_kalman_state_t *k, size_t state_cnt, F_fn_t F, const FLT *Q_per_sec, FLT *P,
-							   size_t *dims, FLT *state);
-void survive_kalman_state_free(survive_kalman_state_t *k);
+SURVIVE_EXPORT void survive_kalman_state_init(survive_kalman_state_t *k, size_t state_cnt, F_fn_t F,
+											  const FLT *Q_per_sec, FLT *P, size_t *dims, FLT *state);
+SURVIVE_EXPORT void survive_kalman_state_free(survive_kalman_state_t *k);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "survive_latency.h"
+#include "survive_atomic.h"
+
+#include <math.h>
+#include <os_generic.h>
+
+// Log-spaced buckets of whole microseconds, four per octave; percentiles are reported as the upper edge of their
+// bucket so they overestimate by up to ~19%. The last bucket collects everything past ~16 seconds.
+#define LATENCY_BUCKETS_PER_OCTAVE 4
+#define LATENCY_BUCKET_CNT 96
+
+typedef struct survive_latency_histogram {
+	uint32_t count;
+	uint32_t max_us;
+	uint32_t buckets[LATENCY_BUCKET_CNT];
+} survive_latency_histogram;
+
+struct survive_latency_tracer {
+	survive_latency_histogram stages[SURVIVE_LATENCY_STAGE_COUNT];
+};
+
+static const char *stage_names[SURVIVE_LATENCY_STAGE_COUNT] = {
+	[SURVIVE_LATENCY_LIGHTCAP] = "lightcap", [SURVIVE_LATENCY_DISAMBIGUATOR] = "disambiguator",
+	[SURVIVE_LATENCY_ANGLE] = "angle",		 [SURVIVE_LATENCY_POSER] = "poser",
+	[SURVIVE_LATENCY_POSE] = "pose",
+};
+
+const char *survive_latency_stage_str(SurviveLatencyStage stage) {
+	if (stage < 0 || stage >= SURVIVE_LATENCY_STAGE_COUNT)
+		return "unknown";
+	return stage_names[stage];
+}
+
+static size_t bucket_for(uint32_t us) {
+	if (us <= 1)
+		return 0;
+	size_t bucket = (size_t)(LATENCY_BUCKETS_PER_OCTAVE * log2((double)us));
+	return bucket < LATENCY_BUCKET_CNT ? bucket : LATENCY_BUCKET_CNT - 1;
+}
+
+static double bucket_upper_us(size_t bucket) { return pow(2., (bucket + 1) / (double)LATENCY_BUCKETS_PER_OCTAVE); }
+
+survive_latency_tracer *survive_latency_tracer_create(void) { return SV_NEW(survive_latency_tracer); }
+
+void survive_latency_tracer_free(survive_latency_tracer *tracer) { free(tracer); }
+
+void survive_latency_record(survive_latency_tracer *tracer, SurviveLatencyStage stage, double arrival_time) {
+	double age = OGGetAbsoluteTime() - arrival_time;
+	if (age < 0)
+		age = 0;
+	uint32_t us = age * 1e6 > UINT32_MAX ? UINT32_MAX : (uint32_t)(age * 1e6);
+
+	// Stages can be hit from the driver thread, poser workers and optimizer threads at once
+	survive_latency_histogram *h = &tracer->stages[stage];
+	survive_atomic_fetch_add_u32(&h->buckets[bucket_for(us)], 1);
+	survive_atomic_fetch_add_u32(&h->count, 1);
+
+	uint32_t max_us = survive_atomic_load_u32(&h->max_us);
+	while (us > max_us && !survive_atomic_cas_u32(&h->max_us, &max_us, us))
+		;
+}
+
+static FLT percentile(const survive_latency_histogram *h, uint32_t count, FLT p) {
+	uint32_t target = (uint32_t)ceil(p * count);
+	uint32_t seen = 0;
+	for (size_t i = 0; i < LATENCY_BUCKET_CNT; i++) {
+		seen += survive_atomic_load_u32(&h->buckets[i]);
+		if (seen >= target && seen > 0) {
+			double us = bucket_upper_us(i);
+			uint32_t max_us = survive_atomic_load_u32(&h->max_us);
+			return (us > max_us ? max_us : us) / 1e6;
+		}
+	}
+	return survive_atomic_load_u32(&h->max_us) / 1e6;
+}
+
+bool survive_object_latency(const SurviveObject *so, SurviveLatencyStage stage, SurviveLatencyStats *stats) {
+	if (so->latency == 0 || stage < 0 || stage >= SURVIVE_LATENCY_STAGE_COUNT) {
+		return false;
+	}
+
+	const survive_latency_histogram *h = &so->latency->stages[stage];
+	uint32_t count = survive_atomic_load_u32(&h->count);
+	*stats = (SurviveLatencyStats){.count = count};
+	if (count) {
+		stats->p50 = percentile(h, count, .5);
+		stats->p99 = percentile(h, count, .99);
+		stats->max = survive_atomic_load_u32(&h->max_us) / 1e6;
+	}
+	return true;
+}
+
+void survive_latency_report(SurviveObject *so) {
+	if (so->latency == 0) {
+		return;
+	}
+
+	SurviveContext *ctx = so->ctx;
+	SV_INFO("Latency for %s:", so->codename);
+	for (int stage = 0; stage < SURVIVE_LATENCY_STAGE_COUNT; stage++) {
+		SurviveLatencyStats stats;
+		if (!survive_object_latency(so, stage, &stats) || stats.count == 0)
+			continue;
+		SV_INFO("\t%-14s %8u samples  p50 %8.3fms  p99 %8.3fms  max %8.3fms", survive_latency_stage_str(stage),
+				stats.count, 1000. * stats.p50, 1000. * stats.p99, 1000. * stats.max);
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <poser.h>
+#include <survive.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * With 'latency-trace' enabled, every object gets a tracer that keeps a histogram per SurviveLatencyStage of how long
+ * ago the packet behind the data arrived. The arrival time is stamped by the driver on the context while the packet is
+ * processed, and copied into PoserData so it survives the hop onto poser worker threads and async optimizers.
+ *
+ * Objects without a tracer skip everything after a null check.
+ */
+typedef struct survive_latency_tracer survive_latency_tracer;
+
+SURVIVE_EXPORT survive_latency_tracer *survive_latency_tracer_create(void);
+SURVIVE_EXPORT void survive_latency_tracer_free(survive_latency_tracer *tracer);
+
+/**
+ * Records the age of data that arrived at 'arrival_time' as it reaches 'stage'. Safe to call from any thread.
+ */
+SURVIVE_EXPORT void survive_latency_record(survive_latency_tracer *tracer, SurviveLatencyStage stage,
+										   double arrival_time);
+
+/**
+ * Logs the histograms of 'so', if it has any.
+ */
+SURVIVE_EXPORT void survive_latency_report(SurviveObject *so);
+
+static inline void survive_latency_mark(SurviveObject *so, SurviveLatencyStage stage, double arrival_time) {
+	if (so->latency && arrival_time > 0) {
+		survive_latency_record(so->latency, stage, arrival_time);
+	}
+}
+
+/**
+ * Marks 'stage' for the packet the context is currently processing
+ */
+static inline void survive_latency_mark_packet(SurviveObject *so, SurviveLatencyStage stage) {
+	if (so->latency) {
+		survive_latency_mark(so, stage, survive_latency_packet_arrival(so->ctx));
+	}
+}
+
+/**
+ * Copies the current packet's arrival time into 'pd' so later stages can find it
+ */
+static inline void survive_latency_stamp(SurviveObject *so, PoserData *pd) {
+	if (so->latency) {
+		pd->arrival_time = survive_latency_packet_arrival(so->ctx);
+	}
+}
+
+#ifdef __cplusplus
+};
+#endif
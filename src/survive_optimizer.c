@@ -12,6 +12,7 @@
 
 #include "mpfit/mpfit.h"
 #include "survive_default_devices.h"
+#include "survive_parallel.h"
 #include <malloc.h>
 
 STATIC_CONFIG_ITEM(OPTIMIZER_FTOL, "optimizer-ftol", 'f', "Relative chi-square convergence criterium", 0.)
@@ -25,6 +26,12 @@ STATIC_CONFIG_ITEM(OPTIMIZER_MAXITER, "optimizer-maxiter", 'i', "Maximum iterati
 STATIC_CONFIG_ITEM(OPTIMIZER_MAXFEV, "optimizer-maxfev", 'i', "Maximum function evals", 0)
 STATIC_CONFIG_ITEM(OPTIMIZER_NORMTOL, "optimizer-normtol", 'f', "Convergence for norm", 0.00005)
 STATIC_CONFIG_ITEM(OPTIMIZER_NPRINT, "optimizer-nprint", 'i', "", 0)
+STATIC_CONFIG_ITEM(OPTIMIZER_POSE_SOLVER, "optimizer-pose-solver", 'i',
+				   "Use the dedicated solver when only the object pose is free", 1)
+STATIC_CONFIG_ITEM(OPTIMIZER_PARALLEL_THRESHOLD, "optimizer-parallel-threshold", 'i',
+				   "Split residual and jacobian evaluation over threads for problems with at least this many "
+				   "measurements. 0 disables it.",
+				   0)
 
 static char *object_parameter_names[] = {"Pose x",	 "Pose y",	 "Pose z",	"Pose Rot w",
 										 "Pose Rot x", "Pose Rot y", "Pose Rot z"};
@@ -174,6 +181,16 @@ SurvivePose *survive_optimizer_get_pose(survive_optimizer *ctx) {
 		return (SurvivePose *)ctx->parameters;
 	return &ctx->initialPose;
 }
+static inline void store_pair_jacobian(double **derivs, int jac_offset, size_t meas_idx, const FLT *jac) {
+	for (int j = 0; j < 6; j++) {
+		assert(derivs[jac_offset + j] && "all 7 parameters should be the same for jacobian calculation");
+		derivs[jac_offset + j][meas_idx] = jac[j];
+		derivs[jac_offset + j][meas_idx + 1] = jac[j + 6];
+		assert(!isnan(jac[j]));
+		assert(!isnan(jac[j + 6]));
+	}
+}
+
 static inline void run_pair_measurement(survive_optimizer *mpfunc_ctx, size_t meas_idx,
 										const survive_reproject_model_t *reprojectModel,
 										const survive_optimizer_measurement *meas, const LinmathAxisAnglePose *pose,
@@ -185,6 +202,36 @@ static inline void run_pair_measurement(survive_optimizer *mpfunc_ctx, size_t me
 	const struct BaseStationCal *cal = survive_optimizer_get_calibration(mpfunc_ctx, lh);
 	const FLT *pt = &sensor_points[meas->sensor_idx * 3];
 
+	int jac_offset_lh = (lh + mpfunc_ctx->poseLength) * 7;
+	int jac_offset_obj = meas->object * 7;
+	bool needs_obj_jac = derivs && derivs[jac_offset_obj];
+	bool needs_lh_jac = derivs && derivs[jac_offset_lh];
+
+	LinmathAxisAnglePose safe_pose = *pose, safe_world2lh = *world2lh;
+	if (needs_obj_jac || needs_lh_jac) {
+		if (magnitude3d(safe_pose.AxisAngleRot) == 0)
+			safe_pose.AxisAngleRot[0] = 1e-10;
+		if (magnitude3d(safe_world2lh.AxisAngleRot) == 0)
+			safe_world2lh.AxisAngleRot[0] = 1e-10;
+	}
+
+	// Value and both jacobians share most of their terms, so when the model has a fused kernel one call does it all
+	if ((needs_obj_jac || needs_lh_jac) && reprojectModel->reprojectAxisAngleWithJacs) {
+		FLT out[2 + 2 * 2 * 6];
+		reprojectModel->reprojectAxisAngleWithJacs(out, &safe_pose, pt, &safe_world2lh, cal);
+
+		deviates[0] = (out[meas[0].axis] - meas[0].value) / meas[0].variance;
+		deviates[1] = (out[meas[1].axis] - meas[1].value) / meas[1].variance;
+		assert(isfinite(deviates[0]));
+		assert(isfinite(deviates[1]));
+
+		if (needs_obj_jac)
+			store_pair_jacobian(derivs, jac_offset_obj, meas_idx, out + 2);
+		if (needs_lh_jac)
+			store_pair_jacobian(derivs, jac_offset_lh, meas_idx, out + 2 + 2 * 6);
+		return;
+	}
+
 	LinmathPoint3d sensorPtInLH;
 	ApplyAxisAnglePoseToPoint(sensorPtInLH, obj2lh, pt);
 
@@ -197,41 +244,16 @@ static inline void run_pair_measurement(survive_optimizer *mpfunc_ctx, size_t me
 	assert(isfinite(deviates[0]));
 	assert(isfinite(deviates[1]));
 
-	if (derivs) {
-		int jac_offset_lh = (lh + mpfunc_ctx->poseLength) * 7;
-		int jac_offset_obj = meas->object * 7;
-
-		LinmathAxisAnglePose safe_pose = *pose, safe_world2lh = *world2lh;
-		if (magnitude3d(safe_pose.AxisAngleRot) == 0)
-			safe_pose.AxisAngleRot[0] = 1e-10;
-		if (magnitude3d(safe_world2lh.AxisAngleRot) == 0)
-			safe_world2lh.AxisAngleRot[0] = 1e-10;
-
-		if (derivs[jac_offset_obj]) {
-			FLT out[7 * 2] = {0};
-			// reprojectModel->reprojectFullJacObjPose(out, pose, pt, world2lh, cal);
-			reprojectModel->reprojectAxisAngleFullJacObjPose(out, pose, pt, world2lh, cal);
-			// SV_INFO("Double obj %3d %3d %f", jac_offset_obj, meas_idx, out[0]);
-			for (int j = 0; j < 6; j++) {
-				assert(derivs[jac_offset_obj + j] && "all 7 parameters should be the same for jacobian calculation");
-				derivs[jac_offset_obj + j][meas_idx] = out[j];
-				derivs[jac_offset_obj + j][meas_idx + 1] = out[j + 6];
-				assert(!isnan(out[j]));
-				assert(!isnan(out[j + 6]));
-			}
-		}
+	if (needs_obj_jac) {
+		FLT out[7 * 2] = {0};
+		reprojectModel->reprojectAxisAngleFullJacObjPose(out, &safe_pose, pt, &safe_world2lh, cal);
+		store_pair_jacobian(derivs, jac_offset_obj, meas_idx, out);
+	}
 
-		if (derivs[jac_offset_lh]) {
-			FLT out[7 * 2] = {0};
-			reprojectModel->reprojectAxisAngleFullJacLhPose(out, pose, pt, world2lh, cal);
-			for (int j = 0; j < 6; j++) {
-				assert(derivs[jac_offset_lh + j] && "all 7 parameters should be the same for jacobian calculation");
-				derivs[jac_offset_lh + j][meas_idx] = out[j];
-				derivs[jac_offset_lh + j][meas_idx + 1] = out[j + 6];
-				assert(!isnan(out[j]));
-				assert(!isnan(out[j + 6]));
-			}
-		}
+	if (needs_lh_jac) {
+		FLT out[7 * 2] = {0};
+		reprojectModel->reprojectAxisAngleFullJacLhPose(out, &safe_pose, pt, &safe_world2lh, cal);
+		store_pair_jacobian(derivs, jac_offset_lh, meas_idx, out);
 	}
 }
 static void run_single_measurement(survive_optimizer *mpfunc_ctx, size_t meas_idx,
@@ -278,45 +300,84 @@ static void run_single_measurement(survive_optimizer *mpfunc_ctx, size_t meas_id
 	}
 }
 
-static int mpfunc(int m, int n, double *p, double *deviates, double **derivs, void *private) {
-	survive_optimizer *mpfunc_ctx = private;
-	SurviveContext *ctx = mpfunc_ctx->so ? mpfunc_ctx->so->ctx : 0;
-
+/**
+ * Residuals alone come up for every trial step, so they skip the per measurement path. Each run of measurements from
+ * one object against one lighthouse is reprojected with a single batch call, with both halves of a pair sharing a
+ * point.
+ */
+static void mpfunc_range_residuals(survive_optimizer *mpfunc_ctx, int begin, int end, double *deviates) {
 	const survive_reproject_model_t *reprojectModel = mpfunc_ctx->reprojectModel;
-	mpfunc_ctx->parameters = p;
-
 	SurvivePose *cameras = survive_optimizer_get_camera(mpfunc_ctx);
+	const double *sensor_points = survive_optimizer_get_sensors(mpfunc_ctx);
 
-	int start = survive_optimizer_get_camera_index(mpfunc_ctx);
-	for (int i = 0; i < mpfunc_ctx->cameraLength; i++) {
-		if (!mpfunc_ctx->parameters_info[start + 7 * i].fixed) {
-			// quatnormalize(cameras[i].Rot, cameras[i].Rot);
+	FLT x[SURVIVE_REPROJECT_BATCH_CHUNK], y[SURVIVE_REPROJECT_BATCH_CHUNK], z[SURVIVE_REPROJECT_BATCH_CHUNK];
+	FLT ang[2][SURVIVE_REPROJECT_BATCH_CHUNK];
+	uint8_t point_idx[2 * SURVIVE_REPROJECT_BATCH_CHUNK];
+
+	int i = begin;
+	while (i < end) {
+		const survive_optimizer_measurement *first = &mpfunc_ctx->measurements[i];
+		const LinmathAxisAnglePose *pose =
+			(const LinmathAxisAnglePose *)&survive_optimizer_get_pose(mpfunc_ctx)[first->object];
+		LinmathAxisAnglePose obj2lhAA;
+		ApplyAxisAnglePoseToPose(&obj2lhAA, (const LinmathAxisAnglePose *)&cameras[first->lh], pose);
+		SurvivePose obj2lh = {.Pos = {obj2lhAA.Pos[0], obj2lhAA.Pos[1], obj2lhAA.Pos[2]}};
+		const LinmathAxisAngleMag obj2lhRot = {obj2lhAA.AxisAngleRot[0], obj2lhAA.AxisAngleRot[1],
+											   obj2lhAA.AxisAngleRot[2]};
+		quatfromaxisanglemag(obj2lh.Rot, obj2lhRot);
+
+		int run_end = i;
+		size_t pt_cnt = 0;
+		for (; run_end < end; run_end++) {
+			const survive_optimizer_measurement *meas = &mpfunc_ctx->measurements[run_end];
+			if (meas->object != first->object || meas->lh != first->lh)
+				break;
+
+			bool shares_point = run_end > i && meas[-1].sensor_idx == meas->sensor_idx;
+			if (!shares_point) {
+				if (pt_cnt == SURVIVE_REPROJECT_BATCH_CHUNK)
+					break;
+				const FLT *pt = &sensor_points[meas->sensor_idx * 3];
+				x[pt_cnt] = pt[0];
+				y[pt_cnt] = pt[1];
+				z[pt_cnt] = pt[2];
+				pt_cnt++;
+			}
+			point_idx[run_end - i] = pt_cnt - 1;
 		}
+
+		const BaseStationCal *cal = survive_optimizer_get_calibration(mpfunc_ctx, first->lh);
+		reprojectModel->reprojectXYBatch(cal, &obj2lh, pt_cnt, x, y, z, ang[0], ang[1]);
+
+		for (int j = i; j < run_end; j++) {
+			const survive_optimizer_measurement *meas = &mpfunc_ctx->measurements[j];
+			deviates[j] = (ang[meas->axis][point_idx[j - i]] - meas->value) / meas->variance;
+			assert(isfinite(deviates[j]));
+		}
+		i = run_end;
+	}
+}
+
+// Runs measurements [begin, end); 'end' must not split a pair. Each call keeps its own pose cache, so ranges can run
+// concurrently as long as they don't overlap.
+static void mpfunc_range(survive_optimizer *mpfunc_ctx, int m, int begin, int end, double *deviates,
+						 double **derivs) {
+	const survive_reproject_model_t *reprojectModel = mpfunc_ctx->reprojectModel;
+	if (derivs == 0 && reprojectModel->reprojectXYBatch) {
+		mpfunc_range_residuals(mpfunc_ctx, begin, end, deviates);
+		return;
 	}
+
+	SurvivePose *cameras = survive_optimizer_get_camera(mpfunc_ctx);
 	const double *sensor_points = survive_optimizer_get_sensors(mpfunc_ctx);
 
 	int pose_idx = -1;
-	// SurvivePose *pose = 0;
-	// SurvivePose obj2lh[NUM_GEN2_LIGHTHOUSES] = {0};
 	LinmathAxisAnglePose *pose = 0;
 	LinmathAxisAnglePose obj2lh[NUM_GEN2_LIGHTHOUSES] = {0};
 
-	int meas_count = m;
-	if (mpfunc_ctx->current_bias > 0) {
-		meas_count -= 7;
-		FLT *pp = (FLT *)mpfunc_ctx->initialPose.Pos;
-		for (int i = 0; i < 7; i++) {
-			deviates[i + meas_count] = (p[i] - pp[i]) * mpfunc_ctx->current_bias;
-			if (derivs) {
-				derivs[i][i + meas_count] = mpfunc_ctx->current_bias;
-			}
-		}
-	}
-
-	for (int i = 0; i < meas_count; i++) {
+	for (int i = begin; i < end; i++) {
 		const survive_optimizer_measurement *meas = &mpfunc_ctx->measurements[i];
 		const int lh = meas->lh;
-		const struct BaseStationCal *cal = survive_optimizer_get_calibration(mpfunc_ctx, lh);
 		LinmathAxisAnglePose *world2lh = (LinmathAxisAnglePose *)&cameras[lh];
 		const FLT *pt = &sensor_points[meas->sensor_idx * 3];
 
@@ -325,14 +386,9 @@ static int mpfunc(int m, int n, double *p, double *deviates, double **derivs, vo
 			assert(pose_idx < mpfunc_ctx->poseLength);
 			pose = (LinmathAxisAnglePose *)(&survive_optimizer_get_pose(mpfunc_ctx)[meas->object]);
 
-			// SV_INFO("Before\t" SurvivePose_format, SURVIVE_POSE_EXPAND(*pose));
-			// quatnormalize(pose->Rot, pose->Rot);
-			// SV_INFO("After\t" SurvivePose_format, SURVIVE_POSE_EXPAND(*pose));
-
 			int lh_count =
 				mpfunc_ctx->cameraLength > 0 ? mpfunc_ctx->cameraLength : mpfunc_ctx->so->ctx->activeLighthouses;
 			for (int lh = 0; lh < lh_count; lh++) {
-				// ApplyPoseToPose(&obj2lh[lh], &cameras[lh], pose);
 				ApplyAxisAnglePoseToPose(&obj2lh[lh], (const LinmathAxisAnglePose *)&cameras[lh], pose);
 			}
 		}
@@ -346,6 +402,7 @@ static int mpfunc(int m, int n, double *p, double *deviates, double **derivs, vo
 		ApplyAxisAnglePoseToPoint(sensorPtInLH, &obj2lh[lh], pt);
 
 		if (nextIsPair) {
+			assert(i + 1 < end);
 			run_pair_measurement(mpfunc_ctx, i, reprojectModel, meas, pose, &obj2lh[lh], world2lh, deviates + i,
 								 derivs);
 			i++;
@@ -354,6 +411,77 @@ static int mpfunc(int m, int n, double *p, double *deviates, double **derivs, vo
 								   derivs);
 		}
 	}
+}
+
+// Keeps chunks big enough that handing them out costs little next to running them
+#define MPFUNC_MIN_CHUNK 32
+#define MPFUNC_MAX_CHUNKS 64
+
+struct mpfunc_parallel_job {
+	survive_optimizer *mpfunc_ctx;
+	int m;
+	double *deviates;
+	double **derivs;
+	int bounds[MPFUNC_MAX_CHUNKS + 1];
+};
+
+static void mpfunc_parallel_task(void *user, size_t task) {
+	struct mpfunc_parallel_job *job = user;
+	mpfunc_range(job->mpfunc_ctx, job->m, job->bounds[task], job->bounds[task + 1], job->deviates, job->derivs);
+}
+
+/**
+ * Every measurement only writes its own rows of deviates and derivs, so the rows can be split up over the parallel
+ * pool. A chunk boundary is moved past the second half of a pair so each measurement goes down the same path it
+ * would serially; the results are identical either way.
+ */
+static void mpfunc_parallel(survive_optimizer *mpfunc_ctx, int m, int meas_count, double *deviates, double **derivs) {
+	struct mpfunc_parallel_job job = {.mpfunc_ctx = mpfunc_ctx, .m = m, .deviates = deviates, .derivs = derivs};
+
+	size_t chunk_cnt = (survive_parallel_pool_worker_count(mpfunc_ctx->parallel_pool) + 1) * 4;
+	if (chunk_cnt > meas_count / MPFUNC_MIN_CHUNK)
+		chunk_cnt = meas_count / MPFUNC_MIN_CHUNK;
+	if (chunk_cnt > MPFUNC_MAX_CHUNKS)
+		chunk_cnt = MPFUNC_MAX_CHUNKS;
+	if (chunk_cnt < 1)
+		chunk_cnt = 1;
+
+	const survive_optimizer_measurement *meas = mpfunc_ctx->measurements;
+	size_t used = 0;
+	for (size_t c = 1; c < chunk_cnt; c++) {
+		int b = (int)((size_t)meas_count * c / chunk_cnt);
+		// An axis 1 reading never starts a pair, so b - 1 starts one exactly when this holds
+		if (b + 1 < m && meas[b - 1].axis == 0 && meas[b].axis == 1 && meas[b - 1].sensor_idx == meas[b].sensor_idx)
+			b++;
+		if (b > job.bounds[used] && b < meas_count)
+			job.bounds[++used] = b;
+	}
+	job.bounds[++used] = meas_count;
+
+	survive_parallel_for(mpfunc_ctx->parallel_pool, used, mpfunc_parallel_task, &job);
+}
+
+static int mpfunc(int m, int n, double *p, double *deviates, double **derivs, void *private) {
+	survive_optimizer *mpfunc_ctx = private;
+	mpfunc_ctx->parameters = p;
+
+	int meas_count = m;
+	if (mpfunc_ctx->current_bias > 0) {
+		meas_count -= 7;
+		FLT *pp = (FLT *)mpfunc_ctx->initialPose.Pos;
+		for (int i = 0; i < 7; i++) {
+			deviates[i + meas_count] = (p[i] - pp[i]) * mpfunc_ctx->current_bias;
+			if (derivs) {
+				derivs[i][i + meas_count] = mpfunc_ctx->current_bias;
+			}
+		}
+	}
+
+	if (mpfunc_ctx->parallel_pool && meas_count >= mpfunc_ctx->parallel_threshold) {
+		mpfunc_parallel(mpfunc_ctx, m, meas_count, deviates, derivs);
+	} else {
+		mpfunc_range(mpfunc_ctx, m, 0, meas_count, deviates, derivs);
+	}
 
 	return 0;
 }
@@ -391,37 +519,290 @@ const char *survive_optimizer_error(int status) {
 	}
 }
 
-static SurviveContext *cachedCtx = 0;
-static mp_config cachedCfg = {0};
-
-static mp_config *survive_optimizer_get_cfg(SurviveContext *ctx) {
-	if (ctx != cachedCtx) {
-		cachedCfg = (mp_config){0};
-		cachedCfg.maxiter = survive_configf(ctx, OPTIMIZER_MAXITER_TAG, SC_GET, 0);
-		cachedCfg.maxfev = survive_configf(ctx, OPTIMIZER_MAXFEV_TAG, SC_GET, 0);
-		cachedCfg.ftol = survive_configf(ctx, OPTIMIZER_FTOL_TAG, SC_GET, 0);
-		cachedCfg.normtol = survive_configf(ctx, OPTIMIZER_NORMTOL_TAG, SC_GET, 0);
-		cachedCfg.xtol = survive_configf(ctx, OPTIMIZER_XTOL_TAG, SC_GET, 0);
-		cachedCfg.gtol = survive_configf(ctx, OPTIMIZER_GTOL_TAG, SC_GET, 0);
-		cachedCfg.covtol = survive_configf(ctx, OPTIMIZER_COVTOL_TAG, SC_GET, 0);
-		cachedCfg.epsfcn = survive_configf(ctx, OPTIMIZER_EPSFCN_TAG, SC_GET, 0);
-		cachedCfg.stepfactor = survive_configf(ctx, OPTIMIZER_STEPFACTOR_TAG, SC_GET, 0);
-		cachedCfg.douserscale = survive_configi(ctx, OPTIMIZER_DOUSERSCALE_TAG, SC_GET, 0);
-		cachedCfg.nprint = survive_configi(ctx, OPTIMIZER_NPRINT_TAG, SC_GET, 0);
-	}
-	cachedCfg.iterproc = 0;
-	return &cachedCfg;
+void survive_optimizer_settings_init(SurviveContext *ctx, survive_optimizer_settings *settings) {
+	*settings = (survive_optimizer_settings){0};
+	mp_config *cfg = &settings->cfg;
+	cfg->maxiter = survive_configf(ctx, OPTIMIZER_MAXITER_TAG, SC_GET, 0);
+	cfg->maxfev = survive_configf(ctx, OPTIMIZER_MAXFEV_TAG, SC_GET, 0);
+	cfg->ftol = survive_configf(ctx, OPTIMIZER_FTOL_TAG, SC_GET, 0);
+	cfg->normtol = survive_configf(ctx, OPTIMIZER_NORMTOL_TAG, SC_GET, 0);
+	cfg->xtol = survive_configf(ctx, OPTIMIZER_XTOL_TAG, SC_GET, 0);
+	cfg->gtol = survive_configf(ctx, OPTIMIZER_GTOL_TAG, SC_GET, 0);
+	cfg->covtol = survive_configf(ctx, OPTIMIZER_COVTOL_TAG, SC_GET, 0);
+	cfg->epsfcn = survive_configf(ctx, OPTIMIZER_EPSFCN_TAG, SC_GET, 0);
+	cfg->stepfactor = survive_configf(ctx, OPTIMIZER_STEPFACTOR_TAG, SC_GET, 0);
+	cfg->douserscale = survive_configi(ctx, OPTIMIZER_DOUSERSCALE_TAG, SC_GET, 0);
+	cfg->nprint = survive_configi(ctx, OPTIMIZER_NPRINT_TAG, SC_GET, 0);
+	settings->use_pose_solver = survive_configi(ctx, OPTIMIZER_POSE_SOLVER_TAG, SC_GET, 0);
+	settings->parallel_threshold = survive_configi(ctx, OPTIMIZER_PARALLEL_THRESHOLD_TAG, SC_GET, 0);
 }
 
+// Used for optimizers that aren't attached to a context
+static const survive_optimizer_settings default_settings = {.use_pose_solver = true};
+
 mp_config precise_cfg = {0};
 SURVIVE_EXPORT mp_config *survive_optimizer_precise_config() { return &precise_cfg; }
 
+SURVIVE_EXPORT bool survive_optimizer_cameras_face_object(survive_optimizer *opt, const size_t *meas_for_lhs) {
+	const SurvivePose *obj = survive_optimizer_get_pose(opt);
+	SurvivePose *cameras = survive_optimizer_get_camera(opt);
+	for (int lh = 0; lh < opt->cameraLength; lh++) {
+		if ((meas_for_lhs && meas_for_lhs[lh] == 0) || quatiszero(cameras[lh].Rot))
+			continue;
+
+		LinmathPoint3d objInLh;
+		ApplyPoseToPoint(objInLh, &cameras[lh], obj->Pos);
+		if (objInLh[2] >= 0)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * The bulk of solves are for a single object pose against lighthouses whose poses are already known. For those, the
+ * problem is 6 parameters -- position and axis angle rotation -- over a few dozen measurements, and mpfit's general
+ * machinery (per call allocations, QR of the full jacobian, bookkeeping for fixed parameters) dominates the run time.
+ *
+ * This is a plain Levenberg-Marquardt on the 6x6 normal equations using the analytic jacobians. It honors the same
+ * mp_config tolerances and fills in the same mp_result fields posers look at.
+ */
+static bool survive_optimizer_is_pose_problem(const survive_optimizer *optimizer) {
+	if (optimizer->poseLength < 1 || optimizer->reprojectModel == 0 ||
+		optimizer->reprojectModel->reprojectAxisAngleFullJacObjPose == 0) {
+		return false;
+	}
+
+	for (int i = 0; i < survive_optimizer_get_parameters_count(optimizer); i++) {
+		bool shouldBeFree = i < 6;
+		if (optimizer->parameters_info[i].fixed == shouldBeFree) {
+			return false;
+		}
+		if (shouldBeFree && optimizer->parameters_info[i].side != 3) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Solves A * x = b in place for symmetric positive definite 6x6 A; returns false if A isn't.
+static bool cholesky_solve6(double A[6][6], double b[6], double x[6]) {
+	double L[6][6] = {0};
+	for (int i = 0; i < 6; i++) {
+		for (int j = 0; j <= i; j++) {
+			double sum = A[i][j];
+			for (int k = 0; k < j; k++)
+				sum -= L[i][k] * L[j][k];
+
+			if (i == j) {
+				if (sum <= 0 || !isfinite(sum))
+					return false;
+				L[i][i] = sqrt(sum);
+			} else {
+				L[i][j] = sum / L[j][j];
+			}
+		}
+	}
+
+	double y[6];
+	for (int i = 0; i < 6; i++) {
+		double sum = b[i];
+		for (int k = 0; k < i; k++)
+			sum -= L[i][k] * y[k];
+		y[i] = sum / L[i][i];
+	}
+	for (int i = 5; i >= 0; i--) {
+		double sum = y[i];
+		for (int k = i + 1; k < 6; k++)
+			sum -= L[k][i] * x[k];
+		x[i] = sum / L[i][i];
+	}
+	return true;
+}
+
+static double pose_solver_eval(survive_optimizer *optimizer, double *deviates, double *jac, double **derivs) {
+	int m = optimizer->measurementsCnt;
+	int n = survive_optimizer_get_parameters_count(optimizer);
+	double *params = optimizer->parameters;
+
+	for (int j = 0; j < 7; j++)
+		derivs[j] = jac + j * m;
+	mpfunc(m, n, params, deviates, derivs, optimizer);
+	optimizer->parameters = params;
+
+	// mpfunc hands back the jacobian of the reprojection; the deviates are scaled by the variance so the jacobian
+	// has to be too. The bias rows at the end are already right.
+	int meas_count = optimizer->current_bias > 0 ? m - 7 : m;
+	for (int i = 0; i < meas_count; i++) {
+		double scale = 1. / optimizer->measurements[i].variance;
+		for (int j = 0; j < 6; j++)
+			jac[j * m + i] *= scale;
+	}
+
+	double chi2 = 0;
+	for (int i = 0; i < m; i++)
+		chi2 += deviates[i] * deviates[i];
+	return chi2;
+}
+
+static int survive_optimizer_run_pose(survive_optimizer *optimizer, const mp_config *cfg, mp_result *result) {
+	const int m = optimizer->measurementsCnt;
+	const int n = survive_optimizer_get_parameters_count(optimizer);
+	if (m < 6) {
+		return MP_ERR_DOF;
+	}
+
+	const double ftol = cfg->ftol > 0 ? cfg->ftol : 1e-10;
+	const double xtol = cfg->xtol > 0 ? cfg->xtol : 1e-10;
+	const double gtol = cfg->gtol > 0 ? cfg->gtol : 1e-10;
+	const double normtol = cfg->normtol > 0 ? cfg->normtol : 0;
+	const int maxiter = cfg->maxiter == MP_NO_ITER ? 0 : (cfg->maxiter > 0 ? cfg->maxiter : 200);
+
+	double *deviates = alloca(sizeof(double) * m);
+	double *trial_deviates = alloca(sizeof(double) * m);
+	double *jac = alloca(sizeof(double) * m * 7);
+	double *trial_jac = alloca(sizeof(double) * m * 7);
+	double **derivs = alloca(sizeof(double *) * n);
+	memset(derivs, 0, sizeof(double *) * n);
+
+	double *x = optimizer->parameters;
+	const struct mp_par_struct *info = optimizer->parameters_info;
+
+	double chi2 = pose_solver_eval(optimizer, deviates, jac, derivs);
+	int nfev = 1, iter = 0, status = 0;
+	const double orignorm = chi2;
+	if (!isfinite(chi2)) {
+		return MP_ERR_NAN;
+	}
+
+	double lambda = 1e-3;
+	while (status == 0) {
+		if (chi2 < normtol) {
+			status = MP_OK_NORM;
+			break;
+		}
+		if (iter >= maxiter) {
+			status = MP_MAXITER;
+			break;
+		}
+
+		double JtJ[6][6] = {0}, Jtr[6] = {0};
+		for (int a = 0; a < 6; a++) {
+			const double *Ja = jac + a * m;
+			for (int i = 0; i < m; i++)
+				Jtr[a] += Ja[i] * deviates[i];
+			for (int b = 0; b <= a; b++) {
+				const double *Jb = jac + b * m;
+				double v = 0;
+				for (int i = 0; i < m; i++)
+					v += Ja[i] * Jb[i];
+				JtJ[a][b] = JtJ[b][a] = v;
+			}
+		}
+
+		// Orthogonality between the residual and the columns of the jacobian; same test mpfit uses for MP_OK_DIR
+		double gnorm = 0;
+		for (int a = 0; a < 6; a++) {
+			if (JtJ[a][a] > 0)
+				gnorm = fmax(gnorm, fabs(Jtr[a]) / sqrt(JtJ[a][a] * chi2));
+		}
+		if (gnorm <= gtol) {
+			status = MP_OK_DIR;
+			break;
+		}
+
+		bool accepted = false;
+		while (!accepted && status == 0) {
+			double A[6][6], neg_Jtr[6], dx[6];
+			for (int a = 0; a < 6; a++) {
+				for (int b = 0; b < 6; b++)
+					A[a][b] = JtJ[a][b];
+				A[a][a] += lambda * fmax(JtJ[a][a], 1e-12);
+				neg_Jtr[a] = -Jtr[a];
+			}
+
+			if (cholesky_solve6(A, neg_Jtr, dx)) {
+				double x0[6], xnorm = 0, dxnorm = 0;
+				for (int a = 0; a < 6; a++) {
+					x0[a] = x[a];
+					x[a] += dx[a];
+					if (info[a].limited[0] && x[a] < info[a].limits[0])
+						x[a] = info[a].limits[0];
+					if (info[a].limited[1] && x[a] > info[a].limits[1])
+						x[a] = info[a].limits[1];
+					xnorm += x0[a] * x0[a];
+					dxnorm += (x[a] - x0[a]) * (x[a] - x0[a]);
+				}
+
+				double trial_chi2 = pose_solver_eval(optimizer, trial_deviates, trial_jac, derivs);
+				nfev++;
+
+				if (isfinite(trial_chi2) && trial_chi2 < chi2) {
+					double actred = 1. - trial_chi2 / chi2;
+
+					double *tmp = deviates;
+					deviates = trial_deviates;
+					trial_deviates = tmp;
+					tmp = jac;
+					jac = trial_jac;
+					trial_jac = tmp;
+					chi2 = trial_chi2;
+
+					accepted = true;
+					iter++;
+					lambda = fmax(lambda / 10., 1e-12);
+
+					if (actred <= ftol)
+						status = MP_OK_CHI;
+					if (sqrt(dxnorm) <= xtol * sqrt(xnorm))
+						status = status == MP_OK_CHI ? MP_OK_BOTH : MP_OK_PAR;
+				} else {
+					for (int a = 0; a < 6; a++)
+						x[a] = x0[a];
+				}
+			}
+
+			if (!accepted) {
+				lambda *= 10.;
+				if (lambda > 1e16)
+					status = MP_XTOL;
+			}
+
+			if (status == 0 && cfg->maxfev > 0 && nfev >= cfg->maxfev)
+				status = MP_MAXITER;
+		}
+	}
+
+	if (result) {
+		strcpy(result->version, "pose-lm");
+		result->bestnorm = chi2;
+		result->orignorm = orignorm;
+		result->status = status;
+		result->niter = iter;
+		result->nfev = nfev;
+		result->npar = n;
+		result->nfree = 6;
+		result->npegged = 0;
+		result->nfunc = m;
+		if (result->resid)
+			memcpy(result->resid, deviates, sizeof(double) * m);
+	}
+	return status;
+}
+
 int survive_optimizer_run(survive_optimizer *optimizer, struct mp_result_struct *result) {
 	SurviveContext *ctx = optimizer->so ? optimizer->so->ctx : 0;
 
-	mp_config *cfg = optimizer->cfg;
-	if (cfg == 0)
-		cfg = survive_optimizer_get_cfg(ctx);
+	const survive_optimizer_settings *settings = ctx ? survive_get_optimizer_settings(ctx) : &default_settings;
+
+	// Solves run concurrently, so each works from its own copy
+	mp_config ctx_cfg = settings->cfg;
+	mp_config *cfg = optimizer->cfg ? optimizer->cfg : &ctx_cfg;
+
+	if (ctx && optimizer->parallel_pool == 0 && settings->parallel_threshold > 0 &&
+		optimizer->measurementsCnt >= settings->parallel_threshold) {
+		optimizer->parallel_pool = survive_get_parallel_pool(ctx);
+		optimizer->parallel_threshold = settings->parallel_threshold;
+	}
 
 	SurvivePose *poses = survive_optimizer_get_pose(optimizer);
 	for (int i = 0; i < optimizer->poseLength + optimizer->cameraLength; i++) {
@@ -463,11 +844,16 @@ int survive_optimizer_run(survive_optimizer *optimizer, struct mp_result_struct
 		}
 	}
 #endif
-	// MPFit runs on temporary storage; so parameters is manipulated in mpfunc. Save it and restore it here.
-	double *params = optimizer->parameters;
-	int rtn = mpfit(mpfunc, optimizer->measurementsCnt, survive_optimizer_get_parameters_count(optimizer),
+	int rtn;
+	if (settings->use_pose_solver && survive_optimizer_is_pose_problem(optimizer)) {
+		rtn = survive_optimizer_run_pose(optimizer, cfg, result);
+	} else {
+		// MPFit runs on temporary storage; so parameters is manipulated in mpfunc. Save it and restore it here.
+		double *params = optimizer->parameters;
+		rtn = mpfit(mpfunc, optimizer->measurementsCnt, survive_optimizer_get_parameters_count(optimizer),
 					optimizer->parameters, optimizer->parameters_info, cfg, optimizer, result);
-	optimizer->parameters = params;
+		optimizer->parameters = params;
+	}
 
 	for (int i = 0; i < optimizer->poseLength + optimizer->cameraLength; i++) {
 		quatfromaxisangle(poses[i].Rot, poses[i].Rot, norm3d(poses[i].Rot));
@@ -0,0 +1,157 @@
+#include "survive_parallel.h"
+#include "survive_atomic.h"
+
+#include <os_generic.h>
+#include <stdio.h>
+#include <survive.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define SURVIVE_PARALLEL_MAX_THREADS 8
+
+typedef struct parallel_worker {
+	survive_parallel_pool *pool;
+	og_thread_t thread;
+	og_sema_t start;
+} parallel_worker;
+
+struct survive_parallel_pool {
+	size_t worker_cnt;
+	parallel_worker *workers;
+	og_sema_t done;
+
+	// Set while a survive_parallel_for is running; other callers don't wait for it
+	uint32_t busy;
+	uint32_t running;
+
+	// The job being run; written before the workers are started
+	survive_parallel_fn fn;
+	void *user;
+	uint32_t task_cnt;
+	uint32_t next_task;
+};
+
+size_t survive_default_thread_count(void) {
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	long cores = info.dwNumberOfProcessors;
+#else
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	// Leave a core for the driver and poll threads
+	long rtn = cores - 1;
+	if (rtn < 1)
+		rtn = 1;
+	return rtn > SURVIVE_PARALLEL_MAX_THREADS ? SURVIVE_PARALLEL_MAX_THREADS : rtn;
+}
+
+static void run_tasks(survive_parallel_pool *pool) {
+	uint32_t task;
+	while ((task = survive_atomic_fetch_add_u32(&pool->next_task, 1)) < pool->task_cnt) {
+		pool->fn(pool->user, task);
+	}
+}
+
+static void *parallel_worker_thread(void *_worker) {
+	parallel_worker *worker = _worker;
+	survive_parallel_pool *pool = worker->pool;
+
+	while (true) {
+		OGLockSema(worker->start);
+		if (!survive_atomic_load_u32(&pool->running)) {
+			break;
+		}
+
+		run_tasks(pool);
+		OGUnlockSema(pool->done);
+	}
+
+	return 0;
+}
+
+survive_parallel_pool *survive_parallel_pool_create(SurviveContext *ctx, size_t worker_cnt) {
+	if (worker_cnt == 0 && ctx) {
+		worker_cnt = survive_configi(ctx, "optimizer-threads", SC_GET, 0);
+	}
+	if (worker_cnt == 0) {
+		worker_cnt = survive_default_thread_count();
+	}
+
+	survive_parallel_pool *pool = SV_NEW(survive_parallel_pool);
+	pool->running = 1;
+	pool->done = OGCreateSema();
+	pool->worker_cnt = worker_cnt;
+	pool->workers = SV_CALLOC(worker_cnt, sizeof(parallel_worker));
+
+	for (size_t i = 0; i < worker_cnt; i++) {
+		parallel_worker *w = &pool->workers[i];
+		w->pool = pool;
+		w->start = OGCreateSema();
+		w->thread = OGCreateThread(parallel_worker_thread, w);
+
+		char name[32];
+		snprintf(name, sizeof(name), "parallel %d", (int)i);
+		OGNameThread(w->thread, name);
+	}
+
+	if (ctx) {
+		SV_VERBOSE(10, "Started parallel pool with %d threads", (int)worker_cnt);
+	}
+	return pool;
+}
+
+size_t survive_parallel_pool_worker_count(const survive_parallel_pool *pool) { return pool->worker_cnt; }
+
+void survive_parallel_pool_free(survive_parallel_pool *pool) {
+	if (pool == 0) {
+		return;
+	}
+
+	survive_atomic_store_u32(&pool->running, 0);
+	for (size_t i = 0; i < pool->worker_cnt; i++) {
+		OGUnlockSema(pool->workers[i].start);
+	}
+
+	for (size_t i = 0; i < pool->worker_cnt; i++) {
+		OGJoinThread(pool->workers[i].thread);
+		OGDeleteSema(pool->workers[i].start);
+	}
+
+	OGDeleteSema(pool->done);
+	free(pool->workers);
+	free(pool);
+}
+
+void survive_parallel_for(survive_parallel_pool *pool, size_t task_cnt, survive_parallel_fn fn, void *user) {
+	uint32_t idle = 0;
+	if (pool == 0 || task_cnt < 2 || !survive_atomic_cas_u32(&pool->busy, &idle, 1)) {
+		for (size_t task = 0; task < task_cnt; task++) {
+			fn(user, task);
+		}
+		return;
+	}
+
+	pool->fn = fn;
+	pool->user = user;
+	pool->task_cnt = task_cnt;
+	survive_atomic_store_u32(&pool->next_task, 0);
+
+	// No point in waking more workers than there are tasks for
+	size_t worker_cnt = task_cnt - 1 < pool->worker_cnt ? task_cnt - 1 : pool->worker_cnt;
+	for (size_t i = 0; i < worker_cnt; i++) {
+		OGUnlockSema(pool->workers[i].start);
+	}
+
+	run_tasks(pool);
+
+	for (size_t i = 0; i < worker_cnt; i++) {
+		OGLockSema(pool->done);
+	}
+
+	survive_atomic_store_u32(&pool->busy, 0);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stddef.h>
+#include <survive_types.h>
+
+/**
+ * Fork/join helper for splitting a single computation over several threads; unlike the optimizer pool, which runs
+ * whole independent solves. The calling thread takes part, so a pool with n workers runs on n + 1 threads.
+ */
+typedef struct survive_parallel_pool survive_parallel_pool;
+
+typedef void (*survive_parallel_fn)(void *user, size_t task);
+
+/**
+ * Creates a pool with 'worker_cnt' threads; 0 reads 'optimizer-threads', and picks from the core count if that isn't
+ * set either.
+ */
+SURVIVE_EXPORT survive_parallel_pool *survive_parallel_pool_create(SurviveContext *ctx, size_t worker_cnt);
+SURVIVE_EXPORT void survive_parallel_pool_free(survive_parallel_pool *pool);
+SURVIVE_EXPORT size_t survive_parallel_pool_worker_count(const survive_parallel_pool *pool);
+
+/**
+ * Number of worker threads to use when it isn't configured; one less than the core count, capped at 8.
+ */
+SURVIVE_EXPORT size_t survive_default_thread_count(void);
+
+/**
+ * Calls fn(user, task) for every task in [0, task_cnt) and returns once they are all done. Tasks run in no
+ * particular order and concurrently, so they must not write to anything another task touches. If another thread is
+ * already using the pool, every task runs on the calling thread instead of waiting for it.
+ */
+SURVIVE_EXPORT void survive_parallel_for(survive_parallel_pool *pool, size_t task_cnt, survive_parallel_fn fn,
+										 void *user);
+
+/**
+ * Returns the context's pool, creating it on first use. It is freed in survive_close.
+ */
+SURVIVE_EXPORT survive_parallel_pool *survive_get_parallel_pool(SurviveContext *ctx);
@@ -18,6 +18,7 @@
 #define gzprintf fprintf
 #define gzclose fclose
 #define gzvprintf vfprintf
+#define gzflush(f, flush) fflush(f)
 #define gzerror_dropin ferror
 #define gzwrite write
 #define gzeof feof
@@ -32,8 +33,10 @@ int gzerror_dropin(gzFile f) {
 }
 #endif
 
+#include "survive_atomic.h"
 #include "survive_config.h"
 #include "survive_default_devices.h"
+#include "survive_recording.h"
 
 #include "ctype.h"
 #include "os_generic.h"
@@ -61,44 +64,98 @@ STATIC_CONFIG_ITEM(PLAYBACK, "playback", 's', "File to be used for playback if p
 STATIC_CONFIG_ITEM(PLAYBACK_FACTOR, "playback-factor", 'f',
 				   "Time factor of playback -- 1 is run at the same timing as original, 0 is run as fast as possible.",
 				   1.0f)
+STATIC_CONFIG_ITEM(PLAYBACK_SYNCHRONOUS, "playback-synchronous", 'i',
+				   "Replay on the polling thread, as fast as possible, with time driven only by the recording. Gives "
+				   "identical results run to run.",
+				   0)
 STATIC_CONFIG_ITEM(PLAYBACK_RECORD_RAWLIGHT, "record-rawlight", 'i', "Whether or not to output raw light data", 1)
 STATIC_CONFIG_ITEM(PLAYBACK_RECORD_IMU, "record-imu", 'i', "Whether or not to output imu data", 1)
 STATIC_CONFIG_ITEM(PLAYBACK_RECORD_CAL_IMU, "record-cal-imu", 'i', "Whether or not to output calibrated imu data", 0)
 STATIC_CONFIG_ITEM(PLAYBACK_RECORD_ANGLE, "record-angle", 'i', "Whether or not to output angle data", 1)
 
+// Must be a power of two
+#define SURVIVE_RECORDING_QUEUE_SIZE 4096
+
+// How often, in seconds, the writer flushes its outputs while it keeps up
+#define SURVIVE_RECORDING_FLUSH_INTERVAL 1.
+
+// Records that don't fit in a slot -- configs and long log lines -- go to one of these instead. There is one bit per
+// buffer in the free mask, so no more than 32.
+#define SURVIVE_RECORDING_OVERFLOW_CNT 8
+#define SURVIVE_RECORDING_OVERFLOW_SIZE (64 * 1024)
+
+typedef struct recording_slot {
+	// Equal to the slot's position when it is free to claim, and to the position + 1 once its record is filled in
+	uint32_t sequence;
+	// Index + 1 of the overflow buffer holding the record, or 0 if it is in 'record'
+	uint32_t overflow;
+	SurviveRecord record;
+} recording_slot;
+
+/**
+ * Driver, poser and logging threads all record concurrently. Each claims a slot of the queue with a CAS on 'head',
+ * copies its record in and publishes it through the slot's sequence; the writer thread turns records into text or
+ * binary output and does all the compression and file IO. When the writer falls a full queue behind, or every overflow
+ * buffer is taken, new records are dropped and counted rather than making the caller wait.
+ *
+ * Producers can't be made to stop at once, so survive_destroy_recording only detaches the queue and stops the writer;
+ * the queue itself lives until survive_free_recording, once nothing can record anymore.
+ */
 typedef struct SurviveRecordingData {
 	SurviveContext *ctx;
 	bool alwaysWriteStdOut;
 	bool writeRawLight;
-        bool writeIMU;
-		bool writeCalIMU;
-		bool writeAngle;
-		gzFile output_file;
+	bool writeIMU;
+	bool writeCalIMU;
+	bool writeAngle;
+	gzFile output_file;
+	SurviveRecordingBinaryWriter *binary_output;
+
+	og_thread_t writer_thread;
+	og_sema_t available;
+	uint32_t running;
+	uint32_t dropped;
+
+	// head is claimed by producers, tail is only touched by the writer
+	uint32_t head;
+	uint32_t tail;
+	// Cleared by survive_destroy_recording; 'slots' stays valid for producers that already loaded it
+	recording_slot *queue;
+	recording_slot *slots;
+
+	uint32_t overflow_free;
+	uint64_t *overflow;
 } SurviveRecordingData;
 
 struct SurvivePlaybackData {
 	SurviveContext *ctx;
 	const char *playback_dir;
 	gzFile playback_file;
+	SurviveRecordingBinaryReader *binary_reader;
 	int lineno;
 
+	char *line;
+	size_t line_size;
+
 	double next_time_s;
 	double time_now;
+	// Absolute time playback started at; set on first use
+	double start_time_s;
 	FLT playback_factor;
 	bool hasRawLight;
 	bool hasSweepAngle;
 	bool outputExternalPose;
+	bool synchronous;
 
 	uint32_t total_sleep_time;
 	bool keepRunning;
 	og_thread_t playback_thread;
 };
 
-static double timestamp_in_s() {
-	static double start_time_s = 0;
-	if (start_time_s == 0.)
-		start_time_s = OGGetAbsoluteTime();
-	return OGGetAbsoluteTime() - start_time_s;
+static double timestamp_in_s(struct SurvivePlaybackData *driver) {
+	if (driver->start_time_s == 0.)
+		driver->start_time_s = OGGetAbsoluteTime();
+	return OGGetAbsoluteTime() - driver->start_time_s;
 }
 
 static int playback_poll(struct SurviveContext *ctx, void *_driver);
@@ -117,45 +174,207 @@ static void write_to_output_raw(SurviveRecordingData *recordingData, const char
 	}
 }
 
-static void write_to_output(SurviveRecordingData *recordingData, const char *format, ...) {
-	if (!recordingData) {
+static void copy_pose(double *dst, const SurvivePose *pose) {
+	for (int i = 0; i < 3; i++)
+		dst[i] = pose->Pos[i];
+	for (int i = 0; i < 4; i++)
+		dst[3 + i] = pose->Rot[i];
+}
+
+static void copy_velocity(double *dst, const SurviveVelocity *velocity) {
+	for (int i = 0; i < 3; i++)
+		dst[i] = velocity->Pos[i];
+	for (int i = 0; i < 3; i++)
+		dst[3 + i] = velocity->AxisAngleRot[i];
+}
+
+static void pose_from_record(SurvivePose *pose, const double *src) {
+	for (int i = 0; i < 3; i++)
+		pose->Pos[i] = src[i];
+	for (int i = 0; i < 4; i++)
+		pose->Rot[i] = src[3 + i];
+}
+
+static void init_record(SurviveRecordingData *recordingData, SurviveRecord *record, SurviveRecordType type,
+						const char *dev) {
+	survive_record_init(record, type, survive_run_time(recordingData->ctx), dev);
+}
+
+static void write_record_to_outputs(SurviveRecordingData *recordingData, const SurviveRecordHeader *record) {
+	if (recordingData->binary_output) {
+		survive_recording_binary_writer_write(recordingData->binary_output, record);
+	}
+
+	if (recordingData->output_file == 0 && !recordingData->alwaysWriteStdOut) {
 		return;
 	}
 
-	double ts = survive_run_time(recordingData->ctx);
+	char buffer[512];
+	char *line = buffer;
+	int len = survive_record_to_text(record, buffer, sizeof(buffer));
+	if (len >= (int)sizeof(buffer)) {
+		line = SV_MALLOC(len + 1);
+		survive_record_to_text(record, line, len + 1);
+	}
 
-	if (recordingData->output_file) {
-		va_list args;
-		va_start(args, format);
-		gzprintf(recordingData->output_file, "%0.6f ", ts);
-		gzvprintf(recordingData->output_file, format, args);
+	if (len > 0) {
+		write_to_output_raw(recordingData, line, len);
+	}
 
-		va_end(args);
+	if (line != buffer) {
+		free(line);
 	}
+}
 
+static void flush_outputs(SurviveRecordingData *recordingData) {
+	if (recordingData->output_file) {
+		gzflush(recordingData->output_file, Z_SYNC_FLUSH);
+	}
+	if (recordingData->binary_output) {
+		survive_recording_binary_writer_flush(recordingData->binary_output);
+	}
 	if (recordingData->alwaysWriteStdOut) {
-		va_list args;
-		va_start(args, format);
-		fprintf(stdout, "%0.6f ", ts);
-		vfprintf(stdout, format, args);
-		va_end(args);
+		fflush(stdout);
+	}
+}
+
+static SurviveRecordHeader *overflow_buffer(SurviveRecordingData *recordingData, uint32_t overflow) {
+	return (SurviveRecordHeader *)(recordingData->overflow +
+								   (overflow - 1) * (SURVIVE_RECORDING_OVERFLOW_SIZE / sizeof(uint64_t)));
+}
+
+// Returns the index + 1 of a free overflow buffer, or 0 if they are all taken
+static uint32_t claim_overflow(SurviveRecordingData *recordingData) {
+	uint32_t free_mask = survive_atomic_load_u32(&recordingData->overflow_free);
+	while (free_mask) {
+		uint32_t idx = 0;
+		while ((free_mask & (1u << idx)) == 0) {
+			idx++;
+		}
+		if (survive_atomic_cas_u32(&recordingData->overflow_free, &free_mask, free_mask & ~(1u << idx))) {
+			return idx + 1;
+		}
+	}
+	return 0;
+}
+
+static void release_overflow(SurviveRecordingData *recordingData, uint32_t overflow) {
+	uint32_t free_mask = survive_atomic_load_u32(&recordingData->overflow_free);
+	while (!survive_atomic_cas_u32(&recordingData->overflow_free, &free_mask, free_mask | (1u << (overflow - 1)))) {
+	}
+}
+
+static void write_record(SurviveRecordingData *recordingData, const SurviveRecordHeader *record) {
+	recording_slot *queue = survive_atomic_load_ptr((void *const volatile *)&recordingData->queue);
+	if (queue == 0) {
+		return;
+	}
+
+	uint32_t overflow = 0;
+	if (record->size > sizeof(queue->record)) {
+		overflow = record->size <= SURVIVE_RECORDING_OVERFLOW_SIZE ? claim_overflow(recordingData) : 0;
+		if (overflow == 0) {
+			survive_atomic_fetch_add_u32(&recordingData->dropped, 1);
+			return;
+		}
+	}
+
+	uint32_t head = survive_atomic_load_u32(&recordingData->head);
+	recording_slot *slot;
+	while (true) {
+		slot = &queue[head & (SURVIVE_RECORDING_QUEUE_SIZE - 1)];
+		int32_t diff = (int32_t)(survive_atomic_load_u32(&slot->sequence) - head);
+		if (diff == 0) {
+			// On failure 'head' is updated to the current one
+			if (survive_atomic_cas_u32(&recordingData->head, &head, head + 1)) {
+				break;
+			}
+		} else if (diff < 0) {
+			// The writer hasn't released this slot from the last time around yet
+			if (overflow) {
+				release_overflow(recordingData, overflow);
+			}
+			survive_atomic_fetch_add_u32(&recordingData->dropped, 1);
+			return;
+		} else {
+			head = survive_atomic_load_u32(&recordingData->head);
+		}
 	}
+
+	slot->overflow = overflow;
+	memcpy(overflow ? overflow_buffer(recordingData, overflow) : &slot->record.hdr, record, record->size);
+	survive_atomic_store_u32(&slot->sequence, head + 1);
+
+	OGUnlockSema(recordingData->available);
 }
+
+static void *recording_writer_thread(void *_recordingData) {
+	SurviveRecordingData *recordingData = _recordingData;
+	SurviveContext *ctx = recordingData->ctx;
+	double last_flush = OGGetAbsoluteTime();
+	uint32_t reported_dropped = 0;
+
+	// Every record posts once it is published. Records are published out of order when producers race, so the one at
+	// tail may not be ready yet when a post comes in; its own post follows once it is.
+	uint32_t posted = 0;
+	while (true) {
+		OGLockSema(recordingData->available);
+		posted++;
+
+		uint32_t tail = recordingData->tail;
+		for (; posted > 0; posted--, tail++) {
+			recording_slot *slot = &recordingData->slots[tail & (SURVIVE_RECORDING_QUEUE_SIZE - 1)];
+			if (survive_atomic_load_u32(&slot->sequence) != tail + 1) {
+				break;
+			}
+
+			if (slot->overflow) {
+				write_record_to_outputs(recordingData, overflow_buffer(recordingData, slot->overflow));
+				release_overflow(recordingData, slot->overflow);
+			} else {
+				write_record_to_outputs(recordingData, &slot->record.hdr);
+			}
+
+			recordingData->tail = tail + 1;
+			survive_atomic_store_u32(&slot->sequence, tail + SURVIVE_RECORDING_QUEUE_SIZE);
+		}
+
+		// The stop signal is the one post without a record
+		if (survive_atomic_load_u32(&recordingData->head) == tail) {
+			if (!survive_atomic_load_u32(&recordingData->running)) {
+				break;
+			}
+
+			// Caught up; a good time to push what has been written so far out to the file
+			double now = OGGetAbsoluteTime();
+			if (now - last_flush > SURVIVE_RECORDING_FLUSH_INTERVAL) {
+				flush_outputs(recordingData);
+				last_flush = now;
+
+				uint32_t dropped = survive_atomic_load_u32(&recordingData->dropped);
+				if (dropped != reported_dropped) {
+					SV_WARN("Recording dropped %u records because the writer fell behind",
+							dropped - reported_dropped);
+					reported_dropped = dropped;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
 void survive_recording_config_process(SurviveObject *so, char *ct0conf, int len) {
 	SurviveRecordingData *recordingData = so->ctx ? so->ctx->recptr : 0;
 	if (recordingData == 0)
 		return;
 
-	char *buffer = SV_CALLOC(1, len + 1);
-	memcpy(buffer, ct0conf, len);
-	for (int i = 0; i < len; i++)
-		if (buffer[i] == '\n' || buffer[i] == '\r')
-			buffer[i] = ' ';
-
-	write_to_output(recordingData, "%s CONFIG ", so->codename);
-	write_to_output_raw(recordingData, buffer, len);
-	write_to_output_raw(recordingData, "\r\n", 2);
-	free(buffer);
+	size_t size = survive_record_blob_size(len);
+	SurviveRecordBlob *record = SV_MALLOC(size);
+	survive_record_init_blob(record, size, SURVIVE_RECORD_CONFIG, survive_run_time(so->ctx), so->codename, ct0conf,
+							 len);
+	write_record(recordingData, &record->hdr);
+	free(record);
 }
 
 void survive_recording_lighthouse_process(SurviveContext *ctx, uint8_t lighthouse, SurvivePose *lh_pose,
@@ -164,25 +383,34 @@ void survive_recording_lighthouse_process(SurviveContext *ctx, uint8_t lighthous
 	if (recordingData == 0)
 		return;
 
-	write_to_output(recordingData, "%d LH_POSE %0.6f %0.6f %0.6f %0.6f %0.6f %0.6f %0.6f\n", lighthouse,
-					lh_pose->Pos[0], lh_pose->Pos[1], lh_pose->Pos[2], lh_pose->Rot[0], lh_pose->Rot[1],
-					lh_pose->Rot[2], lh_pose->Rot[3]);
+	char dev[8];
+	snprintf(dev, sizeof(dev), "%d", lighthouse);
+
+	SurviveRecord record;
+	init_record(recordingData, &record, SURVIVE_RECORD_LH_POSE, dev);
+	copy_pose(record.pose.pose, lh_pose);
+	record.pose.lighthouse = lighthouse;
+	write_record(recordingData, &record.hdr);
 }
 void survive_recording_velocity_process(SurviveObject *so, uint8_t lighthouse, const SurviveVelocity *pose) {
 	SurviveRecordingData *recordingData = so->ctx->recptr;
 	if (recordingData == 0)
 		return;
 
-	write_to_output(recordingData, "%s VELOCITY %0.6f %0.6f %0.6f %0.6f %0.6f %0.6f\n", so->codename, pose->Pos[0],
-					pose->Pos[1], pose->Pos[2], pose->AxisAngleRot[0], pose->AxisAngleRot[1], pose->AxisAngleRot[2]);
+	SurviveRecord record;
+	init_record(recordingData, &record, SURVIVE_RECORD_VELOCITY, so->codename);
+	copy_velocity(record.velocity.velocity, pose);
+	write_record(recordingData, &record.hdr);
 }
-void survive_recording_raw_pose_process(SurviveObject *so, uint8_t lighthouse, SurvivePose *pose) {
+void survive_recording_raw_pose_process(SurviveObject *so, uint8_t lighthouse, const SurvivePose *pose) {
 	SurviveRecordingData *recordingData = so->ctx->recptr;
 	if (recordingData == 0)
 		return;
 
-	write_to_output(recordingData, "%s POSE %0.6f %0.6f %0.6f %0.6f %0.6f %0.6f %0.6f\n", so->codename, pose->Pos[0],
-					pose->Pos[1], pose->Pos[2], pose->Rot[0], pose->Rot[1], pose->Rot[2], pose->Rot[3]);
+	SurviveRecord record;
+	init_record(recordingData, &record, SURVIVE_RECORD_POSE, so->codename);
+	copy_pose(record.pose.pose, pose);
+	write_record(recordingData, &record.hdr);
 }
 
 void survive_recording_external_velocity_process(SurviveContext *ctx, const char *name, const SurviveVelocity *pose) {
@@ -190,8 +418,10 @@ void survive_recording_external_velocity_process(SurviveContext *ctx, const char
 	if (recordingData == 0)
 		return;
 
-	write_to_output(recordingData, "%s EXTERNAL_VELOCITY %0.6f %0.6f %0.6f %0.6f %0.6f %0.6f\n", name, pose->Pos[0],
-					pose->Pos[1], pose->Pos[2], pose->AxisAngleRot[0], pose->AxisAngleRot[1], pose->AxisAngleRot[2]);
+	SurviveRecord record;
+	init_record(recordingData, &record, SURVIVE_RECORD_EXTERNAL_VELOCITY, name);
+	copy_velocity(record.velocity.velocity, pose);
+	write_record(recordingData, &record.hdr);
 }
 
 void survive_recording_external_pose_process(SurviveContext *ctx, const char *name, const SurvivePose *pose) {
@@ -199,8 +429,10 @@ void survive_recording_external_pose_process(SurviveContext *ctx, const char *na
 	if (recordingData == 0)
 		return;
 
-	write_to_output(recordingData, "%s EXTERNAL_POSE %0.6f %0.6f %0.6f %0.6f %0.6f %0.6f %0.6f\n", name, pose->Pos[0],
-					pose->Pos[1], pose->Pos[2], pose->Rot[0], pose->Rot[1], pose->Rot[2], pose->Rot[3]);
+	SurviveRecord record;
+	init_record(recordingData, &record, SURVIVE_RECORD_EXTERNAL_POSE, name);
+	copy_pose(record.pose.pose, pose);
+	write_record(recordingData, &record.hdr);
 }
 
 void survive_recording_info_process(SurviveContext *ctx, const char *fault) {
@@ -208,35 +440,27 @@ void survive_recording_info_process(SurviveContext *ctx, const char *fault) {
 	if (recordingData == 0)
 		return;
 
-	write_to_output(recordingData, "INFO LOG %s\n", fault);
+	uint64_t storage[(sizeof(SurviveRecordBlob) + 1024) / sizeof(uint64_t)];
+	SurviveRecordBlob *record = (SurviveRecordBlob *)storage;
+	survive_record_init_blob(record, sizeof(storage), SURVIVE_RECORD_INFO, survive_run_time(ctx), "INFO", fault,
+							 strlen(fault));
+	write_record(recordingData, &record->hdr);
 }
 
-// survive_channel channel, int sensor_id, survive_timecode timecode, int8_t plane, FLT angle
-#define SWEEP_ANGLE_SCANF "%s B %hhu %d %u %hhd " FLT_sformat "\n"
-#define SWEEP_ANGLE_PRINTF "%s B %hhu %u %u %hhd " FLT_format "\n"
-#define SWEEP_ANGLE_SCANF_ARGS dev, &channel, &sensor_id, &timecode, &plane, &angle
-#define SWEEP_ANGLE_PRINTF_ARGS dev, channel, sensor_id, timecode, plane, angle
-
-#define SWEEP_SCANF "%s W %hhu %d %u %hhu\n"
-#define SWEEP_PRINTF SWEEP_SCANF
-#define SWEEP_SCANF_ARGS dev, &channel, &sensor_id, &timecode, &flag
-#define SWEEP_PRINTF_ARGS dev, channel, sensor_id, timecode, flag
-
-#define SYNC_SCANF "%s Y %hhu %u %hhu %hhu\n"
-#define SYNC_PRINTF SYNC_SCANF
-#define SYNC_SCANF_ARGS dev, &channel, &timecode, &ootx, &gen
-#define SYNC_PRINTF_ARGS dev, channel, timecode, ootx, gen
-
 void survive_recording_sync_process(SurviveObject *so, survive_channel channel, survive_timecode timecode, bool ootx,
 									bool gen) {
 	SurviveRecordingData *recordingData = so->ctx->recptr;
-	const char *dev = so->codename;
-
 	if (!recordingData || !recordingData->writeAngle) {
 		return;
 	}
 
-	write_to_output(recordingData, SYNC_PRINTF, SYNC_PRINTF_ARGS);
+	SurviveRecord record;
+	init_record(recordingData, &record, SURVIVE_RECORD_SYNC, so->codename);
+	record.sync.channel = channel;
+	record.sync.timecode = timecode;
+	record.sync.ootx = ootx;
+	record.sync.gen = gen;
+	write_record(recordingData, &record.hdr);
 }
 
 void survive_recording_sweep_angle_process(SurviveObject *so, survive_channel channel, int sensor_id,
@@ -246,8 +470,14 @@ void survive_recording_sweep_angle_process(SurviveObject *so, survive_channel ch
 		return;
 	}
 
-	const char *dev = so->codename;
-	write_to_output(recordingData, SWEEP_ANGLE_PRINTF, SWEEP_ANGLE_PRINTF_ARGS);
+	SurviveRecord record;
+	init_record(recordingData, &record, SURVIVE_RECORD_SWEEP_ANGLE, so->codename);
+	record.sweep_angle.channel = channel;
+	record.sweep_angle.sensor_id = sensor_id;
+	record.sweep_angle.timecode = timecode;
+	record.sweep_angle.plane = plane;
+	record.sweep_angle.angle = angle;
+	write_record(recordingData, &record.hdr);
 }
 
 void survive_recording_sweep_process(SurviveObject *so, survive_channel channel, int sensor_id,
@@ -258,8 +488,13 @@ void survive_recording_sweep_process(SurviveObject *so, survive_channel channel,
 		return;
 	}
 
-	const char *dev = so->codename;
-	write_to_output(recordingData, SWEEP_PRINTF, SWEEP_PRINTF_ARGS);
+	SurviveRecord record;
+	init_record(recordingData, &record, SURVIVE_RECORD_SWEEP, so->codename);
+	record.sweep.channel = channel;
+	record.sweep.sensor_id = sensor_id;
+	record.sweep.timecode = timecode;
+	record.sweep.flag = flag;
+	write_record(recordingData, &record.hdr);
 }
 void survive_recording_angle_process(struct SurviveObject *so, int sensor_id, int acode, uint32_t timecode, FLT length,
 									 FLT angle, uint32_t lh) {
@@ -268,8 +503,15 @@ void survive_recording_angle_process(struct SurviveObject *so, int sensor_id, in
 		return;
 	}
 
-	write_to_output(recordingData, "%s A %d %d %u %0.6f %0.6f %u\n", so->codename, sensor_id, acode, timecode, length,
-					angle, lh);
+	SurviveRecord record;
+	init_record(recordingData, &record, SURVIVE_RECORD_ANGLE, so->codename);
+	record.angle.sensor_id = sensor_id;
+	record.angle.acode = acode;
+	record.angle.timecode = timecode;
+	record.angle.length = length;
+	record.angle.angle = angle;
+	record.angle.lh = lh;
+	write_record(recordingData, &record.hdr);
 }
 
 void survive_recording_lightcap(SurviveObject *so, LightcapElement *le) {
@@ -278,7 +520,12 @@ void survive_recording_lightcap(SurviveObject *so, LightcapElement *le) {
 		return;
 
 	if (recordingData->writeRawLight) {
-		write_to_output(recordingData, "%s C %d %u %u\n", so->codename, le->sensor_id, le->timestamp, le->length);
+		SurviveRecord record;
+		init_record(recordingData, &record, SURVIVE_RECORD_LIGHTCAP, so->codename);
+		record.lightcap.sensor_id = le->sensor_id;
+		record.lightcap.timestamp = le->timestamp;
+		record.lightcap.length = le->length;
+		write_record(recordingData, &record.hdr);
 	}
 }
 
@@ -291,41 +538,29 @@ void survive_recording_light_process(struct SurviveObject *so, int sensor_id, in
 	if (!recordingData->writeAngle) {
 	  return;
 	}
-	
-	if (acode == -1) {
-		write_to_output(recordingData, "%s S %d %d %d %u %u %u\n", so->codename, sensor_id, acode, timeinsweep,
-						timecode, length, lh);
-		return;
-	}
 
-	const char *LH_ID = 0;
-	const char *LH_Axis = 0;
+	SurviveRecord record;
+	init_record(recordingData, &record, SURVIVE_RECORD_LIGHT, so->codename);
+	record.light.sensor_id = sensor_id;
+	record.light.acode = acode;
+	record.light.timeinsweep = timeinsweep;
+	record.light.timecode = timecode;
+	record.light.length = length;
+	record.light.lh = lh;
+	write_record(recordingData, &record.hdr);
+}
 
-	switch (acode) {
-	case 0:
-	case 2:
-		LH_ID = "L";
-		LH_Axis = "X";
-		break;
-	case 1:
-	case 3:
-		LH_ID = "L";
-		LH_Axis = "Y";
-		break;
-	case 4:
-	case 6:
-		LH_ID = "R";
-		LH_Axis = "X";
-		break;
-	case 5:
-	case 7:
-		LH_ID = "R";
-		LH_Axis = "Y";
-		break;
+static void write_imu_record(SurviveRecordingData *recordingData, SurviveRecordType type, struct SurviveObject *so,
+							 int mask, FLT *accelgyro, uint32_t timecode, int id) {
+	SurviveRecord record;
+	init_record(recordingData, &record, type, so->codename);
+	record.imu.mask = mask;
+	record.imu.timecode = timecode;
+	record.imu.id = id;
+	for (int i = 0; i < 9; i++) {
+		record.imu.accelgyro[i] = accelgyro[i];
 	}
-
-	write_to_output(recordingData, "%s %s %s %d %d %d %u %u %u\n", so->codename, LH_ID, LH_Axis, sensor_id, acode,
-					timeinsweep, timecode, length, lh);
+	write_record(recordingData, &record.hdr);
 }
 
 void survive_recording_imu_process(struct SurviveObject *so, int mask, FLT *accelgyro, uint32_t timecode, int id) {
@@ -336,10 +571,8 @@ void survive_recording_imu_process(struct SurviveObject *so, int mask, FLT *acce
 	if (!recordingData->writeCalIMU) {
 		return;
 	}
-	
-	write_to_output(recordingData, "%s I %d %u %0.6f %0.6f %0.6f %0.6f %0.6f %0.6f  %0.6f %0.6f %0.6f %d\n",
-					so->codename, mask, timecode, accelgyro[0], accelgyro[1], accelgyro[2], accelgyro[3], accelgyro[4],
-					accelgyro[5], accelgyro[6], accelgyro[7], accelgyro[8], id);
+
+	write_imu_record(recordingData, SURVIVE_RECORD_IMU, so, mask, accelgyro, timecode, id);
 }
 
 void survive_recording_raw_imu_process(struct SurviveObject *so, int mask, FLT *accelgyro, uint32_t timecode, int id) {
@@ -351,9 +584,7 @@ void survive_recording_raw_imu_process(struct SurviveObject *so, int mask, FLT *
 		return;
 	}
 
-	write_to_output(recordingData, "%s i %d %u %0.6f %0.6f %0.6f %0.6f %0.6f %0.6f  %0.6f %0.6f %0.6f %d\n",
-					so->codename, mask, timecode, accelgyro[0], accelgyro[1], accelgyro[2], accelgyro[3], accelgyro[4],
-					accelgyro[5], accelgyro[6], accelgyro[7], accelgyro[8], id);
+	write_imu_record(recordingData, SURVIVE_RECORD_RAW_IMU, so, mask, accelgyro, timecode, id);
 }
 
 typedef struct SurvivePlaybackData SurvivePlaybackData;
@@ -375,306 +606,171 @@ static SurviveObject *find_or_warn(SurvivePlaybackData *driver, const char *dev)
 	return so;
 }
 
-static int parse_and_run_sweep(char *line, SurvivePlaybackData *driver) {
-	char dev[10];
-
-	survive_channel channel;
-	int sensor_id;
-	survive_timecode timecode;
-	uint8_t flag;
+static void playback_run_record(SurvivePlaybackData *driver, const SurviveRecordHeader *hdr) {
+	SurviveContext *ctx = driver->ctx;
+	const SurviveRecord *record = (const SurviveRecord *)hdr;
 
-	int rr = sscanf(line, SWEEP_SCANF, SWEEP_SCANF_ARGS);
-	if (rr != 5) {
-		SurviveContext *ctx = driver->ctx;
-		SV_WARN("Only got %d values for a sweep", rr);
-		return -1;
+	switch ((SurviveRecordType)hdr->type) {
+	case SURVIVE_RECORD_EXTERNAL_POSE: {
+		SurvivePose pose;
+		pose_from_record(&pose, record->pose.pose);
+		ctx->external_poseproc(ctx, hdr->dev, &pose);
+		return;
 	}
+	case SURVIVE_RECORD_POSE: {
+		if (!driver->outputExternalPose) {
+			return;
+		}
 
-	SurviveObject *so = find_or_warn(driver, dev);
-	if (!so) {
-		return -1;
+		char name[128];
+		snprintf(name, sizeof(name), "replay_%s", hdr->dev);
+		SurvivePose pose;
+		pose_from_record(&pose, record->pose.pose);
+		ctx->external_poseproc(ctx, name, &pose);
+		return;
 	}
-
-	driver->hasSweepAngle = true;
-	driver->ctx->sweepproc(so, channel, sensor_id, timecode, flag);
-	return 0;
-}
-
-static int parse_and_run_sync(char *line, SurvivePlaybackData *driver) {
-	char dev[10];
-
-	survive_channel channel;
-	survive_timecode timecode;
-	uint8_t ootx, gen;
-
-	int rr = sscanf(line, SYNC_SCANF, SYNC_SCANF_ARGS);
-	if (rr != 5) {
-		SurviveContext *ctx = driver->ctx;
-		SV_WARN("Only got %d values for a sync", rr);
-		return -1;
+	case SURVIVE_RECORD_LIGHTCAP:
+		driver->hasRawLight = true;
+		break;
+	case SURVIVE_RECORD_LIGHT:
+		// Sync-only 'S' records never made it past the text reader; keep it that way.
+		if (driver->hasRawLight || record->light.acode == -1) {
+			return;
+		}
+		break;
+	case SURVIVE_RECORD_SWEEP:
+		driver->hasSweepAngle = true;
+		break;
+	case SURVIVE_RECORD_SWEEP_ANGLE:
+		if (driver->hasSweepAngle) {
+			return;
+		}
+		break;
+	case SURVIVE_RECORD_SYNC:
+	case SURVIVE_RECORD_IMU:
+	case SURVIVE_RECORD_RAW_IMU:
+		break;
+	default:
+		return;
 	}
 
-	SurviveObject *so = find_or_warn(driver, dev);
+	SurviveObject *so = find_or_warn(driver, hdr->dev);
 	if (!so) {
-		return -1;
+		return;
 	}
 
-	driver->ctx->syncproc(so, channel, timecode, ootx, gen);
-	return 0;
-}
-
-static int parse_and_run_sweep_angle(char *line, SurvivePlaybackData *driver) {
-	char dev[10];
-
-	survive_channel channel;
-	int sensor_id;
-	survive_timecode timecode;
-	int8_t plane;
-	FLT angle;
-
-	int rr = sscanf(line, SWEEP_ANGLE_SCANF, SWEEP_ANGLE_SCANF_ARGS);
-
-	if (rr != 6) {
-		SurviveContext *ctx = driver->ctx;
-		SV_WARN("Only got %d values for sweep angle", rr);
-		return -1;
+	switch ((SurviveRecordType)hdr->type) {
+	case SURVIVE_RECORD_LIGHTCAP: {
+		LightcapElement le = {.sensor_id = record->lightcap.sensor_id,
+							  .length = record->lightcap.length,
+							  .timestamp = record->lightcap.timestamp};
+		handle_lightcap(so, &le);
+		break;
 	}
-
-	SurviveObject *so = find_or_warn(driver, dev);
-	if (!so) {
-		return -1;
+	case SURVIVE_RECORD_LIGHT: {
+		const SurviveRecordLight *r = &record->light;
+		ctx->lightproc(so, r->sensor_id, r->acode, r->timeinsweep, r->timecode, r->length, r->lh);
+		break;
 	}
-
-	driver->ctx->sweep_angleproc(so, channel, sensor_id, timecode, plane, angle);
-	return 0;
-}
-
-static int parse_and_run_pose(const char *line, SurvivePlaybackData *driver) {
-	char name[128] = "replay_";
-	SurvivePose pose;
-
-	int rr = sscanf(line, "%s POSE " SurvivePose_sformat "\n", name + strlen(name), &pose.Pos[0], &pose.Pos[1],
-					&pose.Pos[2], &pose.Rot[0], &pose.Rot[1], &pose.Rot[2], &pose.Rot[3]);
-
-	SurviveContext *ctx = driver->ctx;
-	if (rr != 8) {
-		SV_WARN("Only got %d values for a pose", rr);
-		return 0;
+	case SURVIVE_RECORD_SWEEP: {
+		const SurviveRecordSweep *r = &record->sweep;
+		ctx->sweepproc(so, r->channel, r->sensor_id, r->timecode, r->flag);
+		break;
 	}
-
-	ctx->external_poseproc(ctx, name, &pose);
-	return 0;
-}
-static int parse_and_run_imu(const char *line, SurvivePlaybackData *driver, bool raw) {
-	char dev[10];
-	int timecode = 0;
-	FLT accelgyro[9] = { 0 };
-	int mask;
-	int id;
-	SurviveContext *ctx = driver->ctx;
-
-	char i_char = 0;
-
-	int rr = sscanf(line,
-					"%s %c %d %d " FLT_sformat " " FLT_sformat " " FLT_sformat " " FLT_sformat " " FLT_sformat
-					" " FLT_sformat " " FLT_sformat " " FLT_sformat " " FLT_sformat "%d",
-					dev, &i_char, &mask, &timecode, &accelgyro[0], &accelgyro[1], &accelgyro[2], &accelgyro[3],
-					&accelgyro[4], &accelgyro[5], &accelgyro[6], &accelgyro[7], &accelgyro[8], &id);
-
-	if (rr == 11) {
-		// Older formats might not have mag data
-		id = accelgyro[6];
-		accelgyro[6] = 0;
-	} else if (rr != 14) {
-		SV_WARN("On line %d, only %d values read: '%s'", driver->lineno, rr, line);
-		return -1;
+	case SURVIVE_RECORD_SWEEP_ANGLE: {
+		const SurviveRecordSweepAngle *r = &record->sweep_angle;
+		ctx->sweep_angleproc(so, r->channel, r->sensor_id, r->timecode, r->plane, r->angle);
+		break;
 	}
-
-	assert(raw ^ i_char == 'I');
-
-	SurviveObject *so = survive_get_so_by_name(driver->ctx, dev);
-	if (!so) {
-		static bool display_once = false;
-		if (display_once == false) {
-			SV_ERROR(SURVIVE_ERROR_INVALID_CONFIG, "Could not find device named %s from lineno %d\n", dev,
-					 driver->lineno);
+	case SURVIVE_RECORD_SYNC: {
+		const SurviveRecordSync *r = &record->sync;
+		ctx->syncproc(so, r->channel, r->timecode, r->ootx, r->gen);
+		break;
+	}
+	case SURVIVE_RECORD_IMU:
+	case SURVIVE_RECORD_RAW_IMU: {
+		const SurviveRecordIMU *r = &record->imu;
+		FLT accelgyro[9];
+		for (int i = 0; i < 9; i++) {
+			accelgyro[i] = r->accelgyro[i];
 		}
-		display_once = true;
-		return -1;
+		(hdr->type == SURVIVE_RECORD_RAW_IMU ? ctx->raw_imuproc : ctx->imuproc)(so, r->mask, accelgyro, r->timecode,
+																				 r->id);
+		break;
+	}
+	default:
+		break;
 	}
-
-	(raw ? driver->ctx->raw_imuproc : driver->ctx->imuproc)(so, mask, accelgyro, timecode, id);
-	return 0;
 }
 
-static int parse_and_run_externalpose(const char *line, SurvivePlaybackData *driver) {
-	char name[128] = { 0 };
-	SurvivePose pose;
-
-	int rr = sscanf(line, "%s EXTERNAL_POSE " SurvivePose_sformat "\n", name, &pose.Pos[0], &pose.Pos[1], &pose.Pos[2],
-					&pose.Rot[0], &pose.Rot[1], &pose.Rot[2], &pose.Rot[3]);
+// How many records a synchronous playback processes per call to survive_poll
+#define PLAYBACK_SYNCHRONOUS_BATCH 256
 
-	SurviveContext *ctx = driver->ctx;
-	ctx->external_poseproc(ctx, name, &pose);
-	return 0;
+static bool playback_is_early(SurvivePlaybackData *driver) {
+	return !driver->synchronous && driver->next_time_s * driver->playback_factor > timestamp_in_s(driver);
 }
 
-static int parse_and_run_rawlight(const char *line, SurvivePlaybackData *driver) {
-	driver->hasRawLight = 1;
-
-	char dev[10];
-	char op[10];
-	LightcapElement le;
-	int rr = sscanf(line, "%s %s %hhu %u %hu\n", dev, op, &le.sensor_id, &le.timestamp, &le.length);
-
-	SurviveObject *so = survive_get_so_by_name(driver->ctx, dev);
-	if (!so) {
-		static bool display_once = false;
-		SurviveContext *ctx = driver->ctx;
-		if (display_once == false) {
-			SV_ERROR(SURVIVE_ERROR_INVALID_CONFIG, "Could not find device named %s from lineno %d\n", dev,
-					 driver->lineno);
-		}
-		display_once = true;
-
-		return -1;
-	}
-
-	handle_lightcap(so, &le);
-	return 0;
-}
-
-static int parse_and_run_lightcode(const char *line, SurvivePlaybackData *driver) {
-	char lhn[10];
-	char axn[10];
-	char dev[10];
-	uint32_t timecode = 0;
-	int sensor_id = 0;
-	int acode = 0;
-	int timeinsweep = 0;
-	uint32_t length = 0;
-	uint32_t lh = 0;
+static void playback_dispatch(SurvivePlaybackData *driver, const SurviveRecordHeader *hdr) {
 	SurviveContext *ctx = driver->ctx;
 
-	int rr = sscanf(line, "%8s %8s %8s %d %d %d %u %u %u\n", dev, lhn, axn, &sensor_id, &acode, &timeinsweep, &timecode,
-					&length, &lh);
-
-	if (rr != 9) {
-		SV_WARN("Warning:  On line %d, only %d values read: '%s'\n", driver->lineno, rr, line);
-		return -1;
+	// Synchronous playback runs from within survive_poll, which already holds the lock
+	if (!driver->synchronous) {
+		survive_get_ctx_lock(ctx);
 	}
 
-	SurviveObject *so = survive_get_so_by_name(driver->ctx, dev);
-	if (!so) {
-		static bool display_once = false;
-		if (display_once == false) {
-			SV_ERROR(SURVIVE_ERROR_INVALID_CONFIG, "Could not find device named %s from lineno %d\n", dev,
-					 driver->lineno);
-		}
-		display_once = true;
+	// Records count as packets arriving when they are played back
+	survive_latency_packet_begin(ctx, survive_latency_enabled(ctx) ? OGGetAbsoluteTime() : 0);
+	playback_run_record(driver, hdr);
+	survive_latency_packet_end(ctx);
 
-		return -1;
+	if (!driver->synchronous) {
+		survive_release_ctx_lock(ctx);
 	}
-
-	driver->ctx->lightproc(so, sensor_id, acode, timeinsweep, timecode, length, lh);
-	return 0;
 }
 
-static int playback_pump_msg(struct SurviveContext *ctx, void *_driver) {
-	SurvivePlaybackData *driver = _driver;
+static int playback_pump_text(struct SurviveContext *ctx, SurvivePlaybackData *driver) {
 	gzFile f = driver->playback_file;
 
 	if (f && !gzeof(f) && !gzerror_dropin(f)) {
 		driver->lineno++;
-		char *line = 0;
 
 		if (driver->next_time_s == 0) {
-			size_t n = 0;
-			ssize_t r = gzgetdelim(&line, &n, ' ', f);
+			ssize_t r = gzgetdelim(&driver->line, &driver->line_size, ' ', f);
 			if (r <= 0) {
-				free(line);
 				return 0;
 			}
 
-			if (sscanf(line, "%lf", &driver->next_time_s) != 1) {
-				free(line);
+			if (sscanf(driver->line, "%lf", &driver->next_time_s) != 1) {
 				return 0;
 			}
-			free(line);
-			line = 0;
 		}
 
-		if (driver->next_time_s * driver->playback_factor > timestamp_in_s())
+		if (playback_is_early(driver))
 			return 0;
 
 		driver->time_now = driver->next_time_s;
 		driver->next_time_s = 0;
 
-		size_t n = 0;
-		ssize_t r = gzgetline(&line, &n, f);
+		ssize_t r = gzgetline(&driver->line, &driver->line_size, f);
 		if (r <= 0) {
-			free(line);
 			return 0;
 		}
+		char *line = driver->line;
 		while (r && (line[r - 1] == '\n' || line[r - 1] == '\r')) {
 			line[--r] = 0;
 		}
-		char dev[32];
-		char op[32];
-		if (sscanf(line, "%31s %31s", dev, op) < 2) {
-			free(line);
-			return 0;
-		}
 
-		survive_get_ctx_lock(ctx);
-		switch (op[0]) {
-		case 'W':
-			if (op[1] == 0)
-				parse_and_run_sweep(line, driver);
-			break;
-		case 'B':
-			if (op[1] == 0 && driver->hasSweepAngle == false)
-				parse_and_run_sweep_angle(line, driver);
-			break;
-		case 'Y':
-			if (op[1] == 0)
-				parse_and_run_sync(line, driver);
-			break;
-		case 'E':
-			if (strcmp(op, "EXTERNAL_POSE") == 0) {
-				parse_and_run_externalpose(line, driver);
-				break;
+		SurviveRecord record;
+		int rr = survive_record_from_text(&record, sizeof(record), driver->time_now, line);
+		if (rr == -2) {
+			SV_WARN("Playback doesn't understand op in '%s'", line);
+		} else if (rr < 0) {
+			if (r > 0) {
+				SV_WARN("On line %d, could not parse '%s'", driver->lineno, line);
 			}
-		case 'C':
-			if (op[1] == 0)
-				parse_and_run_rawlight(line, driver);
-			break;
-		case 'L':
-		case 'R':
-			if (op[1] == 0 && driver->hasRawLight == false)
-				parse_and_run_lightcode(line, driver);
-			break;
-		case 'i':
-			if (op[1] == 0)
-				parse_and_run_imu(line, driver, true);
-			break;
-		case 'I':
-			if (op[1] == 0)
-				parse_and_run_imu(line, driver, false);
-			break;
-		case 'P':
-			if (strcmp(op, "POSE") == 0 && driver->outputExternalPose)
-				parse_and_run_pose(line, driver);
-			break;
-		case 'A':
-		case 'V':
-			break;
-		default:
-			SV_WARN("Playback doesn't understand '%s' op in '%s'", op, line);
+		} else {
+			playback_dispatch(driver, &record.hdr);
 		}
-		survive_release_ctx_lock(ctx);
-
-		free(line);
 	} else {
 		if (f) {
 			gzclose(driver->playback_file);
@@ -686,12 +782,40 @@ static int playback_pump_msg(struct SurviveContext *ctx, void *_driver) {
 	return 0;
 }
 
+static int playback_pump_binary(struct SurviveContext *ctx, SurvivePlaybackData *driver) {
+	const SurviveRecordHeader *hdr = survive_recording_binary_reader_peek(driver->binary_reader);
+	if (hdr == 0) {
+		return -1;
+	}
+
+	driver->next_time_s = hdr->time;
+	if (playback_is_early(driver))
+		return 0;
+
+	driver->lineno++;
+	driver->time_now = driver->next_time_s;
+	driver->next_time_s = 0;
+
+	playback_dispatch(driver, hdr);
+
+	survive_recording_binary_reader_next(driver->binary_reader);
+	return 0;
+}
+
+static int playback_pump_msg(struct SurviveContext *ctx, void *_driver) {
+	SurvivePlaybackData *driver = _driver;
+	if (driver->binary_reader) {
+		return playback_pump_binary(ctx, driver);
+	}
+	return playback_pump_text(ctx, driver);
+}
+
 static void *playback_thread(void *_driver) {
 	SurvivePlaybackData *driver = _driver;
 	driver->keepRunning = true;
 	while (driver->keepRunning) {
 		double next_time_s_scaled = driver->next_time_s * driver->playback_factor;
-		double time_now = timestamp_in_s();
+		double time_now = timestamp_in_s(driver);
 		if (next_time_s_scaled == 0 || next_time_s_scaled < time_now) {
 			int rtnVal = playback_pump_msg(driver->ctx, driver);
 			if (rtnVal < 0)
@@ -713,30 +837,81 @@ static int playback_poll(struct SurviveContext *ctx, void *_driver) {
 	return 0;
 }
 
+static int playback_poll_synchronous(struct SurviveContext *ctx, void *_driver) {
+	SurvivePlaybackData *driver = _driver;
+	for (int i = 0; i < PLAYBACK_SYNCHRONOUS_BATCH; i++) {
+		if (playback_pump_msg(ctx, driver) < 0) {
+			driver->keepRunning = false;
+			return -1;
+		}
+	}
+	return 0;
+}
+
 static int playback_close(struct SurviveContext *ctx, void *_driver) {
 	SurvivePlaybackData *driver = _driver;
 	driver->keepRunning = false;
-	SV_VERBOSE(100, "Waiting on playback thread...");
-	survive_release_ctx_lock(ctx);
-	OGJoinThread(driver->playback_thread);
-	survive_get_ctx_lock(ctx);
-	SV_VERBOSE(100, "Playback thread slept for %ums", driver->total_sleep_time);
+	if (driver->playback_thread) {
+		SV_VERBOSE(100, "Waiting on playback thread...");
+		survive_release_ctx_lock(ctx);
+		OGJoinThread(driver->playback_thread);
+		survive_get_ctx_lock(ctx);
+		SV_VERBOSE(100, "Playback thread slept for %ums", driver->total_sleep_time);
+	}
 	if (driver->playback_file)
 		gzclose(driver->playback_file);
 	driver->playback_file = 0;
+	survive_recording_binary_reader_close(driver->binary_reader);
+	driver->binary_reader = 0;
 
 	survive_detach_config(ctx, "playback-factor", &driver->playback_factor);
 
+	free(driver->line);
 	free(driver);
 	return 0;
 }
 
 void survive_destroy_recording(SurviveContext *ctx) {
-	if (ctx->recptr) {
-		gzclose(ctx->recptr->output_file);
-		free(ctx->recptr);
-		ctx->recptr = 0;
+	SurviveRecordingData *recordingData = ctx->recptr;
+	if (recordingData == 0 || recordingData->queue == 0) {
+		return;
+	}
+
+	// Nothing new is queued once the queue is detached; the writer runs everything queued ahead of the stop signal
+	// before it exits
+	survive_atomic_store_ptr((void *volatile *)&recordingData->queue, 0);
+	survive_atomic_store_u32(&recordingData->running, 0);
+	OGUnlockSema(recordingData->available);
+	OGJoinThread(recordingData->writer_thread);
+
+	if (recordingData->dropped) {
+		SV_INFO("Recording dropped %u records", recordingData->dropped);
 	}
+
+	if (recordingData->output_file)
+		gzclose(recordingData->output_file);
+	recordingData->output_file = 0;
+	survive_recording_binary_writer_close(recordingData->binary_output);
+	recordingData->binary_output = 0;
+}
+
+void survive_free_recording(SurviveContext *ctx) {
+	SurviveRecordingData *recordingData = ctx->recptr;
+	if (recordingData == 0) {
+		return;
+	}
+
+	survive_destroy_recording(ctx);
+	ctx->recptr = 0;
+
+	OGDeleteSema(recordingData->available);
+	free(recordingData->slots);
+	free(recordingData->overflow);
+	free(recordingData);
+}
+
+uint32_t survive_recording_dropped(const SurviveContext *ctx) {
+	return ctx->recptr ? survive_atomic_load_u32(&ctx->recptr->dropped) : 0;
 }
 
 void survive_install_recording(SurviveContext *ctx) {
@@ -744,60 +919,73 @@ void survive_install_recording(SurviveContext *ctx) {
 	int record_to_stdout = survive_configi(ctx, "record-stdout", SC_GET, 0);
 
 	if (strlen(dataout_file) > 0 || record_to_stdout) {
-		ctx->recptr = SV_CALLOC(1, sizeof(struct SurviveRecordingData));
-		ctx->recptr->ctx = ctx;
-		if (strlen(dataout_file) > 0) {
+		SurviveRecordingData *recordingData = SV_CALLOC(1, sizeof(struct SurviveRecordingData));
+		recordingData->ctx = ctx;
+		recordingData->alwaysWriteStdOut = record_to_stdout;
+
+		// Log lines are recorded as well, so the writer has to be up before anything below logs
+		recordingData->slots = SV_CALLOC(SURVIVE_RECORDING_QUEUE_SIZE, sizeof(recording_slot));
+		for (uint32_t i = 0; i < SURVIVE_RECORDING_QUEUE_SIZE; i++) {
+			recordingData->slots[i].sequence = i;
+		}
+		recordingData->queue = recordingData->slots;
+		recordingData->overflow = SV_MALLOC(SURVIVE_RECORDING_OVERFLOW_CNT * SURVIVE_RECORDING_OVERFLOW_SIZE);
+		recordingData->overflow_free = (1u << SURVIVE_RECORDING_OVERFLOW_CNT) - 1;
+		recordingData->running = 1;
+		recordingData->available = OGCreateSema();
+		recordingData->writer_thread = OGCreateThread(recording_writer_thread, recordingData);
+		OGNameThread(recordingData->writer_thread, "recording");
+		ctx->recptr = recordingData;
+
+		if (survive_recording_is_binary_path(dataout_file)) {
+			recordingData->binary_output = survive_recording_binary_writer_open(dataout_file);
+			if (recordingData->binary_output == 0) {
+				survive_destroy_recording(ctx);
+				SV_INFO("Could not open %s for writing", dataout_file);
+				return;
+			}
+			SV_INFO("Recording to '%s' in binary format", dataout_file);
+		} else if (strlen(dataout_file) > 0) {
 			bool useCompression = strncmp(dataout_file + strlen(dataout_file) - 3, ".gz", 3) == 0;
 
-			ctx->recptr->output_file = gzopen(dataout_file, useCompression ? "w" : "wT");
-			if (ctx->recptr->output_file == 0) {
+			recordingData->output_file = gzopen(dataout_file, useCompression ? "w" : "wT");
+			if (recordingData->output_file == 0) {
+				survive_destroy_recording(ctx);
 				SV_INFO("Could not open %s for writing", dataout_file);
-				free(ctx->recptr);
-				ctx->recptr = 0;
 				return;
 			}
 			SV_INFO("Recording to '%s' Compression: %d", dataout_file, useCompression);
 		}
 
-		ctx->recptr->alwaysWriteStdOut = record_to_stdout;
 		if (record_to_stdout) {
 			SV_INFO("Recording to stdout");
 		}
 
-		ctx->recptr->writeRawLight = survive_configi(ctx, "record-rawlight", SC_GET, 1);
-		ctx->recptr->writeIMU = survive_configi(ctx, "record-imu", SC_GET, 1);
-		ctx->recptr->writeCalIMU = survive_configi(ctx, "record-cal-imu", SC_GET, 0);
-		ctx->recptr->writeAngle = survive_configi(ctx, "record-angle", SC_GET, 1);
+		recordingData->writeRawLight = survive_configi(ctx, "record-rawlight", SC_GET, 1);
+		recordingData->writeIMU = survive_configi(ctx, "record-imu", SC_GET, 1);
+		recordingData->writeCalIMU = survive_configi(ctx, "record-cal-imu", SC_GET, 0);
+		recordingData->writeAngle = survive_configi(ctx, "record-angle", SC_GET, 1);
 	}
 }
 
-int DriverRegPlayback(SurviveContext *ctx) {
-	const char *playback_file = survive_configs(ctx, "playback", SC_GET, 0);
+static void playback_add_device(SurvivePlaybackData *sp, const char *dev, const char *configStart, size_t len) {
+	SurviveContext *ctx = sp->ctx;
+	SurviveObject *so = survive_create_device(ctx, "replay", sp, dev, 0);
 
-	if (playback_file == 0 || strlen(playback_file) == 0) {
-		SV_WARN("The playback argument requires a filename");
-		return -1;
-	}
+	char *config = SV_CALLOC(1, len + 1);
+	memcpy(config, configStart, len);
 
-	SurvivePlaybackData *sp = SV_CALLOC(1, sizeof(SurvivePlaybackData));
-	sp->ctx = ctx;
-	sp->playback_dir = playback_file;
-
-	sp->outputExternalPose = survive_configi(ctx, "playback-replay-pose", SC_GET, 0);
-
-	sp->playback_file = gzopen(playback_file, "r");
-	if (sp->playback_file == 0) {
-		SV_ERROR(SURVIVE_ERROR_INVALID_CONFIG, "Could not open playback events file %s", playback_file);
-		return -1;
+	if (ctx->configproc(so, config, len) == 0) {
+		SV_INFO("Found %s in playback file...", dev);
+		survive_add_object(ctx, so);
+	} else {
+		SV_WARN("Found %s in playback file, but could not read config description", dev);
+		free(so);
 	}
-	survive_install_run_time_fn(ctx, survive_usbmon_playback_run_time, sp);
-	survive_attach_configf(ctx, "playback-factor", &sp->playback_factor);
-
-	SV_INFO("Using playback file '%s' with timefactor of %f", playback_file, sp->playback_factor);
+}
 
-	ctx->poll_min_time_ms = 1;
-	if (sp->playback_factor == 0.0)
-		ctx->poll_min_time_ms = 0;
+static int playback_load_text_devices(SurvivePlaybackData *sp) {
+	SurviveContext *ctx = sp->ctx;
 
 	FLT time;
 	while (!gzeof(sp->playback_file) && !gzerror_dropin(sp->playback_file)) {
@@ -838,26 +1026,80 @@ int DriverRegPlayback(SurviveContext *ctx) {
 				while (*(++configStart) != ' ')
 					;
 			}
-			size_t len = strlen(configStart);
 
-			SurviveObject *so = survive_create_device(ctx, "replay", sp, dev, 0);
-
-			char *config = SV_CALLOC(1, len + 1);
-			memcpy(config, configStart, len);
-
-			if (ctx->configproc(so, config, len) == 0) {
-				SV_INFO("Found %s in playback file...", dev);
-				survive_add_object(ctx, so);
-			} else {
-				SV_WARN("Found %s in playback file, but could not read config description", dev);
-				free(so);
-			}
+			playback_add_device(sp, dev, configStart, strlen(configStart));
 		}
 
 		free(line);
 	}
 
 	gzseek(sp->playback_file, 0, SEEK_SET); // same as rewind(f);
+	return 0;
+}
+
+static void playback_load_binary_devices(SurvivePlaybackData *sp) {
+	const SurviveRecordHeader *hdr;
+	while ((hdr = survive_recording_binary_reader_peek(sp->binary_reader)) && hdr->time <= 10) {
+		if (hdr->type == SURVIVE_RECORD_CONFIG) {
+			const SurviveRecordBlob *blob = (const SurviveRecordBlob *)hdr;
+			playback_add_device(sp, hdr->dev, survive_record_blob_data(blob), blob->length);
+		}
+		survive_recording_binary_reader_next(sp->binary_reader);
+	}
+
+	survive_recording_binary_reader_rewind(sp->binary_reader);
+}
+
+int DriverRegPlayback(SurviveContext *ctx) {
+	const char *playback_file = survive_configs(ctx, "playback", SC_GET, 0);
+
+	if (playback_file == 0 || strlen(playback_file) == 0) {
+		SV_WARN("The playback argument requires a filename");
+		return -1;
+	}
+
+	SurvivePlaybackData *sp = SV_CALLOC(1, sizeof(SurvivePlaybackData));
+	sp->ctx = ctx;
+	sp->playback_dir = playback_file;
+
+	sp->outputExternalPose = survive_configi(ctx, "playback-replay-pose", SC_GET, 0);
+	sp->synchronous = survive_configi(ctx, "playback-synchronous", SC_GET, 0);
+
+	if (survive_recording_is_binary_file(playback_file)) {
+		sp->binary_reader = survive_recording_binary_reader_open(playback_file);
+		if (sp->binary_reader == 0) {
+			SV_ERROR(SURVIVE_ERROR_INVALID_CONFIG, "Could not open binary playback file %s", playback_file);
+			free(sp);
+			return -1;
+		}
+	} else {
+		sp->playback_file = gzopen(playback_file, "r");
+		if (sp->playback_file == 0) {
+			SV_ERROR(SURVIVE_ERROR_INVALID_CONFIG, "Could not open playback events file %s", playback_file);
+			return -1;
+		}
+	}
+	survive_install_run_time_fn(ctx, survive_usbmon_playback_run_time, sp);
+	survive_attach_configf(ctx, "playback-factor", &sp->playback_factor);
+
+	SV_INFO("Using playback file '%s' with timefactor of %f", playback_file, sp->playback_factor);
+
+	ctx->poll_min_time_ms = 1;
+	if (sp->playback_factor == 0.0 || sp->synchronous)
+		ctx->poll_min_time_ms = 0;
+
+	if (sp->binary_reader) {
+		playback_load_binary_devices(sp);
+	} else if (playback_load_text_devices(sp) != 0) {
+		return -1;
+	}
+
+	if (sp->synchronous) {
+		SV_INFO("Playing back synchronously");
+		sp->keepRunning = true;
+		survive_add_driver(ctx, sp, playback_poll_synchronous, playback_close, 0);
+		return 0;
+	}
 
 	sp->playback_thread = OGCreateThread(playback_thread, sp);
 	OGNameThread(sp->playback_thread, "playback");
@@ -1,7 +1,19 @@
 #include <survive.h>
 
+/**
+ * Stops recording and closes the outputs. Threads still recording at the time keep a valid, but detached, queue until
+ * survive_free_recording.
+ */
 void survive_destroy_recording(SurviveContext *ctx);
+/**
+ * Frees what survive_destroy_recording left behind; only once nothing can record anymore.
+ */
+void survive_free_recording(SurviveContext *ctx);
 void survive_install_recording(SurviveContext *ctx);
+/**
+ * Number of records dropped so far because the recording writer thread fell too far behind.
+ */
+SURVIVE_EXPORT uint32_t survive_recording_dropped(const SurviveContext *ctx);
 void survive_recording_config_process(SurviveObject *so, char *ct0conf, int len);
 
 void survive_recording_lighthouse_process(SurviveContext *ctx, uint8_t lighthouse, SurvivePose *lh_pose,
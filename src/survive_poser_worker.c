@@ -0,0 +1,389 @@
+#include "survive_poser_worker.h"
+#include "survive_atomic.h"
+#include "survive_config.h"
+#include "survive_latency.h"
+
+#include <os_generic.h>
+#include <string.h>
+#include <survive.h>
+
+STATIC_CONFIG_ITEM(POSER_THREADS, "poser-threads", 'i',
+				   "Number of threads to run object posers on; objects share them. 0 runs posers inline", 0)
+
+// Must be a power of two
+#define SURVIVE_POSER_WORKER_QUEUE_SIZE 512
+
+// Posers can report a pose several times a solve, so the pool thread a call comes from has to be known without
+// looking it up
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SURVIVE_THREAD_LOCAL __declspec(thread)
+#else
+#define SURVIVE_THREAD_LOCAL __thread
+#endif
+
+typedef union PoserDataAny {
+	PoserData hdr;
+	PoserDataIMU imu;
+	PoserDataLightGen1 light_gen1;
+	PoserDataLightGen2 light_gen2;
+} PoserDataAny;
+
+typedef struct poser_worker_item {
+	PoserDataAny data;
+	bool add_activations;
+} poser_worker_item;
+
+typedef struct survive_poser_thread survive_poser_thread;
+
+struct survive_poser_worker {
+	SurviveObject *so;
+	survive_poser_thread *thread;
+	struct survive_poser_worker *next;
+
+	// Guarded by the thread's lock; posted once the queue drains while a flush waits on it
+	bool flush_waiting;
+	og_sema_t drained;
+
+	uint32_t dropped;
+
+	// head is only written by the producer, tail only by the pool thread
+	uint32_t head;
+	uint32_t tail;
+	poser_worker_item queue[SURVIVE_POSER_WORKER_QUEUE_SIZE];
+};
+
+struct survive_poser_thread {
+	SurviveContext *ctx;
+	survive_poser_pool *pool;
+	og_thread_t thread;
+	og_sema_t available;
+	uint32_t running;
+
+	// Guards the worker list and the bookkeeping after each item; never held while a poser runs
+	og_mutex_t lock;
+	survive_poser_worker *workers;
+	size_t worker_cnt;
+	// The worker last handed an item; the next scan starts just after it
+	survive_poser_worker *last_served;
+};
+
+struct survive_poser_pool {
+	size_t thread_cnt;
+	survive_poser_thread *threads;
+
+	// Pool threads waiting on or holding the context lock to report results. Driver threads rarely let go of the
+	// context lock for long, so they hand it over until this drops back to zero; see yield_to_output.
+	og_mutex_t output_lock;
+	og_cv_t output_done;
+	uint32_t output_waiting;
+};
+
+static SURVIVE_THREAD_LOCAL survive_poser_thread *current_thread;
+
+static size_t queueable_size(const PoserData *pd) {
+	switch (pd->pt) {
+	case POSERDATA_IMU:
+		return sizeof(PoserDataIMU);
+	case POSERDATA_LIGHT:
+	case POSERDATA_SYNC:
+		return sizeof(PoserDataLightGen1);
+	case POSERDATA_LIGHT_GEN2:
+	case POSERDATA_SYNC_GEN2:
+		return sizeof(PoserDataLightGen2);
+	default:
+		return 0;
+	}
+}
+
+static void run_poser(SurviveObject *so, PoserData *pd, bool add_activations) {
+	if (add_activations) {
+		switch (pd->pt) {
+		case POSERDATA_IMU:
+			SurviveSensorActivations_add_imu(&so->activations, (PoserDataIMU *)pd);
+			break;
+		case POSERDATA_LIGHT:
+			SurviveSensorActivations_add(&so->activations, (PoserDataLightGen1 *)pd);
+			break;
+		case POSERDATA_LIGHT_GEN2:
+			SurviveSensorActivations_add_gen2(&so->activations, (PoserDataLightGen2 *)pd);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (so->PoserFn) {
+		survive_latency_mark(so, SURVIVE_LATENCY_POSER, pd->arrival_time);
+		so->PoserFn(so, pd);
+	}
+}
+
+static survive_poser_worker *next_pending_worker(survive_poser_thread *thread) {
+	survive_poser_worker *start = thread->last_served && thread->last_served->next ? thread->last_served->next
+																				   : thread->workers;
+	survive_poser_worker *worker = start;
+	if (worker == 0) {
+		return 0;
+	}
+
+	do {
+		if (worker->tail != survive_atomic_load_u32(&worker->head)) {
+			thread->last_served = worker;
+			return worker;
+		}
+		worker = worker->next ? worker->next : thread->workers;
+	} while (worker != start);
+	return 0;
+}
+
+static void *poser_thread(void *_thread) {
+	survive_poser_thread *thread = _thread;
+	current_thread = thread;
+
+	while (true) {
+		OGLockSema(thread->available);
+		if (!survive_atomic_load_u32(&thread->running)) {
+			break;
+		}
+
+		// Each post is for one item, but items from every object on this thread are taken in turn
+		OGLockMutex(thread->lock);
+		survive_poser_worker *worker = next_pending_worker(thread);
+		OGUnlockMutex(thread->lock);
+		if (worker == 0) {
+			continue;
+		}
+
+		// Posers read ctx->bsd throughout a solve, which solves on other threads can do at the same time; see
+		// survive_poser_output_begin for how they report results
+		uint32_t tail = worker->tail;
+		poser_worker_item *item = &worker->queue[tail & (SURVIVE_POSER_WORKER_QUEUE_SIZE - 1)];
+		survive_get_bsd_read_lock(thread->ctx);
+		run_poser(worker->so, &item->data.hdr, item->add_activations);
+		survive_release_bsd_read_lock(thread->ctx);
+
+		OGLockMutex(thread->lock);
+		survive_atomic_store_u32(&worker->tail, tail + 1);
+		if (worker->flush_waiting && tail + 1 == survive_atomic_load_u32(&worker->head)) {
+			worker->flush_waiting = false;
+			OGUnlockSema(worker->drained);
+		}
+		OGUnlockMutex(thread->lock);
+	}
+
+	return 0;
+}
+
+survive_poser_pool *survive_poser_pool_create(SurviveContext *ctx) {
+	int thread_cnt = survive_configi(ctx, POSER_THREADS_TAG, SC_GET, 0);
+	if (thread_cnt <= 0) {
+		return 0;
+	}
+
+	survive_poser_pool *pool = SV_NEW(survive_poser_pool);
+	pool->thread_cnt = thread_cnt;
+	pool->output_lock = OGCreateMutex();
+	pool->output_done = OGCreateConditionVariable();
+	pool->threads = SV_CALLOC(thread_cnt, sizeof(survive_poser_thread));
+	for (int i = 0; i < thread_cnt; i++) {
+		survive_poser_thread *thread = &pool->threads[i];
+		thread->ctx = ctx;
+		thread->pool = pool;
+		thread->running = 1;
+		thread->lock = OGCreateMutex();
+		thread->available = OGCreateSema();
+		thread->thread = OGCreateThread(poser_thread, thread);
+
+		char name[32];
+		snprintf(name, sizeof(name), "poser %d", i);
+		OGNameThread(thread->thread, name);
+	}
+
+	return pool;
+}
+
+void survive_poser_pool_free(survive_poser_pool *pool) {
+	if (pool == 0) {
+		return;
+	}
+
+	for (size_t i = 0; i < pool->thread_cnt; i++) {
+		survive_poser_thread *thread = &pool->threads[i];
+		survive_atomic_store_u32(&thread->running, 0);
+		OGUnlockSema(thread->available);
+		OGJoinThread(thread->thread);
+		OGDeleteSema(thread->available);
+		OGDeleteMutex(thread->lock);
+	}
+
+	OGDeleteConditionVariable(pool->output_done);
+	OGDeleteMutex(pool->output_lock);
+	free(pool->threads);
+	free(pool);
+}
+
+void survive_poser_worker_start(survive_poser_pool *pool, SurviveObject *so) {
+	if (pool == 0 || so->poser_worker) {
+		return;
+	}
+
+	survive_poser_thread *thread = &pool->threads[0];
+	for (size_t i = 1; i < pool->thread_cnt; i++) {
+		if (pool->threads[i].worker_cnt < thread->worker_cnt) {
+			thread = &pool->threads[i];
+		}
+	}
+
+	survive_poser_worker *worker = SV_NEW(survive_poser_worker);
+	worker->so = so;
+	worker->thread = thread;
+	worker->drained = OGCreateSema();
+
+	OGLockMutex(thread->lock);
+	worker->next = thread->workers;
+	thread->workers = worker;
+	thread->worker_cnt++;
+	OGUnlockMutex(thread->lock);
+
+	so->poser_worker = worker;
+}
+
+void survive_poser_worker_stop(SurviveObject *so) {
+	survive_poser_worker *worker = so->poser_worker;
+	if (worker == 0) {
+		return;
+	}
+
+	survive_poser_worker_flush(so);
+
+	// The pool thread only touches a worker with something queued, or under its lock
+	survive_poser_thread *thread = worker->thread;
+	OGLockMutex(thread->lock);
+	for (survive_poser_worker **it = &thread->workers; *it; it = &(*it)->next) {
+		if (*it == worker) {
+			*it = worker->next;
+			break;
+		}
+	}
+	if (thread->last_served == worker) {
+		thread->last_served = 0;
+	}
+	thread->worker_cnt--;
+	OGUnlockMutex(thread->lock);
+
+	if (worker->dropped) {
+		SurviveContext *ctx = so->ctx;
+		SV_INFO("Poser worker for %s dropped %u events", so->codename, worker->dropped);
+	}
+
+	so->poser_worker = 0;
+	OGDeleteSema(worker->drained);
+	free(worker);
+}
+
+void survive_poser_worker_flush(SurviveObject *so) {
+	survive_poser_worker *worker = so->poser_worker;
+	if (worker == 0) {
+		return;
+	}
+
+	survive_poser_thread *thread = worker->thread;
+	OGLockMutex(thread->lock);
+	bool pending = worker->tail != worker->head;
+	worker->flush_waiting = pending;
+	OGUnlockMutex(thread->lock);
+
+	if (pending) {
+		// The poser may need the context lock to report what it finds before it can get to the end of the queue
+		survive_release_ctx_lock(so->ctx);
+		OGLockSema(worker->drained);
+		survive_get_ctx_lock(so->ctx);
+	}
+}
+
+static void yield_to_output(SurviveContext *ctx, survive_poser_pool *pool) {
+	if (!survive_atomic_load_u32(&pool->output_waiting)) {
+		return;
+	}
+
+	bool released = false;
+	OGLockMutex(pool->output_lock);
+	while (pool->output_waiting) {
+		if (!released) {
+			survive_release_ctx_lock(ctx);
+			released = true;
+		}
+		OGWaitCond(pool->output_done, pool->output_lock);
+	}
+	OGUnlockMutex(pool->output_lock);
+
+	if (released) {
+		survive_get_ctx_lock(ctx);
+	}
+}
+
+void survive_poser_invoke(SurviveObject *so, PoserData *pd, bool add_activations) {
+	survive_poser_worker *worker = so->poser_worker;
+	size_t size = worker ? queueable_size(pd) : 0;
+	if (size == 0) {
+		survive_poser_worker_flush(so);
+		run_poser(so, pd, add_activations);
+		return;
+	}
+
+	yield_to_output(so->ctx, worker->thread->pool);
+
+	uint32_t head = worker->head;
+	if (head - survive_atomic_load_u32(&worker->tail) >= SURVIVE_POSER_WORKER_QUEUE_SIZE) {
+		if ((worker->dropped++ % SURVIVE_POSER_WORKER_QUEUE_SIZE) == 0) {
+			SurviveContext *ctx = so->ctx;
+			SV_WARN("Poser for %s is %d events behind; dropped %u events so far", so->codename,
+					SURVIVE_POSER_WORKER_QUEUE_SIZE, worker->dropped);
+		}
+		return;
+	}
+
+	poser_worker_item *item = &worker->queue[head & (SURVIVE_POSER_WORKER_QUEUE_SIZE - 1)];
+	memcpy(&item->data, pd, size);
+	item->add_activations = add_activations;
+	survive_atomic_store_u32(&worker->head, head + 1);
+
+	OGUnlockSema(worker->thread->available);
+}
+
+void survive_poser_output_begin(SurviveObject *so) {
+	if (current_thread == 0 || current_thread->ctx != so->ctx) {
+		return;
+	}
+
+	survive_poser_pool *pool = current_thread->pool;
+	OGLockMutex(pool->output_lock);
+	survive_atomic_store_u32(&pool->output_waiting, pool->output_waiting + 1);
+	OGUnlockMutex(pool->output_lock);
+
+	// Driver threads hold the context lock when they take the bsd lock, so it has to be let go first
+	survive_release_bsd_read_lock(so->ctx);
+	survive_get_ctx_lock(so->ctx);
+}
+
+void survive_poser_output_end(SurviveObject *so) {
+	if (current_thread == 0 || current_thread->ctx != so->ctx) {
+		return;
+	}
+
+	survive_release_ctx_lock(so->ctx);
+
+	survive_poser_pool *pool = current_thread->pool;
+	OGLockMutex(pool->output_lock);
+	survive_atomic_store_u32(&pool->output_waiting, pool->output_waiting - 1);
+	if (pool->output_waiting == 0) {
+		OGBroadcastCond(pool->output_done);
+	}
+	OGUnlockMutex(pool->output_lock);
+
+	survive_get_bsd_read_lock(so->ctx);
+}
+
+uint32_t survive_poser_worker_dropped(const SurviveObject *so) {
+	return so->poser_worker ? so->poser_worker->dropped : 0;
+}
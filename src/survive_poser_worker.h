@@ -0,0 +1,74 @@
+#pragma once
+
+#include <poser.h>
+#include <survive_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * With 'poser-threads' set, posers run on a fixed pool of that many threads instead of inline. Each object is bound
+ * to one pool thread, which keeps its measurements in order; driver threads hand measurements to it through a single
+ * producer / single consumer ring per object -- producers are already serialized by the context lock -- so a slow
+ * solve never stalls ingestion.
+ *
+ * ctx->bsd is only written with both the context lock and the bsd lock held (see survive_get_bsd_lock), so either the
+ * context lock or the read side of the bsd lock is enough to read it. Pool threads hold the read side while a poser
+ * runs, so solves on different threads overlap, and trade it for the context lock while the poser reports results;
+ * see survive_poser_output_begin. Each pool thread serves its objects round-robin, one item at a time.
+ */
+typedef struct survive_poser_pool survive_poser_pool;
+typedef struct survive_poser_worker survive_poser_worker;
+
+/**
+ * Starts the pool threads if 'poser-threads' is set; returns NULL otherwise.
+ */
+SURVIVE_EXPORT survive_poser_pool *survive_poser_pool_create(SurviveContext *ctx);
+
+/**
+ * Stops the pool threads. Every object's worker has to be stopped first.
+ */
+SURVIVE_EXPORT void survive_poser_pool_free(survive_poser_pool *pool);
+
+/**
+ * Binds 'so' to the least loaded pool thread, if there is a pool and it isn't bound already.
+ */
+SURVIVE_EXPORT void survive_poser_worker_start(survive_poser_pool *pool, SurviveObject *so);
+
+/**
+ * Lets the pool finish everything queued for 'so', then unbinds it. Posers are called inline again afterwards.
+ * Must be called with the context lock held.
+ */
+SURVIVE_EXPORT void survive_poser_worker_stop(SurviveObject *so);
+
+/**
+ * Blocks until the pool has run everything queued for 'so'. Must be called from the thread that feeds the worker,
+ * with the context lock held, before calling the object's poser directly. The context lock is let go while waiting.
+ */
+SURVIVE_EXPORT void survive_poser_worker_flush(SurviveObject *so);
+
+/**
+ * Hands 'pd' to the object's poser; if 'add_activations' is set the object's sensor activations are updated with it
+ * first. Runs on the pool if the object is bound to it, and inline otherwise. Only IMU, light and sync data can be
+ * queued; anything else runs inline once the worker is flushed. When the pool falls a full queue behind, events are
+ * dropped, counted and logged.
+ */
+SURVIVE_EXPORT void survive_poser_invoke(SurviveObject *so, PoserData *pd, bool add_activations);
+
+/**
+ * Brackets calls a poser makes into the context's pose, velocity and lighthouse callbacks. On a pool thread this
+ * trades the read side of the bsd lock for the context lock for the duration, so callbacks run under the context lock
+ * as they do inline; anywhere else it does nothing.
+ */
+SURVIVE_EXPORT void survive_poser_output_begin(SurviveObject *so);
+SURVIVE_EXPORT void survive_poser_output_end(SurviveObject *so);
+
+/**
+ * Number of events dropped because the pool fell too far behind on 'so'.
+ */
+SURVIVE_EXPORT uint32_t survive_poser_worker_dropped(const SurviveObject *so);
+
+#ifdef __cplusplus
+};
+#endif
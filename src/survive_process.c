@@ -4,7 +4,10 @@
 #include "survive_cal.h"
 #include "survive_config.h"
 #include "survive_default_devices.h"
+#include "survive_internal.h"
+#include "survive_latency.h"
 #include "survive_playback.h"
+#include "survive_poser_worker.h"
 #include <assert.h>
 #include <survive.h>
 
@@ -23,6 +26,7 @@ void survive_default_light_process( SurviveObject * so, int sensor_id, int acode
 	lh = survive_get_bsd_idx(so->ctx, lh);
 
 	survive_notify_gen1(so, "Lightcap called");
+	survive_latency_mark_packet(so, SURVIVE_LATENCY_DISAMBIGUATOR);
 
 	SurviveContext * ctx = so->ctx;
 	int base_station = lh;
@@ -41,7 +45,7 @@ void survive_default_light_process( SurviveObject * so, int sensor_id, int acode
 
 	//We don't use sync times, yet.
 	if (sensor_id <= -1) {
-		if (so->PoserFn) {
+		{
 			PoserDataLightGen1 l = {
 				.common =
 					{
@@ -57,7 +61,7 @@ void survive_default_light_process( SurviveObject * so, int sensor_id, int acode
 				.acode = acode,
 				.length = length,
 			};
-			so->PoserFn(so, (PoserData *)&l);
+			survive_poser_invoke(so, (PoserData *)&l, false);
 		}
 		return;
 	}
@@ -103,18 +107,18 @@ void survive_default_angle_process( SurviveObject * so, int sensor_id, int acode
 		.length = length,
 	};
 
-	// Simulate the use of only one lighthouse in playback mode.
-	if (lh < ctx->activeLighthouses)
-		SurviveSensorActivations_add(&so->activations, &l);
+	survive_latency_stamp(so, &l.common.hdr);
+	survive_latency_mark(so, SURVIVE_LATENCY_ANGLE, l.common.hdr.arrival_time);
 
 	survive_recording_angle_process(so, sensor_id, acode, timecode, length, angle, lh);
+	survive_output_listeners_angle(so, sensor_id, timecode, lh, acode & 1, length, angle);
 
 	if (ctx->calptr) {
 		survive_cal_angle(so, sensor_id, acode, timecode, length, angle, lh);
 	}
-	if (so->PoserFn) {
-		so->PoserFn( so, (PoserData *)&l );
-	}
+
+	// Simulate the use of only one lighthouse in playback mode.
+	survive_poser_invoke(so, (PoserData *)&l, lh < ctx->activeLighthouses);
 }
 
 void survive_default_lightcap_process(SurviveObject *so, const LightcapElement *le) {
@@ -123,7 +127,8 @@ void survive_default_lightcap_process(SurviveObject *so, const LightcapElement *
 
 void survive_default_button_process(SurviveObject * so, uint8_t eventType, uint8_t buttonId, uint8_t axis1Id, uint16_t axis1Val, uint8_t axis2Id, uint16_t axis2Val)
 {
-	// do nothing.
+	survive_output_listeners_button(so, eventType, buttonId, axis1Id, axis1Val, axis2Id, axis2Val);
+
 	//printf("ButtonEntry: eventType:%x, buttonId:%d, axis1:%d, axis1Val:%8.8x, axis2:%d, axis2Val:%8.8x\n",
 	//	eventType,
 	//	buttonId,
@@ -165,11 +170,13 @@ void survive_default_pose_process(SurviveObject *so, uint32_t timecode, SurviveP
 	so->OutPose = *pose;
 	so->OutPose_timecode = timecode;
 	survive_recording_raw_pose_process(so, timecode, pose);
+	survive_output_listeners_pose(so, timecode, pose);
 }
 void survive_default_velocity_process(SurviveObject *so, uint32_t timecode, const SurviveVelocity *velocity) {
 	survive_recording_velocity_process(so, timecode, velocity);
 	so->velocity = *velocity;
 	so->velocity_timecode = timecode;
+	survive_output_listeners_velocity(so, timecode, velocity);
 }
 
 void survive_default_external_velocity_process(SurviveContext *ctx, const char *name, const SurviveVelocity *vel) {
@@ -181,6 +188,7 @@ void survive_default_external_pose_process(SurviveContext *ctx, const char *name
 
 void survive_default_lighthouse_pose_process(SurviveContext *ctx, uint8_t lighthouse, SurvivePose *lighthouse_pose,
 											 SurvivePose *object_pose) {
+	survive_get_bsd_lock(ctx);
 	if (lighthouse_pose) {
 		ctx->bsd[lighthouse].Pose = *lighthouse_pose;
 		ctx->bsd[lighthouse].PositionSet = 1;
@@ -189,6 +197,7 @@ void survive_default_lighthouse_pose_process(SurviveContext *ctx, uint8_t lighth
 	}
 
 	config_set_lighthouse(ctx->lh_config, &ctx->bsd[lighthouse], lighthouse);
+	survive_release_bsd_lock(ctx);
 	config_save(ctx, survive_configs(ctx, "configfile", SC_GET, "config.json"));
 
 	survive_recording_lighthouse_process(ctx, lighthouse, lighthouse_pose, object_pose);
@@ -294,13 +303,11 @@ void survive_default_imu_process( SurviveObject * so, int mask, FLT * accelgyrom
 		.gyro = {accelgyromag[3], accelgyromag[4], accelgyromag[5]},
 		.mag = {accelgyromag[6], accelgyromag[7], accelgyromag[8]},
 	};
+	survive_latency_stamp(so, &imu.hdr);
 
-	SurviveSensorActivations_add_imu(&so->activations, &imu);
-
-	if (so->PoserFn) {
-		so->PoserFn( so, (PoserData *)&imu );
-	}
+	survive_poser_invoke(so, (PoserData *)&imu, true);
 
 	survive_recording_imu_process(so, mask, accelgyromag, timecode, id);
+	survive_output_listeners_imu(so, mask, accelgyromag, timecode, id);
 }
 
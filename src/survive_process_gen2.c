@@ -2,7 +2,9 @@
 #include "survive.h"
 #include "survive_config.h"
 #include "survive_internal.h"
+#include "survive_latency.h"
 #include "survive_playback.h"
+#include "survive_poser_worker.h"
 #include <assert.h>
 #include <math.h>
 
@@ -34,6 +36,7 @@ static void ootx_packet_clbk_d_gen2(ootx_decoder_context *ct, ootx_packet *packe
 	if (doSave) {
 		SV_INFO("Got OOTX packet %d", ctx->bsd[id].mode);
 
+		survive_get_bsd_lock(ctx);
 		b->BaseStationID = v15.id;
 		for (int i = 0; i < 2; i++) {
 			b->fcal[i].phase = v15.fcal_phase[i];
@@ -54,6 +57,7 @@ static void ootx_packet_clbk_d_gen2(ootx_decoder_context *ct, ootx_packet *packe
 		b->OOTXSet = 1;
 
 		config_set_lighthouse(ctx->lh_config, b, id);
+		survive_release_bsd_lock(ctx);
 		config_save(ctx, survive_configs(ctx, "configfile", SC_GET, "config.json"));
 	}
 }
@@ -70,6 +74,7 @@ static void ootx_packet_cblk_d_gen1(ootx_decoder_context *ct, ootx_packet *packe
 
 	BaseStationData *b = &ctx->bsd[id];
 
+	survive_get_bsd_lock(ctx);
 	b->BaseStationID = v6.id;
 	b->fcal[0].phase = v6.fcal_0_phase;
 	b->fcal[1].phase = v6.fcal_1_phase;
@@ -88,6 +93,7 @@ static void ootx_packet_cblk_d_gen1(ootx_decoder_context *ct, ootx_packet *packe
 	b->OOTXSet = 1;
 
 	config_set_lighthouse(ctx->lh_config, b, id);
+	survive_release_bsd_lock(ctx);
 	config_save(ctx, survive_configs(ctx, "configfile", SC_GET, "config.json"));
 }
 
@@ -153,8 +159,8 @@ SURVIVE_EXPORT void survive_default_sync_process(SurviveObject *so, survive_chan
 								.lh = bsd_idx,
 							}};
 
-	if (so->PoserFn && ctx->lh_version != -1) {
-		so->PoserFn(so, (PoserData *)&l);
+	if (ctx->lh_version != -1) {
+		survive_poser_invoke(so, (PoserData *)&l, false);
 	}
 }
 SURVIVE_EXPORT void survive_default_sweep_process(SurviveObject *so, survive_channel channel, int sensor_id,
@@ -168,6 +174,7 @@ SURVIVE_EXPORT void survive_default_sweep_process(SurviveObject *so, survive_cha
 	}
 
 	survive_notify_gen2(so, "sweep called");
+	survive_latency_mark_packet(so, SURVIVE_LATENCY_LIGHTCAP);
 
 	if (ctx->calptr) {
 		// survive_cal_light( so, sensor_id, acode, timeinsweep, timecode, length, lh);
@@ -233,15 +240,14 @@ SURVIVE_EXPORT void survive_default_sweep_angle_process(SurviveObject *so, survi
 								},
 							.plane = plane};
 
-	// Simulate the use of only one lighthouse in playback mode.
-	if (bsd_idx < ctx->activeLighthouses)
-		SurviveSensorActivations_add_gen2(&so->activations, &l);
+	survive_latency_stamp(so, &l.common.hdr);
+	survive_latency_mark(so, SURVIVE_LATENCY_ANGLE, l.common.hdr.arrival_time);
 
 	survive_recording_sweep_angle_process(so, channel, sensor_id, timecode, plane, angle);
+	survive_output_listeners_angle(so, sensor_id, timecode, bsd_idx, plane, 0, angle);
 
-	if (so->PoserFn) {
-		so->PoserFn(so, (PoserData *)&l);
-	}
+	// Simulate the use of only one lighthouse in playback mode.
+	survive_poser_invoke(so, (PoserData *)&l, bsd_idx < ctx->activeLighthouses);
 }
 
 SURVIVE_EXPORT void survive_default_gen_detected_process(SurviveObject *so, int lh_version) {
@@ -0,0 +1,641 @@
+// All MIT/x11 Licensed Code in this file may be relicensed freely under the GPL
+// or LGPL licenses.
+#include "survive_recording.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <survive.h>
+
+#ifdef NOZLIB
+#define gzFile FILE *
+#define gzopen fopen
+#define gzclose fclose
+#define gzwrite(f, buf, len) fwrite(buf, 1, len, f)
+#else
+#include <zlib.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define SURVIVE_RECORD_ALIGN(x) (((x) + 7) & ~(size_t)7)
+
+static const size_t record_sizes[SURVIVE_RECORD_TYPE_MAX] = {
+	[SURVIVE_RECORD_LH_POSE] = sizeof(SurviveRecordPose),
+	[SURVIVE_RECORD_POSE] = sizeof(SurviveRecordPose),
+	[SURVIVE_RECORD_EXTERNAL_POSE] = sizeof(SurviveRecordPose),
+	[SURVIVE_RECORD_VELOCITY] = sizeof(SurviveRecordVelocity),
+	[SURVIVE_RECORD_EXTERNAL_VELOCITY] = sizeof(SurviveRecordVelocity),
+	[SURVIVE_RECORD_LIGHTCAP] = sizeof(SurviveRecordLightcap),
+	[SURVIVE_RECORD_LIGHT] = sizeof(SurviveRecordLight),
+	[SURVIVE_RECORD_ANGLE] = sizeof(SurviveRecordAngle),
+	[SURVIVE_RECORD_SYNC] = sizeof(SurviveRecordSync),
+	[SURVIVE_RECORD_SWEEP] = sizeof(SurviveRecordSweep),
+	[SURVIVE_RECORD_SWEEP_ANGLE] = sizeof(SurviveRecordSweepAngle),
+	[SURVIVE_RECORD_IMU] = sizeof(SurviveRecordIMU),
+	[SURVIVE_RECORD_RAW_IMU] = sizeof(SurviveRecordIMU),
+};
+
+static size_t record_min_size(uint16_t type) {
+	switch (type) {
+	case SURVIVE_RECORD_CONFIG:
+	case SURVIVE_RECORD_INFO:
+		return sizeof(SurviveRecordBlob);
+	case SURVIVE_RECORD_NONE:
+		return sizeof(SurviveRecordHeader);
+	default:
+		// Unknown types can't be read at all
+		return type < SURVIVE_RECORD_TYPE_MAX ? record_sizes[type] : SIZE_MAX;
+	}
+}
+
+static void record_init_header(SurviveRecordHeader *hdr, SurviveRecordType type, double time, const char *dev,
+							   size_t size) {
+	memset(hdr, 0, sizeof(*hdr));
+	hdr->time = time;
+	hdr->type = type;
+	hdr->size = SURVIVE_RECORD_ALIGN(size);
+	if (dev) {
+		strncpy(hdr->dev, dev, sizeof(hdr->dev) - 1);
+	}
+}
+
+void survive_record_init(SurviveRecord *record, SurviveRecordType type, double time, const char *dev) {
+	memset(record, 0, record_sizes[type] ? record_sizes[type] : sizeof(SurviveRecordHeader));
+	record_init_header(&record->hdr, type, time, dev, record_sizes[type]);
+}
+
+size_t survive_record_blob_size(size_t length) { return SURVIVE_RECORD_ALIGN(sizeof(SurviveRecordBlob) + length); }
+
+void survive_record_init_blob(SurviveRecordBlob *record, size_t capacity, SurviveRecordType type, double time,
+							  const char *dev, const char *data, size_t length) {
+	if (sizeof(SurviveRecordBlob) + length > capacity) {
+		length = capacity - sizeof(SurviveRecordBlob);
+	}
+
+	record_init_header(&record->hdr, type, time, dev, sizeof(SurviveRecordBlob) + length);
+	record->length = length;
+	record->reserved = 0;
+	memcpy(record + 1, data, length);
+}
+
+int survive_record_from_text(SurviveRecord *record, size_t capacity, double time, const char *line) {
+	char dev[128] = {0};
+	char op[32] = {0};
+	int consumed = 0;
+
+	if (sscanf(line, "%127s %31s%n", dev, op, &consumed) < 2) {
+		return -1;
+	}
+	const char *args = line + consumed;
+
+	if (strcmp(op, "CONFIG") == 0 || strcmp(op, "LOG") == 0) {
+		// Exactly one separator; the payload's own leading whitespace is kept
+		if (*args == ' ')
+			args++;
+		size_t length = strlen(args);
+		while (length > 0 && (args[length - 1] == '\n' || args[length - 1] == '\r')) {
+			length--;
+		}
+		survive_record_init_blob(&record->blob, capacity, op[0] == 'C' ? SURVIVE_RECORD_CONFIG : SURVIVE_RECORD_INFO,
+								 time, dev, args, length);
+		return 0;
+	}
+
+	if (strcmp(op, "LH_POSE") == 0 || strcmp(op, "POSE") == 0 || strcmp(op, "EXTERNAL_POSE") == 0) {
+		SurviveRecordType type = op[0] == 'L' ? SURVIVE_RECORD_LH_POSE
+											  : (op[0] == 'P' ? SURVIVE_RECORD_POSE : SURVIVE_RECORD_EXTERNAL_POSE);
+		survive_record_init(record, type, time, dev);
+		double *p = record->pose.pose;
+		if (sscanf(args, "%lf %lf %lf %lf %lf %lf %lf", &p[0], &p[1], &p[2], &p[3], &p[4], &p[5], &p[6]) != 7) {
+			return -1;
+		}
+		if (type == SURVIVE_RECORD_LH_POSE) {
+			record->pose.lighthouse = atoi(dev);
+		}
+		return 0;
+	}
+
+	if (strcmp(op, "VELOCITY") == 0 || strcmp(op, "EXTERNAL_VELOCITY") == 0) {
+		survive_record_init(record, op[0] == 'V' ? SURVIVE_RECORD_VELOCITY : SURVIVE_RECORD_EXTERNAL_VELOCITY, time,
+							dev);
+		double *v = record->velocity.velocity;
+		if (sscanf(args, "%lf %lf %lf %lf %lf %lf", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5]) != 6) {
+			return -1;
+		}
+		return 0;
+	}
+
+	if (op[1] != 0) {
+		return -2;
+	}
+
+	switch (op[0]) {
+	case 'C': {
+		SurviveRecordLightcap *r = &record->lightcap;
+		survive_record_init(record, SURVIVE_RECORD_LIGHTCAP, time, dev);
+		return sscanf(args, "%hhu %u %hu", &r->sensor_id, &r->timestamp, &r->length) == 3 ? 0 : -1;
+	}
+	case 'S': {
+		SurviveRecordLight *r = &record->light;
+		survive_record_init(record, SURVIVE_RECORD_LIGHT, time, dev);
+		return sscanf(args, "%d %d %d %u %u %u", &r->sensor_id, &r->acode, &r->timeinsweep, &r->timecode, &r->length,
+					  &r->lh) == 6
+				   ? 0
+				   : -1;
+	}
+	case 'L':
+	case 'R': {
+		SurviveRecordLight *r = &record->light;
+		char axis[10];
+		survive_record_init(record, SURVIVE_RECORD_LIGHT, time, dev);
+		return sscanf(args, "%8s %d %d %d %u %u %u", axis, &r->sensor_id, &r->acode, &r->timeinsweep, &r->timecode,
+					  &r->length, &r->lh) == 7
+				   ? 0
+				   : -1;
+	}
+	case 'A': {
+		SurviveRecordAngle *r = &record->angle;
+		survive_record_init(record, SURVIVE_RECORD_ANGLE, time, dev);
+		return sscanf(args, "%d %d %u %lf %lf %u", &r->sensor_id, &r->acode, &r->timecode, &r->length, &r->angle,
+					  &r->lh) == 6
+				   ? 0
+				   : -1;
+	}
+	case 'Y': {
+		SurviveRecordSync *r = &record->sync;
+		survive_record_init(record, SURVIVE_RECORD_SYNC, time, dev);
+		return sscanf(args, "%hhu %u %hhu %hhu", &r->channel, &r->timecode, &r->ootx, &r->gen) == 4 ? 0 : -1;
+	}
+	case 'W': {
+		SurviveRecordSweep *r = &record->sweep;
+		survive_record_init(record, SURVIVE_RECORD_SWEEP, time, dev);
+		return sscanf(args, "%hhu %d %u %hhu", &r->channel, &r->sensor_id, &r->timecode, &r->flag) == 4 ? 0 : -1;
+	}
+	case 'B': {
+		SurviveRecordSweepAngle *r = &record->sweep_angle;
+		survive_record_init(record, SURVIVE_RECORD_SWEEP_ANGLE, time, dev);
+		return sscanf(args, "%hhu %d %u %hhd %lf", &r->channel, &r->sensor_id, &r->timecode, &r->plane, &r->angle) ==
+					   5
+				   ? 0
+				   : -1;
+	}
+	case 'i':
+	case 'I': {
+		SurviveRecordIMU *r = &record->imu;
+		double *ag = r->accelgyro;
+		survive_record_init(record, op[0] == 'i' ? SURVIVE_RECORD_RAW_IMU : SURVIVE_RECORD_IMU, time, dev);
+		int rr = sscanf(args, "%d %u %lf %lf %lf %lf %lf %lf %lf %lf %lf %d", &r->mask, &r->timecode, &ag[0], &ag[1],
+						&ag[2], &ag[3], &ag[4], &ag[5], &ag[6], &ag[7], &ag[8], &r->id);
+		if (rr == 9) {
+			// Older formats might not have mag data
+			r->id = ag[6];
+			ag[6] = 0;
+		} else if (rr != 12) {
+			return -1;
+		}
+		return 0;
+	}
+	}
+
+	return -2;
+}
+
+static const char *light_op(int acode) {
+	switch (acode) {
+	case 0:
+	case 2:
+		return "L X";
+	case 1:
+	case 3:
+		return "L Y";
+	case 4:
+	case 6:
+		return "R X";
+	case 5:
+	case 7:
+		return "R Y";
+	}
+	return "? ?";
+}
+
+int survive_record_to_text(const SurviveRecordHeader *hdr, char *buffer, size_t buffer_len) {
+	const SurviveRecord *record = (const SurviveRecord *)hdr;
+	int prefix = snprintf(buffer, buffer_len, "%0.6f ", hdr->time);
+	if (prefix < 0) {
+		return prefix;
+	}
+	buffer_len = (size_t)prefix < buffer_len ? buffer_len - prefix : 0;
+	buffer = buffer_len ? buffer + prefix : 0;
+
+	const char *dev = hdr->dev;
+	int rtn = -1;
+	switch ((SurviveRecordType)hdr->type) {
+	case SURVIVE_RECORD_CONFIG: {
+		const SurviveRecordBlob *r = &record->blob;
+		rtn = snprintf(buffer, buffer_len, "%s CONFIG ", dev);
+		size_t written = rtn;
+		for (uint32_t i = 0; i < r->length; i++, written++) {
+			char c = survive_record_blob_data(r)[i];
+			if (written + 1 < buffer_len) {
+				buffer[written] = (c == '\n' || c == '\r') ? ' ' : c;
+			}
+		}
+		if (written < buffer_len) {
+			written += snprintf(buffer + written, buffer_len - written, "\r\n");
+		} else {
+			if (buffer_len) {
+				buffer[buffer_len - 1] = 0;
+			}
+			written += 2;
+		}
+		rtn = written;
+		break;
+	}
+	case SURVIVE_RECORD_INFO: {
+		const SurviveRecordBlob *r = &record->blob;
+		rtn = snprintf(buffer, buffer_len, "%s LOG %.*s\n", dev, (int)r->length, survive_record_blob_data(r));
+		break;
+	}
+	case SURVIVE_RECORD_LH_POSE:
+	case SURVIVE_RECORD_POSE:
+	case SURVIVE_RECORD_EXTERNAL_POSE: {
+		const double *p = record->pose.pose;
+		const char *op = hdr->type == SURVIVE_RECORD_LH_POSE
+							 ? "LH_POSE"
+							 : (hdr->type == SURVIVE_RECORD_POSE ? "POSE" : "EXTERNAL_POSE");
+		rtn = snprintf(buffer, buffer_len, "%s %s %0.6f %0.6f %0.6f %0.6f %0.6f %0.6f %0.6f\n", dev, op, p[0], p[1], p[2],
+					   p[3], p[4], p[5], p[6]);
+		break;
+	}
+	case SURVIVE_RECORD_VELOCITY:
+	case SURVIVE_RECORD_EXTERNAL_VELOCITY: {
+		const double *v = record->velocity.velocity;
+		rtn = snprintf(buffer, buffer_len, "%s %s %0.6f %0.6f %0.6f %0.6f %0.6f %0.6f\n", dev,
+					   hdr->type == SURVIVE_RECORD_VELOCITY ? "VELOCITY" : "EXTERNAL_VELOCITY", v[0], v[1], v[2], v[3],
+					   v[4], v[5]);
+		break;
+	}
+	case SURVIVE_RECORD_LIGHTCAP: {
+		const SurviveRecordLightcap *r = &record->lightcap;
+		rtn = snprintf(buffer, buffer_len, "%s C %d %u %u\n", dev, r->sensor_id, r->timestamp, r->length);
+		break;
+	}
+	case SURVIVE_RECORD_LIGHT: {
+		const SurviveRecordLight *r = &record->light;
+		if (r->acode == -1) {
+			rtn = snprintf(buffer, buffer_len, "%s S %d %d %d %u %u %u\n", dev, r->sensor_id, r->acode, r->timeinsweep,
+						   r->timecode, r->length, r->lh);
+		} else {
+			rtn = snprintf(buffer, buffer_len, "%s %s %d %d %d %u %u %u\n", dev, light_op(r->acode), r->sensor_id,
+						   r->acode, r->timeinsweep, r->timecode, r->length, r->lh);
+		}
+		break;
+	}
+	case SURVIVE_RECORD_ANGLE: {
+		const SurviveRecordAngle *r = &record->angle;
+		rtn = snprintf(buffer, buffer_len, "%s A %d %d %u %0.6f %0.6f %u\n", dev, r->sensor_id, r->acode, r->timecode,
+					   r->length, r->angle, r->lh);
+		break;
+	}
+	case SURVIVE_RECORD_SYNC: {
+		const SurviveRecordSync *r = &record->sync;
+		rtn = snprintf(buffer, buffer_len, "%s Y %hhu %u %hhu %hhu\n", dev, r->channel, r->timecode, r->ootx, r->gen);
+		break;
+	}
+	case SURVIVE_RECORD_SWEEP: {
+		const SurviveRecordSweep *r = &record->sweep;
+		rtn = snprintf(buffer, buffer_len, "%s W %hhu %d %u %hhu\n", dev, r->channel, r->sensor_id, r->timecode,
+					   r->flag);
+		break;
+	}
+	case SURVIVE_RECORD_SWEEP_ANGLE: {
+		const SurviveRecordSweepAngle *r = &record->sweep_angle;
+		rtn = snprintf(buffer, buffer_len, "%s B %hhu %u %u %hhd " FLT_format "\n", dev, r->channel, r->sensor_id,
+					   r->timecode, r->plane, (FLT)r->angle);
+		break;
+	}
+	case SURVIVE_RECORD_IMU:
+	case SURVIVE_RECORD_RAW_IMU: {
+		const SurviveRecordIMU *r = &record->imu;
+		const double *ag = r->accelgyro;
+		rtn = snprintf(buffer, buffer_len, "%s %c %d %u %0.6f %0.6f %0.6f %0.6f %0.6f %0.6f  %0.6f %0.6f %0.6f %d\n", dev,
+					   hdr->type == SURVIVE_RECORD_IMU ? 'I' : 'i', r->mask, r->timecode, ag[0], ag[1], ag[2], ag[3],
+					   ag[4], ag[5], ag[6], ag[7], ag[8], r->id);
+		break;
+	}
+	default:
+		return -1;
+	}
+
+	return rtn < 0 ? rtn : rtn + prefix;
+}
+
+bool survive_recording_is_binary_path(const char *path) {
+	size_t len = path ? strlen(path) : 0;
+	return len > 4 && strcmp(path + len - 4, ".bin") == 0;
+}
+
+bool survive_recording_is_binary_file(const char *path) {
+	FILE *f = fopen(path, "rb");
+	if (f == 0) {
+		return false;
+	}
+
+	char magic[4] = {0};
+	bool rtn = fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+			   memcmp(magic, SURVIVE_RECORDING_BINARY_MAGIC, sizeof(magic)) == 0;
+	fclose(f);
+	return rtn;
+}
+
+struct SurviveRecordingBinaryWriter {
+	FILE *f;
+	size_t used;
+	uint8_t buffer[1 << 16];
+};
+
+SurviveRecordingBinaryWriter *survive_recording_binary_writer_open(const char *path) {
+	FILE *f = fopen(path, "wb");
+	if (f == 0) {
+		return 0;
+	}
+
+	// We do our own buffering; no need to copy everything twice
+	setvbuf(f, 0, _IONBF, 0);
+
+	SurviveRecordingBinaryWriter *writer = SV_NEW(SurviveRecordingBinaryWriter);
+	writer->f = f;
+
+	SurviveRecordingBinaryHeader header = {.version = SURVIVE_RECORDING_BINARY_VERSION,
+										   .byte_order = SURVIVE_RECORDING_BYTE_ORDER_MARK,
+										   .record_header_size = sizeof(SurviveRecordHeader)};
+	memcpy(header.magic, SURVIVE_RECORDING_BINARY_MAGIC, sizeof(header.magic));
+	memcpy(writer->buffer, &header, sizeof(header));
+	writer->used = sizeof(header);
+
+	return writer;
+}
+
+void survive_recording_binary_writer_flush(SurviveRecordingBinaryWriter *writer) {
+	if (writer->used) {
+		fwrite(writer->buffer, 1, writer->used, writer->f);
+		writer->used = 0;
+	}
+}
+
+void survive_recording_binary_writer_write(SurviveRecordingBinaryWriter *writer, const SurviveRecordHeader *record) {
+	if (writer->used + record->size > sizeof(writer->buffer)) {
+		survive_recording_binary_writer_flush(writer);
+	}
+
+	if (record->size > sizeof(writer->buffer)) {
+		fwrite(record, 1, record->size, writer->f);
+		return;
+	}
+
+	memcpy(writer->buffer + writer->used, record, record->size);
+	writer->used += record->size;
+}
+
+void survive_recording_binary_writer_close(SurviveRecordingBinaryWriter *writer) {
+	if (writer == 0) {
+		return;
+	}
+
+	survive_recording_binary_writer_flush(writer);
+	fclose(writer->f);
+	free(writer);
+}
+
+static bool reader_validate(const SurviveRecordingBinaryReader *reader) {
+	if (reader->size < sizeof(SurviveRecordingBinaryHeader)) {
+		return false;
+	}
+
+	const SurviveRecordingBinaryHeader *header = (const SurviveRecordingBinaryHeader *)reader->data;
+	return memcmp(header->magic, SURVIVE_RECORDING_BINARY_MAGIC, sizeof(header->magic)) == 0 &&
+		   header->version == SURVIVE_RECORDING_BINARY_VERSION &&
+		   header->byte_order == SURVIVE_RECORDING_BYTE_ORDER_MARK &&
+		   header->record_header_size == sizeof(SurviveRecordHeader);
+}
+
+SurviveRecordingBinaryReader *survive_recording_binary_reader_open(const char *path) {
+	SurviveRecordingBinaryReader *reader = SV_NEW(SurviveRecordingBinaryReader);
+
+#ifndef _WIN32
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		free(reader);
+		return 0;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		void *data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED) {
+			madvise(data, st.st_size, MADV_SEQUENTIAL);
+			reader->data = data;
+			reader->size = st.st_size;
+			reader->is_mapped = true;
+		}
+	}
+	close(fd);
+#else
+	FILE *f = fopen(path, "rb");
+	if (f) {
+		fseek(f, 0, SEEK_END);
+		long size = ftell(f);
+		fseek(f, 0, SEEK_SET);
+		if (size > 0) {
+			uint8_t *data = SV_MALLOC(size);
+			reader->size = fread(data, 1, size, f);
+			reader->data = data;
+		}
+		fclose(f);
+	}
+#endif
+
+	if (reader->data == 0 || !reader_validate(reader)) {
+		survive_recording_binary_reader_close(reader);
+		return 0;
+	}
+
+	survive_recording_binary_reader_rewind(reader);
+	return reader;
+}
+
+const SurviveRecordHeader *survive_recording_binary_reader_peek(const SurviveRecordingBinaryReader *reader) {
+	if (reader->offset + sizeof(SurviveRecordHeader) > reader->size) {
+		return 0;
+	}
+
+	const SurviveRecordHeader *hdr = (const SurviveRecordHeader *)(reader->data + reader->offset);
+	if (hdr->size < sizeof(SurviveRecordHeader) || reader->offset + hdr->size > reader->size) {
+		// Truncated file; likely the recorder didn't get to shut down cleanly
+		return 0;
+	}
+
+	// Callers cast to the record type without looking further, so a record too small for its type ends the file too
+	if (hdr->size < record_min_size(hdr->type)) {
+		return 0;
+	}
+
+	if (hdr->type == SURVIVE_RECORD_CONFIG || hdr->type == SURVIVE_RECORD_INFO) {
+		const SurviveRecordBlob *blob = (const SurviveRecordBlob *)hdr;
+		if (blob->length > hdr->size - sizeof(SurviveRecordBlob)) {
+			return 0;
+		}
+	}
+
+	return hdr;
+}
+
+void survive_recording_binary_reader_next(SurviveRecordingBinaryReader *reader) {
+	const SurviveRecordHeader *hdr = survive_recording_binary_reader_peek(reader);
+	reader->offset = hdr ? reader->offset + hdr->size : reader->size;
+}
+
+void survive_recording_binary_reader_rewind(SurviveRecordingBinaryReader *reader) {
+	reader->offset = sizeof(SurviveRecordingBinaryHeader);
+}
+
+void survive_recording_binary_reader_close(SurviveRecordingBinaryReader *reader) {
+	if (reader == 0) {
+		return;
+	}
+
+#ifndef _WIN32
+	if (reader->is_mapped) {
+		munmap((void *)reader->data, reader->size);
+	}
+#else
+	free((void *)reader->data);
+#endif
+	free(reader);
+}
+
+#ifdef _MSC_VER
+typedef long ssize_t;
+#endif
+
+// Defined alongside the text playback driver
+ssize_t gzgetline(char **lineptr, size_t *n, gzFile stream);
+
+typedef struct recording_converter {
+	SurviveRecordingBinaryWriter *binary_output;
+	gzFile text_output;
+	int count;
+} recording_converter;
+
+static void convert_record(recording_converter *converter, const SurviveRecordHeader *hdr) {
+	converter->count++;
+	if (converter->binary_output) {
+		survive_recording_binary_writer_write(converter->binary_output, hdr);
+		return;
+	}
+
+	char buffer[512];
+	char *line = buffer;
+	int len = survive_record_to_text(hdr, buffer, sizeof(buffer));
+	if (len >= (int)sizeof(buffer)) {
+		line = SV_MALLOC(len + 1);
+		survive_record_to_text(hdr, line, len + 1);
+	}
+	if (len > 0) {
+		gzwrite(converter->text_output, line, len);
+	}
+	if (line != buffer) {
+		free(line);
+	}
+}
+
+static int convert_text_records(recording_converter *converter, const char *input_path) {
+	gzFile f = gzopen(input_path, "r");
+	if (f == 0) {
+		return -1;
+	}
+
+	char *line = 0;
+	size_t n = 0;
+	ssize_t r;
+	while ((r = gzgetline(&line, &n, f)) > 0) {
+		while (r && (line[r - 1] == '\n' || line[r - 1] == '\r')) {
+			line[--r] = 0;
+		}
+
+		double time;
+		int offset = 0;
+		if (sscanf(line, "%lf %n", &time, &offset) != 1) {
+			continue;
+		}
+
+		SurviveRecord stack_record;
+		SurviveRecord *record = &stack_record;
+		size_t capacity = sizeof(stack_record);
+
+		// CONFIG lines are the only ones that can be larger than a single record
+		if ((size_t)r > sizeof(stack_record) / 2) {
+			capacity = survive_record_blob_size(r);
+			record = SV_MALLOC(capacity);
+		}
+
+		if (survive_record_from_text(record, capacity, time, line + offset) == 0) {
+			convert_record(converter, &record->hdr);
+		}
+
+		if (record != &stack_record) {
+			free(record);
+		}
+	}
+
+	free(line);
+	gzclose(f);
+	return 0;
+}
+
+int survive_recording_convert(const char *input_path, const char *output_path) {
+	recording_converter converter = {0};
+	if (survive_recording_is_binary_path(output_path)) {
+		converter.binary_output = survive_recording_binary_writer_open(output_path);
+		if (converter.binary_output == 0) {
+			return -1;
+		}
+	} else {
+		bool useCompression = strlen(output_path) > 3 && strcmp(output_path + strlen(output_path) - 3, ".gz") == 0;
+		converter.text_output = gzopen(output_path, useCompression ? "w" : "wT");
+		if (converter.text_output == 0) {
+			return -1;
+		}
+	}
+
+	int rtn = 0;
+	if (survive_recording_is_binary_file(input_path)) {
+		SurviveRecordingBinaryReader *reader = survive_recording_binary_reader_open(input_path);
+		if (reader == 0) {
+			rtn = -1;
+		} else {
+			const SurviveRecordHeader *hdr;
+			while ((hdr = survive_recording_binary_reader_peek(reader))) {
+				convert_record(&converter, hdr);
+				survive_recording_binary_reader_next(reader);
+			}
+			survive_recording_binary_reader_close(reader);
+		}
+	} else {
+		rtn = convert_text_records(&converter, input_path);
+	}
+
+	survive_recording_binary_writer_close(converter.binary_output);
+	if (converter.text_output) {
+		gzclose(converter.text_output);
+	}
+
+	return rtn < 0 ? rtn : converter.count;
+}
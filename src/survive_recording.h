@@ -0,0 +1,239 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <survive_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Recordings come in two flavors; the original line based text format and a binary format made up of fixed-size
+ * tagged frames. Both are described by the same record structs below -- the text format is just a printf'd version
+ * of each record.
+ *
+ * A binary file is a SurviveRecordingBinaryHeader followed by back to back records. Every record starts with a
+ * SurviveRecordHeader whose 'size' covers the whole record and is always a multiple of 8 so that every record in a
+ * mapped file is naturally aligned. Values are stored in the byte order of the machine that wrote them; readers
+ * reject files whose byte order mark doesn't match.
+ */
+#define SURVIVE_RECORDING_BINARY_MAGIC "SVRB"
+#define SURVIVE_RECORDING_BINARY_VERSION 1
+#define SURVIVE_RECORDING_BYTE_ORDER_MARK 0x01020304
+
+typedef enum SurviveRecordType {
+	SURVIVE_RECORD_NONE = 0,
+	SURVIVE_RECORD_CONFIG,
+	SURVIVE_RECORD_INFO,
+	SURVIVE_RECORD_LH_POSE,
+	SURVIVE_RECORD_POSE,
+	SURVIVE_RECORD_VELOCITY,
+	SURVIVE_RECORD_EXTERNAL_POSE,
+	SURVIVE_RECORD_EXTERNAL_VELOCITY,
+	SURVIVE_RECORD_LIGHTCAP,
+	SURVIVE_RECORD_LIGHT,
+	SURVIVE_RECORD_ANGLE,
+	SURVIVE_RECORD_SYNC,
+	SURVIVE_RECORD_SWEEP,
+	SURVIVE_RECORD_SWEEP_ANGLE,
+	SURVIVE_RECORD_IMU,
+	SURVIVE_RECORD_RAW_IMU,
+	SURVIVE_RECORD_TYPE_MAX
+} SurviveRecordType;
+
+typedef struct SurviveRecordingBinaryHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t byte_order;
+	uint32_t record_header_size;
+} SurviveRecordingBinaryHeader;
+
+typedef struct SurviveRecordHeader {
+	double time; // survive_run_time when the event was recorded
+	uint32_t size;
+	uint16_t type;
+	uint16_t reserved;
+	char dev[16]; // Codename of the device; lighthouse index for LH_POSE; name for EXTERNAL_*. Always null terminated
+} SurviveRecordHeader;
+
+// Used for CONFIG and INFO records; 'length' bytes of data immediately follow this struct.
+typedef struct SurviveRecordBlob {
+	SurviveRecordHeader hdr;
+	uint32_t length;
+	uint32_t reserved;
+} SurviveRecordBlob;
+
+typedef struct SurviveRecordPose {
+	SurviveRecordHeader hdr;
+	double pose[7];
+	uint32_t lighthouse;
+	uint32_t reserved;
+} SurviveRecordPose;
+
+typedef struct SurviveRecordVelocity {
+	SurviveRecordHeader hdr;
+	double velocity[6];
+} SurviveRecordVelocity;
+
+typedef struct SurviveRecordLightcap {
+	SurviveRecordHeader hdr;
+	uint32_t timestamp;
+	uint16_t length;
+	uint8_t sensor_id;
+	uint8_t reserved;
+} SurviveRecordLightcap;
+
+typedef struct SurviveRecordLight {
+	SurviveRecordHeader hdr;
+	int32_t sensor_id;
+	int32_t acode;
+	int32_t timeinsweep;
+	uint32_t timecode;
+	uint32_t length;
+	uint32_t lh;
+} SurviveRecordLight;
+
+typedef struct SurviveRecordAngle {
+	SurviveRecordHeader hdr;
+	double length;
+	double angle;
+	int32_t sensor_id;
+	int32_t acode;
+	uint32_t timecode;
+	uint32_t lh;
+} SurviveRecordAngle;
+
+typedef struct SurviveRecordSync {
+	SurviveRecordHeader hdr;
+	uint32_t timecode;
+	uint8_t channel;
+	uint8_t ootx;
+	uint8_t gen;
+	uint8_t reserved;
+} SurviveRecordSync;
+
+typedef struct SurviveRecordSweep {
+	SurviveRecordHeader hdr;
+	uint32_t timecode;
+	int32_t sensor_id;
+	uint8_t channel;
+	uint8_t flag;
+	uint8_t reserved[6];
+} SurviveRecordSweep;
+
+typedef struct SurviveRecordSweepAngle {
+	SurviveRecordHeader hdr;
+	double angle;
+	uint32_t timecode;
+	int32_t sensor_id;
+	uint8_t channel;
+	int8_t plane;
+	uint8_t reserved[6];
+} SurviveRecordSweepAngle;
+
+// Used for both IMU and RAW_IMU
+typedef struct SurviveRecordIMU {
+	SurviveRecordHeader hdr;
+	double accelgyro[9];
+	int32_t mask;
+	uint32_t timecode;
+	int32_t id;
+	int32_t reserved;
+} SurviveRecordIMU;
+
+/**
+ * Large enough to hold any fixed-size record; blobs hold whatever of their data fits past the blob header.
+ */
+typedef union SurviveRecord {
+	SurviveRecordHeader hdr;
+	SurviveRecordBlob blob;
+	SurviveRecordPose pose;
+	SurviveRecordVelocity velocity;
+	SurviveRecordLightcap lightcap;
+	SurviveRecordLight light;
+	SurviveRecordAngle angle;
+	SurviveRecordSync sync;
+	SurviveRecordSweep sweep;
+	SurviveRecordSweepAngle sweep_angle;
+	SurviveRecordIMU imu;
+	uint64_t storage[32];
+} SurviveRecord;
+
+static inline const char *survive_record_blob_data(const SurviveRecordBlob *blob) {
+	return (const char *)(blob + 1);
+}
+
+/**
+ * Fills out the header for a fixed-size record of the given type.
+ */
+SURVIVE_EXPORT void survive_record_init(SurviveRecord *record, SurviveRecordType type, double time, const char *dev);
+
+/**
+ * Fills out a CONFIG or INFO record; copies as much of 'data' as fits into 'capacity' bytes of record.
+ */
+SURVIVE_EXPORT void survive_record_init_blob(SurviveRecordBlob *record, size_t capacity, SurviveRecordType type,
+											 double time, const char *dev, const char *data, size_t length);
+
+/**
+ * Size in bytes of a CONFIG or INFO record holding 'length' bytes of data.
+ */
+SURVIVE_EXPORT size_t survive_record_blob_size(size_t length);
+
+/**
+ * Parses one line of the text format, without its leading timestamp, into 'record'. Returns 0 on success, -1 if
+ * the line was malformed and -2 if the op isn't one the text format knows about.
+ */
+SURVIVE_EXPORT int survive_record_from_text(SurviveRecord *record, size_t capacity, double time, const char *line);
+
+/**
+ * Writes 'record' as a line of the text format, including timestamp and newline. Follows snprintf semantics.
+ */
+SURVIVE_EXPORT int survive_record_to_text(const SurviveRecordHeader *record, char *buffer, size_t buffer_len);
+
+/**
+ * True iff 'path' should be written in the binary format; which is decided by a '.bin' suffix.
+ */
+SURVIVE_EXPORT bool survive_recording_is_binary_path(const char *path);
+
+/**
+ * True iff the file at 'path' starts with the binary recording magic.
+ */
+SURVIVE_EXPORT bool survive_recording_is_binary_file(const char *path);
+
+typedef struct SurviveRecordingBinaryWriter SurviveRecordingBinaryWriter;
+
+SURVIVE_EXPORT SurviveRecordingBinaryWriter *survive_recording_binary_writer_open(const char *path);
+SURVIVE_EXPORT void survive_recording_binary_writer_write(SurviveRecordingBinaryWriter *writer,
+														  const SurviveRecordHeader *record);
+SURVIVE_EXPORT void survive_recording_binary_writer_flush(SurviveRecordingBinaryWriter *writer);
+SURVIVE_EXPORT void survive_recording_binary_writer_close(SurviveRecordingBinaryWriter *writer);
+
+/**
+ * Binary recordings are mapped into memory and walked in place; peek hands back a pointer into the mapping so
+ * replaying a file does no per-record allocation or parsing.
+ */
+typedef struct SurviveRecordingBinaryReader {
+	const uint8_t *data;
+	size_t size;
+	size_t offset;
+	bool is_mapped;
+} SurviveRecordingBinaryReader;
+
+SURVIVE_EXPORT SurviveRecordingBinaryReader *survive_recording_binary_reader_open(const char *path);
+SURVIVE_EXPORT const SurviveRecordHeader *survive_recording_binary_reader_peek(const SurviveRecordingBinaryReader *reader);
+SURVIVE_EXPORT void survive_recording_binary_reader_next(SurviveRecordingBinaryReader *reader);
+SURVIVE_EXPORT void survive_recording_binary_reader_rewind(SurviveRecordingBinaryReader *reader);
+SURVIVE_EXPORT void survive_recording_binary_reader_close(SurviveRecordingBinaryReader *reader);
+
+/**
+ * Converts a recording between the text and binary formats. The input format is detected from the file contents;
+ * the output format is picked from the output path the same way '--record' does it. Returns the number of records
+ * converted, or a negative value on error.
+ */
+SURVIVE_EXPORT int survive_recording_convert(const char *input_path, const char *output_path);
+
+#ifdef __cplusplus
+};
+#endif
@@ -5,6 +5,8 @@
 #include <math.h>
 #include <survive_reproject.h>
 
+#include "survive_reproject_simd.h"
+
 #pragma GCC push_options
 #pragma GCC optimize("Ofast")
 
@@ -32,6 +34,24 @@ static inline FLT survive_reproject_axis(const BaseStationCal *bcal, FLT axis_va
 	return ang;
 }
 
+#ifdef SURVIVE_REPROJECT_LANES
+// survive_reproject_axis over a vector of points
+static inline sv_vec survive_reproject_axis_simd(const BaseStationCal *bcal, sv_vec axis_value, sv_vec other_axis_value,
+												 sv_vec Z, bool invert_axis_value) {
+	sv_vec axis_ang = sv_atan2(axis_value, Z);
+	sv_vec ang = invert_axis_value ? sv_add(sv_set1(M_PI_2), axis_ang) : sv_sub(sv_set1(M_PI_2), axis_ang);
+
+	sv_vec mag = sv_sqrt(sv_fma(axis_value, axis_value, sv_mul(Z, Z)));
+
+	ang = sv_sub(ang, sv_set1(bcal->phase));
+	sv_vec asin_arg = sv_clamp(sv_div(sv_mul(sv_set1(bcal->tilt), other_axis_value), mag), -1, 1);
+	ang = sv_sub(ang, sv_asin(asin_arg));
+	ang = sv_sub(ang, sv_mul(sv_cos(sv_add(sv_set1(bcal->gibpha), ang)), sv_set1(bcal->gibmag)));
+	sv_vec curve_ang = sv_atan2(other_axis_value, Z);
+	return sv_fma(sv_mul(sv_set1(bcal->curve), curve_ang), curve_ang, ang);
+}
+#endif
+
 static inline FLT survive_reproject_axis_x_inline(const BaseStationCal *bcal, LinmathVec3d const ptInLh) {
 	return survive_reproject_axis(&bcal[0], ptInLh[0], ptInLh[1], -ptInLh[2], false) - M_PI / 2.;
 }
@@ -88,6 +108,110 @@ void survive_apply_bsd_calibration(const SurviveContext *ctx, int lh, const FLT
 	out[1] = in[1] + cal[1].phase;
 }
 
+void survive_apply_pose_to_points(const SurvivePose *pose, size_t n, const FLT *x, const FLT *y, const FLT *z,
+								  FLT *out_x, FLT *out_y, FLT *out_z) {
+	// quatrotatevector is linear in the vector, so rotating the basis gives the matrix it applies -- even for
+	// quaternions that aren't quite normalized.
+	LinmathVec3d R[3];
+	for (int i = 0; i < 3; i++) {
+		LinmathVec3d e = {0};
+		e[i] = 1;
+		quatrotatevector(R[i], pose->Rot, e);
+	}
+	const FLT *t = pose->Pos;
+
+	size_t i = 0;
+#if defined(SURVIVE_REPROJECT_AVX2)
+	__m256d r[3][3], tv[3];
+	for (int j = 0; j < 3; j++) {
+		tv[j] = _mm256_set1_pd(t[j]);
+		for (int k = 0; k < 3; k++)
+			r[j][k] = _mm256_set1_pd(R[k][j]);
+	}
+	for (; i + 4 <= n; i += 4) {
+		__m256d px = _mm256_loadu_pd(x + i), py = _mm256_loadu_pd(y + i), pz = _mm256_loadu_pd(z + i);
+		__m256d o[3];
+		for (int j = 0; j < 3; j++) {
+#ifdef __FMA__
+			o[j] = _mm256_fmadd_pd(r[j][2], pz, _mm256_fmadd_pd(r[j][1], py, _mm256_fmadd_pd(r[j][0], px, tv[j])));
+#else
+			o[j] = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(r[j][0], px), _mm256_mul_pd(r[j][1], py)),
+								 _mm256_add_pd(_mm256_mul_pd(r[j][2], pz), tv[j]));
+#endif
+		}
+		_mm256_storeu_pd(out_x + i, o[0]);
+		_mm256_storeu_pd(out_y + i, o[1]);
+		_mm256_storeu_pd(out_z + i, o[2]);
+	}
+#elif defined(SURVIVE_REPROJECT_NEON)
+	float64x2_t r[3][3], tv[3];
+	for (int j = 0; j < 3; j++) {
+		tv[j] = vdupq_n_f64(t[j]);
+		for (int k = 0; k < 3; k++)
+			r[j][k] = vdupq_n_f64(R[k][j]);
+	}
+	for (; i + 2 <= n; i += 2) {
+		float64x2_t px = vld1q_f64(x + i), py = vld1q_f64(y + i), pz = vld1q_f64(z + i);
+		float64x2_t o[3];
+		for (int j = 0; j < 3; j++) {
+			o[j] = vfmaq_f64(vfmaq_f64(vfmaq_f64(tv[j], r[j][0], px), r[j][1], py), r[j][2], pz);
+		}
+		vst1q_f64(out_x + i, o[0]);
+		vst1q_f64(out_y + i, o[1]);
+		vst1q_f64(out_z + i, o[2]);
+	}
+#endif
+	for (; i < n; i++) {
+		FLT px = x[i], py = y[i], pz = z[i];
+		out_x[i] = R[0][0] * px + R[1][0] * py + R[2][0] * pz + t[0];
+		out_y[i] = R[0][1] * px + R[1][1] * py + R[2][1] * pz + t[1];
+		out_z[i] = R[0][2] * px + R[1][2] * py + R[2][2] * pz + t[2];
+	}
+}
+
+void survive_reproject_xy_batch(const BaseStationCal *bcal, const SurvivePose *obj2lh, size_t n, const FLT *x,
+								const FLT *y, const FLT *z, FLT *out_x, FLT *out_y) {
+	FLT lx[SURVIVE_REPROJECT_BATCH_CHUNK], ly[SURVIVE_REPROJECT_BATCH_CHUNK], lz[SURVIVE_REPROJECT_BATCH_CHUNK];
+	for (size_t start = 0; start < n; start += SURVIVE_REPROJECT_BATCH_CHUNK) {
+		size_t cnt = n - start < SURVIVE_REPROJECT_BATCH_CHUNK ? n - start : SURVIVE_REPROJECT_BATCH_CHUNK;
+		survive_apply_pose_to_points(obj2lh, cnt, x + start, y + start, z + start, lx, ly, lz);
+
+		size_t i = 0;
+#ifdef SURVIVE_REPROJECT_LANES
+		for (; i + SURVIVE_REPROJECT_LANES <= cnt; i += SURVIVE_REPROJECT_LANES) {
+			sv_vec px = sv_load(lx + i), py = sv_load(ly + i), nz = sv_xor(sv_load(lz + i), SV_SIGN_BIT);
+			sv_vec ax = survive_reproject_axis_simd(&bcal[0], px, py, nz, false);
+			sv_vec ay = survive_reproject_axis_simd(&bcal[1], py, px, nz, true);
+			sv_store(out_x + start + i, sv_sub(ax, sv_set1(M_PI / 2.)));
+			sv_store(out_y + start + i, sv_sub(ay, sv_set1(M_PI / 2.)));
+		}
+#endif
+		for (; i < cnt; i++) {
+			out_x[start + i] = survive_reproject_axis(&bcal[0], lx[i], ly[i], -lz[i], false) - M_PI / 2.;
+			out_y[start + i] = survive_reproject_axis(&bcal[1], ly[i], lx[i], -lz[i], true) - M_PI / 2.;
+		}
+	}
+}
+
+void survive_reproject_full_jac_obj_pose_batch(FLT *out, const SurvivePose *obj2world, const SurvivePose *world2lh,
+											   const BaseStationCal *bcal, size_t n, const FLT *x, const FLT *y,
+											   const FLT *z) {
+	for (size_t i = 0; i < n; i++) {
+		const FLT pt[3] = {x[i], y[i], z[i]};
+		gen_reproject_jac_obj_p(out + i * 2 * 7, obj2world, pt, world2lh, bcal);
+	}
+}
+
+void survive_reproject_axisangle_full_jac_obj_pose_batch(FLT *out, const LinmathAxisAnglePose *obj2world,
+														 const LinmathAxisAnglePose *world2lh,
+														 const BaseStationCal *bcal, size_t n, const FLT *x,
+														 const FLT *y, const FLT *z) {
+	for (size_t i = 0; i < n; i++) {
+		const FLT pt[3] = {x[i], y[i], z[i]};
+		gen_reproject_jac_obj_p_axis_angle(out + i * 2 * 6, obj2world, pt, world2lh, bcal);
+	}
+}
+
 #pragma GCC pop_options
 
 const survive_reproject_model_t SURVIVE_EXPORT survive_reproject_model = {
@@ -96,4 +220,8 @@ const survive_reproject_model_t SURVIVE_EXPORT survive_reproject_model = {
 	.reprojectXY = survive_reproject_xy,
 	.reprojectFullJacObjPose = gen_reproject_jac_obj_p,
 	.reprojectFullJacLhPose = gen_reproject_jac_lh_p,
-	.reprojectAxisJacobLhPoseFn = {gen_reproject_axis_x_jac_lh_p, gen_reproject_axis_y_jac_lh_p}};
+	.reprojectAxisJacobLhPoseFn = {gen_reproject_axis_x_jac_lh_p, gen_reproject_axis_y_jac_lh_p},
+	.reprojectAxisAngleWithJacs = survive_reproject_axisangle_with_jacs,
+	.reprojectXYBatch = survive_reproject_xy_batch,
+	.reprojectFullJacObjPoseBatch = survive_reproject_full_jac_obj_pose_batch,
+	.reprojectAxisAngleFullJacObjPoseBatch = survive_reproject_axisangle_full_jac_obj_pose_batch};
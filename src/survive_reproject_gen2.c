@@ -4,6 +4,8 @@
 #include <survive_reproject.h>
 #include <survive_reproject_gen2.h>
 
+#include "survive_reproject_simd.h"
+
 #pragma GCC push_options
 #pragma GCC optimize("Ofast")
 
@@ -102,6 +104,46 @@ static inline FLT survive_reproject_axis_gen2(const BaseStationCal *bcal, FLT X,
 	return rtn;
 }
 
+#ifdef SURVIVE_REPROJECT_LANES
+// survive_reproject_axis_gen2 over a vector of points
+static inline sv_vec survive_reproject_axis_gen2_simd(const BaseStationCal *bcal, sv_vec X, sv_vec Y, sv_vec Z,
+													  bool axis) {
+	const FLT Ydeg = bcal->tilt + (axis ? -1 : 1) * M_PI / 6.;
+	const FLT tanA = tan(Ydeg);
+	const FLT sinYdeg = sin(Ydeg);
+	const FLT cosYdeg = cos(Ydeg);
+
+	sv_vec B = sv_atan2(Z, X);
+
+	sv_vec normXZ2 = sv_fma(X, X, sv_mul(Z, Z));
+	sv_vec asinArg = sv_clamp(sv_div(sv_mul(sv_set1(tanA), Y), sv_sqrt(normXZ2)), -1, 1);
+
+	sv_vec sinPart =
+		sv_mul(sv_sin(sv_add(sv_sub(B, sv_asin(asinArg)), sv_set1(bcal->ogeephase))), sv_set1(bcal->ogeemag));
+
+	sv_vec normXYZ = sv_sqrt(sv_fma(Y, Y, normXZ2));
+	sv_vec asinOut = sv_asin(sv_clamp(sv_div(sv_div(Y, normXYZ), sv_set1(cosYdeg)), -1, 1));
+
+	// calc_cal_series
+	const double f[6] = {-8.0108022e-06, 0.0028679863, 5.3685255000000001e-06, 0.0076069798000000001};
+	sv_vec mod = sv_set1(f[0]), acc = sv_set1(0);
+	for (int i = 1; i < 6; i++) {
+		acc = sv_fma(acc, asinOut, mod);
+		mod = sv_fma(mod, asinOut, sv_set1(f[i]));
+	}
+
+	sv_vec BcalCurved = sv_add(sinPart, sv_set1(bcal->curve));
+	sv_vec denom = sv_sub(sv_set1(cosYdeg), sv_mul(sv_mul(acc, BcalCurved), sv_set1(sinYdeg)));
+	sv_vec asinArg2 = sv_clamp(sv_add(asinArg, sv_div(sv_mul(mod, BcalCurved), denom)), -1, 1);
+
+	sv_vec asinOut2 = sv_asin(asinArg2);
+	sv_vec sinOut2 = sv_sin(sv_add(sv_sub(B, asinOut2), sv_set1(bcal->gibpha)));
+
+	sv_vec rtn = sv_fma(sinOut2, sv_set1(bcal->gibmag), sv_sub(B, asinOut2));
+	return sv_sub(rtn, sv_set1(bcal->phase + M_PI / 2.));
+}
+#endif
+
 static inline FLT survive_reproject_axis_x_gen2_inline(const BaseStationCal *bcal, LinmathVec3d const ptInLh) {
 	return survive_reproject_axis_gen2(&bcal[0], ptInLh[0], ptInLh[1], -ptInLh[2], 0);
 }
@@ -153,6 +195,47 @@ void survive_reproject_gen2(const SurviveContext *ctx, int lighthouse, LinmathVe
 	survive_reproject_from_pose_gen2(ctx, lighthouse, &world2lh, ptInWorld, out);
 }
 
+void survive_reproject_xy_gen2_batch(const BaseStationCal *bcal, const SurvivePose *obj2lh, size_t n, const FLT *x,
+									 const FLT *y, const FLT *z, FLT *out_x, FLT *out_y) {
+	FLT lx[SURVIVE_REPROJECT_BATCH_CHUNK], ly[SURVIVE_REPROJECT_BATCH_CHUNK], lz[SURVIVE_REPROJECT_BATCH_CHUNK];
+	for (size_t start = 0; start < n; start += SURVIVE_REPROJECT_BATCH_CHUNK) {
+		size_t cnt = n - start < SURVIVE_REPROJECT_BATCH_CHUNK ? n - start : SURVIVE_REPROJECT_BATCH_CHUNK;
+		survive_apply_pose_to_points(obj2lh, cnt, x + start, y + start, z + start, lx, ly, lz);
+
+		size_t i = 0;
+#ifdef SURVIVE_REPROJECT_LANES
+		for (; i + SURVIVE_REPROJECT_LANES <= cnt; i += SURVIVE_REPROJECT_LANES) {
+			sv_vec px = sv_load(lx + i), py = sv_load(ly + i), nz = sv_xor(sv_load(lz + i), SV_SIGN_BIT);
+			sv_store(out_x + start + i, survive_reproject_axis_gen2_simd(&bcal[0], px, py, nz, 0));
+			sv_store(out_y + start + i, survive_reproject_axis_gen2_simd(&bcal[1], px, py, nz, 1));
+		}
+#endif
+		for (; i < cnt; i++) {
+			out_x[start + i] = survive_reproject_axis_gen2(&bcal[0], lx[i], ly[i], -lz[i], 0);
+			out_y[start + i] = survive_reproject_axis_gen2(&bcal[1], lx[i], ly[i], -lz[i], 1);
+		}
+	}
+}
+
+void survive_reproject_full_jac_obj_pose_gen2_batch(FLT *out, const SurvivePose *obj2world,
+													const SurvivePose *world2lh, const BaseStationCal *bcal, size_t n,
+													const FLT *x, const FLT *y, const FLT *z) {
+	for (size_t i = 0; i < n; i++) {
+		const FLT pt[3] = {x[i], y[i], z[i]};
+		gen_reproject_gen2_jac_obj_p(out + i * 2 * 7, obj2world, pt, world2lh, bcal);
+	}
+}
+
+void survive_reproject_axisangle_full_jac_obj_pose_gen2_batch(FLT *out, const LinmathAxisAnglePose *obj2world,
+															  const LinmathAxisAnglePose *world2lh,
+															  const BaseStationCal *bcal, size_t n, const FLT *x,
+															  const FLT *y, const FLT *z) {
+	for (size_t i = 0; i < n; i++) {
+		const FLT pt[3] = {x[i], y[i], z[i]};
+		gen_reproject_gen2_jac_obj_p_axis_angle(out + i * 2 * 6, obj2world, pt, world2lh, bcal);
+	}
+}
+
 const survive_reproject_model_t survive_reproject_gen2_model = {
 	.reprojectAxisFn = {survive_reproject_axis_x_gen2, survive_reproject_axis_y_gen2},
 	.reprojectXY = survive_reproject_xy_gen2,
@@ -162,11 +245,16 @@ const survive_reproject_model_t survive_reproject_gen2_model = {
 	.reprojectAxisJacobLhPoseFn = {gen_reproject_axis_x_jac_lh_p, gen_reproject_axis_y_jac_lh_p},
 
 	.reprojectAxisAngleFullJacObjPose = gen_reproject_gen2_jac_obj_p_axis_angle,
-	.reprojectAxisAngleAxisJacobFn = {gen_reproject_axis_x_jac_obj_p_axis_angle,
-									  gen_reproject_axis_y_jac_obj_p_axis_angle},
+	.reprojectAxisAngleAxisJacobFn = {gen_reproject_axis_x_gen2_jac_obj_p_axis_angle,
+									  gen_reproject_axis_y_gen2_jac_obj_p_axis_angle},
 
 	.reprojectAxisAngleFullJacLhPose = gen_reproject_gen2_jac_lh_p_axis_angle,
 	.reprojectAxisAngleAxisJacobLhPoseFn = {gen_reproject_axis_x_gen2_jac_lh_p_axis_angle,
 											gen_reproject_axis_y_gen2_jac_lh_p_axis_angle},
+	.reprojectAxisAngleWithJacs = survive_reproject_axisangle_with_jacs_gen2,
+
+	.reprojectXYBatch = survive_reproject_xy_gen2_batch,
+	.reprojectFullJacObjPoseBatch = survive_reproject_full_jac_obj_pose_gen2_batch,
+	.reprojectAxisAngleFullJacObjPoseBatch = survive_reproject_axisangle_full_jac_obj_pose_gen2_batch,
 
 };
@@ -0,0 +1,175 @@
+#pragma once
+
+/**
+ * Lane-wise double math for the batched reprojection. Builds targeting AVX2 get four lanes and aarch64 builds get
+ * two; everything else leaves SURVIVE_REPROJECT_LANES undefined and the batches run the scalar code.
+ *
+ * atan, sin and cos follow the Cephes double precision routines, so they agree with libm to within a couple of ulps
+ * over the range reprojection feeds them. Only include this from translation units that can take the intrinsics.
+ */
+#if defined(__AVX2__) && !defined(USE_FLOAT)
+#include <immintrin.h>
+#define SURVIVE_REPROJECT_AVX2 1
+#define SURVIVE_REPROJECT_LANES 4
+
+typedef __m256d sv_vec;
+#define sv_set1(v) _mm256_set1_pd(v)
+#define sv_load(p) _mm256_loadu_pd(p)
+#define sv_store(p, v) _mm256_storeu_pd(p, v)
+#define sv_add(a, b) _mm256_add_pd(a, b)
+#define sv_sub(a, b) _mm256_sub_pd(a, b)
+#define sv_mul(a, b) _mm256_mul_pd(a, b)
+#define sv_div(a, b) _mm256_div_pd(a, b)
+#define sv_sqrt(a) _mm256_sqrt_pd(a)
+#define sv_min(a, b) _mm256_min_pd(a, b)
+#define sv_max(a, b) _mm256_max_pd(a, b)
+#define sv_floor(a) _mm256_floor_pd(a)
+#define sv_abs(a) _mm256_andnot_pd(_mm256_set1_pd(-0.), a)
+#define sv_xor(a, b) _mm256_xor_pd(a, b)
+#define sv_and(a, b) _mm256_and_pd(a, b)
+#define sv_lt(a, b) _mm256_cmp_pd(a, b, _CMP_LT_OQ)
+#define sv_gt(a, b) _mm256_cmp_pd(a, b, _CMP_GT_OQ)
+#define sv_eq(a, b) _mm256_cmp_pd(a, b, _CMP_EQ_OQ)
+// Lanes of 'a' where 'mask' is set, 'b' elsewhere
+#define sv_select(mask, a, b) _mm256_blendv_pd(b, a, mask)
+#ifdef __FMA__
+#define sv_fma(a, b, c) _mm256_fmadd_pd(a, b, c)
+#else
+#define sv_fma(a, b, c) _mm256_add_pd(_mm256_mul_pd(a, b), c)
+#endif
+
+#elif defined(__ARM_NEON) && defined(__aarch64__) && !defined(USE_FLOAT)
+#include <arm_neon.h>
+#define SURVIVE_REPROJECT_NEON 1
+#define SURVIVE_REPROJECT_LANES 2
+
+typedef float64x2_t sv_vec;
+#define sv_set1(v) vdupq_n_f64(v)
+#define sv_load(p) vld1q_f64(p)
+#define sv_store(p, v) vst1q_f64(p, v)
+#define sv_add(a, b) vaddq_f64(a, b)
+#define sv_sub(a, b) vsubq_f64(a, b)
+#define sv_mul(a, b) vmulq_f64(a, b)
+#define sv_div(a, b) vdivq_f64(a, b)
+#define sv_sqrt(a) vsqrtq_f64(a)
+#define sv_min(a, b) vminq_f64(a, b)
+#define sv_max(a, b) vmaxq_f64(a, b)
+#define sv_floor(a) vrndmq_f64(a)
+#define sv_abs(a) vabsq_f64(a)
+#define sv_xor(a, b) vreinterpretq_f64_u64(veorq_u64(vreinterpretq_u64_f64(a), vreinterpretq_u64_f64(b)))
+#define sv_and(a, b) vreinterpretq_f64_u64(vandq_u64(vreinterpretq_u64_f64(a), vreinterpretq_u64_f64(b)))
+#define sv_lt(a, b) vreinterpretq_f64_u64(vcltq_f64(a, b))
+#define sv_gt(a, b) vreinterpretq_f64_u64(vcgtq_f64(a, b))
+#define sv_eq(a, b) vreinterpretq_f64_u64(vceqq_f64(a, b))
+#define sv_select(mask, a, b) vbslq_f64(vreinterpretq_u64_f64(mask), a, b)
+#define sv_fma(a, b, c) vfmaq_f64(c, a, b)
+#endif
+
+#ifdef SURVIVE_REPROJECT_LANES
+#define SV_SIGN_BIT sv_set1(-0.)
+
+static inline sv_vec sv_clamp(sv_vec v, double lo, double hi) { return sv_min(sv_max(v, sv_set1(lo)), sv_set1(hi)); }
+
+static inline sv_vec sv_atan(sv_vec x) {
+	static const double P[] = {-8.750608600031904122785E-1, -1.615753718733365076637E1, -7.500855792314704667340E1,
+							   -1.228866684490136173410E2, -6.485021904942025371773E1};
+	static const double Q[] = {2.485846490142306297962E1, 1.650270098316988542046E2, 4.328810604912902668951E2,
+							   4.853903996359136964868E2, 1.945506571482613964425E2};
+	const double T3P8 = 2.41421356237309504880, MOREBITS = 6.123233995736765886130E-17;
+
+	sv_vec sign = sv_and(x, SV_SIGN_BIT);
+	x = sv_abs(x);
+
+	// Reduce to |x| <= .66 around 0, pi/4 or pi/2
+	sv_vec big = sv_gt(x, sv_set1(T3P8));
+	sv_vec mid = sv_gt(x, sv_set1(.66));
+	sv_vec one = sv_set1(1);
+	sv_vec xr = sv_select(mid, sv_div(sv_sub(x, one), sv_add(x, one)), x);
+	xr = sv_select(big, sv_div(sv_set1(-1), x), xr);
+	sv_vec y = sv_select(mid, sv_set1(M_PI_4), sv_set1(0));
+	y = sv_select(big, sv_set1(M_PI_2), y);
+	sv_vec more = sv_select(mid, sv_set1(.5 * MOREBITS), sv_set1(0));
+	more = sv_select(big, sv_set1(MOREBITS), more);
+
+	sv_vec z = sv_mul(xr, xr);
+	sv_vec p = sv_set1(P[0]);
+	for (int i = 1; i < 5; i++)
+		p = sv_fma(p, z, sv_set1(P[i]));
+	sv_vec q = sv_add(z, sv_set1(Q[0]));
+	for (int i = 1; i < 5; i++)
+		q = sv_fma(q, z, sv_set1(Q[i]));
+
+	z = sv_fma(xr, sv_div(sv_mul(z, p), q), xr);
+	y = sv_add(y, sv_add(z, more));
+	return sv_xor(y, sign);
+}
+
+static inline sv_vec sv_atan2(sv_vec y, sv_vec x) {
+	sv_vec zero = sv_set1(0);
+	sv_vec a = sv_atan(sv_div(y, x));
+
+	// Left half plane is a half turn away, toward the sign of y
+	sv_vec half_turn = sv_xor(sv_set1(M_PI), sv_and(y, SV_SIGN_BIT));
+	a = sv_select(sv_lt(x, zero), sv_add(a, half_turn), a);
+	// 0/0; libm gives +-0 or +-pi depending on the sign of x, and reprojection only ever sees the +-0 case
+	return sv_select(sv_and(sv_eq(x, zero), sv_eq(y, zero)), sv_and(y, SV_SIGN_BIT), a);
+}
+
+// Only meant for |x| <= 1; callers clamp first the way the scalar code does
+static inline sv_vec sv_asin(sv_vec x) {
+	sv_vec one = sv_set1(1);
+	return sv_atan2(x, sv_sqrt(sv_mul(sv_sub(one, x), sv_add(one, x))));
+}
+
+// Shared reduction for sin and cos; returns the octant j in {0, 2, 4, 6} and x - j * pi/4 in 'r'
+static inline sv_vec sv_trig_reduce(sv_vec x, sv_vec *r) {
+	const double DP1 = 7.85398125648498535156E-1, DP2 = 3.77489470793079817668E-8, DP3 = 2.69515142907905952645E-15;
+	sv_vec j = sv_floor(sv_mul(x, sv_set1(4. / M_PI)));
+	sv_vec odd = sv_sub(j, sv_mul(sv_set1(2), sv_floor(sv_mul(j, sv_set1(.5)))));
+	j = sv_add(j, odd);
+	*r = sv_fma(j, sv_set1(-DP3), sv_fma(j, sv_set1(-DP2), sv_fma(j, sv_set1(-DP1), x)));
+	return sv_sub(j, sv_mul(sv_set1(8), sv_floor(sv_mul(j, sv_set1(.125)))));
+}
+
+static inline sv_vec sv_sin_poly(sv_vec z, sv_vec zz) {
+	static const double S[] = {1.58962301576546568060E-10, -2.50507477628578072866E-8, 2.75573136213857245213E-6,
+							   -1.98412698295895385996E-4, 8.33333333332211858878E-3,  -1.66666666666666307295E-1};
+	sv_vec p = sv_set1(S[0]);
+	for (int i = 1; i < 6; i++)
+		p = sv_fma(p, zz, sv_set1(S[i]));
+	return sv_fma(sv_mul(z, zz), p, z);
+}
+
+static inline sv_vec sv_cos_poly(sv_vec zz) {
+	static const double C[] = {-1.13585365213876817300E-11, 2.08757008419747316778E-9, -2.75573141792967388112E-7,
+							   2.48015872888517045348E-5,	-1.38888888888730564116E-3, 4.16666666666665929218E-2};
+	sv_vec p = sv_set1(C[0]);
+	for (int i = 1; i < 6; i++)
+		p = sv_fma(p, zz, sv_set1(C[i]));
+	return sv_fma(sv_mul(zz, zz), p, sv_fma(zz, sv_set1(-.5), sv_set1(1)));
+}
+
+static inline sv_vec sv_sin(sv_vec x) {
+	sv_vec sign = sv_and(x, SV_SIGN_BIT), r;
+	sv_vec j = sv_trig_reduce(sv_abs(x), &r);
+	sv_vec zz = sv_mul(r, r);
+
+	// Octants 2 and 6 take the cosine polynomial; 4 and 6 flip the sign
+	sv_vec use_cos = sv_eq(sv_sub(j, sv_mul(sv_set1(4), sv_floor(sv_mul(j, sv_set1(.25))))), sv_set1(2));
+	sv_vec y = sv_select(use_cos, sv_cos_poly(zz), sv_sin_poly(r, zz));
+	sign = sv_xor(sign, sv_and(sv_gt(j, sv_set1(3)), SV_SIGN_BIT));
+	return sv_xor(y, sign);
+}
+
+static inline sv_vec sv_cos(sv_vec x) {
+	sv_vec r;
+	sv_vec j = sv_trig_reduce(sv_abs(x), &r);
+	sv_vec zz = sv_mul(r, r);
+
+	// Octants 2 and 6 take the sine polynomial; 2 and 4 flip the sign
+	sv_vec use_sin = sv_eq(sv_sub(j, sv_mul(sv_set1(4), sv_floor(sv_mul(j, sv_set1(.25))))), sv_set1(2));
+	sv_vec y = sv_select(use_sin, sv_sin_poly(r, zz), sv_cos_poly(zz));
+	sv_vec flip = sv_and(sv_gt(j, sv_set1(1)), sv_lt(j, sv_set1(5)));
+	return sv_xor(y, sv_and(flip, SV_SIGN_BIT));
+}
+#endif
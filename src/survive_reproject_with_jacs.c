@@ -0,0 +1,1369 @@
+#include "survive_reproject.h"
+#include "survive_reproject_gen2.h"
+
+#include "generated/common.h"
+
+/**
+ * The angles and both axis angle pose jacobians of a reprojection, in one pass; see
+ * survive_reproject_axisangle_with_jacs_fn_t for the layout of 'out'.
+ *
+ * tools/generate_reprojection_functions doesn't emit these. They were assembled from the value and jacobian
+ * expressions it writes to survive_reproject.generated.h, with the subexpressions the outputs share computed once.
+ * Reproject.WithJacs checks them against reprojectXY and central differences, so rerun it after changing either model.
+ */
+
+void survive_reproject_axisangle_with_jacs_gen2(FLT *out, const LinmathAxisAnglePose *obj_p, const FLT *sensor_pt,
+												const LinmathAxisAnglePose *lh_p, const BaseStationCal *bsd) {
+	const GEN_FLT obj_px = (*obj_p).Pos[0];
+	const GEN_FLT obj_py = (*obj_p).Pos[1];
+	const GEN_FLT obj_pz = (*obj_p).Pos[2];
+	const GEN_FLT obj_qi = (*obj_p).AxisAngleRot[0];
+	const GEN_FLT obj_qj = (*obj_p).AxisAngleRot[1];
+	const GEN_FLT obj_qk = (*obj_p).AxisAngleRot[2];
+	const GEN_FLT sensor_x = sensor_pt[0];
+	const GEN_FLT sensor_y = sensor_pt[1];
+	const GEN_FLT sensor_z = sensor_pt[2];
+	const GEN_FLT lh_px = (*lh_p).Pos[0];
+	const GEN_FLT lh_py = (*lh_p).Pos[1];
+	const GEN_FLT lh_pz = (*lh_p).Pos[2];
+	const GEN_FLT lh_qi = (*lh_p).AxisAngleRot[0];
+	const GEN_FLT lh_qj = (*lh_p).AxisAngleRot[1];
+	const GEN_FLT lh_qk = (*lh_p).AxisAngleRot[2];
+	const GEN_FLT phase_0 = bsd[0].phase;
+	const GEN_FLT tilt_0 = bsd[0].tilt;
+	const GEN_FLT curve_0 = bsd[0].curve;
+	const GEN_FLT gibPhase_0 = bsd[0].gibpha;
+	const GEN_FLT gibMag_0 = bsd[0].gibmag;
+	const GEN_FLT ogeeMag_0 = bsd[0].ogeephase;
+	const GEN_FLT ogeePhase_0 = bsd[0].ogeemag;
+	const GEN_FLT phase_1 = bsd[1].phase;
+	const GEN_FLT tilt_1 = bsd[1].tilt;
+	const GEN_FLT curve_1 = bsd[1].curve;
+	const GEN_FLT gibPhase_1 = bsd[1].gibpha;
+	const GEN_FLT gibMag_1 = bsd[1].gibmag;
+	const GEN_FLT ogeeMag_1 = bsd[1].ogeephase;
+	const GEN_FLT ogeePhase_1 = bsd[1].ogeemag;
+	const GEN_FLT x0 = pow(obj_qi, 2);
+	const GEN_FLT x1 = pow(obj_qj, 2);
+	const GEN_FLT x2 = pow(obj_qk, 2);
+	const GEN_FLT x3 = x0 + x1 + x2;
+	const GEN_FLT x4 = sqrt(x3);
+	const GEN_FLT x5 = sin(x4);
+	const GEN_FLT x6 = 0 < x4;
+	const GEN_FLT x7 = ((x6) ? (obj_qi / x4) : (1));
+	const GEN_FLT x8 = x5 * x7;
+	const GEN_FLT x9 = cos(x4);
+	const GEN_FLT x10 = 1 - x9;
+	const GEN_FLT x11 = ((x6) ? (obj_qj / x4) : (0));
+	const GEN_FLT x12 = ((x6) ? (obj_qk / x4) : (0));
+	const GEN_FLT x13 = x10 * x11 * x12;
+	const GEN_FLT x14 = pow(x12, 2);
+	const GEN_FLT x15 = x7 * x10 * x12;
+	const GEN_FLT x16 = x5 * x11;
+	const GEN_FLT x17 = obj_pz + (x8 + x13) * sensor_y + (x9 + x10 * x14) * sensor_z + (x15 - x16) * sensor_x;
+	const GEN_FLT x18 = pow(lh_qi, 2);
+	const GEN_FLT x19 = pow(lh_qj, 2);
+	const GEN_FLT x20 = pow(lh_qk, 2);
+	const GEN_FLT x21 = x18 + x19 + x20;
+	const GEN_FLT x22 = sqrt(x21);
+	const GEN_FLT x23 = cos(x22);
+	const GEN_FLT x24 = 1 - x23;
+	const GEN_FLT x25 = 0 < x22;
+	const GEN_FLT x26 = ((x25) ? (lh_qk / x22) : (0));
+	const GEN_FLT x27 = pow(x26, 2);
+	const GEN_FLT x28 = x23 + x24 * x27;
+	const GEN_FLT x29 = pow(x11, 2);
+	const GEN_FLT x30 = x5 * x12;
+	const GEN_FLT x31 = x7 * x10 * x11;
+	const GEN_FLT x32 = obj_py + sensor_z * (x13 - x8) + sensor_y * (x9 + x10 * x29) + sensor_x * (x30 + x31);
+	const GEN_FLT x33 = ((x25) ? (lh_qi / x22) : (1));
+	const GEN_FLT x34 = sin(x22);
+	const GEN_FLT x35 = x33 * x34;
+	const GEN_FLT x36 = ((x25) ? (lh_qj / x22) : (0));
+	const GEN_FLT x37 = x26 * x36 * x24;
+	const GEN_FLT x38 = x35 + x37;
+	const GEN_FLT x39 = pow(x7, 2);
+	const GEN_FLT x40 = obj_px + sensor_x * (x9 + x10 * x39) + sensor_z * (x16 + x15) + sensor_y * (x31 - x30);
+	const GEN_FLT x41 = x33 * x26 * x24;
+	const GEN_FLT x42 = x34 * x36;
+	const GEN_FLT x43 = x41 - x42;
+	const GEN_FLT x44 = lh_pz + x17 * x28 + x32 * x38 + x40 * x43;
+	const GEN_FLT x45 = pow(x33, 2);
+	const GEN_FLT x46 = x23 + x24 * x45;
+	const GEN_FLT x47 = x33 * x36 * x24;
+	const GEN_FLT x48 = x34 * x26;
+	const GEN_FLT x49 = x47 - x48;
+	const GEN_FLT x50 = x42 + x41;
+	const GEN_FLT x51 = lh_px + x40 * x46 + x32 * x49 + x17 * x50;
+	const GEN_FLT x52 = atan2(-x44, x51);
+	const GEN_FLT x53 = x37 - x35;
+	const GEN_FLT x54 = pow(x36, 2);
+	const GEN_FLT x55 = x23 + x24 * x54;
+	const GEN_FLT x56 = x48 + x47;
+	const GEN_FLT x57 = lh_py + x17 * x53 + x32 * x55 + x40 * x56;
+	const GEN_FLT x58 = pow(x44, 2);
+	const GEN_FLT x59 = pow(x51, 2);
+	const GEN_FLT x60 = x58 + x59;
+	const GEN_FLT x61 = x57 / sqrt(x60);
+	const GEN_FLT x62 = 0.523598775598299 + tilt_0;
+	const GEN_FLT x63 = tan(x62);
+	const GEN_FLT x64 = x61 * x63;
+	const GEN_FLT x65 = pow(x57, 2);
+	const GEN_FLT x66 = x58 + x59 + x65;
+	const GEN_FLT x67 = x57 / sqrt(x66);
+	const GEN_FLT x68 = cos(x62);
+	const GEN_FLT x69 = asin(x67 / x68);
+	const GEN_FLT x70 = x69 * (-8.0108022e-06 - x69 * 8.0108022e-06);
+	const GEN_FLT x71 = x69 * (0.0028679863 + x70);
+	const GEN_FLT x72 = x69 * (5.3685255e-06 + x71);
+	const GEN_FLT x73 = 0.0076069798 + x72;
+	const GEN_FLT x74 = curve_0 + sin(x52 + ogeeMag_0 - asin(x64)) * ogeePhase_0;
+	const GEN_FLT x75 = sin(x62);
+	const GEN_FLT x76 =
+		-asin(x64 + x73 * x74 * pow(x69, 2) / (x68 - x74 * x75 * (x69 * (0.0076069798 + x72 + x69 * (5.3685255e-06 + x71
+		+ x69 * (0.0028679863 + x70 + x69 * (-8.0108022e-06 - x69 * 1.60216044e-05)))) + x69 * x73)));
+	const GEN_FLT x77 = 0.523598775598299 - tilt_1;
+	const GEN_FLT x78 = tan(x77);
+	const GEN_FLT x79 = (-x61) * x78;
+	const GEN_FLT x80 = curve_1 + sin(x52 + ogeeMag_1 - asin(x79)) * ogeePhase_1;
+	const GEN_FLT x81 = cos(x77);
+	const GEN_FLT x82 = asin(x67 / x81);
+	const GEN_FLT x83 = x82 * (-8.0108022e-06 - 8.0108022e-06 * x82);
+	const GEN_FLT x84 = x82 * (0.0028679863 + x83);
+	const GEN_FLT x85 = x82 * (5.3685255e-06 + x84);
+	const GEN_FLT x86 = 0.0076069798 + x85;
+	const GEN_FLT x87 = sin(x77);
+	const GEN_FLT x88 =
+		-asin(x79 + x80 * x86 * pow(x82, 2) / (x81 + x80 * x87 * (x82 * (0.0076069798 + x85 + x82 * (5.3685255e-06 + x84
+		+ x82 * (0.0028679863 + x83 + x82 * (-8.0108022e-06 - 1.60216044e-05 * x82)))) + x82 * x86)));
+	const GEN_FLT x89 = pow(x60, -1);
+	const GEN_FLT x90 = pow(x51, -1);
+	const GEN_FLT x91 = ((x6) ? (0) : (0));
+	const GEN_FLT x92 = 2 * x10 * x12 * sensor_z * x91;
+	const GEN_FLT x93 = x7 * x10 * x91;
+	const GEN_FLT x94 = x5 * x91;
+	const GEN_FLT x95 = -x94;
+	const GEN_FLT x96 = x10 * x12 * x91;
+	const GEN_FLT x97 = sensor_x * (x93 + x96 + x95);
+	const GEN_FLT x98 = x10 * x11 * x91;
+	const GEN_FLT x99 = sensor_y * (x94 + x98 + x96);
+	const GEN_FLT x100 = x92 + x97 + x99;
+	const GEN_FLT x101 = x28 * x100;
+	const GEN_FLT x102 = ((x25) ? (0) : (0));
+	const GEN_FLT x103 = 2 * x26 * x24 * x17 * x102;
+	const GEN_FLT x104 = x34 * x102;
+	const GEN_FLT x105 = -x104;
+	const GEN_FLT x106 = x26 * x24 * x102;
+	const GEN_FLT x107 = x33 * x24 * x102;
+	const GEN_FLT x108 = x40 * (x106 + x107 + x105);
+	const GEN_FLT x109 = x36 * x24 * x102;
+	const GEN_FLT x110 = x32 * (x104 + x106 + x109);
+	const GEN_FLT x111 = 2 * x10 * x11 * sensor_y * x91;
+	const GEN_FLT x112 = sensor_x * (x93 + x94 + x98);
+	const GEN_FLT x113 = sensor_z * (x98 + x96 + x95);
+	const GEN_FLT x114 = x111 + x112 + x113;
+	const GEN_FLT x115 = x38 * x114;
+	const GEN_FLT x116 = 2 * x7 * x10 * sensor_x * x91;
+	const GEN_FLT x117 = sensor_y * (x93 + x98 + x95);
+	const GEN_FLT x118 = sensor_z * (x93 + x94 + x96);
+	const GEN_FLT x119 = 1 + x116 + x117 + x118;
+	const GEN_FLT x120 = x101 + x103 + x108 + x110 + x115 + x43 * x119;
+	const GEN_FLT x121 = x49 * x114;
+	const GEN_FLT x122 = 2 * x33 * x24 * x40 * x102;
+	const GEN_FLT x123 = x17 * (x104 + x106 + x107);
+	const GEN_FLT x124 = x32 * (x107 + x109 + x105);
+	const GEN_FLT x125 = x50 * x100;
+	const GEN_FLT x126 = x121 + x122 + x123 + x124 + x125 + x46 * x119;
+	const GEN_FLT x127 = x44 / x59;
+	const GEN_FLT x128 = x59 * x89 * (x90 * (-x120) + x126 * x127);
+	const GEN_FLT x129 = (-1.0) / 2.0;
+	const GEN_FLT x130 = pow(x60, x129);
+	const GEN_FLT x131 = x57 * x63 * x130;
+	const GEN_FLT x132 = pow(x66, x129);
+	const GEN_FLT x133 = pow(x68, -1);
+	const GEN_FLT x134 = asin(x57 * x132 * x133);
+	const GEN_FLT x135 = -8.0108022e-06 - 8.0108022e-06 * x134;
+	const GEN_FLT x136 = x134 * x135;
+	const GEN_FLT x137 = 0.0028679863 + x136;
+	const GEN_FLT x138 = x134 * x137;
+	const GEN_FLT x139 = 5.3685255e-06 + x138;
+	const GEN_FLT x140 = x134 * x139;
+	const GEN_FLT x141 = 0.0076069798 + x140;
+	const GEN_FLT x142 = x52 + ogeeMag_0 - asin(x131);
+	const GEN_FLT x143 = curve_0 + ogeePhase_0 * sin(x142);
+	const GEN_FLT x144 = -8.0108022e-06 - 1.60216044e-05 * x134;
+	const GEN_FLT x145 = 0.0028679863 + x136 + x134 * x144;
+	const GEN_FLT x146 = 5.3685255e-06 + x138 + x134 * x145;
+	const GEN_FLT x147 = 0.0076069798 + x140 + x134 * x146;
+	const GEN_FLT x148 = x134 * x141 + x134 * x147;
+	const GEN_FLT x149 = x68 - x75 * x148 * x143;
+	const GEN_FLT x150 = pow(x149, -1);
+	const GEN_FLT x151 = pow(x134, 2);
+	const GEN_FLT x152 = x131 + x141 * x143 * x150 * x151;
+	const GEN_FLT x153 = pow(1 - pow(x152, 2), x129);
+	const GEN_FLT x154 = 2 * x44 * x120;
+	const GEN_FLT x155 = 2 * x51 * x126;
+	const GEN_FLT x156 = x154 + x155;
+	const GEN_FLT x157 = x57 * 1.0 / 2.0;
+	const GEN_FLT x158 = 3.0 / 2.0;
+	const GEN_FLT x159 = x157 / pow(x60, x158);
+	const GEN_FLT x160 = -x63;
+	const GEN_FLT x161 = x156 * x159 * x160;
+	const GEN_FLT x162 = x55 * x114;
+	const GEN_FLT x163 = 2 * x36 * x24 * x32 * x102;
+	const GEN_FLT x164 = x17 * (x106 + x109 + x105);
+	const GEN_FLT x165 = x40 * (x104 + x107 + x109);
+	const GEN_FLT x166 = x53 * x100;
+	const GEN_FLT x167 = x162 + x163 + x164 + x165 + x166 + x56 * x119;
+	const GEN_FLT x168 = x63 * x130 * x167;
+	const GEN_FLT x169 = x157 / pow(x66, x158);
+	const GEN_FLT x170 = x154 + x155 + 2 * x57 * x167;
+	const GEN_FLT x171 = x133 * x169 * (-x170) + x132 * x133 * x167;
+	const GEN_FLT x172 = x65 / x66;
+	const GEN_FLT x173 = pow(1 - x172 / pow(x68, 2), x129);
+	const GEN_FLT x174 = x139 * x171 * x173;
+	const GEN_FLT x175 = x137 * x171 * x173;
+	const GEN_FLT x176 = x135 * x171 * x173;
+	const GEN_FLT x177 = x134 * (x176 - 8.0108022e-06 * x134 * x171 * x173);
+	const GEN_FLT x178 = x134 * (x175 + x177);
+	const GEN_FLT x179 = x174 + x178;
+	const GEN_FLT x180 = cos(x142);
+	const GEN_FLT x181 = pow(1 - x65 * x89 * pow(x63, 2), x129);
+	const GEN_FLT x182 = x128 - (x161 + x168) * x181;
+	const GEN_FLT x183 = x141 * x143 * x151 / pow(x149, 2);
+	const GEN_FLT x184 = -(x75 * x143);
+	const GEN_FLT x185 =
+		x153 * (x161 + x168 + x143 * x150 * x151 * x179 + 2 * x134 * x141 * x143 * x150 * x171 * x173 + ogeePhase_0 *
+		x141 * x150 * x151 * x180 * x182 - x183 * (x184 * (x141 * x171 * x173 + x147 * x171 * x173 + x134 * x179 + x134
+		* (x174 + x178 + x146 * x171 * x173 + x134 * (x175 + x177 + x145 * x171 * x173 + x134 * (x176 + x144 * x171 *
+		x173 - x134 * x171 * x173 * 2.40324066e-05)))) - ogeePhase_0 * x75 * x148 * x180 * x182));
+	const GEN_FLT x186 = cos(x52 + gibPhase_0 - asin(x152));
+	const GEN_FLT x187 = x116 + x117 + x118;
+	const GEN_FLT x188 = x43 * x187;
+	const GEN_FLT x189 = 1 + x111 + x112 + x113;
+	const GEN_FLT x190 = x101 + x103 + x108 + x110 + x188 + x38 * x189;
+	const GEN_FLT x191 = -x90;
+	const GEN_FLT x192 = x46 * x187;
+	const GEN_FLT x193 = x122 + x123 + x124 + x125 + x192 + x49 * x189;
+	const GEN_FLT x194 = x59 * x89 * (x190 * x191 + x127 * x193);
+	const GEN_FLT x195 = 2 * x44 * x190;
+	const GEN_FLT x196 = 2 * x51 * x193;
+	const GEN_FLT x197 = x195 + x196;
+	const GEN_FLT x198 = x159 * x160 * x197;
+	const GEN_FLT x199 = x56 * x187;
+	const GEN_FLT x200 = x163 + x164 + x165 + x166 + x199 + x55 * x189;
+	const GEN_FLT x201 = x63 * x130 * x200;
+	const GEN_FLT x202 = x195 + x196 + 2 * x57 * x200;
+	const GEN_FLT x203 = x133 * x169 * (-x202) + x132 * x133 * x200;
+	const GEN_FLT x204 = x139 * x173 * x203;
+	const GEN_FLT x205 = x137 * x173 * x203;
+	const GEN_FLT x206 = x135 * x173 * x203;
+	const GEN_FLT x207 = x134 * (x206 - 8.0108022e-06 * x134 * x173 * x203);
+	const GEN_FLT x208 = x134 * (x205 + x207);
+	const GEN_FLT x209 = x204 + x208;
+	const GEN_FLT x210 = x194 - x181 * (x198 + x201);
+	const GEN_FLT x211 =
+		x153 * (x198 + x201 + x143 * x150 * x151 * x209 + 2 * x134 * x141 * x143 * x150 * x173 * x203 + ogeePhase_0 *
+		x141 * x150 * x151 * x180 * x210 - x183 * (x184 * (x141 * x173 * x203 + x147 * x173 * x203 + x134 * x209 + x134
+		* (x204 + x208 + x146 * x173 * x203 + x134 * (x205 + x207 + x145 * x173 * x203 + x134 * (x206 + x144 * x173 *
+		x203 - x134 * x173 * 2.40324066e-05 * x203)))) - ogeePhase_0 * x75 * x148 * x180 * x210));
+	const GEN_FLT x212 = 1 + x92 + x97 + x99;
+	const GEN_FLT x213 = x103 + x108 + x110 + x115 + x188 + x28 * x212;
+	const GEN_FLT x214 = x121 + x122 + x123 + x124 + x192 + x50 * x212;
+	const GEN_FLT x215 = x59 * x89 * (x191 * x213 + x127 * x214);
+	const GEN_FLT x216 = 2 * x44 * x213;
+	const GEN_FLT x217 = 2 * x51 * x214;
+	const GEN_FLT x218 = x216 + x217;
+	const GEN_FLT x219 = x159 * x160 * x218;
+	const GEN_FLT x220 = x162 + x163 + x164 + x165 + x199 + x53 * x212;
+	const GEN_FLT x221 = x63 * x130 * x220;
+	const GEN_FLT x222 = x216 + x217 + 2 * x57 * x220;
+	const GEN_FLT x223 = x133 * x169 * (-x222) + x132 * x133 * x220;
+	const GEN_FLT x224 = x139 * x173 * x223;
+	const GEN_FLT x225 = x137 * x173 * x223;
+	const GEN_FLT x226 = x135 * x173 * x223;
+	const GEN_FLT x227 = x134 * (x226 - 8.0108022e-06 * x134 * x173 * x223);
+	const GEN_FLT x228 = x134 * (x225 + x227);
+	const GEN_FLT x229 = x224 + x228;
+	const GEN_FLT x230 = x215 - x181 * (x219 + x221);
+	const GEN_FLT x231 =
+		x153 * (x219 + x221 + x143 * x150 * x151 * x229 + ogeePhase_0 * x141 * x150 * x151 * x180 * x230 + 2 * x134 *
+		x141 * x143 * x150 * x173 * x223 - x183 * (x184 * (x141 * x173 * x223 + x147 * x173 * x223 + x134 * x229 + x134
+		* (x224 + x228 + x146 * x173 * x223 + x134 * (x225 + x227 + x145 * x173 * x223 + x134 * (x226 + x144 * x173 *
+		x223 - x134 * x173 * 2.40324066e-05 * x223)))) - ogeePhase_0 * x75 * x148 * x180 * x230));
+	const GEN_FLT x232 = pow(x4, -1);
+	const GEN_FLT x233 = -(obj_qi * x5 * x232);
+	const GEN_FLT x234 = pow(x3, x158);
+	const GEN_FLT x235 = pow(x3, x129);
+	const GEN_FLT x236 = ((x6) ? ((-x0) / x234 + x235) : (0));
+	const GEN_FLT x237 = ((x6) ? (obj_qi * (-obj_qk) / x234) : (0));
+	const GEN_FLT x238 = x5 * x237;
+	const GEN_FLT x239 = -x238;
+	const GEN_FLT x240 = ((x6) ? (obj_qi * (-obj_qj) / x234) : (0));
+	const GEN_FLT x241 = x7 * x10 * x240;
+	const GEN_FLT x242 = obj_qi * x5 * x7 * x11 * x232;
+	const GEN_FLT x243 = x10 * x11 * x236;
+	const GEN_FLT x244 = obj_qi * x9 * x12 * x232;
+	const GEN_FLT x245 = x5 * x240;
+	const GEN_FLT x246 = obj_qi * x9 * x11 * x232;
+	const GEN_FLT x247 = x7 * x10 * x237;
+	const GEN_FLT x248 = obj_qi * x5 * x7 * x12 * x232;
+	const GEN_FLT x249 = x10 * x12 * x236;
+	const GEN_FLT x250 =
+		sensor_x * (2 * x7 * x10 * x236 + obj_qi * x5 * x39 * x232 + x233) + sensor_y * (x241 + x242 + x243 + x239 -
+		x244) + sensor_z * (x245 + x246 + x247 + x248 + x249);
+	const GEN_FLT x251 = -x245;
+	const GEN_FLT x252 = obj_qi * x7 * x9 * x232;
+	const GEN_FLT x253 = x5 * x236;
+	const GEN_FLT x254 = x10 * x12 * x240;
+	const GEN_FLT x255 = x10 * x11 * x237;
+	const GEN_FLT x256 = obj_qi * x5 * x11 * x12 * x232;
+	const GEN_FLT x257 =
+		sensor_z * (2 * x10 * x12 * x237 + obj_qi * x5 * x14 * x232 + x233) + sensor_x * (x247 + x248 + x249 + x251 -
+		x246) + sensor_y * (x252 + x253 + x254 + x255 + x256);
+	const GEN_FLT x258 =
+		sensor_x * (x238 + x244 + x241 + x242 + x243) + sensor_y * (2 * x10 * x11 * x240 + obj_qi * x5 * x29 * x232 +
+		x233) + sensor_z * (x254 + x255 + x256 - x252 - x253);
+	const GEN_FLT x259 = x103 + x108 + x110 + x43 * x250 + x28 * x257 + x38 * x258;
+	const GEN_FLT x260 = x122 + x123 + x124 + x50 * x257 + x49 * x258 + x46 * x250;
+	const GEN_FLT x261 = x59 * x89 * (x191 * x259 + x127 * x260);
+	const GEN_FLT x262 = x163 + x164 + x165 + x53 * x257 + x55 * x258 + x56 * x250;
+	const GEN_FLT x263 = x63 * x130 * x262;
+	const GEN_FLT x264 = 2 * x44 * x259;
+	const GEN_FLT x265 = 2 * x51 * x260;
+	const GEN_FLT x266 = x264 + x265;
+	const GEN_FLT x267 = -(x63 * x159 * x266);
+	const GEN_FLT x268 = x264 + x265 + 2 * x57 * x262;
+	const GEN_FLT x269 = x133 * x169 * (-x268) + x132 * x133 * x262;
+	const GEN_FLT x270 = x139 * x173 * x269;
+	const GEN_FLT x271 = x137 * x173 * x269;
+	const GEN_FLT x272 = x135 * x173 * x269;
+	const GEN_FLT x273 = x134 * (x272 - 8.0108022e-06 * x134 * x173 * x269);
+	const GEN_FLT x274 = x134 * (x271 + x273);
+	const GEN_FLT x275 = x270 + x274;
+	const GEN_FLT x276 = x261 - x181 * (x263 + x267);
+	const GEN_FLT x277 =
+		x153 * (x263 + 2 * x134 * x141 * x143 * x150 * x173 * x269 + x143 * x150 * x151 * x275 + ogeePhase_0 * x141 *
+		x150 * x151 * x180 * x276 + x267 - x183 * (x184 * (x147 * x173 * x269 + x141 * x173 * x269 + x134 * x275 + x134
+		* (x270 + x274 + x146 * x173 * x269 + x134 * (x271 + x273 + x145 * x173 * x269 + x134 * (x272 + x144 * x173 *
+		x269 - x134 * x173 * 2.40324066e-05 * x269)))) - ogeePhase_0 * x75 * x148 * x180 * x276));
+	const GEN_FLT x278 = -(obj_qj * x5 * x232);
+	const GEN_FLT x279 = x10 * x11 * x240;
+	const GEN_FLT x280 = obj_qj * x5 * x7 * x11 * x232;
+	const GEN_FLT x281 = ((x6) ? (x235 + (-x1) / x234) : (0));
+	const GEN_FLT x282 = x7 * x10 * x281;
+	const GEN_FLT x283 = ((x6) ? (obj_qj * (-obj_qk) / x234) : (0));
+	const GEN_FLT x284 = x5 * x283;
+	const GEN_FLT x285 = -x284;
+	const GEN_FLT x286 = obj_qj * x9 * x12 * x232;
+	const GEN_FLT x287 = obj_qj * x9 * x11 * x232;
+	const GEN_FLT x288 = x5 * x281;
+	const GEN_FLT x289 = x7 * x10 * x283;
+	const GEN_FLT x290 = obj_qj * x5 * x7 * x12 * x232;
+	const GEN_FLT x291 =
+		sensor_x * (2 * x7 * x10 * x240 + obj_qj * x5 * x39 * x232 + x278) + sensor_y * (x279 + x280 + x282 + x285 -
+		x286) + sensor_z * (x254 + x287 + x288 + x289 + x290);
+	const GEN_FLT x292 = obj_qj * x7 * x9 * x232;
+	const GEN_FLT x293 = x10 * x11 * x283;
+	const GEN_FLT x294 = obj_qj * x5 * x11 * x12 * x232;
+	const GEN_FLT x295 = x10 * x12 * x281;
+	const GEN_FLT x296 =
+		sensor_y * (x245 + x292 + x293 + x294 + x295) + sensor_x * (x254 + x289 + x290 - x287 - x288) + sensor_z * (2 *
+		x10 * x12 * x283 + obj_qj * x5 * x14 * x232 + x278);
+	const GEN_FLT x297 =
+		sensor_x * (x279 + x286 + x284 + x280 + x282) + sensor_y * (2 * x10 * x11 * x281 + obj_qj * x5 * x29 * x232 +
+		x278) + sensor_z * (x293 + x294 + x295 + x251 - x292);
+	const GEN_FLT x298 = x103 + x108 + x110 + x43 * x291 + x28 * x296 + x38 * x297;
+	const GEN_FLT x299 = x122 + x123 + x124 + x50 * x296 + x49 * x297 + x46 * x291;
+	const GEN_FLT x300 = x59 * x89 * (x191 * x298 + x127 * x299);
+	const GEN_FLT x301 = x163 + x164 + x165 + x53 * x296 + x55 * x297 + x56 * x291;
+	const GEN_FLT x302 = x63 * x130 * x301;
+	const GEN_FLT x303 = 2 * x44 * x298;
+	const GEN_FLT x304 = 2 * x51 * x299;
+	const GEN_FLT x305 = x303 + x304;
+	const GEN_FLT x306 = -(x63 * x159 * x305);
+	const GEN_FLT x307 = x303 + x304 + 2 * x57 * x301;
+	const GEN_FLT x308 = x133 * x169 * (-x307) + x132 * x133 * x301;
+	const GEN_FLT x309 = x139 * x173 * x308;
+	const GEN_FLT x310 = x137 * x173 * x308;
+	const GEN_FLT x311 = x135 * x173 * x308;
+	const GEN_FLT x312 = x134 * (x311 - 8.0108022e-06 * x134 * x173 * x308);
+	const GEN_FLT x313 = x134 * (x310 + x312);
+	const GEN_FLT x314 = x309 + x313;
+	const GEN_FLT x315 = x300 - x181 * (x302 + x306);
+	const GEN_FLT x316 =
+		x153 * (x302 + 2 * x134 * x141 * x143 * x150 * x173 * x308 + x143 * x150 * x151 * x314 + ogeePhase_0 * x141 *
+		x150 * x151 * x180 * x315 + x306 - x183 * (x184 * (x147 * x173 * x308 + x141 * x173 * x308 + x134 * x314 + x134
+		* (x309 + x313 + x146 * x173 * x308 + x134 * (x310 + x312 + x145 * x173 * x308 + x134 * (x311 + x144 * x173 *
+		x308 - x134 * x173 * 2.40324066e-05 * x308)))) - ogeePhase_0 * x75 * x148 * x180 * x315));
+	const GEN_FLT x317 = -(obj_qk * x5 * x232);
+	const GEN_FLT x318 = obj_qk * x5 * x7 * x11 * x232;
+	const GEN_FLT x319 = obj_qk * x9 * x12 * x232;
+	const GEN_FLT x320 = ((x6) ? (x235 + (-x2) / x234) : (0));
+	const GEN_FLT x321 = x5 * x320;
+	const GEN_FLT x322 = x10 * x12 * x237;
+	const GEN_FLT x323 = obj_qk * x9 * x11 * x232;
+	const GEN_FLT x324 = obj_qk * x5 * x7 * x12 * x232;
+	const GEN_FLT x325 = x7 * x10 * x320;
+	const GEN_FLT x326 =
+		sensor_x * (2 * x7 * x10 * x237 + obj_qk * x5 * x39 * x232 + x317) + sensor_y * (x255 + x289 + x318 - x319 -
+		x321) + sensor_z * (x322 + x284 + x323 + x324 + x325);
+	const GEN_FLT x327 = x10 * x12 * x283;
+	const GEN_FLT x328 = obj_qk * x7 * x9 * x232;
+	const GEN_FLT x329 = x10 * x11 * x320;
+	const GEN_FLT x330 = obj_qk * x5 * x11 * x12 * x232;
+	const GEN_FLT x331 =
+		sensor_y * (x238 + x327 + x328 + x329 + x330) + sensor_z * (obj_qk * x5 * x14 * x232 + 2 * x10 * x12 * x320 +
+		x317) + sensor_x * (x322 + x324 + x325 + x285 - x323);
+	const GEN_FLT x332 =
+		sensor_z * (x327 + x329 + x330 + x239 - x328) + sensor_x * (x255 + x289 + x319 + x321 + x318) + sensor_y * (2 *
+		x10 * x11 * x283 + obj_qk * x5 * x29 * x232 + x317);
+	const GEN_FLT x333 = x103 + x108 + x110 + x43 * x326 + x28 * x331 + x38 * x332;
+	const GEN_FLT x334 = x122 + x123 + x124 + x50 * x331 + x49 * x332 + x46 * x326;
+	const GEN_FLT x335 = x59 * x89 * (x191 * x333 + x127 * x334);
+	const GEN_FLT x336 = x163 + x164 + x165 + x53 * x331 + x55 * x332 + x56 * x326;
+	const GEN_FLT x337 = x63 * x130 * x336;
+	const GEN_FLT x338 = 2 * x44 * x333;
+	const GEN_FLT x339 = 2 * x51 * x334;
+	const GEN_FLT x340 = x338 + x339;
+	const GEN_FLT x341 = -(x63 * x159 * x340);
+	const GEN_FLT x342 = x338 + x339 + 2 * x57 * x336;
+	const GEN_FLT x343 = x133 * x169 * (-x342) + x132 * x133 * x336;
+	const GEN_FLT x344 = x139 * x173 * x343;
+	const GEN_FLT x345 = x137 * x173 * x343;
+	const GEN_FLT x346 = x135 * x173 * x343;
+	const GEN_FLT x347 = x134 * (x346 - 8.0108022e-06 * x134 * x173 * x343);
+	const GEN_FLT x348 = x134 * (x345 + x347);
+	const GEN_FLT x349 = x344 + x348;
+	const GEN_FLT x350 = x335 - x181 * (x337 + x341);
+	const GEN_FLT x351 =
+		x153 * (x337 + 2 * x134 * x141 * x143 * x150 * x173 * x343 + x143 * x150 * x151 * x349 + ogeePhase_0 * x141 *
+		x150 * x151 * x180 * x350 + x341 - x183 * (x184 * (x147 * x173 * x343 + x141 * x173 * x343 + x134 * x349 + x134
+		* (x344 + x348 + x146 * x173 * x343 + x134 * (x345 + x347 + x145 * x173 * x343 + x134 * (x346 + x144 * x173 *
+		x343 - x134 * x173 * 2.40324066e-05 * x343)))) - ogeePhase_0 * x75 * x148 * x180 * x350));
+	const GEN_FLT x352 = x78 * x130 * (-x57);
+	const GEN_FLT x353 = x52 + ogeeMag_1 - asin(x352);
+	const GEN_FLT x354 = curve_1 + ogeePhase_1 * sin(x353);
+	const GEN_FLT x355 = pow(x81, -1);
+	const GEN_FLT x356 = asin(x57 * x132 * x355);
+	const GEN_FLT x357 = -8.0108022e-06 - 8.0108022e-06 * x356;
+	const GEN_FLT x358 = x356 * x357;
+	const GEN_FLT x359 = 0.0028679863 + x358;
+	const GEN_FLT x360 = x356 * x359;
+	const GEN_FLT x361 = 5.3685255e-06 + x360;
+	const GEN_FLT x362 = x356 * x361;
+	const GEN_FLT x363 = 0.0076069798 + x362;
+	const GEN_FLT x364 = -8.0108022e-06 - 1.60216044e-05 * x356;
+	const GEN_FLT x365 = 0.0028679863 + x358 + x356 * x364;
+	const GEN_FLT x366 = 5.3685255e-06 + x360 + x356 * x365;
+	const GEN_FLT x367 = 0.0076069798 + x362 + x356 * x366;
+	const GEN_FLT x368 = x356 * x363 + x356 * x367;
+	const GEN_FLT x369 = x81 + x87 * x354 * x368;
+	const GEN_FLT x370 = pow(x369, -1);
+	const GEN_FLT x371 = pow(x356, 2);
+	const GEN_FLT x372 = x352 + x354 * x363 * x370 * x371;
+	const GEN_FLT x373 = pow(1 - pow(x372, 2), x129);
+	const GEN_FLT x374 = x78 * x156 * x159;
+	const GEN_FLT x375 = -(x78 * x130 * x167);
+	const GEN_FLT x376 = pow(1 - x172 / pow(x81, 2), x129);
+	const GEN_FLT x377 = -(x169 * x355);
+	const GEN_FLT x378 = x170 * x377 + x132 * x167 * x355;
+	const GEN_FLT x379 = pow(1 - x65 * x89 * pow(x78, 2), x129);
+	const GEN_FLT x380 = x128 - (x374 + x375) * x379;
+	const GEN_FLT x381 = cos(x353);
+	const GEN_FLT x382 = x376 * x378 * x361;
+	const GEN_FLT x383 = x376 * x378 * x357;
+	const GEN_FLT x384 = x356 * (x383 - 8.0108022e-06 * x376 * x378 * x356);
+	const GEN_FLT x385 = x376 * x378 * x359;
+	const GEN_FLT x386 = x356 * (x384 + x385);
+	const GEN_FLT x387 = x382 + x386;
+	const GEN_FLT x388 = x354 * x363 * x371 / pow(x369, 2);
+	const GEN_FLT x389 =
+		-(x373 * (x374 + 2 * x376 * x378 * x354 * x356 * x363 * x370 + ogeePhase_1 * x363 * x370 * x380 * x381 * x371 +
+		x354 * x370 * x371 * x387 + x375 - x388 * (x87 * x354 * (x356 * (x382 + x386 + x356 * (x384 + x385 + x356 *
+		(x383 + x376 * x378 * x364 - 2.40324066e-05 * x376 * x378 * x356) + x376 * x378 * x365) + x376 * x378 * x366) +
+		x376 * x378 * x363 + x376 * x378 * x367 + x356 * x387) + ogeePhase_1 * x87 * x368 * x380 * x381)));
+	const GEN_FLT x390 = cos(x52 + gibPhase_1 - asin(x372));
+	const GEN_FLT x391 = x78 * x159 * x197;
+	const GEN_FLT x392 = -(x78 * x130 * x200);
+	const GEN_FLT x393 = x202 * x377 + x132 * x200 * x355;
+	const GEN_FLT x394 = x376 * x361 * x393;
+	const GEN_FLT x395 = x376 * x357 * x393;
+	const GEN_FLT x396 = x356 * (x395 - 8.0108022e-06 * x376 * x356 * x393);
+	const GEN_FLT x397 = x376 * x359 * x393;
+	const GEN_FLT x398 = x356 * (x396 + x397);
+	const GEN_FLT x399 = x394 + x398;
+	const GEN_FLT x400 = x194 - x379 * (x391 + x392);
+	const GEN_FLT x401 =
+		-(x373 * (x391 + 2 * x376 * x354 * x356 * x363 * x370 * x393 + ogeePhase_1 * x363 * x370 * x381 * x371 * x400 +
+		x354 * x370 * x371 * x399 + x392 - x388 * (x87 * x354 * (x356 * (x394 + x398 + x356 * (x396 + x397 + x356 *
+		(x395 + x376 * x364 * x393 - 2.40324066e-05 * x376 * x356 * x393) + x376 * x365 * x393) + x376 * x366 * x393) +
+		x376 * x363 * x393 + x376 * x367 * x393 + x356 * x399) + ogeePhase_1 * x87 * x368 * x381 * x400)));
+	const GEN_FLT x402 = x78 * x159 * x218;
+	const GEN_FLT x403 = -(x78 * x130 * x220);
+	const GEN_FLT x404 = x222 * x377 + x132 * x220 * x355;
+	const GEN_FLT x405 = x376 * x361 * x404;
+	const GEN_FLT x406 = x376 * x357 * x404;
+	const GEN_FLT x407 = x356 * (x406 - 8.0108022e-06 * x376 * x356 * x404);
+	const GEN_FLT x408 = x376 * x359 * x404;
+	const GEN_FLT x409 = x356 * (x407 + x408);
+	const GEN_FLT x410 = x405 + x409;
+	const GEN_FLT x411 = x215 - x379 * (x402 + x403);
+	const GEN_FLT x412 =
+		-(x373 * (x402 + 2 * x376 * x354 * x356 * x363 * x370 * x404 + ogeePhase_1 * x363 * x370 * x381 * x371 * x411 +
+		x354 * x370 * x371 * x410 + x403 - x388 * (x87 * x354 * (x356 * (x405 + x409 + x356 * (x407 + x408 + x356 *
+		(x406 + x376 * x364 * x404 - 2.40324066e-05 * x376 * x356 * x404) + x376 * x365 * x404) + x376 * x366 * x404) +
+		x376 * x363 * x404 + x376 * x367 * x404 + x356 * x410) + ogeePhase_1 * x87 * x368 * x381 * x411)));
+	const GEN_FLT x413 = x78 * x130 * (-x262);
+	const GEN_FLT x414 = x78 * x159 * x266;
+	const GEN_FLT x415 = x132 * x262 * x355 - x169 * x268 * x355;
+	const GEN_FLT x416 = x376 * x361 * x415;
+	const GEN_FLT x417 = x376 * x357 * x415;
+	const GEN_FLT x418 = x356 * (x417 - 8.0108022e-06 * x376 * x356 * x415);
+	const GEN_FLT x419 = x376 * x359 * x415;
+	const GEN_FLT x420 = x356 * (x418 + x419);
+	const GEN_FLT x421 = x416 + x420;
+	const GEN_FLT x422 = x261 - x379 * (x413 + x414);
+	const GEN_FLT x423 =
+		-(x373 * (x413 + x414 + 2 * x376 * x354 * x356 * x363 * x370 * x415 + ogeePhase_1 * x363 * x370 * x381 * x371 *
+		x422 + x354 * x370 * x371 * x421 - x388 * (x87 * x354 * (x356 * (x416 + x420 + x356 * (x418 + x419 + x356 *
+		(x417 + x376 * x364 * x415 - 2.40324066e-05 * x376 * x356 * x415) + x376 * x365 * x415) + x376 * x366 * x415) +
+		x376 * x363 * x415 + x376 * x367 * x415 + x356 * x421) + ogeePhase_1 * x87 * x368 * x381 * x422)));
+	const GEN_FLT x424 = x78 * x130 * (-x301);
+	const GEN_FLT x425 = x78 * x159 * x305;
+	const GEN_FLT x426 = x132 * x301 * x355 - x169 * x307 * x355;
+	const GEN_FLT x427 = x376 * x361 * x426;
+	const GEN_FLT x428 = x376 * x357 * x426;
+	const GEN_FLT x429 = x356 * (x428 - 8.0108022e-06 * x376 * x356 * x426);
+	const GEN_FLT x430 = x376 * x359 * x426;
+	const GEN_FLT x431 = x356 * (x429 + x430);
+	const GEN_FLT x432 = x427 + x431;
+	const GEN_FLT x433 = x300 - x379 * (x424 + x425);
+	const GEN_FLT x434 =
+		-(x373 * (x424 + x425 + 2 * x376 * x354 * x356 * x363 * x370 * x426 + ogeePhase_1 * x363 * x370 * x381 * x371 *
+		x433 + x354 * x370 * x371 * x432 - x388 * (x87 * x354 * (x356 * (x427 + x431 + x356 * (x429 + x430 + x356 *
+		(x428 + x376 * x364 * x426 - 2.40324066e-05 * x376 * x356 * x426) + x376 * x365 * x426) + x376 * x366 * x426) +
+		x376 * x363 * x426 + x376 * x367 * x426 + x356 * x432) + ogeePhase_1 * x87 * x368 * x381 * x433)));
+	const GEN_FLT x435 = x78 * x130 * (-x336);
+	const GEN_FLT x436 = x78 * x159 * x340;
+	const GEN_FLT x437 = x132 * x336 * x355 - x169 * x342 * x355;
+	const GEN_FLT x438 = x376 * x361 * x437;
+	const GEN_FLT x439 = x376 * x357 * x437;
+	const GEN_FLT x440 = x356 * (x439 - 8.0108022e-06 * x376 * x356 * x437);
+	const GEN_FLT x441 = x376 * x359 * x437;
+	const GEN_FLT x442 = x356 * (x440 + x441);
+	const GEN_FLT x443 = x438 + x442;
+	const GEN_FLT x444 = x335 - x379 * (x435 + x436);
+	const GEN_FLT x445 =
+		-(x373 * (x435 + x436 + 2 * x376 * x354 * x356 * x363 * x370 * x437 + ogeePhase_1 * x363 * x370 * x381 * x371 *
+		x444 + x354 * x370 * x371 * x443 - x388 * (x87 * x354 * (x356 * (x438 + x442 + x356 * (x440 + x441 + x356 *
+		(x439 + x376 * x364 * x437 - 2.40324066e-05 * x376 * x356 * x437) + x376 * x365 * x437) + x376 * x366 * x437) +
+		x376 * x363 * x437 + x376 * x367 * x437 + x356 * x443) + ogeePhase_1 * x87 * x368 * x381 * x444)));
+	const GEN_FLT x446 = x101 + x103 + x108 + x110 + x115 + x188;
+	const GEN_FLT x447 = x90 * (-x446);
+	const GEN_FLT x448 = 1 + x121 + x122 + x123 + x124 + x125 + x192;
+	const GEN_FLT x449 = x59 * x89 * (x447 + x127 * x448);
+	const GEN_FLT x450 = x162 + x163 + x164 + x165 + x166 + x199;
+	const GEN_FLT x451 = x63 * x130 * x450;
+	const GEN_FLT x452 = 2 * x44 * x446;
+	const GEN_FLT x453 = 2 * x51 * x448;
+	const GEN_FLT x454 = x452 + x453;
+	const GEN_FLT x455 = -(x63 * x159 * x454);
+	const GEN_FLT x456 = x132 * x133 * x450;
+	const GEN_FLT x457 = 2 * x57 * x450;
+	const GEN_FLT x458 = x457 + x452 + x453;
+	const GEN_FLT x459 = x456 - x133 * x169 * x458;
+	const GEN_FLT x460 = x135 * x173 * x459;
+	const GEN_FLT x461 = x134 * (x460 - 8.0108022e-06 * x134 * x173 * x459);
+	const GEN_FLT x462 = x137 * x173 * x459;
+	const GEN_FLT x463 = x134 * (x461 + x462);
+	const GEN_FLT x464 = x139 * x173 * x459;
+	const GEN_FLT x465 = x463 + x464;
+	const GEN_FLT x466 = x449 - x181 * (x451 + x455);
+	const GEN_FLT x467 =
+		x153 * (x451 + x143 * x150 * x151 * x465 + 2 * x134 * x141 * x143 * x150 * x173 * x459 + ogeePhase_0 * x141 *
+		x150 * x151 * x180 * x466 + x455 - x183 * (x184 * (x147 * x173 * x459 + x134 * x465 + x134 * (x463 + x464 + x146
+		* x173 * x459 + x134 * (x461 + x462 + x145 * x173 * x459 + x134 * (x460 + x144 * x173 * x459 - x134 * x173 *
+		2.40324066e-05 * x459))) + x141 * x173 * x459) - ogeePhase_0 * x75 * x148 * x180 * x466));
+	const GEN_FLT x468 = x121 + x122 + x123 + x124 + x125 + x192;
+	const GEN_FLT x469 = x127 * x468;
+	const GEN_FLT x470 = x59 * x89 * (x447 + x469);
+	const GEN_FLT x471 = 2 * x51 * x468;
+	const GEN_FLT x472 = x452 + x471;
+	const GEN_FLT x473 = x159 * x160 * x472;
+	const GEN_FLT x474 = 1 + x162 + x163 + x164 + x165 + x166 + x199;
+	const GEN_FLT x475 = x63 * x130 * x474;
+	const GEN_FLT x476 = x452 + x471 + 2 * x57 * x474;
+	const GEN_FLT x477 = x132 * x133 * x474 - x133 * x169 * x476;
+	const GEN_FLT x478 = x135 * x173 * x477;
+	const GEN_FLT x479 = x134 * (x478 - 8.0108022e-06 * x134 * x173 * x477);
+	const GEN_FLT x480 = x137 * x173 * x477;
+	const GEN_FLT x481 = x134 * (x479 + x480);
+	const GEN_FLT x482 = x139 * x173 * x477;
+	const GEN_FLT x483 = x481 + x482;
+	const GEN_FLT x484 = x470 - x181 * (x473 + x475);
+	const GEN_FLT x485 =
+		x153 * (x473 + x475 + x143 * x150 * x151 * x483 + 2 * x134 * x141 * x143 * x150 * x173 * x477 + ogeePhase_0 *
+		x141 * x150 * x151 * x180 * x484 - x183 * (x184 * (x147 * x173 * x477 + x134 * x483 + x134 * (x481 + x482 + x146
+		* x173 * x477 + x134 * (x479 + x480 + x145 * x173 * x477 + x134 * (x478 + x144 * x173 * x477 - x134 * x173 *
+		2.40324066e-05 * x477))) + x141 * x173 * x477) - ogeePhase_0 * x75 * x148 * x180 * x484));
+	const GEN_FLT x486 = 1 + x101 + x103 + x108 + x110 + x115 + x188;
+	const GEN_FLT x487 = x59 * x89 * (x469 - x90 * x486);
+	const GEN_FLT x488 = 2 * x44 * x486;
+	const GEN_FLT x489 = x471 + x488;
+	const GEN_FLT x490 = -(x63 * x159 * x489);
+	const GEN_FLT x491 = x457 + x471 + x488;
+	const GEN_FLT x492 = x456 - x133 * x169 * x491;
+	const GEN_FLT x493 = x135 * x173 * x492;
+	const GEN_FLT x494 = x134 * (x493 - 8.0108022e-06 * x134 * x173 * x492);
+	const GEN_FLT x495 = x137 * x173 * x492;
+	const GEN_FLT x496 = x134 * (x494 + x495);
+	const GEN_FLT x497 = x139 * x173 * x492;
+	const GEN_FLT x498 = x496 + x497;
+	const GEN_FLT x499 = x487 - x181 * (x451 + x490);
+	const GEN_FLT x500 =
+		x153 * (x451 + x143 * x150 * x151 * x498 + 2 * x134 * x141 * x143 * x150 * x173 * x492 + ogeePhase_0 * x141 *
+		x150 * x151 * x180 * x499 + x490 - x183 * (x184 * (x147 * x173 * x492 + x134 * x498 + x134 * (x496 + x497 + x146
+		* x173 * x492 + x134 * (x494 + x495 + x145 * x173 * x492 + x134 * (x493 + x144 * x173 * x492 - x134 * x173 *
+		2.40324066e-05 * x492))) + x141 * x173 * x492) - ogeePhase_0 * x75 * x148 * x180 * x499));
+	const GEN_FLT x501 = pow(x22, -1);
+	const GEN_FLT x502 = -(lh_qi * x34 * x501);
+	const GEN_FLT x503 = pow(x21, x158);
+	const GEN_FLT x504 = ((x25) ? (lh_qi * (-lh_qk) / x503) : (0));
+	const GEN_FLT x505 = pow(x21, x129);
+	const GEN_FLT x506 = ((x25) ? ((-x18) / x503 + x505) : (0));
+	const GEN_FLT x507 = x34 * x506;
+	const GEN_FLT x508 = lh_qi * x33 * x23 * x501;
+	const GEN_FLT x509 = ((x25) ? (lh_qi * (-lh_qj) / x503) : (0));
+	const GEN_FLT x510 = x26 * x24 * x509;
+	const GEN_FLT x511 = x36 * x24 * x504;
+	const GEN_FLT x512 = lh_qi * x34 * x26 * x36 * x501;
+	const GEN_FLT x513 = x34 * x509;
+	const GEN_FLT x514 = -x513;
+	const GEN_FLT x515 = x33 * x24 * x504;
+	const GEN_FLT x516 = lh_qi * x33 * x34 * x26 * x501;
+	const GEN_FLT x517 = x26 * x24 * x506;
+	const GEN_FLT x518 = lh_qi * x36 * x23 * x501;
+	const GEN_FLT x519 =
+		x101 + x115 + x188 + x17 * (2 * x26 * x24 * x504 + lh_qi * x34 * x27 * x501 + x502) + x32 * (x507 + x508 + x510
+		+ x511 + x512) + x40 * (x515 + x516 + x517 + x514 - x518);
+	const GEN_FLT x520 = x34 * x504;
+	const GEN_FLT x521 = -x520;
+	const GEN_FLT x522 = x33 * x24 * x509;
+	const GEN_FLT x523 = lh_qi * x33 * x34 * x36 * x501;
+	const GEN_FLT x524 = x36 * x24 * x506;
+	const GEN_FLT x525 = lh_qi * x26 * x23 * x501;
+	const GEN_FLT x526 =
+		x121 + x125 + x192 + x17 * (x513 + x518 + x515 + x516 + x517) + x32 * (x522 + x523 + x524 + x521 - x525) + x40 *
+		(2 * x33 * x24 * x506 + lh_qi * x34 * x45 * x501 + x502);
+	const GEN_FLT x527 = x59 * x89 * (x191 * x519 + x127 * x526);
+	const GEN_FLT x528 =
+		x162 + x166 + x199 + x17 * (x510 + x511 + x512 - x507 - x508) + x32 * (2 * x36 * x24 * x509 + lh_qi * x34 * x54
+		* x501 + x502) + x40 * (x520 + x525 + x522 + x523 + x524);
+	const GEN_FLT x529 = x63 * x130 * x528;
+	const GEN_FLT x530 = 2 * x44 * x519;
+	const GEN_FLT x531 = 2 * x51 * x526;
+	const GEN_FLT x532 = x530 + x531;
+	const GEN_FLT x533 = -(x63 * x159 * x532);
+	const GEN_FLT x534 = x530 + x531 + 2 * x57 * x528;
+	const GEN_FLT x535 = x132 * x133 * x528 - x133 * x169 * x534;
+	const GEN_FLT x536 = x135 * x173 * x535;
+	const GEN_FLT x537 = x134 * (x536 - 8.0108022e-06 * x134 * x173 * x535);
+	const GEN_FLT x538 = x137 * x173 * x535;
+	const GEN_FLT x539 = x134 * (x537 + x538);
+	const GEN_FLT x540 = x139 * x173 * x535;
+	const GEN_FLT x541 = x539 + x540;
+	const GEN_FLT x542 = x527 - x181 * (x529 + x533);
+	const GEN_FLT x543 =
+		x153 * (x529 + 2 * x134 * x141 * x143 * x150 * x173 * x535 + x143 * x150 * x151 * x541 + ogeePhase_0 * x141 *
+		x150 * x151 * x180 * x542 + x533 - x183 * (x184 * (x147 * x173 * x535 + x134 * x541 + x134 * (x539 + x540 + x146
+		* x173 * x535 + x134 * (x537 + x538 + x145 * x173 * x535 + x134 * (x536 + x144 * x173 * x535 - x134 * x173 *
+		2.40324066e-05 * x535))) + x141 * x173 * x535) - ogeePhase_0 * x75 * x148 * x180 * x542));
+	const GEN_FLT x544 = -(lh_qj * x34 * x501);
+	const GEN_FLT x545 = ((x25) ? (lh_qj * (-lh_qk) / x503) : (0));
+	const GEN_FLT x546 = lh_qj * x33 * x23 * x501;
+	const GEN_FLT x547 = x36 * x24 * x545;
+	const GEN_FLT x548 = lh_qj * x34 * x26 * x36 * x501;
+	const GEN_FLT x549 = ((x25) ? (x505 + (-x19) / x503) : (0));
+	const GEN_FLT x550 = x26 * x24 * x549;
+	const GEN_FLT x551 = x33 * x24 * x545;
+	const GEN_FLT x552 = lh_qj * x33 * x34 * x26 * x501;
+	const GEN_FLT x553 = x34 * x549;
+	const GEN_FLT x554 = lh_qj * x36 * x23 * x501;
+	const GEN_FLT x555 =
+		x101 + x115 + x188 + x17 * (2 * x26 * x24 * x545 + lh_qj * x34 * x27 * x501 + x544) + x32 * (x513 + x546 + x547
+		+ x548 + x550) + x40 * (x510 + x551 + x552 - x553 - x554);
+	const GEN_FLT x556 = x36 * x24 * x509;
+	const GEN_FLT x557 = x34 * x545;
+	const GEN_FLT x558 = -x557;
+	const GEN_FLT x559 = x33 * x24 * x549;
+	const GEN_FLT x560 = lh_qj * x33 * x34 * x36 * x501;
+	const GEN_FLT x561 = lh_qj * x26 * x23 * x501;
+	const GEN_FLT x562 =
+		x121 + x125 + x192 + x17 * (x510 + x553 + x554 + x551 + x552) + x32 * (x556 + x559 + x560 + x558 - x561) + x40 *
+		(2 * x33 * x24 * x509 + lh_qj * x34 * x45 * x501 + x544);
+	const GEN_FLT x563 = x59 * x89 * (x191 * x555 + x127 * x562);
+	const GEN_FLT x564 =
+		x162 + x166 + x199 + x17 * (x547 + x548 + x550 + x514 - x546) + x32 * (2 * x36 * x24 * x549 + lh_qj * x34 * x54
+		* x501 + x544) + x40 * (x556 + x557 + x561 + x559 + x560);
+	const GEN_FLT x565 = x63 * x130 * x564;
+	const GEN_FLT x566 = 2 * x44 * x555;
+	const GEN_FLT x567 = 2 * x51 * x562;
+	const GEN_FLT x568 = x566 + x567;
+	const GEN_FLT x569 = -(x63 * x159 * x568);
+	const GEN_FLT x570 = -(x566 + x567 + 2 * x57 * x564);
+	const GEN_FLT x571 = x133 * x169 * x570 + x132 * x133 * x564;
+	const GEN_FLT x572 = x135 * x173 * x571;
+	const GEN_FLT x573 = x134 * (x572 - 8.0108022e-06 * x134 * x173 * x571);
+	const GEN_FLT x574 = x137 * x173 * x571;
+	const GEN_FLT x575 = x134 * (x573 + x574);
+	const GEN_FLT x576 = x139 * x173 * x571;
+	const GEN_FLT x577 = x575 + x576;
+	const GEN_FLT x578 = x563 - x181 * (x565 + x569);
+	const GEN_FLT x579 =
+		x153 * (x565 + 2 * x134 * x141 * x143 * x150 * x173 * x571 + x143 * x150 * x151 * x577 + ogeePhase_0 * x141 *
+		x150 * x151 * x180 * x578 + x569 - x183 * (x184 * (x147 * x173 * x571 + x134 * x577 + x134 * (x575 + x576 + x146
+		* x173 * x571 + x134 * (x573 + x574 + x145 * x173 * x571 + x134 * (x572 + x144 * x173 * x571 - x134 * x173 *
+		2.40324066e-05 * x571))) + x141 * x173 * x571) - ogeePhase_0 * x75 * x148 * x180 * x578));
+	const GEN_FLT x580 = -(lh_qk * x34 * x501);
+	const GEN_FLT x581 = ((x25) ? (x505 + (-x20) / x503) : (0));
+	const GEN_FLT x582 = x26 * x24 * x545;
+	const GEN_FLT x583 = lh_qk * x33 * x23 * x501;
+	const GEN_FLT x584 = lh_qk * x34 * x26 * x36 * x501;
+	const GEN_FLT x585 = x36 * x24 * x581;
+	const GEN_FLT x586 = x26 * x24 * x504;
+	const GEN_FLT x587 = x33 * x24 * x581;
+	const GEN_FLT x588 = lh_qk * x33 * x34 * x26 * x501;
+	const GEN_FLT x589 = lh_qk * x36 * x23 * x501;
+	const GEN_FLT x590 =
+		x101 + x115 + x188 + x17 * (2 * x26 * x24 * x581 + lh_qk * x34 * x27 * x501 + x580) + x32 * (x520 + x582 + x583
+		+ x584 + x585) + x40 * (x586 + x587 + x588 + x558 - x589);
+	const GEN_FLT x591 = lh_qk * x33 * x34 * x36 * x501;
+	const GEN_FLT x592 = x34 * x581;
+	const GEN_FLT x593 = lh_qk * x26 * x23 * x501;
+	const GEN_FLT x594 =
+		x121 + x125 + x192 + x17 * (x586 + x557 + x589 + x587 + x588) + x32 * (x511 + x551 + x591 - x592 - x593) + x40 *
+		(2 * x33 * x24 * x504 + lh_qk * x34 * x45 * x501 + x580);
+	const GEN_FLT x595 = x59 * x89 * (x191 * x590 + x127 * x594);
+	const GEN_FLT x596 =
+		x162 + x166 + x199 + x17 * (x582 + x584 + x585 + x521 - x583) + x32 * (2 * x36 * x24 * x545 + lh_qk * x34 * x54
+		* x501 + x580) + x40 * (x511 + x551 + x592 + x593 + x591);
+	const GEN_FLT x597 = x63 * x130 * x596;
+	const GEN_FLT x598 = 2 * x44 * x590;
+	const GEN_FLT x599 = 2 * x51 * x594;
+	const GEN_FLT x600 = x598 + x599;
+	const GEN_FLT x601 = -(x63 * x159 * x600);
+	const GEN_FLT x602 = x598 + x599 + 2 * x57 * x596;
+	const GEN_FLT x603 = x132 * x133 * x596 - x133 * x169 * x602;
+	const GEN_FLT x604 = x135 * x173 * x603;
+	const GEN_FLT x605 = x134 * (x604 - 8.0108022e-06 * x134 * x173 * x603);
+	const GEN_FLT x606 = x137 * x173 * x603;
+	const GEN_FLT x607 = x134 * (x605 + x606);
+	const GEN_FLT x608 = x139 * x173 * x603;
+	const GEN_FLT x609 = x607 + x608;
+	const GEN_FLT x610 = x595 - x181 * (x597 + x601);
+	const GEN_FLT x611 =
+		x153 * (x597 + 2 * x134 * x141 * x143 * x150 * x173 * x603 + x143 * x150 * x151 * x609 + ogeePhase_0 * x141 *
+		x150 * x151 * x180 * x610 + x601 - x183 * (x184 * (x147 * x173 * x603 + x134 * x609 + x134 * (x607 + x608 + x146
+		* x173 * x603 + x134 * (x605 + x606 + x145 * x173 * x603 + x134 * (x604 + x144 * x173 * x603 - x134 * x173 *
+		2.40324066e-05 * x603))) + x141 * x173 * x603) - ogeePhase_0 * x75 * x148 * x180 * x610));
+	const GEN_FLT x612 = x450 * (-(x78 * x130));
+	const GEN_FLT x613 = x78 * x159 * x454;
+	const GEN_FLT x614 = x132 * x355 * x450;
+	const GEN_FLT x615 = x614 - x169 * x355 * x458;
+	const GEN_FLT x616 = x449 - x379 * (x612 + x613);
+	const GEN_FLT x617 = x376 * x357 * x615;
+	const GEN_FLT x618 = x356 * (x617 - 8.0108022e-06 * x376 * x356 * x615);
+	const GEN_FLT x619 = x376 * x359 * x615;
+	const GEN_FLT x620 = x356 * (x618 + x619);
+	const GEN_FLT x621 = x376 * x361 * x615;
+	const GEN_FLT x622 = x620 + x621;
+	const GEN_FLT x623 =
+		-(x373 * (x612 + x613 + 2 * x376 * x354 * x356 * x363 * x370 * x615 + ogeePhase_1 * x363 * x370 * x381 * x371 *
+		x616 + x354 * x370 * x371 * x622 - x388 * (x87 * x354 * (x356 * x622 + x356 * (x620 + x621 + x356 * (x618 + x619
+		+ x356 * (x617 + x376 * x364 * x615 - 2.40324066e-05 * x376 * x356 * x615) + x376 * x365 * x615) + x376 * x366 *
+		x615) + x376 * x363 * x615 + x376 * x367 * x615) + ogeePhase_1 * x87 * x368 * x381 * x616)));
+	const GEN_FLT x624 = x78 * x159 * x472;
+	const GEN_FLT x625 = -(x78 * x130 * x474);
+	const GEN_FLT x626 = x169 * x476 * (-x355) + x132 * x355 * x474;
+	const GEN_FLT x627 = x376 * x357 * x626;
+	const GEN_FLT x628 = x356 * (x627 - 8.0108022e-06 * x376 * x356 * x626);
+	const GEN_FLT x629 = x376 * x359 * x626;
+	const GEN_FLT x630 = x356 * (x628 + x629);
+	const GEN_FLT x631 = x376 * x361 * x626;
+	const GEN_FLT x632 = x630 + x631;
+	const GEN_FLT x633 = x470 - x379 * (x624 + x625);
+	const GEN_FLT x634 =
+		-(x373 * (x624 + x354 * x370 * x371 * x632 + 2 * x376 * x354 * x356 * x363 * x370 * x626 + ogeePhase_1 * x363 *
+		x370 * x381 * x371 * x633 + x625 - x388 * (x87 * x354 * (x356 * x632 + x356 * (x630 + x631 + x356 * (x628 + x629
+		+ x356 * (x627 + x376 * x364 * x626 - 2.40324066e-05 * x376 * x356 * x626) + x376 * x365 * x626) + x376 * x366 *
+		x626) + x376 * x363 * x626 + x376 * x367 * x626) + ogeePhase_1 * x87 * x368 * x381 * x633)));
+	const GEN_FLT x635 = x78 * x159 * x489;
+	const GEN_FLT x636 = x614 - x169 * x355 * x491;
+	const GEN_FLT x637 = x376 * x357 * x636;
+	const GEN_FLT x638 = x356 * (x637 - 8.0108022e-06 * x376 * x356 * x636);
+	const GEN_FLT x639 = x376 * x359 * x636;
+	const GEN_FLT x640 = x356 * (x638 + x639);
+	const GEN_FLT x641 = x376 * x361 * x636;
+	const GEN_FLT x642 = x640 + x641;
+	const GEN_FLT x643 = x487 - x379 * (x612 + x635);
+	const GEN_FLT x644 =
+		-(x373 * (x612 + x635 + 2 * x376 * x354 * x356 * x363 * x370 * x636 + ogeePhase_1 * x363 * x370 * x381 * x371 *
+		x643 + x354 * x370 * x371 * x642 - x388 * (x87 * x354 * (x356 * x642 + x356 * (x640 + x641 + x356 * (x638 + x639
+		+ x356 * (x637 + x376 * x364 * x636 - 2.40324066e-05 * x376 * x356 * x636) + x376 * x365 * x636) + x376 * x366 *
+		x636) + x376 * x363 * x636 + x376 * x367 * x636) + ogeePhase_1 * x87 * x368 * x381 * x643)));
+	const GEN_FLT x645 = x78 * (-(x130 * x528));
+	const GEN_FLT x646 = x78 * x159 * x532;
+	const GEN_FLT x647 = x132 * x355 * x528 - x169 * x355 * x534;
+	const GEN_FLT x648 = x376 * x357 * x647;
+	const GEN_FLT x649 = x356 * (x648 - 8.0108022e-06 * x376 * x356 * x647);
+	const GEN_FLT x650 = x376 * x359 * x647;
+	const GEN_FLT x651 = x356 * (x649 + x650);
+	const GEN_FLT x652 = x376 * x361 * x647;
+	const GEN_FLT x653 = x651 + x652;
+	const GEN_FLT x654 = x527 - x379 * (x645 + x646);
+	const GEN_FLT x655 =
+		-(x373 * (x645 + x646 + 2 * x376 * x354 * x356 * x363 * x370 * x647 + ogeePhase_1 * x363 * x370 * x381 * x371 *
+		x654 + x354 * x370 * x371 * x653 - x388 * (x87 * x354 * (x356 * x653 + x356 * (x651 + x652 + x356 * (x649 + x650
+		+ x356 * (x648 + x376 * x364 * x647 - 2.40324066e-05 * x376 * x356 * x647) + x376 * x365 * x647) + x376 * x366 *
+		x647) + x376 * x363 * x647 + x376 * x367 * x647) + ogeePhase_1 * x87 * x368 * x381 * x654)));
+	const GEN_FLT x656 = x78 * (-(x130 * x564));
+	const GEN_FLT x657 = x78 * x159 * x568;
+	const GEN_FLT x658 = x169 * x355 * x570 + x132 * x355 * x564;
+	const GEN_FLT x659 = x376 * x357 * x658;
+	const GEN_FLT x660 = x356 * (x659 - 8.0108022e-06 * x376 * x356 * x658);
+	const GEN_FLT x661 = x376 * x359 * x658;
+	const GEN_FLT x662 = x356 * (x660 + x661);
+	const GEN_FLT x663 = x376 * x361 * x658;
+	const GEN_FLT x664 = x662 + x663;
+	const GEN_FLT x665 = x563 - x379 * (x656 + x657);
+	const GEN_FLT x666 =
+		-(x373 * (x656 + x657 + 2 * x376 * x354 * x356 * x363 * x370 * x658 + ogeePhase_1 * x363 * x370 * x381 * x371 *
+		x665 + x354 * x370 * x371 * x664 - x388 * (x87 * x354 * (x356 * x664 + x356 * (x662 + x663 + x356 * (x660 + x661
+		+ x356 * (x659 + x376 * x364 * x658 - 2.40324066e-05 * x376 * x356 * x658) + x376 * x365 * x658) + x376 * x366 *
+		x658) + x376 * x363 * x658 + x376 * x367 * x658) + ogeePhase_1 * x87 * x368 * x381 * x665)));
+	const GEN_FLT x667 = x78 * x130 * (-x596);
+	const GEN_FLT x668 = x78 * x159 * x600;
+	const GEN_FLT x669 = x132 * x355 * x596 - x169 * x355 * x602;
+	const GEN_FLT x670 = x376 * x357 * x669;
+	const GEN_FLT x671 = x356 * (x670 - 8.0108022e-06 * x376 * x356 * x669);
+	const GEN_FLT x672 = x376 * x359 * x669;
+	const GEN_FLT x673 = x356 * (x671 + x672);
+	const GEN_FLT x674 = x376 * x361 * x669;
+	const GEN_FLT x675 = x673 + x674;
+	const GEN_FLT x676 = x595 - x379 * (x667 + x668);
+	const GEN_FLT x677 =
+		-(x373 * (x667 + x668 + 2 * x376 * x354 * x356 * x363 * x370 * x669 + ogeePhase_1 * x363 * x370 * x381 * x371 *
+		x676 + x354 * x370 * x371 * x675 - x388 * (x87 * x354 * (x356 * x675 + x356 * (x673 + x674 + x356 * (x671 + x672
+		+ x356 * (x670 + x376 * x364 * x669 - 2.40324066e-05 * x376 * x356 * x669) + x376 * x365 * x669) + x376 * x366 *
+		x669) + x376 * x363 * x669 + x376 * x367 * x669) + ogeePhase_1 * x87 * x368 * x381 * x676)));
+	*(out++) = x52 + sin(x52 + gibPhase_0 + x76) * gibMag_0 + x76 - 1.5707963267949 - phase_0;
+	*(out++) = x52 + sin(x52 + gibPhase_1 + x88) * gibMag_1 + x88 - 1.5707963267949 - phase_1;
+	*(out++) = x128 - x185 - gibMag_0 * x186 * (x185 - x128);
+	*(out++) = x194 - x211 - gibMag_0 * x186 * (x211 - x194);
+	*(out++) = x215 - x231 - gibMag_0 * x186 * (x231 - x215);
+	*(out++) = x261 - x277 - gibMag_0 * x186 * (x277 - x261);
+	*(out++) = x300 - x316 - gibMag_0 * x186 * (x316 - x300);
+	*(out++) = x335 - x351 - gibMag_0 * x186 * (x351 - x335);
+	*(out++) = x128 + gibMag_1 * (x128 + x389) * x390 + x389;
+	*(out++) = x194 + gibMag_1 * x390 * (x194 + x401) + x401;
+	*(out++) = x215 + gibMag_1 * x390 * (x215 + x412) + x412;
+	*(out++) = x261 + gibMag_1 * x390 * (x261 + x423) + x423;
+	*(out++) = x300 + gibMag_1 * x390 * (x300 + x434) + x434;
+	*(out++) = x335 + gibMag_1 * x390 * (x335 + x445) + x445;
+	*(out++) = x449 - x467 - gibMag_0 * x186 * (x467 - x449);
+	*(out++) = x470 - x485 - gibMag_0 * x186 * (x485 - x470);
+	*(out++) = x487 - x500 - gibMag_0 * x186 * (x500 - x487);
+	*(out++) = x527 - x543 - gibMag_0 * x186 * (x543 - x527);
+	*(out++) = x563 - x579 - gibMag_0 * x186 * (x579 - x563);
+	*(out++) = x595 - x611 - gibMag_0 * x186 * (x611 - x595);
+	*(out++) = x449 + gibMag_1 * x390 * (x449 + x623) + x623;
+	*(out++) = x470 + gibMag_1 * x390 * (x470 + x634) + x634;
+	*(out++) = x487 + gibMag_1 * x390 * (x487 + x644) + x644;
+	*(out++) = x527 + gibMag_1 * x390 * (x527 + x655) + x655;
+	*(out++) = x563 + gibMag_1 * x390 * (x563 + x666) + x666;
+	*(out++) = x595 + gibMag_1 * x390 * (x595 + x677) + x677;
+}
+
+void survive_reproject_axisangle_with_jacs(FLT *out, const LinmathAxisAnglePose *obj_p, const FLT *sensor_pt,
+										   const LinmathAxisAnglePose *lh_p, const BaseStationCal *bsd) {
+	const GEN_FLT obj_px = (*obj_p).Pos[0];
+	const GEN_FLT obj_py = (*obj_p).Pos[1];
+	const GEN_FLT obj_pz = (*obj_p).Pos[2];
+	const GEN_FLT obj_qi = (*obj_p).AxisAngleRot[0];
+	const GEN_FLT obj_qj = (*obj_p).AxisAngleRot[1];
+	const GEN_FLT obj_qk = (*obj_p).AxisAngleRot[2];
+	const GEN_FLT sensor_x = sensor_pt[0];
+	const GEN_FLT sensor_y = sensor_pt[1];
+	const GEN_FLT sensor_z = sensor_pt[2];
+	const GEN_FLT lh_px = (*lh_p).Pos[0];
+	const GEN_FLT lh_py = (*lh_p).Pos[1];
+	const GEN_FLT lh_pz = (*lh_p).Pos[2];
+	const GEN_FLT lh_qi = (*lh_p).AxisAngleRot[0];
+	const GEN_FLT lh_qj = (*lh_p).AxisAngleRot[1];
+	const GEN_FLT lh_qk = (*lh_p).AxisAngleRot[2];
+	const GEN_FLT phase_0 = bsd[0].phase;
+	const GEN_FLT tilt_0 = bsd[0].tilt;
+	const GEN_FLT curve_0 = bsd[0].curve;
+	const GEN_FLT gibPhase_0 = bsd[0].gibpha;
+	const GEN_FLT gibMag_0 = bsd[0].gibmag;
+	const GEN_FLT ogeeMag_0 = bsd[0].ogeephase;
+	const GEN_FLT ogeePhase_0 = bsd[0].ogeemag;
+	const GEN_FLT phase_1 = bsd[1].phase;
+	const GEN_FLT tilt_1 = bsd[1].tilt;
+	const GEN_FLT curve_1 = bsd[1].curve;
+	const GEN_FLT gibPhase_1 = bsd[1].gibpha;
+	const GEN_FLT gibMag_1 = bsd[1].gibmag;
+	const GEN_FLT ogeeMag_1 = bsd[1].ogeephase;
+	const GEN_FLT ogeePhase_1 = bsd[1].ogeemag;
+	const GEN_FLT x0 = pow(obj_qi, 2);
+	const GEN_FLT x1 = pow(obj_qj, 2);
+	const GEN_FLT x2 = pow(obj_qk, 2);
+	const GEN_FLT x3 = x0 + x1 + x2;
+	const GEN_FLT x4 = sqrt(x3);
+	const GEN_FLT x5 = cos(x4);
+	const GEN_FLT x6 = 1 - x5;
+	const GEN_FLT x7 = 0 < x4;
+	const GEN_FLT x8 = ((x7) ? (obj_qi / x4) : (1));
+	const GEN_FLT x9 = pow(x8, 2);
+	const GEN_FLT x10 = sin(x4);
+	const GEN_FLT x11 = ((x7) ? (obj_qj / x4) : (0));
+	const GEN_FLT x12 = x10 * x11;
+	const GEN_FLT x13 = ((x7) ? (obj_qk / x4) : (0));
+	const GEN_FLT x14 = x8 * x13 * x6;
+	const GEN_FLT x15 = x8 * x11 * x6;
+	const GEN_FLT x16 = x10 * x13;
+	const GEN_FLT x17 = obj_px + sensor_x * (x5 + x6 * x9) + sensor_z * (x12 + x14) + sensor_y * (x15 - x16);
+	const GEN_FLT x18 = pow(lh_qi, 2);
+	const GEN_FLT x19 = pow(lh_qj, 2);
+	const GEN_FLT x20 = pow(lh_qk, 2);
+	const GEN_FLT x21 = x18 + x19 + x20;
+	const GEN_FLT x22 = sqrt(x21);
+	const GEN_FLT x23 = cos(x22);
+	const GEN_FLT x24 = 1 - x23;
+	const GEN_FLT x25 = 0 < x22;
+	const GEN_FLT x26 = ((x25) ? (lh_qi / x22) : (1));
+	const GEN_FLT x27 = pow(x26, 2);
+	const GEN_FLT x28 = x23 + x24 * x27;
+	const GEN_FLT x29 = x13 * x11 * x6;
+	const GEN_FLT x30 = x10 * x8;
+	const GEN_FLT x31 = pow(x11, 2);
+	const GEN_FLT x32 = obj_py + sensor_z * (x29 - x30) + sensor_y * (x5 + x6 * x31) + sensor_x * (x16 + x15);
+	const GEN_FLT x33 = ((x25) ? (lh_qj / x22) : (0));
+	const GEN_FLT x34 = x26 * x33 * x24;
+	const GEN_FLT x35 = sin(x22);
+	const GEN_FLT x36 = ((x25) ? (lh_qk / x22) : (0));
+	const GEN_FLT x37 = x35 * x36;
+	const GEN_FLT x38 = x34 - x37;
+	const GEN_FLT x39 = pow(x13, 2);
+	const GEN_FLT x40 = obj_pz + (x30 + x29) * sensor_y + (x5 + x6 * x39) * sensor_z + (x14 - x12) * sensor_x;
+	const GEN_FLT x41 = x35 * x33;
+	const GEN_FLT x42 = x26 * x36 * x24;
+	const GEN_FLT x43 = x41 + x42;
+	const GEN_FLT x44 = lh_px + x17 * x28 + x32 * x38 + x40 * x43;
+	const GEN_FLT x45 = pow(x36, 2);
+	const GEN_FLT x46 = x23 + x24 * x45;
+	const GEN_FLT x47 = x26 * x35;
+	const GEN_FLT x48 = x36 * x33 * x24;
+	const GEN_FLT x49 = x47 + x48;
+	const GEN_FLT x50 = x42 - x41;
+	const GEN_FLT x51 = lh_pz + x40 * x46 + x32 * x49 + x17 * x50;
+	const GEN_FLT x52 = -x51;
+	const GEN_FLT x53 = atan2(x44, x52);
+	const GEN_FLT x54 = -x53;
+	const GEN_FLT x55 = pow(x33, 2);
+	const GEN_FLT x56 = x23 + x24 * x55;
+	const GEN_FLT x57 = x37 + x34;
+	const GEN_FLT x58 = x48 - x47;
+	const GEN_FLT x59 = lh_py + x32 * x56 + x17 * x57 + x40 * x58;
+	const GEN_FLT x60 = pow(x51, 2);
+	const GEN_FLT x61 = pow(x44, 2);
+	const GEN_FLT x62 = x60 + x61;
+	const GEN_FLT x63 = sqrt(x62);
+	const GEN_FLT x64 = -asin(x59 * tilt_0 / x63);
+	const GEN_FLT x65 = atan2(x59, x52);
+	const GEN_FLT x66 = pow(x59, 2);
+	const GEN_FLT x67 = x60 + x66;
+	const GEN_FLT x68 = sqrt(x67);
+	const GEN_FLT x69 = -asin(x44 * tilt_1 / x68);
+	const GEN_FLT x70 = -atan2(-x59, x52);
+	const GEN_FLT x71 = pow(x62, -1);
+	const GEN_FLT x72 = ((x7) ? (0) : (0));
+	const GEN_FLT x73 = 2 * x13 * x6 * sensor_z * x72;
+	const GEN_FLT x74 = x8 * x6 * x72;
+	const GEN_FLT x75 = x10 * x72;
+	const GEN_FLT x76 = -x75;
+	const GEN_FLT x77 = x13 * x6 * x72;
+	const GEN_FLT x78 = sensor_x * (x74 + x77 + x76);
+	const GEN_FLT x79 = x11 * x6 * x72;
+	const GEN_FLT x80 = sensor_y * (x75 + x79 + x77);
+	const GEN_FLT x81 = x73 + x78 + x80;
+	const GEN_FLT x82 = x46 * x81;
+	const GEN_FLT x83 = ((x25) ? (0) : (0));
+	const GEN_FLT x84 = 2 * x36 * x24 * x40 * x83;
+	const GEN_FLT x85 = x35 * x83;
+	const GEN_FLT x86 = -x85;
+	const GEN_FLT x87 = x36 * x24 * x83;
+	const GEN_FLT x88 = x26 * x24 * x83;
+	const GEN_FLT x89 = x17 * (x87 + x88 + x86);
+	const GEN_FLT x90 = x33 * x24 * x83;
+	const GEN_FLT x91 = x32 * (x85 + x87 + x90);
+	const GEN_FLT x92 = 2 * x11 * x6 * sensor_y * x72;
+	const GEN_FLT x93 = sensor_x * (x74 + x75 + x79);
+	const GEN_FLT x94 = sensor_z * (x79 + x77 + x76);
+	const GEN_FLT x95 = x92 + x93 + x94;
+	const GEN_FLT x96 = x49 * x95;
+	const GEN_FLT x97 = 2 * x8 * x6 * sensor_x * x72;
+	const GEN_FLT x98 = sensor_y * (x74 + x79 + x76);
+	const GEN_FLT x99 = sensor_z * (x74 + x75 + x77);
+	const GEN_FLT x100 = 1 + x97 + x98 + x99;
+	const GEN_FLT x101 = x82 + x84 + x89 + x91 + x96 + x50 * x100;
+	const GEN_FLT x102 = pow(x60, -1);
+	const GEN_FLT x103 = x38 * x95;
+	const GEN_FLT x104 = 2 * x26 * x24 * x17 * x83;
+	const GEN_FLT x105 = x40 * (x85 + x87 + x88);
+	const GEN_FLT x106 = x32 * (x88 + x90 + x86);
+	const GEN_FLT x107 = x43 * x81;
+	const GEN_FLT x108 = x103 + x104 + x105 + x106 + x107 + x28 * x100;
+	const GEN_FLT x109 = pow(x51, -1);
+	const GEN_FLT x110 = x44 * x101 * x102 - x108 * x109;
+	const GEN_FLT x111 = -(x60 * x71 * x110);
+	const GEN_FLT x112 = (-1.0) / 2.0;
+	const GEN_FLT x113 = pow(1 - x66 * x71 * pow(tilt_0, 2), x112);
+	const GEN_FLT x114 = 1.0 / 2.0;
+	const GEN_FLT x115 = 3.0 / 2.0;
+	const GEN_FLT x116 = x59 * tilt_0 * x114 / pow(x62, x115);
+	const GEN_FLT x117 = -x116;
+	const GEN_FLT x118 = 2 * x51 * x101;
+	const GEN_FLT x119 = x56 * x95;
+	const GEN_FLT x120 = 2 * x33 * x24 * x32 * x83;
+	const GEN_FLT x121 = x40 * (x87 + x90 + x86);
+	const GEN_FLT x122 = x17 * (x85 + x88 + x90);
+	const GEN_FLT x123 = x58 * x81;
+	const GEN_FLT x124 = x119 + x120 + x121 + x122 + x123 + x57 * x100;
+	const GEN_FLT x125 = tilt_0 / x63;
+	const GEN_FLT x126 = -(x113 * (x117 * (x118 + 2 * x44 * x108) + x124 * x125));
+	const GEN_FLT x127 = sin(1.5707963267949 + gibPhase_0 + x54 - phase_0 - asin(x59 * x125));
+	const GEN_FLT x128 = pow(x67, -1);
+	const GEN_FLT x129 = x59 * x101 * x102;
+	const GEN_FLT x130 = x109 * x124;
+	const GEN_FLT x131 = x97 + x98 + x99;
+	const GEN_FLT x132 = x50 * x131;
+	const GEN_FLT x133 = 1 + x92 + x93 + x94;
+	const GEN_FLT x134 = x82 + x84 + x89 + x91 + x132 + x49 * x133;
+	const GEN_FLT x135 = x28 * x131;
+	const GEN_FLT x136 = x104 + x105 + x106 + x107 + x135 + x38 * x133;
+	const GEN_FLT x137 = x44 * x102 * x134 - x109 * x136;
+	const GEN_FLT x138 = -(x60 * x71 * x137);
+	const GEN_FLT x139 = 2 * x51 * x134;
+	const GEN_FLT x140 = x57 * x131;
+	const GEN_FLT x141 = x120 + x121 + x122 + x123 + x140 + x56 * x133;
+	const GEN_FLT x142 = -(x113 * (x117 * (x139 + 2 * x44 * x136) + x125 * x141));
+	const GEN_FLT x143 = x59 * x102 * x134;
+	const GEN_FLT x144 = x109 * x141;
+	const GEN_FLT x145 = 1 + x73 + x78 + x80;
+	const GEN_FLT x146 = x84 + x89 + x91 + x96 + x132 + x46 * x145;
+	const GEN_FLT x147 = x103 + x104 + x105 + x106 + x135 + x43 * x145;
+	const GEN_FLT x148 = x44 * x102 * x146 - x109 * x147;
+	const GEN_FLT x149 = -(x60 * x71 * x148);
+	const GEN_FLT x150 = 2 * x51 * x146;
+	const GEN_FLT x151 = x119 + x120 + x121 + x122 + x140 + x58 * x145;
+	const GEN_FLT x152 = -(x113 * (x117 * (x150 + 2 * x44 * x147) + x125 * x151));
+	const GEN_FLT x153 = x59 * x102 * x146;
+	const GEN_FLT x154 = x109 * x151;
+	const GEN_FLT x155 = pow(x4, -1);
+	const GEN_FLT x156 = -(obj_qi * x10 * x155);
+	const GEN_FLT x157 = pow(x3, x115);
+	const GEN_FLT x158 = pow(x3, x112);
+	const GEN_FLT x159 = ((x7) ? ((-x0) / x157 + x158) : (0));
+	const GEN_FLT x160 = ((x7) ? (obj_qi * (-obj_qk) / x157) : (0));
+	const GEN_FLT x161 = x10 * x160;
+	const GEN_FLT x162 = -x161;
+	const GEN_FLT x163 = ((x7) ? (obj_qi * (-obj_qj) / x157) : (0));
+	const GEN_FLT x164 = x8 * x6 * x163;
+	const GEN_FLT x165 = obj_qi * x10 * x8 * x11 * x155;
+	const GEN_FLT x166 = x11 * x6 * x159;
+	const GEN_FLT x167 = obj_qi * x13 * x5 * x155;
+	const GEN_FLT x168 = obj_qi * x11 * x5 * x155;
+	const GEN_FLT x169 = x10 * x163;
+	const GEN_FLT x170 = x8 * x6 * x160;
+	const GEN_FLT x171 = obj_qi * x10 * x8 * x13 * x155;
+	const GEN_FLT x172 = x13 * x6 * x159;
+	const GEN_FLT x173 =
+		sensor_x * (obj_qi * x10 * x9 * x155 + 2 * x8 * x6 * x159 + x156) + sensor_y * (x164 + x165 + x166 + x162 -
+		x167) + sensor_z * (x168 + x169 + x170 + x171 + x172);
+	const GEN_FLT x174 = obj_qi * x8 * x5 * x155;
+	const GEN_FLT x175 = x10 * x159;
+	const GEN_FLT x176 = x13 * x6 * x163;
+	const GEN_FLT x177 = x11 * x6 * x160;
+	const GEN_FLT x178 = obj_qi * x10 * x13 * x11 * x155;
+	const GEN_FLT x179 = -x169;
+	const GEN_FLT x180 =
+		sensor_y * (x174 + x175 + x176 + x177 + x178) + sensor_x * (x170 + x171 + x172 + x179 - x168) + sensor_z * (2 *
+		x13 * x6 * x160 + obj_qi * x10 * x39 * x155 + x156);
+	const GEN_FLT x181 =
+		sensor_y * (2 * x11 * x6 * x163 + obj_qi * x10 * x31 * x155 + x156) + sensor_x * (x167 + x161 + x164 + x165 +
+		x166) + sensor_z * (x176 + x177 + x178 - x174 - x175);
+	const GEN_FLT x182 = x84 + x89 + x91 + x50 * x173 + x46 * x180 + x49 * x181;
+	const GEN_FLT x183 = x104 + x105 + x106 + x43 * x180 + x38 * x181 + x28 * x173;
+	const GEN_FLT x184 = x44 * x102 * x182 - x109 * x183;
+	const GEN_FLT x185 = -(x60 * x71 * x184);
+	const GEN_FLT x186 = 2 * x51 * x182;
+	const GEN_FLT x187 = x120 + x121 + x122 + x58 * x180 + x56 * x181 + x57 * x173;
+	const GEN_FLT x188 = -(x113 * (x117 * (x186 + 2 * x44 * x183) + x125 * x187));
+	const GEN_FLT x189 = x59 * x102 * x182;
+	const GEN_FLT x190 = x109 * x187;
+	const GEN_FLT x191 = x11 * x6 * x163;
+	const GEN_FLT x192 = obj_qj * x10 * x8 * x11 * x155;
+	const GEN_FLT x193 = ((x7) ? (x158 + (-x1) / x157) : (0));
+	const GEN_FLT x194 = x8 * x6 * x193;
+	const GEN_FLT x195 = ((x7) ? (obj_qj * (-obj_qk) / x157) : (0));
+	const GEN_FLT x196 = x10 * x195;
+	const GEN_FLT x197 = -x196;
+	const GEN_FLT x198 = obj_qj * x13 * x5 * x155;
+	const GEN_FLT x199 = -(obj_qj * x10 * x155);
+	const GEN_FLT x200 = obj_qj * x11 * x5 * x155;
+	const GEN_FLT x201 = x10 * x193;
+	const GEN_FLT x202 = x8 * x6 * x195;
+	const GEN_FLT x203 = obj_qj * x10 * x8 * x13 * x155;
+	const GEN_FLT x204 =
+		sensor_y * (x191 + x192 + x194 + x197 - x198) + sensor_x * (2 * x8 * x6 * x163 + obj_qj * x10 * x9 * x155 +
+		x199) + sensor_z * (x176 + x200 + x201 + x202 + x203);
+	const GEN_FLT x205 = obj_qj * x8 * x5 * x155;
+	const GEN_FLT x206 = x11 * x6 * x195;
+	const GEN_FLT x207 = obj_qj * x10 * x13 * x11 * x155;
+	const GEN_FLT x208 = x13 * x6 * x193;
+	const GEN_FLT x209 =
+		sensor_z * (2 * x13 * x6 * x195 + obj_qj * x10 * x39 * x155 + x199) + sensor_y * (x169 + x205 + x206 + x207 +
+		x208) + sensor_x * (x176 + x202 + x203 - x200 - x201);
+	const GEN_FLT x210 =
+		sensor_z * (x206 + x207 + x208 + x179 - x205) + sensor_x * (x191 + x198 + x196 + x192 + x194) + sensor_y * (2 *
+		x11 * x6 * x193 + obj_qj * x10 * x31 * x155 + x199);
+	const GEN_FLT x211 = x84 + x89 + x91 + x50 * x204 + x46 * x209 + x49 * x210;
+	const GEN_FLT x212 = x104 + x105 + x106 + x43 * x209 + x38 * x210 + x28 * x204;
+	const GEN_FLT x213 = x44 * x102 * x211 - x109 * x212;
+	const GEN_FLT x214 = -(x60 * x71 * x213);
+	const GEN_FLT x215 = 2 * x51 * x211;
+	const GEN_FLT x216 = x120 + x121 + x122 + x58 * x209 + x56 * x210 + x57 * x204;
+	const GEN_FLT x217 = -(x113 * (x117 * (x215 + 2 * x44 * x212) + x125 * x216));
+	const GEN_FLT x218 = x59 * x102 * x211;
+	const GEN_FLT x219 = x109 * x216;
+	const GEN_FLT x220 = obj_qk * x10 * x8 * x11 * x155;
+	const GEN_FLT x221 = obj_qk * x13 * x5 * x155;
+	const GEN_FLT x222 = ((x7) ? (x158 + (-x2) / x157) : (0));
+	const GEN_FLT x223 = x10 * x222;
+	const GEN_FLT x224 = -(obj_qk * x10 * x155);
+	const GEN_FLT x225 = x13 * x6 * x160;
+	const GEN_FLT x226 = obj_qk * x11 * x5 * x155;
+	const GEN_FLT x227 = x8 * x6 * x222;
+	const GEN_FLT x228 = obj_qk * x10 * x8 * x13 * x155;
+	const GEN_FLT x229 =
+		sensor_y * (x177 + x202 + x220 - x221 - x223) + sensor_x * (2 * x8 * x6 * x160 + obj_qk * x10 * x9 * x155 +
+		x224) + sensor_z * (x225 + x196 + x226 + x227 + x228);
+	const GEN_FLT x230 = x13 * x6 * x195;
+	const GEN_FLT x231 = obj_qk * x8 * x5 * x155;
+	const GEN_FLT x232 = x11 * x6 * x222;
+	const GEN_FLT x233 = obj_qk * x10 * x13 * x11 * x155;
+	const GEN_FLT x234 =
+		sensor_z * (2 * x13 * x6 * x222 + obj_qk * x10 * x39 * x155 + x224) + sensor_y * (x161 + x230 + x231 + x232 +
+		x233) + sensor_x * (x225 + x227 + x228 + x197 - x226);
+	const GEN_FLT x235 =
+		sensor_x * (x177 + x202 + x221 + x223 + x220) + sensor_y * (2 * x11 * x6 * x195 + obj_qk * x10 * x31 * x155 +
+		x224) + sensor_z * (x230 + x232 + x233 + x162 - x231);
+	const GEN_FLT x236 = x84 + x89 + x91 + x50 * x229 + x46 * x234 + x49 * x235;
+	const GEN_FLT x237 = x104 + x105 + x106 + x43 * x234 + x38 * x235 + x28 * x229;
+	const GEN_FLT x238 = x44 * x102 * x236 - x109 * x237;
+	const GEN_FLT x239 = -(x60 * x71 * x238);
+	const GEN_FLT x240 = 2 * x51 * x236;
+	const GEN_FLT x241 = x120 + x121 + x122 + x58 * x234 + x56 * x235 + x57 * x229;
+	const GEN_FLT x242 = -(x113 * (x117 * (x240 + 2 * x44 * x237) + x125 * x241));
+	const GEN_FLT x243 = x59 * x102 * x236;
+	const GEN_FLT x244 = x109 * x241;
+	const GEN_FLT x245 = -pow(1 - x61 * x128 * pow(tilt_1, 2), x112);
+	const GEN_FLT x246 = x44 * tilt_1 * x114 / pow(x67, x115);
+	const GEN_FLT x247 = -x246;
+	const GEN_FLT x248 = tilt_1 / x68;
+	const GEN_FLT x249 = x245 * (x247 * (x118 + 2 * x59 * x124) + x108 * x248);
+	const GEN_FLT x250 = -(x60 * x128 * (x130 - x129));
+	const GEN_FLT x251 = sin(1.5707963267949 + gibPhase_1 + x70 - phase_1 - asin(x44 * x248));
+	const GEN_FLT x252 = x245 * (x136 * x248 - x246 * (x139 + 2 * x59 * x141));
+	const GEN_FLT x253 = -(x60 * x128 * (x144 - x143));
+	const GEN_FLT x254 = x245 * (x147 * x248 - x246 * (x150 + 2 * x59 * x151));
+	const GEN_FLT x255 = -(x60 * x128 * (x154 - x153));
+	const GEN_FLT x256 = x245 * (x183 * x248 - x246 * (x186 + 2 * x59 * x187));
+	const GEN_FLT x257 = -(x60 * x128 * (x190 - x189));
+	const GEN_FLT x258 = x245 * (x212 * x248 - x246 * (x215 + 2 * x59 * x216));
+	const GEN_FLT x259 = -(x60 * x128 * (x219 - x218));
+	const GEN_FLT x260 = x245 * (x237 * x248 - x246 * (x240 + 2 * x59 * x241));
+	const GEN_FLT x261 = -(x60 * x128 * (x244 - x243));
+	const GEN_FLT x262 = x82 + x84 + x89 + x91 + x96 + x132;
+	const GEN_FLT x263 = x44 * x102 * x262;
+	const GEN_FLT x264 = 1 + x103 + x104 + x105 + x106 + x107 + x135;
+	const GEN_FLT x265 = x263 - x109 * x264;
+	const GEN_FLT x266 = -(x60 * x71 * x265);
+	const GEN_FLT x267 = x119 + x120 + x121 + x122 + x123 + x140;
+	const GEN_FLT x268 = x125 * x267;
+	const GEN_FLT x269 = 2 * x51 * x262;
+	const GEN_FLT x270 = -(x113 * (x268 - x116 * (x269 + 2 * x44 * x264)));
+	const GEN_FLT x271 = x59 * x102 * x262;
+	const GEN_FLT x272 = x109 * x267;
+	const GEN_FLT x273 = -x272;
+	const GEN_FLT x274 = x103 + x104 + x105 + x106 + x107 + x135;
+	const GEN_FLT x275 = x274 * (-x109);
+	const GEN_FLT x276 = x263 + x275;
+	const GEN_FLT x277 = -(x60 * x71 * x276);
+	const GEN_FLT x278 = 1 + x119 + x120 + x121 + x122 + x123 + x140;
+	const GEN_FLT x279 = 2 * x44 * x274;
+	const GEN_FLT x280 = -(x113 * (x125 * x278 - x116 * (x269 + x279)));
+	const GEN_FLT x281 = x109 * x278;
+	const GEN_FLT x282 = 1 + x82 + x84 + x89 + x91 + x96 + x132;
+	const GEN_FLT x283 = x275 + x44 * x102 * x282;
+	const GEN_FLT x284 = -(x60 * x71 * x283);
+	const GEN_FLT x285 = 2 * x51 * x282;
+	const GEN_FLT x286 = -(x113 * (x268 - x116 * (x279 + x285)));
+	const GEN_FLT x287 = x59 * x102 * x282;
+	const GEN_FLT x288 = pow(x21, x115);
+	const GEN_FLT x289 = ((x25) ? (lh_qi * (-lh_qj) / x288) : (0));
+	const GEN_FLT x290 = x35 * x289;
+	const GEN_FLT x291 = -x290;
+	const GEN_FLT x292 = ((x25) ? (lh_qi * (-lh_qk) / x288) : (0));
+	const GEN_FLT x293 = x26 * x24 * x292;
+	const GEN_FLT x294 = pow(x22, -1);
+	const GEN_FLT x295 = lh_qi * x26 * x35 * x36 * x294;
+	const GEN_FLT x296 = pow(x21, x112);
+	const GEN_FLT x297 = ((x25) ? ((-x18) / x288 + x296) : (0));
+	const GEN_FLT x298 = x36 * x24 * x297;
+	const GEN_FLT x299 = lh_qi * x33 * x23 * x294;
+	const GEN_FLT x300 = x35 * x297;
+	const GEN_FLT x301 = lh_qi * x26 * x23 * x294;
+	const GEN_FLT x302 = x36 * x24 * x289;
+	const GEN_FLT x303 = x33 * x24 * x292;
+	const GEN_FLT x304 = lh_qi * x35 * x36 * x33 * x294;
+	const GEN_FLT x305 = -(lh_qi * x35 * x294);
+	const GEN_FLT x306 =
+		x82 + x96 + x132 + x17 * (x293 + x295 + x298 + x291 - x299) + x32 * (x300 + x301 + x302 + x303 + x304) + x40 *
+		(2 * x36 * x24 * x292 + lh_qi * x35 * x45 * x294 + x305);
+	const GEN_FLT x307 = x35 * x292;
+	const GEN_FLT x308 = -x307;
+	const GEN_FLT x309 = x26 * x24 * x289;
+	const GEN_FLT x310 = lh_qi * x26 * x35 * x33 * x294;
+	const GEN_FLT x311 = x33 * x24 * x297;
+	const GEN_FLT x312 = lh_qi * x36 * x23 * x294;
+	const GEN_FLT x313 =
+		x103 + x107 + x135 + x17 * (2 * x26 * x24 * x297 + lh_qi * x35 * x27 * x294 + x305) + x32 * (x309 + x310 + x311
+		+ x308 - x312) + x40 * (x290 + x299 + x293 + x295 + x298);
+	const GEN_FLT x314 = x44 * x102 * x306 - x109 * x313;
+	const GEN_FLT x315 = -(x60 * x71 * x314);
+	const GEN_FLT x316 =
+		x119 + x123 + x140 + x17 * (x307 + x312 + x309 + x310 + x311) + x32 * (2 * x33 * x24 * x289 + lh_qi * x35 * x55
+		* x294 + x305) + x40 * (x302 + x303 + x304 - x300 - x301);
+	const GEN_FLT x317 = 2 * x51 * x306;
+	const GEN_FLT x318 = -(x113 * (x125 * x316 - x116 * (x317 + 2 * x44 * x313)));
+	const GEN_FLT x319 = x59 * x102 * x306;
+	const GEN_FLT x320 = x109 * x316;
+	const GEN_FLT x321 = ((x25) ? (lh_qj * (-lh_qk) / x288) : (0));
+	const GEN_FLT x322 = x26 * x24 * x321;
+	const GEN_FLT x323 = lh_qj * x26 * x35 * x36 * x294;
+	const GEN_FLT x324 = ((x25) ? (x296 + (-x19) / x288) : (0));
+	const GEN_FLT x325 = x35 * x324;
+	const GEN_FLT x326 = lh_qj * x33 * x23 * x294;
+	const GEN_FLT x327 = lh_qj * x26 * x23 * x294;
+	const GEN_FLT x328 = x33 * x24 * x321;
+	const GEN_FLT x329 = lh_qj * x35 * x36 * x33 * x294;
+	const GEN_FLT x330 = x36 * x24 * x324;
+	const GEN_FLT x331 = -(lh_qj * x35 * x294);
+	const GEN_FLT x332 =
+		x82 + x96 + x132 + x17 * (x302 + x322 + x323 - x325 - x326) + x32 * (x290 + x327 + x328 + x329 + x330) + x40 *
+		(2 * x36 * x24 * x321 + lh_qj * x35 * x45 * x294 + x331);
+	const GEN_FLT x333 = x33 * x24 * x289;
+	const GEN_FLT x334 = x35 * x321;
+	const GEN_FLT x335 = -x334;
+	const GEN_FLT x336 = lh_qj * x26 * x35 * x33 * x294;
+	const GEN_FLT x337 = x26 * x24 * x324;
+	const GEN_FLT x338 = lh_qj * x36 * x23 * x294;
+	const GEN_FLT x339 =
+		x103 + x107 + x135 + x17 * (2 * x26 * x24 * x289 + lh_qj * x35 * x27 * x294 + x331) + x32 * (x333 + x336 + x337
+		+ x335 - x338) + x40 * (x302 + x325 + x326 + x322 + x323);
+	const GEN_FLT x340 = x44 * x102 * x332 - x109 * x339;
+	const GEN_FLT x341 = -(x60 * x71 * x340);
+	const GEN_FLT x342 =
+		x119 + x123 + x140 + x17 * (x333 + x334 + x338 + x336 + x337) + x32 * (2 * x33 * x24 * x324 + lh_qj * x35 * x55
+		* x294 + x331) + x40 * (x328 + x329 + x330 + x291 - x327);
+	const GEN_FLT x343 = 2 * x51 * x332;
+	const GEN_FLT x344 = -(x113 * (x125 * x342 - x116 * (x343 + 2 * x44 * x339)));
+	const GEN_FLT x345 = x59 * x102 * x332;
+	const GEN_FLT x346 = x109 * x342;
+	const GEN_FLT x347 = x36 * x24 * x292;
+	const GEN_FLT x348 = ((x25) ? (x296 + (-x20) / x288) : (0));
+	const GEN_FLT x349 = x26 * x24 * x348;
+	const GEN_FLT x350 = lh_qk * x26 * x35 * x36 * x294;
+	const GEN_FLT x351 = lh_qk * x33 * x23 * x294;
+	const GEN_FLT x352 = x36 * x24 * x321;
+	const GEN_FLT x353 = lh_qk * x26 * x23 * x294;
+	const GEN_FLT x354 = lh_qk * x35 * x36 * x33 * x294;
+	const GEN_FLT x355 = x33 * x24 * x348;
+	const GEN_FLT x356 = -(lh_qk * x35 * x294);
+	const GEN_FLT x357 =
+		x82 + x96 + x132 + x17 * (x347 + x349 + x350 + x335 - x351) + x32 * (x307 + x352 + x353 + x354 + x355) + x40 *
+		(2 * x36 * x24 * x348 + lh_qk * x35 * x45 * x294 + x356);
+	const GEN_FLT x358 = lh_qk * x26 * x35 * x33 * x294;
+	const GEN_FLT x359 = x35 * x348;
+	const GEN_FLT x360 = lh_qk * x36 * x23 * x294;
+	const GEN_FLT x361 =
+		x103 + x107 + x135 + x17 * (2 * x26 * x24 * x292 + lh_qk * x35 * x27 * x294 + x356) + x32 * (x303 + x322 + x358
+		- x359 - x360) + x40 * (x347 + x334 + x351 + x349 + x350);
+	const GEN_FLT x362 = x44 * x102 * x357 - x109 * x361;
+	const GEN_FLT x363 = -(x60 * x71 * x362);
+	const GEN_FLT x364 =
+		x119 + x123 + x140 + x17 * (x303 + x322 + x359 + x360 + x358) + x32 * (2 * x33 * x24 * x321 + lh_qk * x35 * x55
+		* x294 + x356) + x40 * (x352 + x354 + x355 + x308 - x353);
+	const GEN_FLT x365 = 2 * x51 * x357;
+	const GEN_FLT x366 = -(x113 * (x125 * x364 - x116 * (x365 + 2 * x44 * x361)));
+	const GEN_FLT x367 = x59 * x102 * x357;
+	const GEN_FLT x368 = x109 * x364;
+	const GEN_FLT x369 = 2 * x59 * x267;
+	const GEN_FLT x370 = x245 * (x247 * (x269 + x369) + x248 * x264);
+	const GEN_FLT x371 = -x271;
+	const GEN_FLT x372 = -(x60 * x128 * (x272 + x371));
+	const GEN_FLT x373 = x248 * x274;
+	const GEN_FLT x374 = x245 * (x373 - x246 * (x269 + 2 * x59 * x278));
+	const GEN_FLT x375 = -(x60 * x128 * (x281 + x371));
+	const GEN_FLT x376 = x245 * (x373 - x246 * (x285 + x369));
+	const GEN_FLT x377 = -(x60 * x128 * (x272 - x287));
+	const GEN_FLT x378 = x245 * (x248 * x313 - x246 * (x317 + 2 * x59 * x316));
+	const GEN_FLT x379 = -(x60 * x128 * (x320 - x319));
+	const GEN_FLT x380 = x245 * (x248 * x339 - x246 * (x343 + 2 * x59 * x342));
+	const GEN_FLT x381 = -(x60 * x128 * (x346 - x345));
+	const GEN_FLT x382 = x245 * (x248 * x361 - x246 * (x365 + 2 * x59 * x364));
+	const GEN_FLT x383 = -(x60 * x128 * (x368 - x367));
+	*(out++) =
+		pow(x65, 2) * curve_0 + x54 + x64 - phase_0 - cos(1.5707963267949 + gibPhase_0 + x54 + x64 - phase_0) *
+		gibMag_0;
+	*(out++) =
+		pow(x53, 2) * curve_1 + x69 + x70 - phase_1 - cos(1.5707963267949 + gibPhase_1 + x69 + x70 - phase_1) *
+		gibMag_1;
+	*(out++) = gibMag_0 * (x111 + x126) * x127 + 2 * x60 * x65 * curve_0 * x128 * (x129 - x130) + x111 + x126;
+	*(out++) = gibMag_0 * x127 * (x138 + x142) + 2 * x60 * x65 * curve_0 * x128 * (x143 - x144) + x138 + x142;
+	*(out++) = gibMag_0 * x127 * (x149 + x152) + 2 * x60 * x65 * curve_0 * x128 * (x153 - x154) + x149 + x152;
+	*(out++) = gibMag_0 * x127 * (x185 + x188) + 2 * x60 * x65 * curve_0 * x128 * (x189 - x190) + x185 + x188;
+	*(out++) = gibMag_0 * x127 * (x214 + x217) + 2 * x60 * x65 * curve_0 * x128 * (x218 - x219) + x214 + x217;
+	*(out++) = gibMag_0 * x127 * (x239 + x242) + 2 * x60 * x65 * curve_0 * x128 * (x243 - x244) + x239 + x242;
+	*(out++) = x249 + gibMag_1 * (x249 + x250) * x251 + 2 * x60 * x53 * curve_1 * x71 * x110 + x250;
+	*(out++) = x252 + gibMag_1 * x251 * (x252 + x253) + 2 * x60 * x53 * curve_1 * x71 * x137 + x253;
+	*(out++) = x254 + gibMag_1 * x251 * (x254 + x255) + 2 * x60 * x53 * curve_1 * x71 * x148 + x255;
+	*(out++) = x256 + gibMag_1 * x251 * (x256 + x257) + 2 * x60 * x53 * curve_1 * x71 * x184 + x257;
+	*(out++) = x258 + gibMag_1 * x251 * (x258 + x259) + 2 * x60 * x53 * curve_1 * x71 * x213 + x259;
+	*(out++) = x260 + gibMag_1 * x251 * (x260 + x261) + 2 * x60 * x53 * curve_1 * x71 * x238 + x261;
+	*(out++) = gibMag_0 * x127 * (x266 + x270) + 2 * x60 * x65 * curve_0 * x128 * (x271 + x273) + x266 + x270;
+	*(out++) = gibMag_0 * x127 * (x277 + x280) + 2 * x60 * x65 * curve_0 * x128 * (x271 - x281) + x277 + x280;
+	*(out++) = gibMag_0 * x127 * (x284 + x286) + 2 * x60 * x65 * curve_0 * x128 * (x287 + x273) + x284 + x286;
+	*(out++) = gibMag_0 * x127 * (x315 + x318) + 2 * x60 * x65 * curve_0 * x128 * (x319 - x320) + x315 + x318;
+	*(out++) = gibMag_0 * x127 * (x341 + x344) + 2 * x60 * x65 * curve_0 * x128 * (x345 - x346) + x341 + x344;
+	*(out++) = gibMag_0 * x127 * (x363 + x366) + 2 * x60 * x65 * curve_0 * x128 * (x367 - x368) + x363 + x366;
+	*(out++) = x370 + gibMag_1 * x251 * (x370 + x372) + 2 * x60 * x53 * curve_1 * x71 * x265 + x372;
+	*(out++) = x374 + gibMag_1 * x251 * (x374 + x375) + 2 * x60 * x53 * curve_1 * x71 * x276 + x375;
+	*(out++) = x376 + gibMag_1 * x251 * (x376 + x377) + 2 * x60 * x53 * curve_1 * x71 * x283 + x377;
+	*(out++) = x378 + gibMag_1 * x251 * (x378 + x379) + 2 * x60 * x53 * curve_1 * x71 * x314 + x379;
+	*(out++) = x380 + gibMag_1 * x251 * (x380 + x381) + 2 * x60 * x53 * curve_1 * x71 * x340 + x381;
+	*(out++) = x382 + gibMag_1 * x251 * (x382 + x383) + 2 * x60 * x53 * curve_1 * x71 * x362 + x383;
+}
@@ -0,0 +1,548 @@
+#include "survive_sba.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SBA_CAL_FIELDS (sizeof(BaseStationCal) / sizeof(FLT))
+#define SBA_MAX_BLOCK_LEN (6 + 2 * SBA_CAL_FIELDS)
+
+// Step for central differences; the calibration never has analytic jacobians, poses only lack them for some models
+#define SBA_NUMERIC_STEP 1e-6
+#define SBA_MIN_DAMPING 1e-9
+
+typedef struct sba_params {
+	LinmathAxisAnglePose world2lh[NUM_GEN2_LIGHTHOUSES];
+	BaseStationCal fcal[NUM_GEN2_LIGHTHOUSES][2];
+	LinmathAxisAnglePose *poses;
+} sba_params;
+
+// Normal equations of a single object pose, as of the last linearization
+typedef struct sba_pose_block {
+	double U[36];
+	double g[6];
+
+	// Lighthouses this pose has measurements for. W holds the coupling to just their columns of the reduced system;
+	// 6 rows of w_cols each.
+	uint32_t touched;
+	int w_cols;
+	double *W;
+
+	const survive_optimizer_measurement *meas;
+	size_t meas_cnt;
+} sba_pose_block;
+
+typedef struct sba_state {
+	const survive_sba *sba;
+	sba_params current, trial;
+
+	// Layout of the reduced system. Each lighthouse owns a contiguous block of columns: its 6 pose parameters if they
+	// are free, then the free calibration fields of the x axis and of the y axis.
+	int block_start[NUM_GEN2_LIGHTHOUSES];
+	int block_len[NUM_GEN2_LIGHTHOUSES];
+	bool block_has_pose[NUM_GEN2_LIGHTHOUSES];
+	int cal_fields[SBA_CAL_FIELDS];
+	int cal_field_cnt;
+	int L;
+
+	sba_pose_block *blocks;
+	size_t block_cnt;
+
+	// V and g are the lighthouse rows of the normal equations, S the reduced system; L x L or L
+	double *V, *g, *S, *rhs, *delta;
+	// Scratch for one pose; 6 x L and L
+	double *Y;
+	int *cols;
+	size_t skipped_poses;
+} sba_state;
+
+// Factors the n x n symmetric matrix A in place into its lower cholesky factor; false if A isn't positive definite
+static bool sba_cholesky(double *A, int n) {
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j <= i; j++) {
+			double sum = A[i * n + j];
+			for (int k = 0; k < j; k++)
+				sum -= A[i * n + k] * A[j * n + k];
+
+			if (i == j) {
+				if (sum <= 0 || !isfinite(sum))
+					return false;
+				A[i * n + i] = sqrt(sum);
+			} else {
+				A[i * n + j] = sum / A[j * n + j];
+			}
+		}
+	}
+	return true;
+}
+
+// Solves L * L^T * x = b in place, with L from sba_cholesky
+static void sba_cholesky_solve(const double *L, int n, double *b) {
+	for (int i = 0; i < n; i++) {
+		for (int k = 0; k < i; k++)
+			b[i] -= L[i * n + k] * b[k];
+		b[i] /= L[i * n + i];
+	}
+	for (int i = n - 1; i >= 0; i--) {
+		for (int k = i + 1; k < n; k++)
+			b[i] -= L[k * n + i] * b[k];
+		b[i] /= L[i * n + i];
+	}
+}
+
+static inline FLT sba_reproject(const survive_reproject_model_t *model, int axis, const LinmathAxisAnglePose *obj2world,
+								const LinmathAxisAnglePose *world2lh, const BaseStationCal *cal, const FLT *pt) {
+	LinmathPoint3d ptInWorld, ptInLh;
+	ApplyAxisAnglePoseToPoint(ptInWorld, obj2world, pt);
+	ApplyAxisAnglePoseToPoint(ptInLh, world2lh, ptInWorld);
+	return model->reprojectAxisFn[axis](cal, ptInLh);
+}
+
+static inline FLT sba_deviate(const sba_state *state, const sba_params *params, const LinmathAxisAnglePose *obj2world,
+							  const survive_optimizer_measurement *meas) {
+	const survive_sba *sba = state->sba;
+	FLT angle = sba_reproject(sba->reprojectModel, meas->axis, obj2world, &params->world2lh[meas->lh],
+							  params->fcal[meas->lh], &sba->sensor_locations[meas->sensor_idx * 3]);
+	return (angle - meas->value) / meas->variance;
+}
+
+// Central differences of the reprojection with respect to values[indices[i]]. 'values' points into one of the
+// arguments, which are perturbed in place and restored.
+static void sba_numeric_jacobian(FLT *out, FLT *values, const int *indices, int cnt,
+								 const survive_reproject_model_t *model, int axis, LinmathAxisAnglePose *obj2world,
+								 LinmathAxisAnglePose *world2lh, BaseStationCal *cal, const FLT *pt) {
+	for (int i = 0; i < cnt; i++) {
+		FLT *v = &values[indices ? indices[i] : i];
+		FLT orig = *v;
+		*v = orig + SBA_NUMERIC_STEP;
+		FLT hi = sba_reproject(model, axis, obj2world, world2lh, cal, pt);
+		*v = orig - SBA_NUMERIC_STEP;
+		FLT lo = sba_reproject(model, axis, obj2world, world2lh, cal, pt);
+		*v = orig;
+		out[i] = (hi - lo) / (2 * SBA_NUMERIC_STEP);
+	}
+}
+
+// Weighted jacobian of one measurement; 'jp' for the object pose and 'jc' for the block of its lighthouse
+static void sba_jacobian(const sba_state *state, const LinmathAxisAnglePose *obj2world,
+						 const survive_optimizer_measurement *meas, FLT *jp, FLT *jc) {
+	const survive_sba *sba = state->sba;
+	const survive_reproject_model_t *model = sba->reprojectModel;
+	const int lh = meas->lh, axis = meas->axis;
+	const FLT *pt = &sba->sensor_locations[meas->sensor_idx * 3];
+	const FLT scale = 1. / meas->variance;
+
+	BaseStationCal cal[2] = {state->current.fcal[lh][0], state->current.fcal[lh][1]};
+	LinmathAxisAnglePose safe_pose = *obj2world, safe_world2lh = state->current.world2lh[lh];
+	if (magnitude3d(safe_pose.AxisAngleRot) == 0)
+		safe_pose.AxisAngleRot[0] = 1e-10;
+	if (magnitude3d(safe_world2lh.AxisAngleRot) == 0)
+		safe_world2lh.AxisAngleRot[0] = 1e-10;
+
+	if (model->reprojectAxisAngleAxisJacobFn[axis]) {
+		model->reprojectAxisAngleAxisJacobFn[axis](jp, &safe_pose, pt, &safe_world2lh, cal);
+	} else {
+		sba_numeric_jacobian(jp, safe_pose.Pos, 0, 6, model, axis, &safe_pose, &safe_world2lh, cal, pt);
+	}
+	for (int i = 0; i < 6; i++)
+		jp[i] *= scale;
+
+	int col = 0;
+	if (state->block_has_pose[lh]) {
+		if (model->reprojectAxisAngleAxisJacobLhPoseFn[axis]) {
+			model->reprojectAxisAngleAxisJacobLhPoseFn[axis](jc, &safe_pose, pt, &safe_world2lh, cal);
+		} else {
+			sba_numeric_jacobian(jc, safe_world2lh.Pos, 0, 6, model, axis, &safe_pose, &safe_world2lh, cal, pt);
+		}
+		col = 6;
+	}
+
+	// Each axis only depends on its own calibration
+	for (int a = 0; a < 2; a++) {
+		if (a == axis) {
+			sba_numeric_jacobian(jc + col, (FLT *)&cal[a], state->cal_fields, state->cal_field_cnt, model, axis,
+								 &safe_pose, &safe_world2lh, cal, pt);
+		} else {
+			memset(jc + col, 0, sizeof(FLT) * state->cal_field_cnt);
+		}
+		col += state->cal_field_cnt;
+	}
+
+	for (int i = 0; i < col; i++)
+		jc[i] *= scale;
+}
+
+// Global columns of the lighthouses in 'touched', in the order a pose block's W stores them; returns the count.
+// 'cols' can be null to only count them.
+static int sba_block_columns(const sba_state *state, uint32_t touched, int *cols) {
+	int cnt = 0;
+	for (int lh = 0; lh < state->sba->lighthouseCnt; lh++) {
+		if (touched & (1u << lh)) {
+			for (int i = 0; i < state->block_len[lh]; i++, cnt++) {
+				if (cols)
+					cols[cnt] = state->block_start[lh] + i;
+			}
+		}
+	}
+	return cnt;
+}
+
+/**
+ * Evaluates the jacobians at the current estimate and builds the normal equations from them: a pose block per object
+ * pose, and the lighthouse rows in state->V and state->g. Every damped solve until the next step is accepted reuses
+ * them, so this is the only pass that computes jacobians.
+ */
+static void sba_linearize(sba_state *state) {
+	const int L = state->L;
+	memset(state->V, 0, sizeof(double) * L * L);
+	memset(state->g, 0, sizeof(double) * L);
+
+	for (size_t b = 0; b < state->block_cnt; b++) {
+		sba_pose_block *block = &state->blocks[b];
+		const LinmathAxisAnglePose *pose = &state->current.poses[block->meas->object];
+		memset(block->U, 0, sizeof(block->U));
+		memset(block->g, 0, sizeof(block->g));
+		memset(block->W, 0, sizeof(double) * 6 * block->w_cols);
+
+		int w_offset[NUM_GEN2_LIGHTHOUSES], offset = 0;
+		for (int lh = 0; lh < state->sba->lighthouseCnt; lh++) {
+			w_offset[lh] = offset;
+			if (block->touched & (1u << lh))
+				offset += state->block_len[lh];
+		}
+
+		for (size_t i = 0; i < block->meas_cnt; i++) {
+			const survive_optimizer_measurement *meas = &block->meas[i];
+			const int start = state->block_start[meas->lh], len = state->block_len[meas->lh];
+			double *W = block->W + w_offset[meas->lh];
+
+			FLT jp[7], jc[SBA_MAX_BLOCK_LEN + 1];
+			FLT r = sba_deviate(state, &state->current, pose, meas);
+			sba_jacobian(state, pose, meas, jp, jc);
+
+			for (int a = 0; a < 6; a++) {
+				block->g[a] += jp[a] * r;
+				for (int c = 0; c <= a; c++)
+					block->U[a * 6 + c] += jp[a] * jp[c];
+				for (int c = 0; c < len; c++)
+					W[a * block->w_cols + c] += jp[a] * jc[c];
+			}
+
+			for (int c = 0; c < len; c++) {
+				state->g[start + c] += jc[c] * r;
+				for (int d = 0; d < len; d++)
+					state->V[(start + c) * L + start + d] += jc[c] * jc[d];
+			}
+		}
+
+		for (int a = 0; a < 6; a++) {
+			for (int c = 0; c < a; c++)
+				block->U[c * 6 + a] = block->U[a * 6 + c];
+		}
+	}
+}
+
+// Damps a pose block and factors it into U; false if the pose can't be solved for
+static bool sba_factor_pose(const sba_pose_block *block, double lambda, double *U) {
+	memcpy(U, block->U, sizeof(block->U));
+	for (int a = 0; a < 6; a++)
+		U[a * 6 + a] *= 1 + lambda;
+	return sba_cholesky(U, 6);
+}
+
+/**
+ * Eliminates every object pose from the damped normal equations and solves what remains for the lighthouse step,
+ * into state->delta. False if the reduced system isn't positive definite.
+ */
+static bool sba_solve_lighthouses(sba_state *state, double lambda) {
+	const int L = state->L;
+	memset(state->S, 0, sizeof(double) * L * L);
+	for (int i = 0; i < L; i++)
+		state->rhs[i] = -state->g[i];
+	state->skipped_poses = 0;
+
+	int *cols = state->cols;
+	for (size_t b = 0; b < state->block_cnt; b++) {
+		const sba_pose_block *block = &state->blocks[b];
+		const int n = block->w_cols;
+
+		// A pose that can't be solved for is held fixed; its measurements then only constrain the lighthouses
+		double U[36];
+		if (!sba_factor_pose(block, lambda, U)) {
+			state->skipped_poses++;
+			continue;
+		}
+
+		double z[6];
+		memcpy(z, block->g, sizeof(z));
+		sba_cholesky_solve(U, 6, z);
+
+		for (int k = 0; k < n; k++) {
+			double y[6];
+			for (int a = 0; a < 6; a++)
+				y[a] = block->W[a * n + k];
+			sba_cholesky_solve(U, 6, y);
+			for (int a = 0; a < 6; a++)
+				state->Y[a * n + k] = y[a];
+		}
+
+		sba_block_columns(state, block->touched, cols);
+		for (int k = 0; k < n; k++) {
+			for (int a = 0; a < 6; a++)
+				state->rhs[cols[k]] += block->W[a * n + k] * z[a];
+
+			for (int l = 0; l < n; l++) {
+				double v = 0;
+				for (int a = 0; a < 6; a++)
+					v += block->W[a * n + k] * state->Y[a * n + l];
+				state->S[cols[k] * L + cols[l]] -= v;
+			}
+		}
+	}
+
+	for (int i = 0; i < L * L; i++)
+		state->S[i] += state->V[i];
+	// Calibration fields can have no effect at all at the current estimate -- gibpha while gibmag is 0 -- so the
+	// damping has a floor to keep those columns from making S singular
+	for (int i = 0; i < L; i++)
+		state->S[i * L + i] += lambda * fmax(state->V[i * L + i], SBA_MIN_DAMPING);
+
+	if (L == 0)
+		return true;
+	if (!sba_cholesky(state->S, L))
+		return false;
+
+	memcpy(state->delta, state->rhs, sizeof(double) * L);
+	sba_cholesky_solve(state->S, L, state->delta);
+	return true;
+}
+
+// Applies the lighthouse step to state->trial, back substitutes each pose's step and returns the resulting norm
+static double sba_apply_step(sba_state *state, double lambda) {
+	const survive_sba *sba = state->sba;
+	const double *delta = state->delta;
+
+	for (int lh = 0; lh < sba->lighthouseCnt; lh++) {
+		state->trial.world2lh[lh] = state->current.world2lh[lh];
+		memcpy(state->trial.fcal[lh], state->current.fcal[lh], sizeof(state->trial.fcal[lh]));
+
+		const double *d = delta + state->block_start[lh];
+		if (state->block_len[lh] == 0)
+			continue;
+		if (state->block_has_pose[lh]) {
+			FLT *p = state->trial.world2lh[lh].Pos;
+			for (int i = 0; i < 6; i++)
+				p[i] += d[i];
+			d += 6;
+		}
+		for (int a = 0; a < 2; a++) {
+			FLT *cal = (FLT *)&state->trial.fcal[lh][a];
+			for (int f = 0; f < state->cal_field_cnt; f++)
+				cal[state->cal_fields[f]] += *d++;
+		}
+	}
+
+	double chi2 = 0;
+	int *cols = state->cols;
+	for (size_t b = 0; b < state->block_cnt; b++) {
+		const sba_pose_block *block = &state->blocks[b];
+		const int n = block->w_cols;
+		const int object = block->meas->object;
+		LinmathAxisAnglePose *trial_pose = &state->trial.poses[object];
+		*trial_pose = state->current.poses[object];
+
+		double U[36];
+		if (sba_factor_pose(block, lambda, U)) {
+			sba_block_columns(state, block->touched, cols);
+
+			double step[6];
+			for (int a = 0; a < 6; a++) {
+				step[a] = -block->g[a];
+				for (int k = 0; k < n; k++)
+					step[a] -= block->W[a * n + k] * delta[cols[k]];
+			}
+			sba_cholesky_solve(U, 6, step);
+
+			FLT *p = trial_pose->Pos;
+			for (int i = 0; i < 6; i++)
+				p[i] += step[i];
+		}
+
+		for (size_t i = 0; i < block->meas_cnt; i++) {
+			FLT dev = sba_deviate(state, &state->trial, trial_pose, &block->meas[i]);
+			chi2 += dev * dev;
+		}
+	}
+	return chi2;
+}
+
+static double sba_norm(const sba_state *state) {
+	const survive_sba *sba = state->sba;
+	double chi2 = 0;
+	for (size_t i = 0; i < sba->measurementsCnt; i++) {
+		const survive_optimizer_measurement *meas = &sba->measurements[i];
+		FLT dev = sba_deviate(state, &state->current, &state->current.poses[meas->object], meas);
+		chi2 += dev * dev;
+	}
+	return chi2;
+}
+
+static void sba_to_axis_angle(LinmathAxisAnglePose *out, const SurvivePose *pose) {
+	LinmathAxisAngleMag aa;
+	quattoaxisanglemag(aa, pose->Rot);
+	copy3d(out->Pos, pose->Pos);
+	copy3d(out->AxisAngleRot, aa);
+}
+
+static void sba_from_axis_angle(SurvivePose *out, const LinmathAxisAnglePose *pose) {
+	copy3d(out->Pos, pose->Pos);
+	quatfromaxisangle(out->Rot, pose->AxisAngleRot, norm3d(pose->AxisAngleRot));
+}
+
+static bool sba_validate(const survive_sba *sba, uint32_t *seen) {
+	if (sba->reprojectModel == 0 || sba->sensor_locations == 0 || sba->lighthouseCnt < 0 ||
+		sba->lighthouseCnt > NUM_GEN2_LIGHTHOUSES) {
+		return false;
+	}
+
+	*seen = 0;
+	for (size_t i = 0; i < sba->measurementsCnt; i++) {
+		const survive_optimizer_measurement *meas = &sba->measurements[i];
+		if (meas->object < 0 || meas->object >= sba->poseCnt || meas->lh >= sba->lighthouseCnt || meas->axis > 1 ||
+			meas->variance <= 0) {
+			return false;
+		}
+		if (i > 0 && meas->object < meas[-1].object) {
+			return false;
+		}
+		*seen |= 1u << meas->lh;
+	}
+	return true;
+}
+
+int survive_sba_run(survive_sba *sba, survive_sba_result *result) {
+	uint32_t seen;
+	if (!sba_validate(sba, &seen)) {
+		return -1;
+	}
+
+	const int max_iterations = sba->max_iterations > 0 ? sba->max_iterations : 50;
+	const double ftol = sba->ftol > 0 ? sba->ftol : 1e-10;
+
+	sba_state state = {.sba = sba};
+	for (int f = 0; f < SBA_CAL_FIELDS; f++) {
+		if (sba->cal_mask & (1u << f))
+			state.cal_fields[state.cal_field_cnt++] = f;
+	}
+
+	// Lighthouses without measurements would make the reduced system singular; they keep their place but get no columns
+	for (int lh = 0; lh < sba->lighthouseCnt; lh++) {
+		SurvivePose world2lh = InvertPoseRtn(&sba->lighthouses[lh]);
+		sba_to_axis_angle(&state.current.world2lh[lh], &world2lh);
+		memcpy(state.current.fcal[lh], sba->fcal[lh], sizeof(state.current.fcal[lh]));
+
+		state.block_start[lh] = state.L;
+		if (seen & (1u << lh)) {
+			state.block_has_pose[lh] = (sba->fixed_lighthouses & (1u << lh)) == 0;
+			state.block_len[lh] = (state.block_has_pose[lh] ? 6 : 0) + 2 * state.cal_field_cnt;
+		}
+		state.L += state.block_len[lh];
+	}
+	state.trial = state.current;
+
+	// One block per run of measurements of the same pose; their W rows share one allocation
+	size_t w_size = 0;
+	state.blocks = SV_CALLOC(sba->poseCnt + 1, sizeof(sba_pose_block));
+	for (size_t begin = 0, cnt; begin < sba->measurementsCnt; begin += cnt) {
+		const survive_optimizer_measurement *meas = &sba->measurements[begin];
+		uint32_t touched = 0;
+		for (cnt = 0; begin + cnt < sba->measurementsCnt && meas[cnt].object == meas->object; cnt++)
+			touched |= 1u << meas[cnt].lh;
+
+		sba_pose_block *block = &state.blocks[state.block_cnt++];
+		*block = (sba_pose_block){.touched = touched, .meas = meas, .meas_cnt = cnt};
+		block->w_cols = sba_block_columns(&state, touched, 0);
+		w_size += 6 * block->w_cols;
+	}
+
+	const int L = state.L;
+	double *w_buffer = SV_CALLOC(w_size + 1, sizeof(double));
+	for (size_t b = 0, offset = 0; b < state.block_cnt; b++) {
+		state.blocks[b].W = w_buffer + offset;
+		offset += 6 * state.blocks[b].w_cols;
+	}
+
+	state.current.poses = SV_CALLOC(sba->poseCnt, sizeof(LinmathAxisAnglePose));
+	state.trial.poses = SV_CALLOC(sba->poseCnt, sizeof(LinmathAxisAnglePose));
+	state.V = SV_CALLOC(2 * L * L + 9 * L + 1, sizeof(double));
+	state.S = state.V + L * L;
+	state.g = state.S + L * L;
+	state.rhs = state.g + L;
+	state.delta = state.rhs + L;
+	state.Y = state.delta + L;
+	state.cols = SV_CALLOC(L + 1, sizeof(int));
+
+	for (size_t i = 0; i < sba->poseCnt; i++) {
+		sba_to_axis_angle(&state.current.poses[i], &sba->poses[i]);
+		state.trial.poses[i] = state.current.poses[i];
+	}
+
+	double chi2 = sba_norm(&state);
+	const double orignorm = chi2;
+	double lambda = 1e-3;
+	size_t skipped_poses = 0;
+	int accepted = 0;
+
+	while (accepted < max_iterations && chi2 > 0) {
+		sba_linearize(&state);
+
+		double trial_chi2 = NAN;
+		for (; lambda < 1e10; lambda *= 10) {
+			if (!sba_solve_lighthouses(&state, lambda))
+				continue;
+
+			trial_chi2 = sba_apply_step(&state, lambda);
+			if (trial_chi2 < chi2)
+				break;
+		}
+		if (!(trial_chi2 < chi2))
+			break;
+
+		sba_params swap = state.current;
+		state.current = state.trial;
+		state.trial = swap;
+
+		const double reduction = (chi2 - trial_chi2) / chi2;
+		chi2 = trial_chi2;
+		skipped_poses = state.skipped_poses;
+		accepted++;
+		lambda = lambda > 1e-9 ? lambda / 10 : lambda;
+
+		if (reduction < ftol)
+			break;
+	}
+
+	for (size_t i = 0; i < sba->poseCnt; i++)
+		sba_from_axis_angle(&sba->poses[i], &state.current.poses[i]);
+	for (int lh = 0; lh < sba->lighthouseCnt; lh++) {
+		SurvivePose world2lh;
+		sba_from_axis_angle(&world2lh, &state.current.world2lh[lh]);
+		InvertPose(&sba->lighthouses[lh], &world2lh);
+		memcpy(sba->fcal[lh], state.current.fcal[lh], sizeof(sba->fcal[lh]));
+	}
+
+	if (result) {
+		result->orignorm = orignorm;
+		result->bestnorm = chi2;
+		result->iterations = accepted;
+		result->skipped_poses = skipped_poses;
+	}
+
+	free(state.current.poses);
+	free(state.trial.poses);
+	free(state.V);
+	free(state.cols);
+	free(state.blocks);
+	free(w_buffer);
+	return accepted;
+}
@@ -3,36 +3,212 @@
 #include <math.h>
 #include <survive.h>
 
-STATIC_CONFIG_ITEM(MOVMENT_THRESHOLD_GYRO, "move-threshold-gyro", 'f', "Threshold to count gyro norms as moving", .075)
-STATIC_CONFIG_ITEM(MOVMENT_THRESHOLD_ACC, "move-threshold-acc", 'f', "Threshold to count acc diff norms as moving", .03)
+// Also used for activations that don't belong to an object
+#define MOVE_THRESHOLD_GYRO_DEFAULT .075
+#define MOVE_THRESHOLD_ACC_DEFAULT .03
+#define MOVE_THRESHOLD_ANG_DEFAULT .015
+
+STATIC_CONFIG_ITEM(MOVMENT_THRESHOLD_GYRO, "move-threshold-gyro", 'f', "Threshold to count gyro norms as moving",
+				   MOVE_THRESHOLD_GYRO_DEFAULT)
+STATIC_CONFIG_ITEM(MOVMENT_THRESHOLD_ACC, "move-threshold-acc", 'f', "Threshold to count acc diff norms as moving",
+				   MOVE_THRESHOLD_ACC_DEFAULT)
 STATIC_CONFIG_ITEM(MOVMENT_THRESHOLD_ANG, "move-threshold-ang", 'f', "Threshold to count light angle diffs as moving",
-				   .015)
+				   MOVE_THRESHOLD_ANG_DEFAULT)
+
+const SurviveSensorActivationsEntry SurviveSensorActivations_empty_entry = {.angles = {NAN, NAN}};
+
+static inline size_t activations_slot_cnt(const SurviveSensorActivations *self) {
+	return (size_t)self->sensor_cnt * self->lh_cnt * 2;
+}
+
+static inline uint16_t activations_slot(const SurviveSensorActivations *self, uint32_t sensor_idx, int lh, int axis) {
+	return (uint16_t)((lh * self->sensor_cnt + sensor_idx) * 2 + axis);
+}
+
+static inline survive_timecode slot_timecode(const SurviveSensorActivations *self, uint16_t slot) {
+	return self->entries[slot / 2].timecode[slot & 1];
+}
 
-static FLT moveThresholdGyro = 0;
-static FLT moveThresholdAcc = 0;
-static FLT moveThresholdAng = 0;
+static void fresh_unlink(SurviveSensorActivations *self, uint16_t slot) {
+	uint16_t prev = self->fresh_prev[slot], next = self->fresh_next[slot];
+	if (prev == 0 && self->fresh_head != slot + 1)
+		return;
+
+	if (prev)
+		self->fresh_next[prev - 1] = next;
+	else
+		self->fresh_head = next;
+	if (next)
+		self->fresh_prev[next - 1] = prev;
+
+	self->fresh_prev[slot] = self->fresh_next[slot] = 0;
+}
+
+// Readings come in timecode order nearly all the time, so this almost always ends up inserting at the head.
+static void fresh_insert(SurviveSensorActivations *self, uint16_t slot) {
+	fresh_unlink(self, slot);
+
+	survive_timecode timecode = slot_timecode(self, slot);
+	uint16_t prev = 0, next = self->fresh_head;
+	while (next && (int32_t)(slot_timecode(self, next - 1) - timecode) > 0) {
+		prev = next;
+		next = self->fresh_next[next - 1];
+	}
+
+	self->fresh_prev[slot] = prev;
+	self->fresh_next[slot] = next;
+	if (prev)
+		self->fresh_next[prev - 1] = slot + 1;
+	else
+		self->fresh_head = slot + 1;
+	if (next)
+		self->fresh_prev[next - 1] = slot + 1;
+}
+
+// Points entries and the link arrays at a block big enough for the given size
+static void activations_alloc(SurviveSensorActivations *self, uint8_t sensor_cnt, uint8_t lh_cnt) {
+	size_t entry_cnt = (size_t)sensor_cnt * lh_cnt;
+	size_t size = entry_cnt * (sizeof(SurviveSensorActivationsEntry) + 4 * sizeof(uint16_t));
+	self->entries = SV_REALLOC(self->entries, size);
+	self->fresh_next = (uint16_t *)(self->entries + entry_cnt);
+	self->fresh_prev = self->fresh_next + entry_cnt * 2;
+	self->sensor_cnt = sensor_cnt;
+	self->lh_cnt = lh_cnt;
+}
+
+/**
+ * Makes room for the given sensor and lighthouse. Sensors are added in groups of 8 to keep this from happening on
+ * nearly every new sensor at startup; lighthouses are added one at a time since there are only a few of them.
+ */
+static void activations_grow(SurviveSensorActivations *self, uint32_t sensor_idx, int lh) {
+	uint8_t old_sensor_cnt = self->sensor_cnt, old_lh_cnt = self->lh_cnt;
+	uint8_t sensor_cnt = old_sensor_cnt, lh_cnt = old_lh_cnt;
+	if (sensor_idx >= sensor_cnt) {
+		sensor_cnt = (sensor_idx + 8) & ~7u;
+		if (sensor_cnt > SENSORS_PER_OBJECT)
+			sensor_cnt = SENSORS_PER_OBJECT;
+	}
+	if (lh >= lh_cnt)
+		lh_cnt = lh + 1;
+
+	SurviveSensorActivationsEntry *old = 0;
+	size_t old_cnt = (size_t)old_sensor_cnt * old_lh_cnt;
+	if (old_cnt) {
+		old = SV_MALLOC(old_cnt * sizeof(SurviveSensorActivationsEntry));
+		memcpy(old, self->entries, old_cnt * sizeof(SurviveSensorActivationsEntry));
+	}
+
+	activations_alloc(self, sensor_cnt, lh_cnt);
+	for (size_t i = 0; i < (size_t)sensor_cnt * lh_cnt; i++) {
+		self->entries[i] = SurviveSensorActivations_empty_entry;
+	}
+	for (int l = 0; l < old_lh_cnt; l++) {
+		memcpy(&self->entries[l * sensor_cnt], &old[l * old_sensor_cnt],
+			   old_sensor_cnt * sizeof(SurviveSensorActivationsEntry));
+	}
+	free(old);
+
+	SurviveSensorActivations_reindex(self);
+}
+
+SurviveSensorActivationsEntry *SurviveSensorActivations_entry_for_write(SurviveSensorActivations *self,
+																	   uint32_t sensor_idx, int lh) {
+	assert(sensor_idx < SENSORS_PER_OBJECT && lh >= 0 && lh < NUM_GEN2_LIGHTHOUSES);
+	if (sensor_idx >= self->sensor_cnt || lh >= self->lh_cnt)
+		activations_grow(self, sensor_idx, lh);
+	return &self->entries[lh * self->sensor_cnt + sensor_idx];
+}
+
+void SurviveSensorActivations_copy(SurviveSensorActivations *dst, const SurviveSensorActivations *src) {
+	if (dst == src)
+		return;
+
+	SurviveSensorActivationsEntry *entries = dst->entries;
+	uint16_t *fresh_next = dst->fresh_next, *fresh_prev = dst->fresh_prev;
+	*dst = *src;
+	dst->entries = entries;
+	dst->fresh_next = fresh_next;
+	dst->fresh_prev = fresh_prev;
+
+	size_t entry_cnt = (size_t)src->sensor_cnt * src->lh_cnt;
+	if (entry_cnt == 0)
+		return;
+
+	activations_alloc(dst, src->sensor_cnt, src->lh_cnt);
+	memcpy(dst->entries, src->entries, entry_cnt * sizeof(SurviveSensorActivationsEntry));
+	memcpy(dst->fresh_next, src->fresh_next, entry_cnt * 2 * sizeof(uint16_t));
+	memcpy(dst->fresh_prev, src->fresh_prev, entry_cnt * 2 * sizeof(uint16_t));
+}
+
+void SurviveSensorActivations_dtor(SurviveSensorActivations *self) {
+	free(self->entries);
+	self->entries = 0;
+	self->fresh_next = self->fresh_prev = 0;
+	self->sensor_cnt = self->lh_cnt = 0;
+	self->fresh_head = 0;
+}
+
+size_t SurviveSensorActivations_fresh_readings(const SurviveSensorActivations *self, survive_timecode tolerance,
+											   survive_timecode timecode_now, SurviveSensorActivationsReading *readings,
+											   size_t max_readings) {
+	size_t cnt = 0;
+	for (uint16_t link = self->fresh_head; link && cnt < max_readings; link = self->fresh_next[link - 1]) {
+		uint16_t slot = link - 1;
+
+		// The list is in timecode order, so everything past the first stale entry is stale too
+		int32_t age = (int32_t)(timecode_now - slot_timecode(self, slot));
+		if (age > 0 && (survive_timecode)age > tolerance)
+			break;
+
+		uint32_t sensor_idx = (slot / 2) % self->sensor_cnt;
+		int lh = (slot / 2) / self->sensor_cnt;
+		int axis = slot & 1;
+		if (!SurviveSensorActivations_isReadingValid(self, tolerance, timecode_now, sensor_idx, lh, axis))
+			continue;
+
+		readings[cnt].sensor_idx = sensor_idx;
+		readings[cnt].lh = lh;
+		readings[cnt].axis = axis;
+		cnt++;
+	}
+	return cnt;
+}
+
+void SurviveSensorActivations_reindex(SurviveSensorActivations *self) {
+	self->fresh_head = 0;
+	size_t slot_cnt = activations_slot_cnt(self);
+	if (slot_cnt == 0)
+		return;
+
+	memset(self->fresh_next, 0, slot_cnt * sizeof(uint16_t));
+	memset(self->fresh_prev, 0, slot_cnt * sizeof(uint16_t));
+	for (uint16_t slot = 0; slot < slot_cnt; slot++) {
+		if (!isnan(self->entries[slot / 2].angles[slot & 1]))
+			fresh_insert(self, slot);
+	}
+}
 
 bool SurviveSensorActivations_isReadingValid(const SurviveSensorActivations *self, survive_timecode tolerance,
 											 survive_timecode timecode_now, uint32_t idx, int lh, int axis) {
-	const uint32_t *data_timecode = self->timecode[idx][lh];
-	if (self->lh_gen != 1 && lh < 2 && self->lengths[idx][lh][axis] == 0)
+	const SurviveSensorActivationsEntry *entry = SurviveSensorActivations_entry(self, idx, lh);
+	if (self->lh_gen != 1 && lh < 2 && entry->lengths[axis] == 0)
 		return false;
 
-	if (isnan(self->angles[idx][lh][axis]))
+	if (isnan(entry->angles[axis]))
 		return false;
 
-	return survive_timecode_difference(timecode_now, data_timecode[axis]) <= tolerance;
+	return survive_timecode_difference(timecode_now, entry->timecode[axis]) <= tolerance;
 }
 bool SurviveSensorActivations_isPairValid(const SurviveSensorActivations *self, uint32_t tolerance,
 										  uint32_t timecode_now, uint32_t idx, int lh) {
-	const uint32_t *data_timecode = self->timecode[idx][lh];
-	if (self->lh_gen != 1 && (self->lengths[idx][lh][0] == 0 || self->lengths[idx][lh][1] == 0))
+	const SurviveSensorActivationsEntry *entry = SurviveSensorActivations_entry(self, idx, lh);
+	if (self->lh_gen != 1 && (entry->lengths[0] == 0 || entry->lengths[1] == 0))
 		return false;
 
-	if (isnan(self->angles[idx][lh][0]) || isnan(self->angles[idx][lh][1]))
+	if (isnan(entry->angles[0]) || isnan(entry->angles[1]))
 		return false;
 
-	return !(timecode_now - data_timecode[0] > tolerance || timecode_now - data_timecode[1] > tolerance);
+	return !(timecode_now - entry->timecode[0] > tolerance || timecode_now - entry->timecode[1] > tolerance);
 }
 
 survive_long_timecode survive_extend_time(const SurviveObject *so, survive_timecode time) {
@@ -83,7 +259,8 @@ void SurviveSensorActivations_add_imu(SurviveSensorActivations *self, struct Pos
 		}
 	}
 
-	if (norm3d(imuData->gyro) > moveThresholdGyro || dist3d(self->accel, imuData->accel) > moveThresholdAcc) {
+	if (norm3d(imuData->gyro) > self->move_threshold_gyro ||
+		dist3d(self->accel, imuData->accel) > self->move_threshold_acc) {
 		survive_long_timecode long_timecode =
 			((survive_long_timecode)self->rollover_count << 32u) | imuData->hdr.timecode;
 		self->last_movement = long_timecode;
@@ -98,11 +275,11 @@ void SurviveSensorActivations_add_gen2(SurviveSensorActivations *self, struct Po
 	if (l->sensor_id >= SENSORS_PER_OBJECT)
 		return;
 
-	uint32_t *data_timecode = &self->timecode[l->sensor_id][l->lh][axis];
+	SurviveSensorActivationsEntry *entry = SurviveSensorActivations_entry_for_write(self, l->sensor_id, l->lh);
+	uint32_t *data_timecode = &entry->timecode[axis];
+	FLT *angle = &entry->angles[axis];
 
-	FLT *angle = &self->angles[l->sensor_id][l->lh][axis];
-
-	if (!isnan(*angle) && fabs(*angle - l->angle) > moveThresholdAng) {
+	if (!isnan(*angle) && fabs(*angle - l->angle) > self->move_threshold_ang) {
 		survive_long_timecode long_timecode = ((survive_long_timecode)self->rollover_count << 32u) | l->hdr.timecode;
 		// assert(long_timecode > self->last_movement);
 		// fprintf(stderr, "%f \n", fabs(*angle - l->angle));
@@ -112,23 +289,21 @@ void SurviveSensorActivations_add_gen2(SurviveSensorActivations *self, struct Po
 	*data_timecode = l->hdr.timecode;
 	*angle = l->angle;
 	self->last_light = lightData->common.hdr.timecode;
+
+	fresh_insert(self, activations_slot(self, l->sensor_id, l->lh, axis));
 }
 
 SURVIVE_EXPORT void SurviveSensorActivations_ctor(SurviveObject *so, SurviveSensorActivations *self) {
-	if (so) {
-		moveThresholdAcc = survive_configf(so->ctx, MOVMENT_THRESHOLD_ACC_TAG, SC_GET, 0);
-		moveThresholdGyro = survive_configf(so->ctx, MOVMENT_THRESHOLD_GYRO_TAG, SC_GET, 0);
-		moveThresholdAng = survive_configf(so->ctx, MOVMENT_THRESHOLD_ANG_TAG, SC_GET, 0);
-	}
-
 	memset(self, 0, sizeof(SurviveSensorActivations));
 
-	for (int i = 0; i < SENSORS_PER_OBJECT; i++) {
-		for (int j = 0; j < NUM_GEN2_LIGHTHOUSES; j++) {
-			for (int h = 0; h < 2; h++) {
-				self->angles[i][j][h] = NAN;
-			}
-		}
+	if (so) {
+		self->move_threshold_acc = survive_configf(so->ctx, MOVMENT_THRESHOLD_ACC_TAG, SC_GET, 0);
+		self->move_threshold_gyro = survive_configf(so->ctx, MOVMENT_THRESHOLD_GYRO_TAG, SC_GET, 0);
+		self->move_threshold_ang = survive_configf(so->ctx, MOVMENT_THRESHOLD_ANG_TAG, SC_GET, 0);
+	} else {
+		self->move_threshold_acc = MOVE_THRESHOLD_ACC_DEFAULT;
+		self->move_threshold_gyro = MOVE_THRESHOLD_GYRO_DEFAULT;
+		self->move_threshold_ang = MOVE_THRESHOLD_ANG_DEFAULT;
 	}
 
 	for (int i = 0; i < 3; i++) {
@@ -147,10 +322,11 @@ void SurviveSensorActivations_add(SurviveSensorActivations *self, struct PoserDa
 
 	int axis = (_lightData->acode & 1);
 	PoserDataLight *lightData = &_lightData->common;
-	uint32_t *data_timecode = &self->timecode[lightData->sensor_id][lightData->lh][axis];
-
-	FLT *angle = &self->angles[lightData->sensor_id][lightData->lh][axis];
-	uint32_t *length = &self->lengths[lightData->sensor_id][lightData->lh][axis];
+	SurviveSensorActivationsEntry *entry =
+		SurviveSensorActivations_entry_for_write(self, lightData->sensor_id, lightData->lh);
+	uint32_t *data_timecode = &entry->timecode[axis];
+	FLT *angle = &entry->angles[axis];
+	uint32_t *length = &entry->lengths[axis];
 	// printf("error %10.7f\n", fabs(*angle - lightData->angle));
 	if (*length == 0 || fabs(*angle - lightData->angle) > 0.05) {
 		self->last_movement = 0;
@@ -159,7 +335,7 @@ void SurviveSensorActivations_add(SurviveSensorActivations *self, struct PoserDa
 		self->last_movement = long_timecode;
 	}
 
-	if (*length == 0 || fabs(*angle - lightData->angle) > moveThresholdAcc) {
+	if (*length == 0 || fabs(*angle - lightData->angle) > self->move_threshold_acc) {
 		survive_long_timecode long_timecode =
 			((survive_long_timecode)self->rollover_count << 32u) | lightData->hdr.timecode;
 		// assert(long_timecode > self->last_movement);
@@ -170,6 +346,8 @@ void SurviveSensorActivations_add(SurviveSensorActivations *self, struct PoserDa
 	*data_timecode = lightData->hdr.timecode;
 	*length = (uint32_t)(_lightData->length * 48000000);
 	self->last_light = lightData->hdr.timecode;
+
+	fresh_insert(self, activations_slot(self, lightData->sensor_id, lightData->lh, axis));
 }
 
 FLT SurviveSensorActivations_difference(const SurviveSensorActivations *rhs, const SurviveSensorActivations *lhs) {
@@ -177,9 +355,11 @@ FLT SurviveSensorActivations_difference(const SurviveSensorActivations *rhs, con
 	int cnt = 0;
 	for(size_t i = 0;i < SENSORS_PER_OBJECT;i++) {
 		for (size_t lh = 0; lh < NUM_GEN1_LIGHTHOUSES; lh++) {
+			const SurviveSensorActivationsEntry *r = SurviveSensorActivations_entry(rhs, i, lh);
+			const SurviveSensorActivationsEntry *l = SurviveSensorActivations_entry(lhs, i, lh);
 			for(size_t axis = 0;axis < 2;axis++) {
-				if(rhs->lengths[i][lh][axis] > 0 && lhs->lengths[i][lh][axis] > 0) {
-					FLT diff = rhs->angles[i][lh][axis] - lhs->angles[i][lh][axis];
+				if (r->lengths[axis] > 0 && l->lengths[axis] > 0) {
+					FLT diff = r->angles[axis] - l->angles[axis];
 					rtn += diff * diff;
 					cnt++;
 				}
@@ -0,0 +1,417 @@
+#include "survive_stream.h"
+
+#include <os_generic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <survive.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET survive_socket_t;
+#define close_socket closesocket
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int survive_socket_t;
+#define INVALID_SOCKET (-1)
+#define close_socket close
+#endif
+
+#define SURVIVE_STREAM_MAX_SUBSCRIPTIONS 32
+
+static void put_u16(uint8_t *p, uint16_t v) {
+	p[0] = v;
+	p[1] = v >> 8;
+}
+static void put_u32(uint8_t *p, uint32_t v) {
+	for (int i = 0; i < 4; i++)
+		p[i] = v >> (8 * i);
+}
+static void put_u64(uint8_t *p, uint64_t v) {
+	for (int i = 0; i < 8; i++)
+		p[i] = v >> (8 * i);
+}
+static void put_f32(uint8_t *p, FLT v) {
+	float f = v;
+	uint32_t u;
+	memcpy(&u, &f, sizeof(u));
+	put_u32(p, u);
+}
+static void put_f64(uint8_t *p, double v) {
+	uint64_t u;
+	memcpy(&u, &v, sizeof(u));
+	put_u64(p, u);
+}
+
+static uint16_t get_u16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+static uint32_t get_u32(const uint8_t *p) {
+	uint32_t v = 0;
+	for (int i = 0; i < 4; i++)
+		v |= (uint32_t)p[i] << (8 * i);
+	return v;
+}
+static uint64_t get_u64(const uint8_t *p) {
+	uint64_t v = 0;
+	for (int i = 0; i < 8; i++)
+		v |= (uint64_t)p[i] << (8 * i);
+	return v;
+}
+static FLT get_f32(const uint8_t *p) {
+	uint32_t u = get_u32(p);
+	float f;
+	memcpy(&f, &u, sizeof(f));
+	return f;
+}
+static double get_f64(const uint8_t *p) {
+	uint64_t u = get_u64(p);
+	double d;
+	memcpy(&d, &u, sizeof(d));
+	return d;
+}
+
+size_t survive_stream_frame_size(SurviveStreamFrameType type) {
+	switch (type) {
+	case SURVIVE_STREAM_POSE:
+		return SURVIVE_STREAM_HEADER_SIZE + 4 + 7 * 4;
+	case SURVIVE_STREAM_VELOCITY:
+		return SURVIVE_STREAM_HEADER_SIZE + 4 + 6 * 4;
+	case SURVIVE_STREAM_BUTTON:
+		return SURVIVE_STREAM_HEADER_SIZE + 8;
+	case SURVIVE_STREAM_SUBSCRIBE:
+		return SURVIVE_STREAM_HEADER_SIZE;
+	default:
+		return 0;
+	}
+}
+
+size_t survive_stream_encode(const SurviveStreamFrame *frame, uint8_t *buffer, size_t len) {
+	size_t size = survive_stream_frame_size(frame->type);
+	if (size == 0 || size > len) {
+		return 0;
+	}
+
+	buffer[0] = frame->type;
+	buffer[1] = SURVIVE_STREAM_VERSION;
+	put_u16(buffer + 2, size);
+	put_u32(buffer + 4, frame->seq);
+	put_f64(buffer + 8, frame->time);
+	memset(buffer + 16, 0, SURVIVE_STREAM_OBJECT_LEN);
+	memcpy(buffer + 16, frame->object, strnlen(frame->object, SURVIVE_STREAM_OBJECT_LEN));
+
+	uint8_t *body = buffer + SURVIVE_STREAM_HEADER_SIZE;
+	switch (frame->type) {
+	case SURVIVE_STREAM_POSE:
+		put_u32(body, frame->timecode);
+		for (int i = 0; i < 3; i++)
+			put_f32(body + 4 + 4 * i, frame->body.pose.Pos[i]);
+		for (int i = 0; i < 4; i++)
+			put_f32(body + 16 + 4 * i, frame->body.pose.Rot[i]);
+		break;
+	case SURVIVE_STREAM_VELOCITY:
+		put_u32(body, frame->timecode);
+		for (int i = 0; i < 3; i++)
+			put_f32(body + 4 + 4 * i, frame->body.velocity.Pos[i]);
+		for (int i = 0; i < 3; i++)
+			put_f32(body + 16 + 4 * i, frame->body.velocity.AxisAngleRot[i]);
+		break;
+	case SURVIVE_STREAM_BUTTON:
+		body[0] = frame->body.button.event_type;
+		body[1] = frame->body.button.button_id;
+		body[2] = frame->body.button.axis1_id;
+		body[3] = frame->body.button.axis2_id;
+		put_u16(body + 4, frame->body.button.axis1_val);
+		put_u16(body + 6, frame->body.button.axis2_val);
+		break;
+	default:
+		break;
+	}
+	return size;
+}
+
+int survive_stream_decode(SurviveStreamFrame *frame, const uint8_t *buffer, size_t len) {
+	if (len < SURVIVE_STREAM_HEADER_SIZE) {
+		return 0;
+	}
+
+	uint16_t size = get_u16(buffer + 2);
+	if (buffer[1] != SURVIVE_STREAM_VERSION || size < SURVIVE_STREAM_HEADER_SIZE) {
+		return -1;
+	}
+	if (size > len) {
+		return 0;
+	}
+
+	memset(frame, 0, sizeof(*frame));
+	frame->type = buffer[0];
+	frame->seq = get_u32(buffer + 4);
+	frame->time = get_f64(buffer + 8);
+	memcpy(frame->object, buffer + 16, SURVIVE_STREAM_OBJECT_LEN);
+
+	// Later versions may grow a frame, but never shrink it
+	size_t expected = survive_stream_frame_size(frame->type);
+	if (expected == 0 || size < expected) {
+		frame->type = SURVIVE_STREAM_NONE;
+		return size;
+	}
+
+	const uint8_t *body = buffer + SURVIVE_STREAM_HEADER_SIZE;
+	switch (frame->type) {
+	case SURVIVE_STREAM_POSE:
+		frame->timecode = get_u32(body);
+		for (int i = 0; i < 3; i++)
+			frame->body.pose.Pos[i] = get_f32(body + 4 + 4 * i);
+		for (int i = 0; i < 4; i++)
+			frame->body.pose.Rot[i] = get_f32(body + 16 + 4 * i);
+		break;
+	case SURVIVE_STREAM_VELOCITY:
+		frame->timecode = get_u32(body);
+		for (int i = 0; i < 3; i++)
+			frame->body.velocity.Pos[i] = get_f32(body + 4 + 4 * i);
+		for (int i = 0; i < 3; i++)
+			frame->body.velocity.AxisAngleRot[i] = get_f32(body + 16 + 4 * i);
+		break;
+	case SURVIVE_STREAM_BUTTON:
+		frame->body.button.event_type = body[0];
+		frame->body.button.button_id = body[1];
+		frame->body.button.axis1_id = body[2];
+		frame->body.button.axis2_id = body[3];
+		frame->body.button.axis1_val = get_u16(body + 4);
+		frame->body.button.axis2_val = get_u16(body + 6);
+		break;
+	default:
+		break;
+	}
+	return size;
+}
+
+struct SurviveStreamClient {
+	survive_socket_t sock;
+	bool is_tcp;
+
+	// TCP data can end partway through a frame; multicast datagrams always hold whole frames
+	uint8_t buffer[4096];
+	size_t offset, len;
+
+	bool have_seq;
+	uint32_t next_seq;
+	uint32_t dropped;
+
+	char subscriptions[SURVIVE_STREAM_MAX_SUBSCRIPTIONS][SURVIVE_STREAM_OBJECT_LEN + 1];
+	size_t subscription_cnt;
+};
+
+static bool socket_init() {
+#ifdef _WIN32
+	static bool initialized = false;
+	if (!initialized) {
+		WSADATA data;
+		if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+			return false;
+		initialized = true;
+	}
+#endif
+	return true;
+}
+
+static SurviveStreamClient *client_new(survive_socket_t sock, bool is_tcp) {
+	SurviveStreamClient *client = SV_NEW(SurviveStreamClient);
+	client->sock = sock;
+	client->is_tcp = is_tcp;
+	return client;
+}
+
+SurviveStreamClient *survive_stream_connect(const char *host, uint16_t port) {
+	if (!socket_init()) {
+		return 0;
+	}
+
+	char port_str[16];
+	snprintf(port_str, sizeof(port_str), "%u", port);
+
+	struct addrinfo hints = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM};
+	struct addrinfo *addrs = 0;
+	if (getaddrinfo(host, port_str, &hints, &addrs) != 0) {
+		return 0;
+	}
+
+	survive_socket_t sock = INVALID_SOCKET;
+	for (struct addrinfo *addr = addrs; addr; addr = addr->ai_next) {
+		sock = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+		if (sock == INVALID_SOCKET)
+			continue;
+		if (connect(sock, addr->ai_addr, addr->ai_addrlen) == 0)
+			break;
+		close_socket(sock);
+		sock = INVALID_SOCKET;
+	}
+	freeaddrinfo(addrs);
+
+	if (sock == INVALID_SOCKET) {
+		return 0;
+	}
+	return client_new(sock, true);
+}
+
+SurviveStreamClient *survive_stream_join(const char *group, uint16_t port) {
+	if (!socket_init()) {
+		return 0;
+	}
+
+	survive_socket_t sock = socket(AF_INET, SOCK_DGRAM, 0);
+	if (sock == INVALID_SOCKET) {
+		return 0;
+	}
+
+	int reuse = 1;
+	setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (const char *)&reuse, sizeof(reuse));
+
+	struct sockaddr_in addr = {0};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = htons(port);
+
+	struct ip_mreq mreq = {0};
+	mreq.imr_multiaddr.s_addr = inet_addr(group);
+	mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+
+	if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+		setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char *)&mreq, sizeof(mreq)) < 0) {
+		close_socket(sock);
+		return 0;
+	}
+
+	return client_new(sock, false);
+}
+
+int survive_stream_subscribe(SurviveStreamClient *client, const char *object) {
+	if (client->subscription_cnt >= SURVIVE_STREAM_MAX_SUBSCRIPTIONS) {
+		return -1;
+	}
+
+	char *subscription = client->subscriptions[client->subscription_cnt++];
+	strncpy(subscription, object, SURVIVE_STREAM_OBJECT_LEN);
+	subscription[SURVIVE_STREAM_OBJECT_LEN] = 0;
+
+	if (client->is_tcp) {
+		SurviveStreamFrame frame = {.type = SURVIVE_STREAM_SUBSCRIBE};
+		strncpy(frame.object, object, SURVIVE_STREAM_OBJECT_LEN);
+
+		uint8_t buffer[SURVIVE_STREAM_MAX_FRAME_SIZE];
+		size_t len = survive_stream_encode(&frame, buffer, sizeof(buffer));
+		if (send(client->sock, (const char *)buffer, len, 0) != (int)len) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static bool is_subscribed(const SurviveStreamClient *client, const char *object) {
+	if (client->subscription_cnt == 0) {
+		return true;
+	}
+	for (size_t i = 0; i < client->subscription_cnt; i++) {
+		if (strcmp(client->subscriptions[i], object) == 0)
+			return true;
+	}
+	return false;
+}
+
+static void track_seq(SurviveStreamClient *client, uint32_t seq) {
+	// Multicast can reorder; anything behind the expected sequence was already counted as a gap
+	int32_t gap = (int32_t)(seq - client->next_seq);
+	if (client->have_seq && gap < 0) {
+		return;
+	}
+	if (client->have_seq) {
+		client->dropped += gap;
+	}
+	client->have_seq = true;
+	client->next_seq = seq + 1;
+}
+
+static int receive(SurviveStreamClient *client, int timeout_ms) {
+	fd_set read_fds;
+	FD_ZERO(&read_fds);
+	FD_SET(client->sock, &read_fds);
+	struct timeval tv = {.tv_sec = timeout_ms / 1000, .tv_usec = (timeout_ms % 1000) * 1000};
+	int ready = select(client->sock + 1, &read_fds, 0, 0, timeout_ms < 0 ? 0 : &tv);
+	if (ready <= 0) {
+		return ready;
+	}
+
+	if (client->is_tcp) {
+		memmove(client->buffer, client->buffer + client->offset, client->len - client->offset);
+		client->len -= client->offset;
+		client->offset = 0;
+	} else {
+		client->offset = client->len = 0;
+	}
+
+	int rd = recv(client->sock, (char *)client->buffer + client->len, sizeof(client->buffer) - client->len, 0);
+	if (rd <= 0) {
+		// A datagram socket doesn't close; an empty datagram is just ignored
+		return client->is_tcp ? -1 : 0;
+	}
+	client->len += rd;
+	return 1;
+}
+
+int survive_stream_read(SurviveStreamClient *client, SurviveStreamFrame *frame, int timeout_ms) {
+	double deadline = OGGetAbsoluteTime() + timeout_ms / 1000.;
+	while (true) {
+		while (client->offset < client->len) {
+			int used = survive_stream_decode(frame, client->buffer + client->offset, client->len - client->offset);
+			if (used == 0 && client->is_tcp) {
+				break;
+			}
+			if (used <= 0) {
+				if (client->is_tcp) {
+					return -1;
+				}
+				// Not one of ours; drop the rest of the datagram
+				client->offset = client->len;
+				break;
+			}
+			client->offset += used;
+
+			if (frame->type == SURVIVE_STREAM_NONE || frame->type == SURVIVE_STREAM_SUBSCRIBE) {
+				continue;
+			}
+			track_seq(client, frame->seq);
+			if (is_subscribed(client, frame->object)) {
+				return 1;
+			}
+		}
+
+		int wait_ms = -1;
+		if (timeout_ms >= 0) {
+			wait_ms = (int)((deadline - OGGetAbsoluteTime()) * 1000.);
+			if (wait_ms < 0)
+				wait_ms = 0;
+		}
+
+		int rtn = receive(client, wait_ms);
+		if (rtn < 0) {
+			return -1;
+		}
+		if (rtn == 0 && timeout_ms >= 0 && OGGetAbsoluteTime() >= deadline) {
+			return 0;
+		}
+	}
+}
+
+uint32_t survive_stream_dropped(const SurviveStreamClient *client) { return client->dropped; }
+
+void survive_stream_close(SurviveStreamClient *client) {
+	if (client == 0) {
+		return;
+	}
+	close_socket(client->sock);
+	free(client);
+}
@@ -0,0 +1,136 @@
+#define SURVIVE_ENABLE_FULL_API
+#include "../survive_internal.h"
+#include "survive_api.h"
+#include "test_case.h"
+#include <stdio.h>
+
+static double test_clock(const SurviveContext *ctx, void *user) { return *(const double *)user; }
+
+static int check_pose(const SurvivePose *pose, FLT x, FLT y, FLT z, FLT yaw) {
+	ASSERT_DOUBLE_EQ(pose->Pos[0], x);
+	ASSERT_DOUBLE_EQ(pose->Pos[1], y);
+	ASSERT_DOUBLE_EQ(pose->Pos[2], z);
+	ASSERT_DOUBLE_EQ(pose->Rot[0], cos(yaw / 2.));
+	ASSERT_DOUBLE_EQ(pose->Rot[1], 0.);
+	ASSERT_DOUBLE_EQ(pose->Rot[2], 0.);
+	ASSERT_DOUBLE_EQ(pose->Rot[3], sin(yaw / 2.));
+	return 0;
+}
+
+TEST(SimpleApi, PoseAt) {
+	char *const args[] = {"survive_tests", "--dummy", "--configfile", "simple_api_test.json"};
+	SurviveSimpleContext *actx = survive_simple_init(sizeof(args) / sizeof(args[0]), args);
+	ASSERT_EQ((actx != 0), 1);
+
+	SurviveContext *ctx = survive_simple_get_ctx(actx);
+	double now = 0;
+	survive_install_run_time_fn(ctx, test_clock, &now);
+
+	const SurviveSimpleObject *sao = survive_simple_get_first_object(actx);
+	ASSERT_EQ((sao != 0), 1);
+	// The dummy driver's object has no type, so the simple API won't hand it out
+	ASSERT_EQ(ctx->objs_ct, 1);
+	SurviveObject *so = ctx->objs[0];
+
+	SurvivePose pose = {0};
+	ASSERT_EQ(survive_simple_object_get_pose_at(sao, 0, &pose), false);
+
+	// One second apart in both clocks; the second pose is a quarter turn about z
+	SurvivePose first = {.Rot = {1}};
+	SurvivePose second = {.Pos = {1, 2, 0}, .Rot = {cos(M_PI / 4.), 0, 0, sin(M_PI / 4.)}};
+	ctx->poseproc(so, 0, &first);
+	now = 1;
+	ctx->poseproc(so, 48000000, &second);
+
+	SurviveVelocity velocity = {.Pos = {1, 0, 0}, .AxisAngleRot = {0, 0, M_PI}};
+	ctx->velocityproc(so, 48000000, &velocity);
+
+	ASSERT_EQ(survive_simple_object_get_pose_at(sao, .5, &pose), true);
+	ASSERT_EQ(check_pose(&pose, .5, 1, 0, M_PI / 4.), 0);
+
+	// Before the history starts, the oldest pose is all there is
+	ASSERT_EQ(survive_simple_object_get_pose_at(sao, -1, &pose), true);
+	ASSERT_EQ(check_pose(&pose, 0, 0, 0, 0), 0);
+
+	ASSERT_EQ(survive_simple_object_get_pose_at(sao, 1.05, &pose), true);
+	ASSERT_EQ(check_pose(&pose, 1.05, 2, 0, M_PI / 2. + M_PI * .05), 0);
+
+	// Extrapolation stops 100ms past the newest pose
+	ASSERT_EQ(survive_simple_object_get_pose_at(sao, 3, &pose), true);
+	ASSERT_EQ(check_pose(&pose, 1.1, 2, 0, M_PI / 2. + M_PI * .1), 0);
+
+	survive_simple_close(actx);
+	remove("simple_api_test.json");
+	return 0;
+}
+
+// Mirror the queue's sizing in survive_api.c
+#define TEST_EVENT_BLOCK_SIZE 64
+#define TEST_MAX_EVENT_CNT (1 << 16)
+
+// Drains up to 'max_events' and checks that they carry the button values 'expected', 'expected + 1', ...
+static int check_next_events(SurviveSimpleContext *actx, const SurviveSimpleObject *sao, SurviveSimpleEvent *events,
+							 size_t max_events, size_t expected_cnt, uint32_t expected) {
+	ASSERT_EQ(survive_simple_next_events(actx, events, max_events), expected_cnt);
+	for (size_t i = 0; i < expected_cnt; i++) {
+		const SurviveSimpleButtonEvent *button = survive_simple_get_button_event(&events[i]);
+		ASSERT_EQ((button != 0), 1);
+		ASSERT_EQ((button->object == sao), 1);
+		ASSERT_EQ(button->axis_val[0], (uint16_t)(expected + i));
+	}
+	return 0;
+}
+
+TEST(SimpleApi, EventQueue) {
+	char *const args[] = {"survive_tests", "--dummy", "--configfile", "simple_api_events_test.json"};
+	SurviveSimpleContext *actx = survive_simple_init(sizeof(args) / sizeof(args[0]), args);
+	ASSERT_EQ((actx != 0), 1);
+
+	SurviveContext *ctx = survive_simple_get_ctx(actx);
+	const SurviveSimpleObject *sao = survive_simple_get_first_object(actx);
+	ASSERT_EQ((sao != 0), 1);
+	SurviveObject *so = ctx->objs[0];
+
+	const size_t max_drain = 1000;
+	SurviveSimpleEvent *events = SV_CALLOC(max_drain, sizeof(SurviveSimpleEvent));
+	while (survive_simple_next_events(actx, events, max_drain)) {
+	}
+
+	// A few blocks' worth, ending partway into the last one
+	const uint32_t cnt = 3 * TEST_EVENT_BLOCK_SIZE + 5;
+	for (uint32_t i = 0; i < cnt; i++) {
+		ctx->buttonproc(so, 1, 2, 0, i, 1, 0);
+	}
+	ASSERT_EQ(survive_simple_get_dropped_event_count(actx), 0);
+
+	// Stop just past the first block boundary, then take the rest
+	const uint32_t partial = TEST_EVENT_BLOCK_SIZE + 6;
+	ASSERT_EQ(check_next_events(actx, sao, events, partial, partial, 0), 0);
+	ASSERT_EQ(check_next_events(actx, sao, events, max_drain, cnt - partial, partial), 0);
+	ASSERT_EQ(survive_simple_next_events(actx, events, max_drain), 0);
+
+	// Fill the queue; only what comes after that is dropped
+	for (uint32_t i = 0; i < TEST_MAX_EVENT_CNT; i++) {
+		ctx->buttonproc(so, 1, 2, 0, i, 1, 0);
+	}
+	ASSERT_EQ(survive_simple_get_dropped_event_count(actx), 0);
+	ctx->buttonproc(so, 1, 2, 0, 0, 1, 0);
+	ctx->buttonproc(so, 1, 2, 0, 0, 1, 0);
+	ASSERT_EQ(survive_simple_get_dropped_event_count(actx), 2);
+
+	for (uint32_t drained = 0; drained < TEST_MAX_EVENT_CNT; drained += max_drain) {
+		size_t expected_cnt = TEST_MAX_EVENT_CNT - drained < max_drain ? TEST_MAX_EVENT_CNT - drained : max_drain;
+		ASSERT_EQ(check_next_events(actx, sao, events, max_drain, expected_cnt, drained), 0);
+	}
+	ASSERT_EQ(survive_simple_next_events(actx, events, max_drain), 0);
+
+	// Draining makes room again
+	ctx->buttonproc(so, 1, 2, 0, 7, 1, 0);
+	ASSERT_EQ(check_next_events(actx, sao, events, max_drain, 1, 7), 0);
+	ASSERT_EQ(survive_simple_get_dropped_event_count(actx), 2);
+
+	free(events);
+	survive_simple_close(actx);
+	remove("simple_api_events_test.json");
+	return 0;
+}
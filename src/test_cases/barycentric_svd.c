@@ -0,0 +1,99 @@
+#include "../barycentric_svd/barycentric_svd.h"
+#include "test_case.h"
+
+#include <stdlib.h>
+
+#define BC_SVD_TEST_POINTS 16
+
+// Gen 1 style sweeps; each angle puts the point on the plane through the origin with this normal
+static void test_fill_m(void *user, double *eq, int axis, double angle) {
+	double sv = sin(angle), cv = cos(angle);
+	eq[0] = axis == 0 ? cv : 0;
+	eq[1] = axis == 0 ? 0 : cv;
+	eq[2] = -sv;
+}
+
+static int check_pose(bc_svd *bc, double Rtruth[3][3], const double *ttruth) {
+	double R[3][3], t[3];
+	double err = bc_svd_compute_pose(bc, R, t);
+	ASSERT_GE(err, 0.);
+	ASSERT_GT(1e-8, err);
+	ASSERT_DOUBLE_ARRAY_EQ(3, t, ttruth);
+	for (int i = 0; i < 3; i++) {
+		ASSERT_DOUBLE_ARRAY_EQ(3, R[i], Rtruth[i]);
+	}
+	return 0;
+}
+
+TEST(BarycentricSVD, IncrementalCorrespondences) {
+	LinmathPoint3d pts[BC_SVD_TEST_POINTS];
+	srand(5);
+	for (int i = 0; i < BC_SVD_TEST_POINTS; i++) {
+		for (int j = 0; j < 3; j++) {
+			pts[i][j] = (rand() / (double)RAND_MAX - .5) * .2;
+		}
+	}
+
+	LinmathQuat q;
+	LinmathAxisAngle axis = {.3, -.5, .8};
+	quatfromaxisangle(q, axis, .7);
+	double R[3][3], t[3] = {.1, -.2, 2};
+	quattomatrix33(R[0], q);
+
+	bc_svd bc;
+	bc_svd_bc_svd(&bc, 0, test_fill_m, (const LinmathPoint3d *)pts, BC_SVD_TEST_POINTS);
+
+	double angles[BC_SVD_TEST_POINTS][2];
+	for (int i = 0; i < BC_SVD_TEST_POINTS; i++) {
+		double p[3];
+		for (int j = 0; j < 3; j++) {
+			p[j] = R[j][0] * pts[i][0] + R[j][1] * pts[i][1] + R[j][2] * pts[i][2] + t[j];
+		}
+		angles[i][0] = atan2(p[0], p[2]);
+		angles[i][1] = atan2(p[1], p[2]);
+		bc_svd_add_correspondence(&bc, i, angles[i][0], angles[i][1]);
+	}
+	ASSERT_EQ(bc.meas_cnt, 2 * BC_SVD_TEST_POINTS);
+	int rtn = check_pose(&bc, R, t);
+	if (rtn != 0)
+		return rtn;
+
+	// Bad correspondences that are replaced by the right ones again leave no trace, and neither does aging everything
+	// equally
+	bc_svd_add_correspondence(&bc, 3, .4, NAN);
+	bc_svd_add_correspondence(&bc, 5, -.2, .3);
+	bc_svd_add_correspondence(&bc, 3, angles[3][0], NAN);
+	bc_svd_add_correspondence(&bc, 5, angles[5][0], angles[5][1]);
+	bc_svd_decay_correspondences(&bc, .5);
+	ASSERT_EQ(bc.meas_cnt, 2 * BC_SVD_TEST_POINTS);
+	rtn = check_pose(&bc, R, t);
+	if (rtn != 0)
+		return rtn;
+
+	// Taking one back after a decay takes back what's left of it, not what it was added with
+	bc_svd_add_correspondence(&bc, 7, -.3, .1);
+	bc_svd_decay_correspondences(&bc, .25);
+	bc_svd_remove_correspondence(&bc, 7, -.3, .1);
+	ASSERT_EQ(bc.meas_cnt, 2 * BC_SVD_TEST_POINTS - 2);
+	ASSERT_DOUBLE_EQ(bc.meas_weight, (2 * BC_SVD_TEST_POINTS - 2) * .125);
+	rtn = check_pose(&bc, R, t);
+	if (rtn != 0)
+		return rtn;
+
+	// Updating with the same angle leaves that axis as it was; a NAN takes that axis back
+	bc_svd_update_correspondence(&bc, 2, angles[2][0], NAN);
+	ASSERT_EQ(bc.meas_cnt, 2 * BC_SVD_TEST_POINTS - 3);
+	ASSERT_DOUBLE_EQ(bc.meas_weights[2 * 2], .125);
+	rtn = check_pose(&bc, R, t);
+	if (rtn != 0)
+		return rtn;
+
+	// Once everything has decayed away there is nothing left to solve with
+	bc_svd_decay_correspondences(&bc, 1e-3);
+	ASSERT_EQ(bc.meas_cnt, 0);
+	double Rout[3][3], tout[3];
+	ASSERT_GT(0., bc_svd_compute_pose(&bc, Rout, tout));
+
+	bc_svd_dtor(&bc);
+	return 0;
+}
@@ -0,0 +1,92 @@
+#define SURVIVE_ENABLE_FULL_API
+#include "../survive_internal.h"
+#include "survive_batch.h"
+#include "test_case.h"
+#include <stdio.h>
+#include <string.h>
+
+static double test_clock(const SurviveContext *ctx, void *user) { return *(const double *)user; }
+
+TEST(Batch, DrainSwapsBuffers) {
+	char *const args[] = {"survive_tests", "--dummy", "--disable-calibrate", "--configfile", "batch_test.json"};
+	SurviveContext *ctx = survive_init(sizeof(args) / sizeof(args[0]), args);
+	ASSERT_EQ((ctx != 0), 1);
+	ASSERT_EQ(survive_startup(ctx), 0);
+	ASSERT_EQ(ctx->objs_ct, 1);
+	SurviveObject *so = ctx->objs[0];
+
+	double now = 2.5;
+	survive_install_run_time_fn(ctx, test_clock, &now);
+
+	SurviveBatch *batch = survive_batch_create(ctx, 2);
+
+	SurvivePose pose = {.Pos = {1, 2, 3}, .Rot = {0, 1, 0, 0}};
+	ctx->poseproc(so, 100, &pose);
+	FLT agm[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+	ctx->imuproc(so, 3, agm, 200, 1);
+	// Only two of each kind fit; the third angle is dropped
+	for (int i = 0; i < 3; i++) {
+		ctx->angleproc(so, i, 1, 300 + i, .001, .25 * i, 1);
+	}
+
+	const SurviveBatchData *data = survive_batch_drain(batch);
+	ASSERT_EQ(data->pose_cnt, 1);
+	ASSERT_EQ(data->imu_cnt, 1);
+	ASSERT_EQ(data->angle_cnt, 2);
+	ASSERT_EQ(data->dropped, 1);
+
+	const SurviveBatchPose *p = &data->poses[0];
+	ASSERT_EQ(strcmp(p->object, "DM0"), 0);
+	ASSERT_DOUBLE_EQ(p->time, 2.5);
+	ASSERT_EQ(p->timecode, 100);
+	ASSERT_DOUBLE_ARRAY_EQ(3, p->pos, pose.Pos);
+	ASSERT_DOUBLE_ARRAY_EQ(4, p->rot, pose.Rot);
+
+	const SurviveBatchIMU *imu = &data->imu[0];
+	const double *gyro = imu->gyro, *mag = imu->mag;
+	ASSERT_EQ(imu->timecode, 200);
+	ASSERT_EQ(imu->mask, 3);
+	ASSERT_EQ(imu->id, 1);
+	ASSERT_DOUBLE_ARRAY_EQ(3, imu->accel, agm);
+	ASSERT_DOUBLE_EQ(gyro[0], 4.);
+	ASSERT_DOUBLE_EQ(mag[2], 9.);
+
+	const SurviveBatchAngle *angle = &data->angles[1];
+	ASSERT_EQ(angle->timecode, 301);
+	ASSERT_EQ(angle->sensor_id, 1);
+	ASSERT_EQ(angle->lh, 1);
+	ASSERT_EQ(angle->plane, 1);
+	ASSERT_DOUBLE_EQ(angle->length, .001);
+	ASSERT_DOUBLE_EQ(angle->angle, .25);
+
+	// Events after a drain go to the other set and leave the drained one alone
+	const SurviveBatchPose *first_poses = data->poses;
+	now = 3;
+	pose.Pos[0] = -1;
+	ctx->poseproc(so, 400, &pose);
+	ASSERT_EQ(data->pose_cnt, 1);
+	ASSERT_DOUBLE_EQ(first_poses[0].pos[0], 1.);
+
+	data = survive_batch_drain(batch);
+	ASSERT_EQ((data->poses != first_poses), 1);
+	ASSERT_EQ(data->pose_cnt, 1);
+	ASSERT_EQ(data->imu_cnt, 0);
+	ASSERT_EQ(data->angle_cnt, 0);
+	ASSERT_EQ(data->dropped, 0);
+	ASSERT_DOUBLE_EQ(data->poses[0].time, 3.);
+	ASSERT_DOUBLE_EQ(data->poses[0].pos[0], -1.);
+
+	// Nothing since the last drain; the first set comes back empty
+	data = survive_batch_drain(batch);
+	ASSERT_EQ((data->poses == first_poses), 1);
+	ASSERT_EQ(data->pose_cnt, 0);
+	ASSERT_EQ(data->dropped, 0);
+
+	// Once freed, the batch no longer listens
+	survive_batch_free(batch);
+	ctx->poseproc(so, 500, &pose);
+
+	survive_close(ctx);
+	remove("batch_test.json");
+	return 0;
+}
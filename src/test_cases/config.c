@@ -0,0 +1,61 @@
+#include "../survive_config.h"
+#include "test_case.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static void count_change(SurviveContext *ctx, const char *tag, void *user) { (*(int *)user)++; }
+
+TEST(Config, AttachAndSubscribe) {
+	SurviveContext *ctx = SV_CALLOC(1, sizeof(SurviveContext));
+	ctx->log_target = stderr;
+	ctx->global_config_values = SV_MALLOC(sizeof(config_group));
+	ctx->temporary_config_values = SV_MALLOC(sizeof(config_group));
+	init_config_group(ctx->global_config_values, 30, ctx);
+	init_config_group(ctx->temporary_config_values, 30, ctx);
+
+	// Enough tags that both groups grow, and get reindexed, several times
+	char tag[32];
+	for (int i = 0; i < 500; i++) {
+		snprintf(tag, sizeof(tag), "test-tag-%d", i);
+		survive_configi(ctx, tag, SC_SETCONFIG, i);
+	}
+	for (int i = 0; i < 500; i++) {
+		snprintf(tag, sizeof(tag), "test-tag-%d", i);
+		ASSERT_EQ((int)survive_configi(ctx, tag, SC_GET, 0), i);
+	}
+
+	int ivar = 0, changes = 0;
+	FLT fvar = 0;
+	survive_attach_configi(ctx, "test-tag-7", &ivar);
+	survive_attach_configf(ctx, "test-tag-7", &fvar);
+	survive_config_subscribe(ctx, "test-tag-7", count_change, &changes);
+	ASSERT_EQ(ivar, 7);
+
+	// Attached variables get the value converted to their own type
+	survive_configf(ctx, "test-tag-7", SC_SET | SC_OVERRIDE, 2.75);
+	ASSERT_EQ(ivar, 3);
+	ASSERT_DOUBLE_EQ(fvar, 2.75);
+	ASSERT_EQ(changes, 1);
+
+	// Neither setting the same value again nor changing the global value underneath it changes what is in effect
+	survive_configf(ctx, "test-tag-7", SC_SET | SC_OVERRIDE, 2.75);
+	config_set_uint32(ctx->global_config_values, "test-tag-7", 42);
+	ASSERT_EQ(ivar, 3);
+	ASSERT_EQ(changes, 1);
+
+	survive_config_unsubscribe(ctx, "test-tag-7", count_change, &changes);
+	survive_detach_config(ctx, "test-tag-7", &ivar);
+	survive_configi(ctx, "test-tag-7", SC_SET | SC_OVERRIDE, 9);
+	ASSERT_EQ(ivar, 3);
+	ASSERT_EQ(changes, 1);
+	ASSERT_DOUBLE_EQ(fvar, 9.);
+	survive_detach_config(ctx, "test-tag-7", &fvar);
+
+	destroy_config_group(ctx->global_config_values);
+	destroy_config_group(ctx->temporary_config_values);
+	free(ctx->global_config_values);
+	free(ctx->temporary_config_values);
+	free(ctx);
+	return 0;
+}
@@ -1,8 +1,10 @@
 #include "../survive_imu.h"
+#include "../survive_kalman.h"
 #include "test_case.h"
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 static const double two_pi = 2.0 * 3.14159265358979323846;
 
@@ -127,3 +129,61 @@ TEST(Kalman, Inexact) {
 	const FLT rot_variance = 0.01;
 	return TestKalmanIntegratePose(pvariance, rot_variance);
 }
+
+static void kalman_test_f2(FLT t, FLT *F) {
+	FLT f[] = {1, t, 0, 1};
+	memcpy(F, f, sizeof(f));
+}
+
+static void kalman_test_f3(FLT t, FLT *F) {
+	FLT f[] = {1, t, t * t / 2., 0, 1, t, 0, 0, 1};
+	memcpy(F, f, sizeof(f));
+}
+
+static void kalman_run(survive_kalman_state_t *k, size_t iterations, const FLT *H) {
+	srand(42);
+	for (size_t i = 0; i < iterations; i++) {
+		FLT z[4];
+		for (int j = 0; j < 4; j++)
+			z[j] = rand() / (FLT)RAND_MAX;
+		survive_kalman_predict_update_state(.001, k, z, H, .1);
+	}
+}
+
+// Both kernel sets have to agree; survive-bench's kalman benchmarks compare their speed
+static int check_kalman_fixed_kernels(size_t state_cnt, F_fn_t F, size_t *dims, const FLT *Q, const FLT *H) {
+	const size_t iterations = 1000;
+
+	survive_kalman_state_t fixed, generic;
+	survive_kalman_state_init(&fixed, state_cnt, F, Q, 0, dims, 0);
+	survive_kalman_state_init(&generic, state_cnt, F, Q, 0, dims, 0);
+	survive_kalman_use_generic_kernels(&generic.info);
+
+	kalman_run(&fixed, iterations, H);
+	kalman_run(&generic, iterations, H);
+
+	for (size_t i = 0; i < state_cnt * state_cnt; i++) {
+		ASSERT_DOUBLE_EQ(fixed.info.P[i], generic.info.P[i]);
+	}
+	for (size_t i = 0; i < state_cnt * fixed.max_dim_cnt; i++) {
+		ASSERT_DOUBLE_EQ(fixed.state[i], generic.state[i]);
+	}
+
+	survive_kalman_state_free(&fixed);
+	survive_kalman_state_free(&generic);
+	return 0;
+}
+
+TEST(Kalman, FixedKernels) {
+	size_t dims2[] = {4, 3};
+	FLT Q2[] = {1e-3, 0, 0, 1e-2};
+	FLT H2[] = {1, 0};
+	int rtn = check_kalman_fixed_kernels(2, kalman_test_f2, dims2, Q2, H2);
+	if (rtn != 0)
+		return rtn;
+
+	size_t dims3[] = {3, 3, 3};
+	FLT Q3[] = {1e-3, 0, 0, 0, 1e-2, 0, 0, 0, 1};
+	FLT H3[] = {1, 0, 0};
+	return check_kalman_fixed_kernels(3, kalman_test_f3, dims3, Q3, H3);
+}
@@ -0,0 +1,32 @@
+#include "../survive_latency.h"
+#include "test_case.h"
+#include <os_generic.h>
+
+TEST(Latency, Percentiles) {
+	SurviveObject so = {.latency = survive_latency_tracer_create()};
+
+	// 98 samples around 1ms and two around 50ms; p99 has to land in the slow group
+	for (int i = 0; i < 100; i++) {
+		double age = i < 98 ? .001 : .05;
+		survive_latency_mark(&so, SURVIVE_LATENCY_POSE, OGGetAbsoluteTime() - age);
+	}
+	// Unstamped data isn't recorded
+	survive_latency_mark(&so, SURVIVE_LATENCY_POSE, 0);
+
+	SurviveLatencyStats stats;
+	ASSERT_EQ(survive_object_latency(&so, SURVIVE_LATENCY_POSE, &stats), true);
+	ASSERT_EQ(stats.count, 100);
+	ASSERT_GE(stats.p50, .0009);
+	ASSERT_GT(.0013, stats.p50);
+	ASSERT_GE(stats.p99, .045);
+	ASSERT_GE(stats.max, stats.p99);
+	ASSERT_GT(.06, stats.max);
+
+	ASSERT_EQ(survive_object_latency(&so, SURVIVE_LATENCY_ANGLE, &stats), true);
+	ASSERT_EQ(stats.count, 0);
+
+	survive_latency_tracer_free(so.latency);
+	so.latency = 0;
+	ASSERT_EQ(survive_object_latency(&so, SURVIVE_LATENCY_POSE, &stats), false);
+	return 0;
+}
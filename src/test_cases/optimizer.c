@@ -0,0 +1,223 @@
+#include "../survive_default_devices.h"
+#include "../survive_parallel.h"
+#include "survive_optimizer.h"
+#include "survive_reproject_gen2.h"
+#include "test_case.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define OPTIMIZER_TEST_SENSORS 12
+#define OPTIMIZER_TEST_POSES 8
+
+// The optimizer takes its settings from the context of the object it solves for, so the tests use a real one. The
+// default norm tolerance stops well short of the exact answers these tests check for.
+static SurviveObject *create_test_object(void) {
+	char *const args[] = {"survive_tests",
+						  "--configfile",
+						  "optimizer_test.json",
+						  "--optimizer-pose-solver",
+						  "1",
+						  "--optimizer-normtol",
+						  "1e-20"};
+	SurviveContext *ctx = survive_init_with_logger(sizeof(args) / sizeof(args[0]), args, 0, 0);
+	if (ctx == 0) {
+		return 0;
+	}
+
+	SurviveObject *so = survive_create_device(ctx, "TST", 0, "TS0", 0);
+	so->sensor_ct = OPTIMIZER_TEST_SENSORS;
+	so->sensor_locations = SV_CALLOC(OPTIMIZER_TEST_SENSORS * 3, sizeof(FLT));
+
+	srand(42);
+	for (int i = 0; i < OPTIMIZER_TEST_SENSORS * 3; i++) {
+		so->sensor_locations[i] = (rand() / (FLT)RAND_MAX - .5) * .2;
+	}
+	return so;
+}
+
+static void free_test_object(SurviveObject *so) {
+	SurviveContext *ctx = so->ctx;
+	survive_destroy_device(so);
+	survive_close(ctx);
+	remove("optimizer_test.json");
+}
+
+static int solve_pose(SurviveObject *so, int use_jacobian_function, const SurvivePose *initial, SurvivePose *out,
+					  mp_result *result) {
+	const FLT *sensor_locations = so->sensor_locations;
+	survive_optimizer opt = {
+		.reprojectModel = &survive_reproject_gen2_model,
+		.so = so,
+		.poseLength = 1,
+		.cameraLength = 2,
+	};
+	SURVIVE_OPTIMIZER_SETUP_STACK_BUFFERS(opt);
+
+	SurvivePose lh2world[2] = {{.Pos = {0, 0, 3}, .Rot = {1}}, {.Pos = {2, .5, 2}, .Rot = {0.9659258, 0, 0.258819, 0}}};
+	const SurvivePose obj2world = {.Pos = {.1, -.2, .05}, .Rot = {0.9848078, 0.1736482, 0, 0}};
+
+	survive_optimizer_setup_pose(&opt, initial, false, use_jacobian_function);
+	for (int lh = 0; lh < 2; lh++) {
+		survive_optimizer_setup_camera(&opt, lh, &lh2world[lh], true, use_jacobian_function);
+		memset(survive_optimizer_get_calibration(&opt, lh), 0, 2 * sizeof(BaseStationCal));
+	}
+
+	for (int lh = 0; lh < 2; lh++) {
+		SurvivePose world2lh = InvertPoseRtn(&lh2world[lh]);
+		for (int sensor = 0; sensor < OPTIMIZER_TEST_SENSORS; sensor++) {
+			LinmathPoint3d ptInWorld, ptInLh;
+			ApplyPoseToPoint(ptInWorld, &obj2world, &sensor_locations[sensor * 3]);
+			ApplyPoseToPoint(ptInLh, &world2lh, ptInWorld);
+
+			FLT angles[2];
+			opt.reprojectModel->reprojectXY(survive_optimizer_get_calibration(&opt, lh), ptInLh, angles);
+			for (int axis = 0; axis < 2; axis++) {
+				opt.measurements[opt.measurementsCnt++] = (survive_optimizer_measurement){
+					.value = angles[axis], .variance = 1, .lh = lh, .sensor_idx = sensor, .axis = axis};
+			}
+		}
+	}
+
+	int res = survive_optimizer_run(&opt, result);
+	*out = *survive_optimizer_get_pose(&opt);
+
+	ASSERT_DOUBLE_ARRAY_EQ(3, out->Pos, obj2world.Pos);
+	ASSERT_QUAT_EQ(out->Rot, obj2world.Rot);
+	return res;
+}
+
+TEST(Optimizer, PoseSolverMatchesMPFIT) {
+	const SurvivePose initial = {.Pos = {.15, -.1, 0}, .Rot = {1}};
+	SurviveObject *so = create_test_object();
+	ASSERT_EQ((so != 0), 1);
+
+	// With analytic jacobians and only the pose free, survive_optimizer_run uses the dedicated pose solver, which is
+	// on by default.
+	SurvivePose pose_solver, mpfit;
+	mp_result pose_result = {0}, mpfit_result = {0};
+	int pose_res = solve_pose(so, 1, &initial, &pose_solver, &pose_result);
+	ASSERT_GT((double)pose_res, 0.);
+	ASSERT_EQ(strcmp(pose_result.version, "pose-lm"), 0);
+
+	// Numerical jacobians aren't handled there, so this goes through mpfit
+	int mpfit_res = solve_pose(so, 0, &initial, &mpfit, &mpfit_result);
+	ASSERT_GT((double)mpfit_res, 0.);
+	ASSERT_EQ((strcmp(mpfit_result.version, "pose-lm") != 0), 1);
+	free_test_object(so);
+
+	printf("Pose solver: %d iterations %d fev; mpfit: %d iterations %d fev\n", pose_result.niter, pose_result.nfev,
+		   mpfit_result.niter, mpfit_result.nfev);
+
+	ASSERT_DOUBLE_ARRAY_EQ(3, pose_solver.Pos, mpfit.Pos);
+	ASSERT_QUAT_EQ(pose_solver.Rot, mpfit.Rot);
+	return 0;
+}
+
+// Solves for a batch of poses and the second lighthouse; with a pool the evaluation is split over its threads
+static int solve_batch(SurviveObject *so, survive_parallel_pool *pool, SurvivePose *poses, SurvivePose *lh,
+					   mp_result *result) {
+	const FLT *sensor_locations = so->sensor_locations;
+	survive_optimizer opt = {.reprojectModel = &survive_reproject_gen2_model,
+							 .so = so,
+							 .poseLength = OPTIMIZER_TEST_POSES,
+							 .cameraLength = 2,
+							 .parallel_pool = pool,
+							 .parallel_threshold = 1};
+	SURVIVE_OPTIMIZER_SETUP_HEAP_BUFFERS(opt);
+
+	// The single axis jacobians don't handle a zero rotation, so nothing here is left unrotated
+	SurvivePose lh2world[2] = {{.Pos = {0, 0, 3}, .Rot = {0.9998477, 0, 0, 0.0174524}},
+							   {.Pos = {2, .5, 2}, .Rot = {0.9659258, 0, 0.258819, 0}}};
+	SurvivePose truth[OPTIMIZER_TEST_POSES], initial[OPTIMIZER_TEST_POSES];
+	for (int i = 0; i < OPTIMIZER_TEST_POSES; i++) {
+		truth[i] = (SurvivePose){.Pos = {.1 * i, -.2, .05 * i}, .Rot = {0.9848078, 0.1736482, 0, 0}};
+		initial[i] = (SurvivePose){.Pos = {.1 * i + .03, -.15, .05 * i}, .Rot = {0.9961947, 0.0871557, 0, 0}};
+	}
+
+	survive_optimizer_setup_pose(&opt, initial, false, 1);
+	for (int lh = 0; lh < 2; lh++) {
+		survive_optimizer_setup_camera(&opt, lh, &lh2world[lh], lh == 0, 1);
+		memset(survive_optimizer_get_calibration(&opt, lh), 0, 2 * sizeof(BaseStationCal));
+	}
+	survive_optimizer_get_camera(&opt)[1].Pos[0] += .05;
+
+	for (int i = 0; i < OPTIMIZER_TEST_POSES; i++) {
+		for (int lh = 0; lh < 2; lh++) {
+			SurvivePose world2lh = InvertPoseRtn(&lh2world[lh]);
+			for (int sensor = 0; sensor < OPTIMIZER_TEST_SENSORS; sensor++) {
+				LinmathPoint3d ptInWorld, ptInLh;
+				ApplyPoseToPoint(ptInWorld, &truth[i], &sensor_locations[sensor * 3]);
+				ApplyPoseToPoint(ptInLh, &world2lh, ptInWorld);
+
+				FLT angles[2];
+				opt.reprojectModel->reprojectXY(survive_optimizer_get_calibration(&opt, lh), ptInLh, angles);
+
+				// Leave some sensors with only one axis so not everything is a pair
+				int axis_cnt = (sensor + i) % 5 == 0 ? 1 : 2;
+				for (int axis = 0; axis < axis_cnt; axis++) {
+					opt.measurements[opt.measurementsCnt++] = (survive_optimizer_measurement){.value = angles[axis],
+																							  .variance = 1,
+																							  .lh = lh,
+																							  .sensor_idx = sensor,
+																							  .axis = axis,
+																							  .object = i};
+				}
+			}
+		}
+	}
+
+	int res = survive_optimizer_run(&opt, result);
+	memcpy(poses, survive_optimizer_get_pose(&opt), sizeof(SurvivePose) * OPTIMIZER_TEST_POSES);
+	*lh = survive_optimizer_get_camera(&opt)[1];
+
+	SURVIVE_OPTIMIZER_CLEANUP_HEAP_BUFFERS(opt);
+	return res;
+}
+
+TEST(Optimizer, ParallelMatchesSerial) {
+	SurviveObject *so = create_test_object();
+	ASSERT_EQ((so != 0), 1);
+	survive_parallel_pool *pool = survive_parallel_pool_create(so->ctx, 3);
+
+	SurvivePose serial[OPTIMIZER_TEST_POSES], parallel[OPTIMIZER_TEST_POSES], serial_lh, parallel_lh;
+	mp_result serial_result = {0}, parallel_result = {0};
+	int serial_res = solve_batch(so, 0, serial, &serial_lh, &serial_result);
+	int parallel_res = solve_batch(so, pool, parallel, &parallel_lh, &parallel_result);
+	survive_parallel_pool_free(pool);
+	free_test_object(so);
+
+	printf("Serial: %d iterations %g; parallel: %d iterations %g\n", serial_result.niter, serial_result.bestnorm,
+		   parallel_result.niter, parallel_result.bestnorm);
+	ASSERT_GT((FLT)serial_res, 0.);
+	ASSERT_EQ(serial_res, parallel_res);
+	ASSERT_EQ(serial_result.niter, parallel_result.niter);
+	ASSERT_EQ((serial_result.bestnorm == parallel_result.bestnorm), 1);
+
+	// Every row comes from the same code with the same inputs, so the solves match exactly
+	ASSERT_EQ(memcmp(serial, parallel, sizeof(serial)), 0);
+	ASSERT_EQ(memcmp(&serial_lh, &parallel_lh, sizeof(serial_lh)), 0);
+	return 0;
+}
+
+// Lighthouse solves that leave the object behind a lighthouse which saw it get thrown out
+TEST(Optimizer, CamerasFaceObject) {
+	survive_optimizer opt = {.poseLength = 1, .cameraLength = 2};
+	SURVIVE_OPTIMIZER_SETUP_STACK_BUFFERS(opt);
+
+	SurvivePose front = {.Pos = {0, 0, 3}, .Rot = {1}}, behind = {.Pos = {0, 0, -3}, .Rot = {1}};
+	survive_optimizer_setup_pose(&opt, &LinmathPose_Identity, false, 0);
+	survive_optimizer_setup_camera(&opt, 0, &front, false, 0);
+	survive_optimizer_setup_camera(&opt, 1, &behind, false, 0);
+
+	size_t both_seen[NUM_GEN2_LIGHTHOUSES] = {10, 10}, front_seen[NUM_GEN2_LIGHTHOUSES] = {10, 0};
+	ASSERT_EQ(survive_optimizer_cameras_face_object(&opt, both_seen), false);
+	ASSERT_EQ(survive_optimizer_cameras_face_object(&opt, 0), false);
+	ASSERT_EQ(survive_optimizer_cameras_face_object(&opt, front_seen), true);
+
+	// Lighthouses the solve left unset are skipped
+	survive_optimizer_setup_camera(&opt, 1, 0, false, 0);
+	ASSERT_EQ(survive_optimizer_cameras_face_object(&opt, both_seen), true);
+	return 0;
+}
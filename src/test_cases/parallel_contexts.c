@@ -0,0 +1,121 @@
+#include "test_case.h"
+#include <os_generic.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PARALLEL_CONTEXTS 4
+
+static const char *init_configfile = "parallel_contexts_init.json";
+
+// Both lighthouses solved up front, facing each other across the simulated volume
+static const char *init_config = "\"lighthouse0\":{\n"
+								 "\"index\":\"0\",\"id\":\"1\",\"mode\":\"0\",\n"
+								 "\"OOTXSet\":\"1\",\"PositionSet\":\"1\",\n"
+								 "\"pose\":[\"-3\",\"0\",\"1\",\"-0.707107\",\"0\",\"0.707107\",\"0\"]\n"
+								 "}\n"
+								 "\"lighthouse1\":{\n"
+								 "\"index\":\"1\",\"id\":\"2\",\"mode\":\"1\",\n"
+								 "\"OOTXSet\":\"1\",\"PositionSet\":\"1\",\n"
+								 "\"pose\":[\"3\",\"0\",\"1\",\"0.707107\",\"0\",\"0.707107\",\"0\"]\n"
+								 "}\n";
+
+typedef struct simulated_run {
+	int idx;
+	int rtn;
+	FLT move_threshold_ang;
+	SurvivePose pose;
+} simulated_run;
+
+static void quiet_log(SurviveContext *ctx, SurviveLogLevel logLevel, const char *fault) {
+	if (logLevel == SURVIVE_LOG_LEVEL_ERROR)
+		fprintf(stderr, "%s", fault);
+}
+
+static void *run_simulator(void *_run) {
+	simulated_run *run = _run;
+
+	char configfile[64];
+	snprintf(configfile, sizeof(configfile), "parallel_contexts_%d.json", run->idx);
+	remove(configfile);
+
+	// Every context gets its own movement thresholds, so any that leak between contexts show up
+	char gyro[32], acc[32], ang[32];
+	snprintf(gyro, sizeof(gyro), "%f", .05 + .01 * run->idx);
+	snprintf(acc, sizeof(acc), "%f", .02 + .01 * run->idx);
+	snprintf(ang, sizeof(ang), "%f", .01 + .005 * run->idx);
+
+	char *const args[] = {"survive_tests",
+						  "--simulator",
+						  "--simulator-time",
+						  "1",
+						  "--time-factor",
+						  "0",
+						  "--move-threshold-gyro",
+						  gyro,
+						  "--move-threshold-acc",
+						  acc,
+						  "--move-threshold-ang",
+						  ang,
+						  "--configfile",
+						  configfile,
+						  "--init-configfile",
+						  (char *)init_configfile};
+	SurviveContext *ctx = survive_init_with_logger(sizeof(args) / sizeof(args[0]), args, 0, quiet_log);
+	if (ctx == 0) {
+		run->rtn = -1;
+		return 0;
+	}
+
+	// The simulator generates data as fast as it is polled
+	ctx->poll_min_time_ms = 0;
+	while (survive_poll(ctx) == 0) {
+	}
+
+	run->rtn = ctx->objs_ct > 0 ? 0 : -2;
+	if (ctx->objs_ct > 0) {
+		run->pose = ctx->objs[0]->OutPose;
+		run->move_threshold_ang = ctx->objs[0]->activations.move_threshold_ang;
+	}
+
+	survive_close(ctx);
+	remove(configfile);
+	return 0;
+}
+
+// Every context owns all of its state, so the same simulated session ends up in the same place no matter how many
+// other contexts, configured differently, run alongside it.
+TEST(Reentrancy, ParallelSimulatedContexts) {
+	FILE *f = fopen(init_configfile, "w");
+	ASSERT_EQ((f != 0), 1);
+	fputs(init_config, f);
+	fclose(f);
+
+	simulated_run serial[PARALLEL_CONTEXTS] = {0};
+	for (int i = 0; i < PARALLEL_CONTEXTS; i++) {
+		serial[i].idx = i;
+		run_simulator(&serial[i]);
+		ASSERT_EQ(serial[i].rtn, 0);
+	}
+
+	simulated_run runs[PARALLEL_CONTEXTS] = {0};
+	og_thread_t threads[PARALLEL_CONTEXTS];
+	for (int i = 0; i < PARALLEL_CONTEXTS; i++) {
+		runs[i].idx = i;
+		threads[i] = OGCreateThread(run_simulator, &runs[i]);
+	}
+
+	for (int i = 0; i < PARALLEL_CONTEXTS; i++) {
+		OGJoinThread(threads[i]);
+	}
+
+	for (int n = 0; n < PARALLEL_CONTEXTS; n++) {
+		const SurvivePose *pose = &runs[n].pose, *expected = &serial[n].pose;
+		ASSERT_EQ(runs[n].rtn, 0);
+		ASSERT_DOUBLE_EQ(runs[n].move_threshold_ang, .01 + .005 * n);
+		ASSERT_DOUBLE_ARRAY_EQ(3, pose->Pos, expected->Pos);
+		ASSERT_QUAT_EQ(pose->Rot, expected->Rot);
+	}
+
+	remove(init_configfile);
+	return 0;
+}
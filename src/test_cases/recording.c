@@ -0,0 +1,204 @@
+#include "test_case.h"
+#include <os_generic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../survive_playback.h"
+#include "../survive_recording.h"
+
+static const char *recording_lines[] = {
+	"0.000000 SM0 CONFIG {\"a\": 1}\r\n",
+	"0.100000 0 LH_POSE 1.000000 2.000000 3.000000 1.000000 0.000000 0.000000 0.000000\n",
+	"0.200000 SM0 POSE 0.100000 0.200000 0.300000 1.000000 0.000000 0.000000 0.000000\n",
+	"0.300000 SM0 Y 1 123456 1 0\n",
+	"0.400000 SM0 W 1 5 123460 1\n",
+	"0.500000 SM0 B 1 5 123470 0 +0.123456\n",
+	"0.600000 SM0 C 5 123480 30\n",
+	"0.700000 SM0 L X 5 0 100 123490 30 0\n",
+	"0.800000 SM0 I 3 123500 0.100000 0.200000 9.800000 0.010000 0.020000 0.030000  0.000000 0.000000 0.000000 0\n",
+	"0.900000 INFO LOG \tindented message\n",
+};
+
+TEST(Recording, TextRoundTrip) {
+	for (int i = 0; i < sizeof(recording_lines) / sizeof(recording_lines[0]); i++) {
+		const char *line = recording_lines[i];
+		double time = 0;
+		int offset = 0;
+		sscanf(line, "%lf %n", &time, &offset);
+
+		char text[256];
+		strcpy(text, line + offset);
+		text[strcspn(text, "\r\n")] = 0;
+
+		SurviveRecord record;
+		ASSERT_EQ(survive_record_from_text(&record, sizeof(record), time, text), 0);
+
+		char output[512];
+		survive_record_to_text(&record.hdr, output, sizeof(output));
+		if (strcmp(output, line) != 0) {
+			fprintf(stderr, "Expected '%s', got '%s'\n", line, output);
+			return -1;
+		}
+	}
+
+	SurviveRecord record;
+	ASSERT_EQ(survive_record_from_text(&record, sizeof(record), 0, "SM0 NOT_AN_OP 1 2 3"), -2);
+	return 0;
+}
+
+TEST(Recording, BinaryRoundTrip) {
+	const char *path = "recording_test.bin";
+	SurviveRecordingBinaryWriter *writer = survive_recording_binary_writer_open(path);
+	ASSERT_EQ((writer != 0), 1);
+
+	for (int i = 0; i < 100; i++) {
+		SurviveRecord record;
+		survive_record_init(&record, SURVIVE_RECORD_SYNC, i * .01, "WM0");
+		record.sync.timecode = i * 1000;
+		record.sync.channel = i % 16;
+		survive_recording_binary_writer_write(writer, &record.hdr);
+	}
+	survive_recording_binary_writer_close(writer);
+
+	ASSERT_EQ(survive_recording_is_binary_file(path), 1);
+	SurviveRecordingBinaryReader *reader = survive_recording_binary_reader_open(path);
+	ASSERT_EQ((reader != 0), 1);
+
+	int cnt = 0;
+	const SurviveRecordHeader *hdr;
+	while ((hdr = survive_recording_binary_reader_peek(reader))) {
+		const SurviveRecordSync *sync = (const SurviveRecordSync *)hdr;
+		ASSERT_EQ(hdr->type, SURVIVE_RECORD_SYNC);
+		ASSERT_EQ(strcmp(hdr->dev, "WM0"), 0);
+		ASSERT_EQ(sync->timecode, cnt * 1000);
+		int channel = cnt % 16;
+		ASSERT_EQ(sync->channel, channel);
+		cnt++;
+		survive_recording_binary_reader_next(reader);
+	}
+	ASSERT_EQ(cnt, 100);
+
+	survive_recording_binary_reader_close(reader);
+	remove(path);
+	return 0;
+}
+
+TEST(Recording, BinaryMalformed) {
+	const char *path = "recording_malformed.bin";
+	SurviveRecordingBinaryWriter *writer = survive_recording_binary_writer_open(path);
+	ASSERT_EQ((writer != 0), 1);
+
+	SurviveRecord record;
+	survive_record_init(&record, SURVIVE_RECORD_SYNC, 0, "WM0");
+	survive_recording_binary_writer_write(writer, &record.hdr);
+
+	// A blob claiming more data than its record holds
+	char blob_buffer[128];
+	SurviveRecordBlob *blob = (SurviveRecordBlob *)blob_buffer;
+	survive_record_init_blob(blob, sizeof(blob_buffer), SURVIVE_RECORD_INFO, 0, "WM0", "info", 4);
+	blob->length = 1000;
+	survive_recording_binary_writer_write(writer, &blob->hdr);
+
+	// A sync record cut down to just its header
+	survive_record_init(&record, SURVIVE_RECORD_SYNC, 0, "WM0");
+	record.hdr.size = sizeof(SurviveRecordHeader);
+	survive_recording_binary_writer_write(writer, &record.hdr);
+	survive_recording_binary_writer_close(writer);
+
+	SurviveRecordingBinaryReader *reader = survive_recording_binary_reader_open(path);
+	ASSERT_EQ((reader != 0), 1);
+	ASSERT_EQ((survive_recording_binary_reader_peek(reader) != 0), 1);
+	survive_recording_binary_reader_next(reader);
+	ASSERT_EQ((survive_recording_binary_reader_peek(reader) != 0), 0);
+	survive_recording_binary_reader_close(reader);
+
+	// Skip the bad blob by hand so the short sync record gets checked too
+	writer = survive_recording_binary_writer_open(path);
+	record.hdr.size = sizeof(SurviveRecordHeader);
+	survive_recording_binary_writer_write(writer, &record.hdr);
+	survive_recording_binary_writer_close(writer);
+
+	reader = survive_recording_binary_reader_open(path);
+	ASSERT_EQ((reader != 0), 1);
+	ASSERT_EQ((survive_recording_binary_reader_peek(reader) != 0), 0);
+	survive_recording_binary_reader_close(reader);
+
+	remove(path);
+	return 0;
+}
+
+#define RECORDING_THREADS 4
+#define RECORDS_PER_THREAD 20000
+
+typedef struct recording_producer {
+	SurviveContext *ctx;
+	char name[8];
+} recording_producer;
+
+static void *record_poses(void *_producer) {
+	recording_producer *producer = _producer;
+	SurvivePose pose = {.Rot = {1}};
+	for (int i = 0; i < RECORDS_PER_THREAD; i++) {
+		pose.Pos[0] = i;
+		producer->ctx->external_poseproc(producer->ctx, producer->name, &pose);
+	}
+	return 0;
+}
+
+// Records from many threads at once all make it to the file in the order each thread made them, or are counted as
+// dropped. Device configs don't fit in a queue slot, and have to make it through as well.
+TEST(Recording, ConcurrentWriters) {
+	const char *path = "recording_writers_test.bin";
+	char *const args[] = {"survive_tests", "--simulator", "--record", (char *)path, "--configfile",
+						  "recording_writers_test.json"};
+	SurviveContext *ctx = survive_init_with_logger(sizeof(args) / sizeof(args[0]), args, 0, 0);
+	ASSERT_EQ((ctx != 0), 1);
+	ASSERT_EQ(survive_startup(ctx), 0);
+
+	recording_producer producers[RECORDING_THREADS];
+	og_thread_t threads[RECORDING_THREADS];
+	for (int i = 0; i < RECORDING_THREADS; i++) {
+		producers[i].ctx = ctx;
+		snprintf(producers[i].name, sizeof(producers[i].name), "T%d", i);
+		threads[i] = OGCreateThread(record_poses, &producers[i]);
+	}
+	for (int i = 0; i < RECORDING_THREADS; i++) {
+		OGJoinThread(threads[i]);
+	}
+
+	uint32_t dropped = survive_recording_dropped(ctx);
+	survive_close(ctx);
+	remove("recording_writers_test.json");
+
+	SurviveRecordingBinaryReader *reader = survive_recording_binary_reader_open(path);
+	ASSERT_EQ((reader != 0), 1);
+
+	int configs = 0;
+	int cnt[RECORDING_THREADS] = {0};
+	double last[RECORDING_THREADS] = {-1, -1, -1, -1};
+	const SurviveRecordHeader *hdr;
+	while ((hdr = survive_recording_binary_reader_peek(reader))) {
+		int idx = -1;
+		if (hdr->type == SURVIVE_RECORD_EXTERNAL_POSE && sscanf(hdr->dev, "T%d", &idx) == 1) {
+			const SurviveRecordPose *pose = (const SurviveRecordPose *)hdr;
+			ASSERT_GT(pose->pose[0], last[idx]);
+			last[idx] = pose->pose[0];
+			cnt[idx]++;
+		}
+		if (hdr->type == SURVIVE_RECORD_CONFIG && hdr->size > sizeof(SurviveRecord)) {
+			configs++;
+		}
+		survive_recording_binary_reader_next(reader);
+	}
+	survive_recording_binary_reader_close(reader);
+	remove(path);
+
+	int total = 0;
+	for (int i = 0; i < RECORDING_THREADS; i++) {
+		total += cnt[i];
+	}
+	ASSERT_EQ(configs, 1);
+	ASSERT_GT((double)total, 0.);
+	ASSERT_EQ(total + (int)dropped, RECORDING_THREADS * RECORDS_PER_THREAD);
+	return 0;
+}
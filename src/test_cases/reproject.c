@@ -77,3 +77,126 @@ TEST(Reproject, Extents_gen2) {
 
 	return 0;
 }
+
+static FLT rand_range(FLT min, FLT max) { return min + (max - min) * rand() / (FLT)RAND_MAX; }
+
+// Odd count so the SIMD paths have a tail, and more than one chunk
+#define BATCH_TEST_CNT 37
+
+static int check_reproject_batch(const survive_reproject_model_t *model) {
+	BaseStationCal cal[2] = {{.phase = .01, .tilt = .02, .curve = .03, .gibpha = .4, .gibmag = .005},
+							 {.phase = -.01, .tilt = -.02, .curve = .01, .gibpha = 1.2, .gibmag = -.004}};
+	SurvivePose obj2world = {.Pos = {.1, .2, 1.5}, .Rot = {1, .1, -.2, .3}};
+	quatnormalize(obj2world.Rot, obj2world.Rot);
+	SurvivePose world2lh = {.Pos = {.3, -.1, -3}, .Rot = {1, -.05, .1, .02}};
+	quatnormalize(world2lh.Rot, world2lh.Rot);
+	SurvivePose obj2lh;
+	ApplyPoseToPose(&obj2lh, &world2lh, &obj2world);
+
+	FLT x[BATCH_TEST_CNT], y[BATCH_TEST_CNT], z[BATCH_TEST_CNT];
+	for (int i = 0; i < BATCH_TEST_CNT; i++) {
+		x[i] = rand_range(-.1, .1);
+		y[i] = rand_range(-.1, .1);
+		z[i] = rand_range(-.1, .1);
+	}
+
+	FLT ang_x[BATCH_TEST_CNT], ang_y[BATCH_TEST_CNT];
+	model->reprojectXYBatch(cal, &obj2lh, BATCH_TEST_CNT, x, y, z, ang_x, ang_y);
+
+	FLT jac[BATCH_TEST_CNT * 2 * 7];
+	model->reprojectFullJacObjPoseBatch(jac, &obj2world, &world2lh, cal, BATCH_TEST_CNT, x, y, z);
+
+	LinmathAxisAngleMag obj2worldRot, world2lhRot;
+	quattoaxisanglemag(obj2worldRot, obj2world.Rot);
+	quattoaxisanglemag(world2lhRot, world2lh.Rot);
+	LinmathAxisAnglePose obj2worldAA = {.Pos = {obj2world.Pos[0], obj2world.Pos[1], obj2world.Pos[2]},
+										.AxisAngleRot = {obj2worldRot[0], obj2worldRot[1], obj2worldRot[2]}};
+	LinmathAxisAnglePose world2lhAA = {.Pos = {world2lh.Pos[0], world2lh.Pos[1], world2lh.Pos[2]},
+									   .AxisAngleRot = {world2lhRot[0], world2lhRot[1], world2lhRot[2]}};
+	FLT jac_aa[BATCH_TEST_CNT * 2 * 6];
+	model->reprojectAxisAngleFullJacObjPoseBatch(jac_aa, &obj2worldAA, &world2lhAA, cal, BATCH_TEST_CNT, x, y, z);
+
+	for (int p = 0; p < BATCH_TEST_CNT; p++) {
+		LinmathPoint3d pt = {x[p], y[p], z[p]}, ptInLh;
+		ApplyPoseToPoint(ptInLh, &obj2lh, pt);
+
+		SurviveAngleReading expected;
+		model->reprojectXY(cal, ptInLh, expected);
+		ASSERT_DOUBLE_EQ(ang_x[p], expected[0]);
+		ASSERT_DOUBLE_EQ(ang_y[p], expected[1]);
+
+		FLT expected_jac[2 * 7];
+		model->reprojectFullJacObjPose(expected_jac, &obj2world, pt, &world2lh, cal);
+		const FLT *batch_jac = jac + p * 2 * 7;
+		ASSERT_DOUBLE_ARRAY_EQ(2 * 7, batch_jac, expected_jac);
+
+		// Not every model has the standalone axis angle jacobian, but they all have the fused one
+		FLT expected_aa[2 + 2 * 2 * 6];
+		model->reprojectAxisAngleWithJacs(expected_aa, &obj2worldAA, pt, &world2lhAA, cal);
+		const FLT *batch_jac_aa = jac_aa + p * 2 * 6, *expected_jac_aa = expected_aa + 2;
+		ASSERT_DOUBLE_ARRAY_EQ(2 * 6, batch_jac_aa, expected_jac_aa);
+	}
+
+	return 0;
+}
+
+TEST(Reproject, Batch) {
+	int rtn = check_reproject_batch(&survive_reproject_model);
+	if (rtn)
+		return rtn;
+	return check_reproject_batch(&survive_reproject_gen2_model);
+}
+
+static void reproject_axis_angle(const survive_reproject_model_t *model, const BaseStationCal *cal,
+								 const LinmathAxisAnglePose *obj2world, const LinmathPoint3d pt,
+								 const LinmathAxisAnglePose *world2lh, SurviveAngleReading out) {
+	LinmathPoint3d ptInWorld, ptInLh;
+	ApplyAxisAnglePoseToPoint(ptInWorld, obj2world, pt);
+	ApplyAxisAnglePoseToPoint(ptInLh, world2lh, ptInWorld);
+	model->reprojectXY(cal, ptInLh, out);
+}
+
+static int check_reproject_with_jacs(const survive_reproject_model_t *model) {
+	BaseStationCal cal[2] = {{.phase = .01, .tilt = .02, .curve = .03, .gibpha = .4, .gibmag = .005},
+							 {.phase = -.01, .tilt = -.02, .curve = .01, .gibpha = 1.2, .gibmag = -.004}};
+	LinmathAxisAnglePose poses[2] = {{.Pos = {.1, .2, 1.5}, .AxisAngleRot = {.2, -.4, .6}},
+									 {.Pos = {.3, -.1, -3}, .AxisAngleRot = {-.1, .2, .05}}};
+
+	for (int p = 0; p < 8; p++) {
+		LinmathPoint3d pt = {rand_range(-.1, .1), rand_range(-.1, .1), rand_range(-.1, .1)};
+
+		FLT out[2 + 2 * 2 * 6];
+		model->reprojectAxisAngleWithJacs(out, &poses[0], pt, &poses[1], cal);
+
+		SurviveAngleReading expected;
+		reproject_axis_angle(model, cal, &poses[0], pt, &poses[1], expected);
+		ASSERT_DOUBLE_ARRAY_EQ(2, out, expected);
+
+		// Central differences over each pose in turn; object first, then lighthouse
+		const FLT h = 1e-6;
+		for (int pose_idx = 0; pose_idx < 2; pose_idx++) {
+			for (int j = 0; j < 6; j++) {
+				LinmathAxisAnglePose plus[2] = {poses[0], poses[1]}, minus[2] = {poses[0], poses[1]};
+				((FLT *)&plus[pose_idx])[j] += h;
+				((FLT *)&minus[pose_idx])[j] -= h;
+
+				SurviveAngleReading ang_plus, ang_minus;
+				reproject_axis_angle(model, cal, &plus[0], pt, &plus[1], ang_plus);
+				reproject_axis_angle(model, cal, &minus[0], pt, &minus[1], ang_minus);
+
+				const FLT *jac = out + 2 + pose_idx * 2 * 6;
+				ASSERT_DOUBLE_EQ(jac[j], (ang_plus[0] - ang_minus[0]) / (2 * h));
+				ASSERT_DOUBLE_EQ(jac[j + 6], (ang_plus[1] - ang_minus[1]) / (2 * h));
+			}
+		}
+	}
+
+	return 0;
+}
+
+TEST(Reproject, WithJacs) {
+	int rtn = check_reproject_with_jacs(&survive_reproject_model);
+	if (rtn)
+		return rtn;
+	return check_reproject_with_jacs(&survive_reproject_gen2_model);
+}
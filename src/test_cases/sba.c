@@ -0,0 +1,116 @@
+#include "survive_reproject_gen2.h"
+#include "survive_sba.h"
+#include "test_case.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SBA_TEST_SENSORS 12
+#define SBA_TEST_POSES 100
+#define SBA_TEST_LIGHTHOUSES 3
+
+static FLT sba_test_rand(FLT scale) { return (rand() / (FLT)RAND_MAX - .5) * scale; }
+
+static int check_sba(const survive_reproject_model_t *model, uint32_t cal_mask) {
+	static FLT sensor_locations[SBA_TEST_SENSORS * 3];
+	static SurvivePose poses[SBA_TEST_POSES], truth[SBA_TEST_POSES];
+	static survive_optimizer_measurement measurements[SBA_TEST_POSES * SBA_TEST_LIGHTHOUSES * SBA_TEST_SENSORS * 2];
+
+	srand(42);
+	for (int i = 0; i < SBA_TEST_SENSORS * 3; i++) {
+		sensor_locations[i] = sba_test_rand(.2);
+	}
+
+	const SurvivePose lh2world[SBA_TEST_LIGHTHOUSES] = {{.Pos = {0, 0, 3}, .Rot = {1}},
+														{.Pos = {2, .5, 2}, .Rot = {0.9659258, 0, 0.258819, 0}},
+														{.Pos = {-2, -.5, 2.5}, .Rot = {0.9659258, 0, -0.258819, 0}}};
+	BaseStationCal fcal[SBA_TEST_LIGHTHOUSES][2] = {0};
+	for (int lh = 0; lh < SBA_TEST_LIGHTHOUSES; lh++) {
+		for (int axis = 0; axis < 2; axis++) {
+			for (int f = 0; f < sizeof(BaseStationCal) / sizeof(FLT); f++) {
+				if (cal_mask & (1u << f))
+					((FLT *)&fcal[lh][axis])[f] = sba_test_rand(.02);
+			}
+		}
+	}
+
+	survive_sba sba = {.reprojectModel = model,
+					   .sensor_locations = sensor_locations,
+					   .poses = poses,
+					   .poseCnt = SBA_TEST_POSES,
+					   .measurements = measurements,
+					   .lighthouseCnt = SBA_TEST_LIGHTHOUSES,
+					   .fixed_lighthouses = 1,
+					   .cal_mask = cal_mask};
+
+	for (int i = 0; i < SBA_TEST_POSES; i++) {
+		LinmathAxisAngleMag aa = {sba_test_rand(2), sba_test_rand(2), sba_test_rand(2)};
+		truth[i] = (SurvivePose){.Pos = {sba_test_rand(1), sba_test_rand(1), sba_test_rand(.5)}};
+		quatfromaxisangle(truth[i].Rot, aa, norm3d(aa));
+
+		for (int lh = 0; lh < SBA_TEST_LIGHTHOUSES; lh++) {
+			SurvivePose obj2lh, world2lh = InvertPoseRtn(&lh2world[lh]);
+			ApplyPoseToPose(&obj2lh, &world2lh, &truth[i]);
+			for (int sensor = 0; sensor < SBA_TEST_SENSORS; sensor++) {
+				LinmathPoint3d ptInLh;
+				ApplyPoseToPoint(ptInLh, &obj2lh, &sensor_locations[sensor * 3]);
+
+				FLT angles[2];
+				model->reprojectXY(fcal[lh], ptInLh, angles);
+				for (int axis = 0; axis < 2; axis++) {
+					measurements[sba.measurementsCnt++] = (survive_optimizer_measurement){.value = angles[axis],
+																						  .variance = 1,
+																						  .lh = lh,
+																						  .sensor_idx = sensor,
+																						  .axis = axis,
+																						  .object = i};
+				}
+			}
+		}
+
+		poses[i] = truth[i];
+		for (int j = 0; j < 3; j++)
+			poses[i].Pos[j] += sba_test_rand(.02);
+	}
+
+	// Lighthouse 0 anchors the world; the others start a few centimeters off and without calibration
+	for (int lh = 0; lh < SBA_TEST_LIGHTHOUSES; lh++) {
+		sba.lighthouses[lh] = lh2world[lh];
+		if (lh > 0) {
+			sba.lighthouses[lh].Pos[0] += .05;
+			sba.lighthouses[lh].Pos[2] -= .03;
+		}
+	}
+	sba.fcal[0][0] = fcal[0][0];
+	sba.fcal[0][1] = fcal[0][1];
+
+	survive_sba_result result;
+	int iterations = survive_sba_run(&sba, &result);
+	printf("SBA %d iterations, %g -> %g\n", iterations, result.orignorm, result.bestnorm);
+	ASSERT_GT((FLT)iterations, 0.);
+	ASSERT_GT(1e-10, result.bestnorm);
+	ASSERT_EQ(result.skipped_poses, 0);
+
+	for (int lh = 1; lh < SBA_TEST_LIGHTHOUSES; lh++) {
+		ASSERT_DOUBLE_ARRAY_EQ(3, sba.lighthouses[lh].Pos, lh2world[lh].Pos);
+		ASSERT_QUAT_EQ(sba.lighthouses[lh].Rot, lh2world[lh].Rot);
+		const FLT *cal = (const FLT *)sba.fcal[lh], *cal_truth = (const FLT *)fcal[lh];
+		ASSERT_DOUBLE_ARRAY_EQ(2 * sizeof(BaseStationCal) / sizeof(FLT), cal, cal_truth);
+	}
+	for (int i = 0; i < SBA_TEST_POSES; i++) {
+		ASSERT_DOUBLE_ARRAY_EQ(3, poses[i].Pos, truth[i].Pos);
+	}
+
+	// Out of order measurements are rejected
+	measurements[0].object = 1;
+	ASSERT_EQ(survive_sba_run(&sba, 0), -1);
+	return 0;
+}
+
+TEST(SBA, RecoverLighthouses) {
+	int rtn = check_sba(&survive_reproject_model, SURVIVE_SBA_CAL(phase) | SURVIVE_SBA_CAL(tilt));
+	if (rtn != 0)
+		return rtn;
+	return check_sba(&survive_reproject_gen2_model, SURVIVE_SBA_CAL(tilt) | SURVIVE_SBA_CAL(curve));
+}
@@ -0,0 +1,83 @@
+#include "test_case.h"
+#include <stdio.h>
+#include <string.h>
+
+static int check_fresh_readings(const SurviveSensorActivations *activations, survive_timecode tolerance,
+								survive_timecode now) {
+	SurviveSensorActivationsReading readings[SENSORS_PER_OBJECT * NUM_GEN2_LIGHTHOUSES * 2];
+	size_t cnt = SurviveSensorActivations_fresh_readings(activations, tolerance, now, readings,
+														 sizeof(readings) / sizeof(readings[0]));
+
+	bool seen[SENSORS_PER_OBJECT][NUM_GEN2_LIGHTHOUSES][2] = {0};
+	for (size_t i = 0; i < cnt; i++) {
+		ASSERT_EQ(seen[readings[i].sensor_idx][readings[i].lh][readings[i].axis], false);
+		seen[readings[i].sensor_idx][readings[i].lh][readings[i].axis] = true;
+	}
+
+	size_t expected = 0;
+	for (int sensor = 0; sensor < SENSORS_PER_OBJECT; sensor++) {
+		for (int lh = 0; lh < NUM_GEN2_LIGHTHOUSES; lh++) {
+			for (int axis = 0; axis < 2; axis++) {
+				bool valid = SurviveSensorActivations_isReadingValid(activations, tolerance, now, sensor, lh, axis);
+				ASSERT_EQ(seen[sensor][lh][axis], valid);
+				expected += valid;
+			}
+		}
+	}
+	ASSERT_EQ(cnt, expected);
+	return 0;
+}
+
+TEST(SensorActivations, FreshReadings) {
+	SurviveSensorActivations activations;
+	SurviveSensorActivations_ctor(0, &activations);
+
+	// What the old dense [sensor][lh][axis] layout would hold; the entries have to agree with it as they grow
+	static FLT angles[SENSORS_PER_OBJECT][NUM_GEN2_LIGHTHOUSES][2];
+	for (int i = 0; i < SENSORS_PER_OBJECT * NUM_GEN2_LIGHTHOUSES * 2; i++)
+		((FLT *)angles)[i] = NAN;
+
+	srand(42);
+	survive_timecode timecode = 0xFFF00000; // Make sure the timecode rolls over partway through
+	for (int i = 0; i < 20000; i++) {
+		// Readings mostly show up in order, with the occasional small step back
+		timecode += rand() % 2000;
+		PoserDataLightGen2 l = {0};
+		l.common.hdr.pt = POSERDATA_LIGHT_GEN2;
+		l.common.hdr.timecode = timecode - (rand() % 8 == 0 ? rand() % 4000 : 0);
+		l.common.sensor_id = rand() % SENSORS_PER_OBJECT;
+		l.common.lh = rand() % 4;
+		l.common.angle = (rand() % 1000) / 1000.;
+		l.plane = rand() % 2;
+		SurviveSensorActivations_add_gen2(&activations, &l);
+		angles[l.common.sensor_id][l.common.lh][l.plane] = l.common.angle;
+
+		if (i % 100 == 0) {
+			ASSERT_SUCCESS(check_fresh_readings(&activations, SurviveSensorActivations_default_tolerance, timecode));
+			ASSERT_SUCCESS(check_fresh_readings(&activations, 48000, timecode));
+		}
+	}
+
+	SurviveSensorActivations_reindex(&activations);
+	ASSERT_SUCCESS(check_fresh_readings(&activations, SurviveSensorActivations_default_tolerance, timecode));
+
+	SurviveSensorActivations copy = {0};
+	SurviveSensorActivations_copy(&copy, &activations);
+	SurviveSensorActivations_dtor(&activations);
+	ASSERT_SUCCESS(check_fresh_readings(&copy, SurviveSensorActivations_default_tolerance, timecode));
+
+	for (int sensor = 0; sensor < SENSORS_PER_OBJECT; sensor++) {
+		for (int lh = 0; lh < NUM_GEN2_LIGHTHOUSES; lh++) {
+			const FLT *entry_angles = SurviveSensorActivations_entry(&copy, sensor, lh)->angles;
+			for (int axis = 0; axis < 2; axis++) {
+				ASSERT_EQ(isnan(entry_angles[axis]), isnan(angles[sensor][lh][axis]));
+				if (!isnan(angles[sensor][lh][axis])) {
+					ASSERT_EQ((entry_angles[axis] == angles[sensor][lh][axis]), 1);
+				}
+			}
+		}
+	}
+
+	SurviveSensorActivations_dtor(&copy);
+	return 0;
+}
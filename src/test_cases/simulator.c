@@ -0,0 +1,85 @@
+#include "test_case.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SIMULATED_OBJECTS 3
+
+static const char *init_configfile = "simulator_init.json";
+
+static const char *init_config = "\"lighthouse0\":{\n"
+								 "\"index\":\"0\",\"id\":\"1\",\"mode\":\"0\",\n"
+								 "\"OOTXSet\":\"1\",\"PositionSet\":\"1\",\n"
+								 "\"pose\":[\"-3\",\"0\",\"1\",\"-0.707107\",\"0\",\"0.707107\",\"0\"]\n"
+								 "}\n"
+								 "\"lighthouse1\":{\n"
+								 "\"index\":\"1\",\"id\":\"2\",\"mode\":\"1\",\n"
+								 "\"OOTXSet\":\"1\",\"PositionSet\":\"1\",\n"
+								 "\"pose\":[\"3\",\"0\",\"1\",\"0.707107\",\"0\",\"0.707107\",\"0\"]\n"
+								 "}\n";
+
+typedef struct tracking_error {
+	SurvivePose truth[SIMULATED_OBJECTS];
+	FLT err[SIMULATED_OBJECTS];
+	int pose_cnt[SIMULATED_OBJECTS];
+} tracking_error;
+
+static void truth_process(SurviveContext *ctx, const char *name, const SurvivePose *pose) {
+	tracking_error *t = ctx->user_ptr;
+	int idx = 0;
+	if (strcmp(name, "Sim_GT") == 0 || sscanf(name, "Sim_GT%d", &idx) == 1) {
+		if (idx < SIMULATED_OBJECTS)
+			t->truth[idx] = *pose;
+	}
+}
+
+static void pose_process(SurviveObject *so, survive_timecode timecode, SurvivePose *pose) {
+	survive_default_pose_process(so, timecode, pose);
+
+	tracking_error *t = so->ctx->user_ptr;
+	int idx = 0;
+	if (sscanf(so->codename, "SM%d", &idx) == 1 && idx < SIMULATED_OBJECTS) {
+		t->err[idx] += dist3d(pose->Pos, t->truth[idx].Pos);
+		t->pose_cnt[idx]++;
+	}
+}
+
+static int track_noisy_objects(const char *time, const char *no_sleep, const char *poser_threads, int min_poses) {
+	FILE *f = fopen(init_configfile, "w");
+	ASSERT_EQ((f != 0), 1);
+	fputs(init_config, f);
+	fclose(f);
+
+	char *const args[] = {"survive_tests", "--simulator", "--simulator-time", (char *)time, "--simulator-no-sleep",
+						  (char *)no_sleep, "--simulator-objects", "3", "--simulator-sensor-noise", ".0005",
+						  "--simulator-imu-noise", ".01", "--simulator-dropout", ".05", "--simulator-occlusion", ".5",
+						  "--poser-threads", (char *)poser_threads, "--configfile", "simulator_test.json",
+						  "--init-configfile", (char *)init_configfile};
+	tracking_error t = {0};
+	SurviveContext *ctx = survive_init_with_logger(sizeof(args) / sizeof(args[0]), args, &t, 0);
+	ASSERT_EQ((ctx != 0), 1);
+
+	survive_install_external_pose_fn(ctx, truth_process);
+	survive_install_pose_fn(ctx, pose_process);
+	while (survive_poll(ctx) == 0) {
+	}
+
+	int objs_ct = ctx->objs_ct;
+	survive_close(ctx);
+	remove(init_configfile);
+	remove("simulator_test.json");
+
+	ASSERT_EQ(objs_ct, SIMULATED_OBJECTS);
+	for (int n = 0; n < SIMULATED_OBJECTS; n++) {
+		ASSERT_GT((double)t.pose_cnt[n], (double)min_poses);
+		ASSERT_GT(.03, t.err[n] / t.pose_cnt[n]);
+	}
+
+	return 0;
+}
+
+// Several objects, each seeing noisy light that comes and goes, should all still be tracked
+TEST(Simulator, NoisyObjects) { return track_noisy_objects("4", "1", "0", 1000); }
+
+// Sharing a pool of poser threads between the objects shouldn't change that. The pool drops what it can't keep up
+// with, so this one runs in real time.
+TEST(Simulator, PoserThreads) { return track_noisy_objects("1", "0", "2", 500); }
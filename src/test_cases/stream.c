@@ -0,0 +1,54 @@
+#include "test_case.h"
+#include <math.h>
+#include <string.h>
+#include <survive_stream.h>
+
+TEST(Stream, RoundTrip) {
+	SurviveStreamFrame pose = {.type = SURVIVE_STREAM_POSE,
+							   .seq = 0xfffffffe,
+							   .time = 12.5,
+							   .object = "WM0",
+							   .timecode = 0x12345678,
+							   .body.pose = {.Pos = {1, -2, 3.25}, .Rot = {.5, .5, -.5, .5}}};
+	SurviveStreamFrame button = {
+		.type = SURVIVE_STREAM_BUTTON,
+		.seq = 3,
+		.object = "T20",
+		.body.button = {.event_type = 3, .button_id = 24, .axis1_id = 1, .axis1_val = 0xbeef, .axis2_val = 7}};
+
+	uint8_t buffer[2 * SURVIVE_STREAM_MAX_FRAME_SIZE];
+	size_t len = survive_stream_encode(&pose, buffer, sizeof(buffer));
+	ASSERT_EQ(len, survive_stream_frame_size(SURVIVE_STREAM_POSE));
+	len += survive_stream_encode(&button, buffer + len, sizeof(buffer) - len);
+
+	// Little endian regardless of the host
+	ASSERT_EQ(buffer[4], 0xfe);
+	ASSERT_EQ(buffer[7], 0xff);
+
+	SurviveStreamFrame frame;
+	ASSERT_EQ(survive_stream_decode(&frame, buffer, SURVIVE_STREAM_HEADER_SIZE + 1), 0);
+
+	int used = survive_stream_decode(&frame, buffer, len);
+	ASSERT_EQ(used, survive_stream_frame_size(SURVIVE_STREAM_POSE));
+	ASSERT_EQ(frame.type, SURVIVE_STREAM_POSE);
+	ASSERT_EQ(frame.seq, 0xfffffffe);
+	ASSERT_EQ(frame.timecode, 0x12345678);
+	ASSERT_EQ(strcmp(frame.object, "WM0"), 0);
+	ASSERT_DOUBLE_EQ(frame.time, 12.5);
+	ASSERT_DOUBLE_ARRAY_EQ(3, frame.body.pose.Pos, pose.body.pose.Pos);
+	ASSERT_QUAT_EQ(frame.body.pose.Rot, pose.body.pose.Rot);
+
+	ASSERT_EQ(survive_stream_decode(&frame, buffer + used, len - used), len - used);
+	ASSERT_EQ(frame.type, SURVIVE_STREAM_BUTTON);
+	ASSERT_EQ(frame.body.button.button_id, 24);
+	ASSERT_EQ(frame.body.button.axis1_val, 0xbeef);
+	ASSERT_EQ(frame.body.button.axis2_val, 7);
+
+	// Unknown types are skipped over, anything that isn't a frame is rejected
+	buffer[0] = SURVIVE_STREAM_TYPE_MAX;
+	ASSERT_EQ(survive_stream_decode(&frame, buffer, len), used);
+	ASSERT_EQ(frame.type, SURVIVE_STREAM_NONE);
+	buffer[1] = SURVIVE_STREAM_VERSION + 1;
+	ASSERT_EQ(survive_stream_decode(&frame, buffer, len), -1);
+	return 0;
+}
@@ -33,6 +33,8 @@ static int test_path(const char *name, int main_argc, char **main_argv) {
 					(char *)name,
 					"--playback-factor",
 					"0",
+					"--playback-synchronous",
+					"1",
 					"--v",
 					"100"};
 	int argc = sizeof(argv) / sizeof(argv[0]);
@@ -0,0 +1,823 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include <os_generic.h>
+#include <survive.h>
+
+#include "survive_optimizer.h"
+#include "survive_reproject.h"
+#include "survive_reproject_gen2.h"
+
+#include "src/driver_vive.h"
+#include "src/survive_kalman.h"
+#include "src/survive_recording.h"
+
+/**
+ * Microbenchmarks for the hot paths of libsurvive. Every benchmark is run as a number of timed samples, each of which
+ * is a batch of operations sized so the sample takes about SAMPLE_TARGET_NS; ns/op is reported as the mean along with
+ * percentiles over the samples. Inputs are generated from fixed seeds so runs are comparable across versions.
+ *
+ * Optimizer problems written by survive_optimizer_serialize and recordings can be passed in to benchmark against real
+ * data; the disambiguators are only benchmarked on recordings that contain raw lightcap data.
+ */
+
+#define SAMPLE_TARGET_NS 2000000ull
+#define DEFAULT_SAMPLE_CNT 50
+#define MAX_INPUT_FILES 16
+
+static uint64_t bench_now_ns() {
+#ifdef _WIN32
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER now;
+	if (!freq.QuadPart)
+		QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&now);
+	return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+#endif
+}
+
+/**
+ * Allocations are counted by interposing the allocator; libsurvive and its plugins resolve malloc and friends to these
+ * definitions. Only available on glibc, elsewhere allocations/op is reported as -1.
+ */
+static volatile size_t bench_alloc_cnt;
+
+#if defined(__GLIBC__)
+#define BENCH_COUNTS_ALLOCATIONS 1
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) {
+	__atomic_fetch_add(&bench_alloc_cnt, 1, __ATOMIC_RELAXED);
+	return __libc_malloc(size);
+}
+void *calloc(size_t nmemb, size_t size) {
+	__atomic_fetch_add(&bench_alloc_cnt, 1, __ATOMIC_RELAXED);
+	return __libc_calloc(nmemb, size);
+}
+void *realloc(void *ptr, size_t size) {
+	__atomic_fetch_add(&bench_alloc_cnt, 1, __ATOMIC_RELAXED);
+	return __libc_realloc(ptr, size);
+}
+#else
+#define BENCH_COUNTS_ALLOCATIONS 0
+#endif
+
+static size_t bench_allocations() { return __atomic_load_n(&bench_alloc_cnt, __ATOMIC_RELAXED); }
+
+typedef struct bench_result {
+	char name[128];
+	size_t ops;
+	size_t samples;
+	double ns_per_op;
+	double min, p50, p90, p99, max;
+	double allocs_per_op;
+} bench_result;
+
+typedef struct bench_ctx {
+	const char *filter;
+	size_t sample_cnt;
+
+	// Human readable results go here; stderr when the JSON goes to stdout
+	FILE *table;
+
+	bench_result *results;
+	size_t results_cnt;
+} bench_ctx;
+
+// Runs 'iterations' operations of a benchmark
+typedef void (*bench_fn)(void *user, size_t iterations);
+
+static bool bench_selected(const bench_ctx *b, const char *name) {
+	return b->filter == 0 || strstr(name, b->filter) != 0;
+}
+
+static int compare_double(const void *_a, const void *_b) {
+	double a = *(const double *)_a, b = *(const double *)_b;
+	return (a > b) - (a < b);
+}
+
+static double percentile(const double *sorted, size_t cnt, double p) {
+	size_t idx = (size_t)(p * (cnt - 1) + .5);
+	return sorted[idx < cnt ? idx : cnt - 1];
+}
+
+/**
+ * Adds a result from per-sample ns/op numbers. Sorts 'samples' in place.
+ */
+static void bench_add_result(bench_ctx *b, const char *name, double *samples, size_t sample_cnt, size_t ops,
+							 uint64_t total_ns, size_t allocations) {
+	if (sample_cnt == 0 || ops == 0)
+		return;
+
+	b->results = realloc(b->results, sizeof(bench_result) * (b->results_cnt + 1));
+	bench_result *r = &b->results[b->results_cnt++];
+	memset(r, 0, sizeof(*r));
+	snprintf(r->name, sizeof(r->name), "%s", name);
+
+	qsort(samples, sample_cnt, sizeof(double), compare_double);
+	r->ops = ops;
+	r->samples = sample_cnt;
+	r->ns_per_op = total_ns / (double)ops;
+	r->min = samples[0];
+	r->p50 = percentile(samples, sample_cnt, .5);
+	r->p90 = percentile(samples, sample_cnt, .9);
+	r->p99 = percentile(samples, sample_cnt, .99);
+	r->max = samples[sample_cnt - 1];
+	r->allocs_per_op = BENCH_COUNTS_ALLOCATIONS ? allocations / (double)ops : -1;
+
+	fprintf(b->table, "%-56s %12.1f %12.1f %12.1f %12.1f %10.2f\n", r->name, r->ns_per_op, r->p50, r->p90, r->p99,
+			r->allocs_per_op);
+	fflush(b->table);
+}
+
+static void bench_run(bench_ctx *b, const char *name, bench_fn fn, void *user) {
+	if (!bench_selected(b, name))
+		return;
+
+	// Warm up and find a batch size that fills out a sample
+	size_t batch = 1;
+	while (true) {
+		uint64_t start = bench_now_ns();
+		fn(user, batch);
+		uint64_t elapsed = bench_now_ns() - start;
+		if (elapsed >= SAMPLE_TARGET_NS || batch >= (1u << 24))
+			break;
+		batch = elapsed == 0 ? batch * 16 : batch * 2;
+	}
+
+	double *samples = calloc(b->sample_cnt, sizeof(double));
+	uint64_t total_ns = 0;
+	size_t allocations_start = bench_allocations();
+	for (size_t i = 0; i < b->sample_cnt; i++) {
+		uint64_t start = bench_now_ns();
+		fn(user, batch);
+		uint64_t elapsed = bench_now_ns() - start;
+		samples[i] = elapsed / (double)batch;
+		total_ns += elapsed;
+	}
+	size_t allocations = bench_allocations() - allocations_start;
+
+	bench_add_result(b, name, samples, b->sample_cnt, batch * b->sample_cnt, total_ns, allocations);
+	free(samples);
+}
+
+/* Reprojection */
+
+#define BENCH_SENSOR_CNT 32
+
+typedef struct reproject_bench {
+	const survive_reproject_model_t *model;
+	BaseStationCal cal[2];
+	SurvivePose obj2world, world2lh, obj2lh;
+	LinmathAxisAnglePose obj2worldAA, world2lhAA;
+
+	FLT x[BENCH_SENSOR_CNT], y[BENCH_SENSOR_CNT], z[BENCH_SENSOR_CNT];
+	LinmathPoint3d ptsInLh[BENCH_SENSOR_CNT];
+
+	FLT out[BENCH_SENSOR_CNT * 2 * 7];
+	FLT sink;
+} reproject_bench;
+
+static FLT rand_range(FLT min, FLT max) { return min + (max - min) * rand() / (FLT)RAND_MAX; }
+
+static void reproject_bench_init(reproject_bench *r, const survive_reproject_model_t *model) {
+	memset(r, 0, sizeof(*r));
+	r->model = model;
+	srand(42);
+	for (int axis = 0; axis < 2; axis++) {
+		r->cal[axis] = (BaseStationCal){.phase = rand_range(-.01, .01),
+										.tilt = rand_range(-.01, .01),
+										.curve = rand_range(-.01, .01),
+										.gibpha = rand_range(-1, 1),
+										.gibmag = rand_range(-.01, .01),
+										.ogeephase = rand_range(-1, 1),
+										.ogeemag = rand_range(-.01, .01)};
+	}
+
+	r->obj2world = (SurvivePose){.Pos = {.1, .2, 1.2}, .Rot = {1, .1, -.2, .3}};
+	quatnormalize(r->obj2world.Rot, r->obj2world.Rot);
+	SurvivePose lh2world = {.Pos = {-1, 1, 2.5}, .Rot = {.9, .1, .3, 0}};
+	quatnormalize(lh2world.Rot, lh2world.Rot);
+	r->world2lh = InvertPoseRtn(&lh2world);
+	ApplyPoseToPose(&r->obj2lh, &r->world2lh, &r->obj2world);
+
+	LinmathAxisAngleMag aa;
+	memcpy(r->obj2worldAA.Pos, r->obj2world.Pos, sizeof(LinmathPoint3d));
+	quattoaxisanglemag(aa, r->obj2world.Rot);
+	memcpy(r->obj2worldAA.AxisAngleRot, aa, sizeof(LinmathAxisAngle));
+	memcpy(r->world2lhAA.Pos, r->world2lh.Pos, sizeof(LinmathPoint3d));
+	quattoaxisanglemag(aa, r->world2lh.Rot);
+	memcpy(r->world2lhAA.AxisAngleRot, aa, sizeof(LinmathAxisAngle));
+
+	for (int i = 0; i < BENCH_SENSOR_CNT; i++) {
+		r->x[i] = rand_range(-.1, .1);
+		r->y[i] = rand_range(-.1, .1);
+		r->z[i] = rand_range(-.1, .1);
+		LinmathPoint3d pt = {r->x[i], r->y[i], r->z[i]};
+		ApplyPoseToPoint(r->ptsInLh[i], &r->obj2lh, pt);
+	}
+}
+
+static void bench_reproject_xy(void *user, size_t iterations) {
+	reproject_bench *r = user;
+	SurviveAngleReading ang;
+	for (size_t i = 0; i < iterations; i++) {
+		r->model->reprojectXY(r->cal, r->ptsInLh[i % BENCH_SENSOR_CNT], ang);
+		r->sink += ang[0];
+	}
+}
+
+// One op is one sensor, so this compares directly with the single point version
+static void bench_reproject_xy_batch(void *user, size_t iterations) {
+	reproject_bench *r = user;
+	for (size_t i = 0; i < iterations; i += BENCH_SENSOR_CNT) {
+		size_t n = iterations - i < BENCH_SENSOR_CNT ? iterations - i : BENCH_SENSOR_CNT;
+		r->model->reprojectXYBatch(r->cal, &r->obj2lh, n, r->x, r->y, r->z, r->out, r->out + BENCH_SENSOR_CNT);
+		r->sink += r->out[0];
+	}
+}
+
+static void bench_reproject_jac_obj_pose(void *user, size_t iterations) {
+	reproject_bench *r = user;
+	for (size_t i = 0; i < iterations; i++) {
+		size_t idx = i % BENCH_SENSOR_CNT;
+		FLT pt[3] = {r->x[idx], r->y[idx], r->z[idx]};
+		r->model->reprojectFullJacObjPose(r->out, &r->obj2world, pt, &r->world2lh, r->cal);
+		r->sink += r->out[0];
+	}
+}
+
+static void bench_reproject_jac_obj_pose_axisangle(void *user, size_t iterations) {
+	reproject_bench *r = user;
+	for (size_t i = 0; i < iterations; i++) {
+		size_t idx = i % BENCH_SENSOR_CNT;
+		FLT pt[3] = {r->x[idx], r->y[idx], r->z[idx]};
+		r->model->reprojectAxisAngleFullJacObjPose(r->out, &r->obj2worldAA, pt, &r->world2lhAA, r->cal);
+		r->sink += r->out[0];
+	}
+}
+
+static void run_reproject_benches(bench_ctx *b) {
+	struct {
+		const char *name;
+		const survive_reproject_model_t *model;
+	} models[] = {{"gen1", &survive_reproject_model}, {"gen2", &survive_reproject_gen2_model}};
+
+	for (int i = 0; i < sizeof(models) / sizeof(models[0]); i++) {
+		reproject_bench r;
+		reproject_bench_init(&r, models[i].model);
+
+		char name[128];
+		snprintf(name, sizeof(name), "reproject/%s/xy", models[i].name);
+		bench_run(b, name, bench_reproject_xy, &r);
+		snprintf(name, sizeof(name), "reproject/%s/xy_batch", models[i].name);
+		bench_run(b, name, bench_reproject_xy_batch, &r);
+		snprintf(name, sizeof(name), "reproject/%s/jac_obj_pose", models[i].name);
+		bench_run(b, name, bench_reproject_jac_obj_pose, &r);
+		if (r.model->reprojectAxisAngleFullJacObjPose) {
+			snprintf(name, sizeof(name), "reproject/%s/jac_obj_pose_axisangle", models[i].name);
+			bench_run(b, name, bench_reproject_jac_obj_pose_axisangle, &r);
+		}
+	}
+}
+
+/* Optimizer */
+
+typedef struct optimizer_bench {
+	survive_optimizer *opt;
+	FLT *parameters;
+	survive_optimizer_measurement *measurements;
+	size_t par_cnt;
+} optimizer_bench;
+
+// survive_optimizer_run works on the problem in place; so every op starts from a copy of the original
+static void bench_optimizer_run(void *user, size_t iterations) {
+	optimizer_bench *o = user;
+	for (size_t i = 0; i < iterations; i++) {
+		memcpy(o->opt->parameters, o->parameters, sizeof(FLT) * o->par_cnt);
+		memcpy(o->opt->measurements, o->measurements, sizeof(survive_optimizer_measurement) * o->opt->measurementsCnt);
+		mp_result result = {0};
+		survive_optimizer_run(o->opt, &result);
+	}
+}
+
+static void run_optimizer_bench(bench_ctx *b, const char *name, survive_optimizer *opt) {
+	optimizer_bench o = {.opt = opt, .par_cnt = survive_optimizer_get_parameters_count(opt)};
+	o.parameters = malloc(sizeof(FLT) * o.par_cnt);
+	o.measurements = malloc(sizeof(survive_optimizer_measurement) * (opt->measurementsCnt + 1));
+	memcpy(o.parameters, opt->parameters, sizeof(FLT) * o.par_cnt);
+	memcpy(o.measurements, opt->measurements, sizeof(survive_optimizer_measurement) * opt->measurementsCnt);
+
+	bench_run(b, name, bench_optimizer_run, &o);
+
+	free(o.parameters);
+	free(o.measurements);
+}
+
+static void run_synthetic_optimizer_bench(bench_ctx *b, bool use_jacobian_function) {
+	reproject_bench r;
+	reproject_bench_init(&r, &survive_reproject_gen2_model);
+
+	FLT sensor_locations[BENCH_SENSOR_CNT * 3];
+	for (int i = 0; i < BENCH_SENSOR_CNT; i++) {
+		sensor_locations[i * 3 + 0] = r.x[i];
+		sensor_locations[i * 3 + 1] = r.y[i];
+		sensor_locations[i * 3 + 2] = r.z[i];
+	}
+	SurviveObject so = {.sensor_ct = BENCH_SENSOR_CNT, .sensor_locations = sensor_locations};
+
+	survive_optimizer opt = {.reprojectModel = r.model, .so = &so, .poseLength = 1, .cameraLength = 1};
+	SURVIVE_OPTIMIZER_SETUP_HEAP_BUFFERS(opt);
+
+	SurvivePose initial = r.obj2world;
+	initial.Pos[0] += .05;
+	survive_optimizer_setup_pose(&opt, &initial, false, use_jacobian_function);
+	SurvivePose lh2world = InvertPoseRtn(&r.world2lh);
+	survive_optimizer_setup_camera(&opt, 0, &lh2world, true, use_jacobian_function);
+	memcpy(survive_optimizer_get_calibration(&opt, 0), r.cal, sizeof(r.cal));
+
+	for (int sensor = 0; sensor < BENCH_SENSOR_CNT; sensor++) {
+		SurviveAngleReading ang;
+		r.model->reprojectXY(r.cal, r.ptsInLh[sensor], ang);
+		for (int axis = 0; axis < 2; axis++) {
+			opt.measurements[opt.measurementsCnt++] = (survive_optimizer_measurement){
+				.value = ang[axis], .variance = 1, .lh = 0, .sensor_idx = sensor, .axis = axis};
+		}
+	}
+
+	const char *name = use_jacobian_function ? "optimizer/synthetic_pose/jacobian" : "optimizer/synthetic_pose/numeric";
+	run_optimizer_bench(b, name, &opt);
+	SURVIVE_OPTIMIZER_CLEANUP_HEAP_BUFFERS(opt);
+}
+
+static const char *path_basename(const char *path) {
+	const char *rtn = path;
+	for (const char *c = path; *c; c++) {
+		if (*c == '/' || *c == '\\')
+			rtn = c + 1;
+	}
+	return rtn;
+}
+
+static void run_optimizer_benches(bench_ctx *b, const char **problems, size_t problem_cnt) {
+	if (bench_selected(b, "optimizer/synthetic_pose/jacobian"))
+		run_synthetic_optimizer_bench(b, true);
+	if (bench_selected(b, "optimizer/synthetic_pose/numeric"))
+		run_synthetic_optimizer_bench(b, false);
+
+	for (size_t i = 0; i < problem_cnt; i++) {
+		char name[128];
+		snprintf(name, sizeof(name), "optimizer/%s", path_basename(problems[i]));
+		if (!bench_selected(b, name))
+			continue;
+
+		FILE *f = fopen(problems[i], "r");
+		if (f == 0) {
+			fprintf(stderr, "Could not open optimizer problem '%s'\n", problems[i]);
+			continue;
+		}
+		fclose(f);
+
+		survive_optimizer *opt = survive_optimizer_load(problems[i]);
+		run_optimizer_bench(b, name, opt);
+	}
+}
+
+/* Kalman */
+
+typedef struct kalman_bench {
+	survive_kalman_state_t k;
+	FLT H[3];
+	FLT z[64];
+} kalman_bench;
+
+static void kalman_bench_f2(FLT t, FLT *F) {
+	FLT f[] = {1, t, 0, 1};
+	memcpy(F, f, sizeof(f));
+}
+
+static void kalman_bench_f3(FLT t, FLT *F) {
+	FLT f[] = {1, t, t * t / 2., 0, 1, t, 0, 0, 1};
+	memcpy(F, f, sizeof(f));
+}
+
+static void bench_kalman_predict_update(void *user, size_t iterations) {
+	kalman_bench *k = user;
+	for (size_t i = 0; i < iterations; i++) {
+		survive_kalman_predict_update_state(.001, &k->k, &k->z[i % 61], k->H, .1);
+	}
+}
+
+static void run_kalman_benches(bench_ctx *b) {
+	size_t dims2[] = {4, 3};
+	FLT Q2[] = {1e-3, 0, 0, 1e-2};
+	size_t dims3[] = {3, 3, 3};
+	FLT Q3[] = {1e-3, 0, 0, 0, 1e-2, 0, 0, 0, 1};
+
+	for (int state_cnt = 2; state_cnt <= 3; state_cnt++) {
+		for (int generic = 0; generic < 2; generic++) {
+			char name[128];
+			snprintf(name, sizeof(name), "kalman/predict_update/%d_states%s", state_cnt, generic ? "/generic" : "");
+			if (!bench_selected(b, name))
+				continue;
+
+			kalman_bench k = {.H = {1, 0, 0}};
+			srand(42);
+			for (int i = 0; i < sizeof(k.z) / sizeof(k.z[0]); i++)
+				k.z[i] = rand() / (FLT)RAND_MAX;
+
+			survive_kalman_state_init(&k.k, state_cnt, state_cnt == 2 ? kalman_bench_f2 : kalman_bench_f3,
+									  state_cnt == 2 ? Q2 : Q3, 0, state_cnt == 2 ? dims2 : dims3, 0);
+			if (generic)
+				survive_kalman_use_generic_kernels(&k.k.info);
+
+			bench_run(b, name, bench_kalman_predict_update, &k);
+			survive_kalman_state_free(&k.k);
+		}
+	}
+}
+
+/* Watchman */
+
+typedef struct watchman_packet {
+	uint8_t time1;
+	uint32_t reference_time;
+	uint8_t data[32];
+	uint8_t len;
+} watchman_packet;
+
+static const watchman_packet watchman_packets[] = {
+	{0, 0, {0xff, 0x09, 0x00, 0x04, 0x00, 0x38, 0xb8, 0xec, 0xe4, 0x9f}, 10},
+	{224, 3761897504, {0x00, 0x6f, 0xfd, 0x83, 0xff}, 5},
+	{224,
+	 3761897504,
+	 {0x88, 0x81, 0xa1, 0x10, 0x00, 0xd3, 0x06, 0x93, 0x03, 0xa3, 0x06, 0xf3, 0x06,
+	  0x83, 0x01, 0xd6, 0x06, 0xe4, 0xa8, 0x0c, 0xd9, 0x07, 0xc1, 0x92, 0xd2},
+	 25},
+};
+
+static void bench_parse_watchman_lightcap(void *user, size_t iterations) {
+	size_t *sink = user;
+	LightcapElement les[10];
+	size_t packet_cnt = sizeof(watchman_packets) / sizeof(watchman_packets[0]);
+	for (size_t i = 0; i < iterations; i++) {
+		// The parser takes a mutable buffer, so hand it a copy of the packet
+		watchman_packet p = watchman_packets[i % packet_cnt];
+		*sink += parse_watchman_lightcap(0, "WW0", p.time1, p.reference_time, p.data, p.len, les, 10);
+	}
+}
+
+/* Playback parsing */
+
+typedef struct text_parse_bench {
+	char **lines;
+	size_t line_cnt;
+	size_t sink;
+} text_parse_bench;
+
+static void bench_text_parse(void *user, size_t iterations) {
+	text_parse_bench *t = user;
+	for (size_t i = 0; i < iterations; i++) {
+		const char *line = t->lines[i % t->line_cnt];
+		double time;
+		int offset = 0;
+		if (sscanf(line, "%lf %n", &time, &offset) != 1)
+			continue;
+
+		SurviveRecord record;
+		if (survive_record_from_text(&record, sizeof(record), time, line + offset) == 0)
+			t->sink += record.hdr.type;
+	}
+}
+
+static void text_parse_bench_add(text_parse_bench *t, const char *line) {
+	t->lines = realloc(t->lines, sizeof(char *) * (t->line_cnt + 1));
+	size_t len = strlen(line);
+	while (len && (line[len - 1] == '\n' || line[len - 1] == '\r'))
+		len--;
+	t->lines[t->line_cnt] = calloc(len + 1, 1);
+	memcpy(t->lines[t->line_cnt++], line, len);
+}
+
+static void text_parse_bench_free(text_parse_bench *t) {
+	for (size_t i = 0; i < t->line_cnt; i++)
+		free(t->lines[i]);
+	free(t->lines);
+}
+
+// A mix of the records that dominate a typical recording
+static void text_parse_bench_synthesize(text_parse_bench *t) {
+	srand(42);
+	for (int i = 0; i < 256; i++) {
+		SurviveRecord record;
+		double time = i * .001;
+		switch (i % 4) {
+		case 0:
+			survive_record_init(&record, SURVIVE_RECORD_LIGHTCAP, time, "HMD");
+			record.lightcap = (SurviveRecordLightcap){
+				.hdr = record.hdr, .timestamp = rand(), .length = rand() % 4000, .sensor_id = rand() % 32};
+			break;
+		case 1:
+			survive_record_init(&record, SURVIVE_RECORD_IMU, time, "HMD");
+			record.imu.hdr = record.hdr;
+			for (int j = 0; j < 9; j++)
+				record.imu.accelgyro[j] = rand_range(-1, 1);
+			record.imu.mask = 3;
+			record.imu.timecode = rand();
+			break;
+		case 2:
+			survive_record_init(&record, SURVIVE_RECORD_SWEEP_ANGLE, time, "T20");
+			record.sweep_angle = (SurviveRecordSweepAngle){.hdr = record.hdr,
+														   .angle = rand_range(-1, 1),
+														   .timecode = rand(),
+														   .sensor_id = rand() % 32,
+														   .channel = rand() % 16,
+														   .plane = rand() % 2};
+			break;
+		default:
+			survive_record_init(&record, SURVIVE_RECORD_LIGHT, time, "WM0");
+			record.light = (SurviveRecordLight){.hdr = record.hdr,
+												.sensor_id = rand() % 32,
+												.acode = rand() % 8,
+												.timeinsweep = rand() % 400000,
+												.timecode = rand(),
+												.length = rand() % 1000};
+			break;
+		}
+
+		char buffer[1024];
+		survive_record_to_text(&record.hdr, buffer, sizeof(buffer));
+		text_parse_bench_add(t, buffer);
+	}
+}
+
+typedef struct binary_walk_bench {
+	SurviveRecordingBinaryReader *reader;
+	size_t sink;
+} binary_walk_bench;
+
+static void bench_binary_walk(void *user, size_t iterations) {
+	binary_walk_bench *w = user;
+	for (size_t i = 0; i < iterations; i++) {
+		const SurviveRecordHeader *hdr = survive_recording_binary_reader_peek(w->reader);
+		if (hdr == 0) {
+			survive_recording_binary_reader_rewind(w->reader);
+			hdr = survive_recording_binary_reader_peek(w->reader);
+			if (hdr == 0)
+				return;
+		}
+		w->sink += hdr->type;
+		survive_recording_binary_reader_next(w->reader);
+	}
+}
+
+static void run_playback_benches(bench_ctx *b, const char **recordings, size_t recording_cnt) {
+	if (bench_selected(b, "playback/synthetic/text_parse")) {
+		text_parse_bench t = {0};
+		text_parse_bench_synthesize(&t);
+		bench_run(b, "playback/synthetic/text_parse", bench_text_parse, &t);
+		text_parse_bench_free(&t);
+	}
+
+	for (size_t i = 0; i < recording_cnt; i++) {
+		char name[128];
+		if (survive_recording_is_binary_file(recordings[i])) {
+			snprintf(name, sizeof(name), "playback/%s/binary_walk", path_basename(recordings[i]));
+			if (!bench_selected(b, name))
+				continue;
+
+			binary_walk_bench w = {.reader = survive_recording_binary_reader_open(recordings[i])};
+			if (w.reader) {
+				bench_run(b, name, bench_binary_walk, &w);
+				survive_recording_binary_reader_close(w.reader);
+			}
+			continue;
+		}
+
+		snprintf(name, sizeof(name), "playback/%s/text_parse", path_basename(recordings[i]));
+		if (!bench_selected(b, name))
+			continue;
+
+		// Compressed recordings should be decompressed first; the bench times parsing, not zlib
+		FILE *f = fopen(recordings[i], "r");
+		if (f == 0) {
+			fprintf(stderr, "Could not open recording '%s'\n", recordings[i]);
+			continue;
+		}
+
+		text_parse_bench t = {0};
+		char line[4096];
+		while (fgets(line, sizeof(line), f)) {
+			text_parse_bench_add(&t, line);
+		}
+		fclose(f);
+
+		if (t.line_cnt)
+			bench_run(b, name, bench_text_parse, &t);
+		text_parse_bench_free(&t);
+	}
+}
+
+/* Disambiguators */
+
+typedef struct disambiguator_samples {
+	double *ns;
+	size_t cnt, capacity;
+	uint64_t total_ns;
+	size_t allocations;
+} disambiguator_samples;
+
+static lightcap_process_func disambiguator_fn;
+static disambiguator_samples *disambiguator_current;
+
+static void timed_lightcap(SurviveObject *so, const LightcapElement *le) {
+	size_t allocations_start = bench_allocations();
+	uint64_t start = bench_now_ns();
+	disambiguator_fn(so, le);
+	uint64_t elapsed = bench_now_ns() - start;
+
+	// Closing the context calls the disambiguator with no element
+	if (le == 0)
+		return;
+
+	disambiguator_samples *s = disambiguator_current;
+	s->allocations += bench_allocations() - allocations_start;
+	s->total_ns += elapsed;
+	if (s->cnt == s->capacity) {
+		s->capacity = s->capacity ? s->capacity * 2 : 1024;
+		s->ns = realloc(s->ns, sizeof(double) * s->capacity);
+	}
+	s->ns[s->cnt++] = elapsed;
+}
+
+static void quiet_log(SurviveContext *ctx, SurviveLogLevel logLevel, const char *fault) {
+	if (logLevel == SURVIVE_LOG_LEVEL_ERROR)
+		fprintf(stderr, "%s\n", fault);
+}
+
+static void run_disambiguator_benches(bench_ctx *b, const char **recordings, size_t recording_cnt) {
+	const char *disambiguators[] = {"StateBased", "Turvey", "Charles"};
+
+	for (size_t i = 0; i < recording_cnt; i++) {
+		for (int d = 0; d < sizeof(disambiguators) / sizeof(disambiguators[0]); d++) {
+			char name[128];
+			snprintf(name, sizeof(name), "disambiguator/%s/%s", disambiguators[d], path_basename(recordings[i]));
+			if (!bench_selected(b, name))
+				continue;
+
+			char *const argv[] = {"survive-bench",
+								  "--playback",
+								  (char *)recordings[i],
+								  "--playback-factor",
+								  "0",
+								  "--playback-synchronous",
+								  "1",
+								  "--disambiguator",
+								  (char *)disambiguators[d],
+								  "--poser",
+								  "Dummy",
+								  "--configfile",
+								  "survive-bench-config.json",
+								  "--v",
+								  "0"};
+			SurviveContext *ctx = survive_init_with_logger(sizeof(argv) / sizeof(argv[0]), argv, 0, quiet_log);
+			if (ctx == 0 || survive_startup(ctx) != 0) {
+				fprintf(stderr, "Could not replay '%s'\n", recordings[i]);
+				if (ctx)
+					survive_close(ctx);
+				continue;
+			}
+
+			disambiguator_samples samples = {0};
+			disambiguator_fn = ctx->lightcapproc;
+			disambiguator_current = &samples;
+			ctx->lightcapproc = timed_lightcap;
+
+			while (survive_poll(ctx) == 0) {
+			}
+			survive_close(ctx);
+
+			bench_add_result(b, name, samples.ns, samples.cnt, samples.cnt, samples.total_ns, samples.allocations);
+			free(samples.ns);
+		}
+	}
+}
+
+/* Output */
+
+static void json_string(FILE *f, const char *s) {
+	fputc('"', f);
+	for (; *s; s++) {
+		if (*s == '"' || *s == '\\')
+			fputc('\\', f);
+		if ((unsigned char)*s < 0x20)
+			fprintf(f, "\\u%04x", *s);
+		else
+			fputc(*s, f);
+	}
+	fputc('"', f);
+}
+
+static void write_json(const bench_ctx *b, const char *path, const char *label) {
+	FILE *f = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+	if (f == 0) {
+		fprintf(stderr, "Could not open '%s' for writing\n", path);
+		return;
+	}
+
+	fprintf(f, "{\n  \"label\": ");
+	json_string(f, label ? label : "");
+	fprintf(f, ",\n  \"timestamp\": %.0f,\n  \"sizeof_flt\": %d,\n  \"benchmarks\": [\n", OGGetAbsoluteTime(),
+			(int)sizeof(FLT));
+	for (size_t i = 0; i < b->results_cnt; i++) {
+		const bench_result *r = &b->results[i];
+		fprintf(f, "    {\"name\": ");
+		json_string(f, r->name);
+		fprintf(f,
+				", \"ops\": %zu, \"samples\": %zu, \"ns_per_op\": %.3f, \"min_ns\": %.3f, \"p50_ns\": %.3f, "
+				"\"p90_ns\": %.3f, \"p99_ns\": %.3f, \"max_ns\": %.3f, \"allocs_per_op\": %.4f}%s\n",
+				r->ops, r->samples, r->ns_per_op, r->min, r->p50, r->p90, r->p99, r->max, r->allocs_per_op,
+				i + 1 == b->results_cnt ? "" : ",");
+	}
+	fprintf(f, "  ]\n}\n");
+
+	if (f != stdout)
+		fclose(f);
+}
+
+static void usage(const char *name) {
+	fprintf(stderr, "Usage: %s [options]\n", name);
+	fprintf(stderr, "  --filter <str>       Only run benchmarks whose name contains <str>\n");
+	fprintf(stderr, "  --samples <n>        Number of timed samples per benchmark (default %d)\n", DEFAULT_SAMPLE_CNT);
+	fprintf(stderr, "  --optimizer <file>   Benchmark survive_optimizer_run on a serialized problem\n");
+	fprintf(stderr, "  --recording <file>   Benchmark playback parsing and the disambiguators on a recording\n");
+	fprintf(stderr, "  --json <file>        Write results as JSON; '-' for stdout\n");
+	fprintf(stderr, "  --label <str>        Label stored in the JSON output, eg the version under test\n");
+}
+
+int main(int argc, char **argv) {
+	bench_ctx b = {.sample_cnt = DEFAULT_SAMPLE_CNT};
+	const char *json_path = 0, *label = 0;
+	const char *problems[MAX_INPUT_FILES], *recordings[MAX_INPUT_FILES];
+	size_t problem_cnt = 0, recording_cnt = 0;
+
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : 0;
+		if (value == 0 || strncmp(arg, "--", 2) != 0) {
+			usage(argv[0]);
+			return -1;
+		}
+		i++;
+
+		if (strcmp(arg, "--filter") == 0) {
+			b.filter = value;
+		} else if (strcmp(arg, "--samples") == 0) {
+			b.sample_cnt = atoi(value) > 0 ? atoi(value) : 1;
+		} else if (strcmp(arg, "--optimizer") == 0 && problem_cnt < MAX_INPUT_FILES) {
+			problems[problem_cnt++] = value;
+		} else if (strcmp(arg, "--recording") == 0 && recording_cnt < MAX_INPUT_FILES) {
+			recordings[recording_cnt++] = value;
+		} else if (strcmp(arg, "--json") == 0) {
+			json_path = value;
+		} else if (strcmp(arg, "--label") == 0) {
+			label = value;
+		} else {
+			usage(argv[0]);
+			return -1;
+		}
+	}
+
+	b.table = json_path && strcmp(json_path, "-") == 0 ? stderr : stdout;
+	fprintf(b.table, "%-56s %12s %12s %12s %12s %10s\n", "benchmark", "ns/op", "p50", "p90", "p99", "allocs/op");
+
+	run_reproject_benches(&b);
+	run_optimizer_benches(&b, problems, problem_cnt);
+	run_kalman_benches(&b);
+
+	size_t watchman_sink = 0;
+	bench_run(&b, "watchman/parse_lightcap", bench_parse_watchman_lightcap, &watchman_sink);
+
+	run_playback_benches(&b, recordings, recording_cnt);
+	run_disambiguator_benches(&b, recordings, recording_cnt);
+
+	if (json_path)
+		write_json(&b, json_path, label);
+
+	free(b.results);
+	return 0;
+}
@@ -0,0 +1,20 @@
+#include <stdio.h>
+
+#include "src/survive_recording.h"
+
+int main(int argc, char **argv) {
+	if (argc != 3) {
+		fprintf(stderr, "Usage: %s <input recording> <output recording>\n", argv[0]);
+		fprintf(stderr, "Outputs ending in '.bin' are written in the binary format; '.gz' outputs are compressed.\n");
+		return -1;
+	}
+
+	int cnt = survive_recording_convert(argv[1], argv[2]);
+	if (cnt < 0) {
+		fprintf(stderr, "Could not convert '%s' to '%s'\n", argv[1], argv[2]);
+		return -1;
+	}
+
+	printf("Converted %d records from '%s' to '%s'\n", cnt, argv[1], argv[2]);
+	return 0;
+}
@@ -1,5 +1,6 @@
-//Don't use this. 
-// Use the following:
+//Don't use this.
+// For poses, velocities and buttons, run with '--stream 1' and read the binary stream with the client in
+// survive_stream.h. For the full text recording, use the following:
 //   ./data_recorder | socat - tcp-listen:5555,fork > /dev/null
 // SOCAT is better.
 
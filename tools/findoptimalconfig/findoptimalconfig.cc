@@ -33,8 +33,8 @@ struct PlaybackDataInput {
 	std::vector<char> vmask;
 	std::vector<double> meas, cov;
 	SurviveSensorActivations activations;
-	PlaybackDataInput(SurviveObject *so, const SurvivePose &position)
-		: so(so), position(position), activations(so->activations) {
+	PlaybackDataInput(SurviveObject *so, const SurvivePose &position) : so(so), position(position), activations() {
+		SurviveSensorActivations_copy(&activations, &so->activations);
 		int32_t sensor_count = so->sensor_ct;
 		vmask.resize(sensor_count * NUM_LIGHTHOUSES);
 		cov.resize(4 * sensor_count * NUM_LIGHTHOUSES);
@@ -44,7 +44,22 @@ struct PlaybackDataInput {
 		cov.resize(4 * new_size);
 		meas.resize(2 * new_size);
 	}
-	~PlaybackDataInput() {}
+	PlaybackDataInput(const PlaybackDataInput &o)
+		: so(o.so), position(o.position), timestamp(o.timestamp), vmask(o.vmask), meas(o.meas), cov(o.cov),
+		  activations() {
+		SurviveSensorActivations_copy(&activations, &o.activations);
+	}
+	PlaybackDataInput &operator=(const PlaybackDataInput &o) {
+		so = o.so;
+		position = o.position;
+		timestamp = o.timestamp;
+		vmask = o.vmask;
+		meas = o.meas;
+		cov = o.cov;
+		SurviveSensorActivations_copy(&activations, &o.activations);
+		return *this;
+	}
+	~PlaybackDataInput() { SurviveSensorActivations_dtor(&activations); }
 };
 
 struct PlaybackData {
@@ -61,17 +76,18 @@ static size_t construct_input_from_scene(SurviveObject *so, uint32_t timestamp,
 	for (size_t sensor = 0; sensor < so->sensor_ct; sensor++) {
 		for (size_t lh = 0; lh < 2; lh++) {
 			if (SurviveSensorActivations_isPairValid(scene, settings.sensor_time_window, timestamp, sensor, lh)) {
-				double *a = scene->angles[sensor][lh];
+				auto entry = SurviveSensorActivations_entry(scene, sensor, lh);
+				const double *a = entry->angles;
 				vmask[sensor * NUM_LIGHTHOUSES + lh] = 1;
 
 				if (cov) {
 					*(cov++) = settings.sensor_variance +
-							   std::abs((double)timestamp - scene->timecode[sensor][lh][0]) *
+							   std::abs((double)timestamp - entry->timecode[0]) *
 								   settings.sensor_variance_per_second / (double)so->timebase_hz;
 					*(cov++) = 0;
 					*(cov++) = 0;
 					*(cov++) = settings.sensor_variance +
-							   std::abs((double)timestamp - scene->timecode[sensor][lh][1]) *
+							   std::abs((double)timestamp - entry->timecode[1]) *
 								   settings.sensor_variance_per_second / (double)so->timebase_hz;
 				}
 				meas[rtn++] = a[0];
@@ -232,7 +248,7 @@ double find_optimal_cal(SurviveContext *ctx, PlaybackData &data) {
 				auto scene = &in.activations;
 				if (SurviveSensorActivations_isPairValid(scene, settings.sensor_time_window, in.timestamp, sensor,
 														 lh)) {
-					double *a = scene->angles[sensor][lh];
+					const double *a = SurviveSensorActivations_entry(scene, sensor, lh)->angles;
 					vmask.emplace_back(1); //[sensor * NUM_LIGHTHOUSES + lh] = 1;
 
 					meas.emplace_back(a[0]);
@@ -1,136 +1,134 @@
-#include <chrono>
+#include <algorithm>
 #include <iostream>
 #include <libsurvive/survive.h>
-#include <libsurvive/survive_optimizer.h>
 #include <libsurvive/survive_reproject.h>
-#include <map>
+#include <libsurvive/survive_reproject_gen2.h>
+#include <libsurvive/survive_sba.h>
 #include <math.h>
-#include <memory>
-#include <mpfit/mpfit.h>
-#include <set>
+#include <tuple>
 #include <vector>
 
-uint32_t timestamp;
-std::vector<survive_optimizer_measurement> measurements;
+// Minimum time between captured frames, in seconds
+static const FLT capture_interval = .01;
 
-SurvivePose currentPose = LinmathPose_Identity;
+std::vector<survive_optimizer_measurement> measurements;
 std::vector<SurvivePose> poses;
 
-static size_t construct_input_from_scene(SurviveObject *so, size_t timecode, survive_timecode sensor_time_window,
-										 FLT sensor_variance, FLT sensor_variance_per_second) {
+static size_t construct_input_from_scene(SurviveObject *so, survive_timecode timecode,
+										 survive_timecode sensor_time_window, FLT sensor_variance,
+										 FLT sensor_variance_per_second) {
 	size_t rtn = 0;
 	auto scene = &so->activations;
-	const bool force_pair = false;
-	for (uint8_t sensor = 0; sensor < so->sensor_ct; sensor++) {
-		for (uint8_t lh = 0; lh < 2; lh++) {
-			for (uint8_t axis = 0; axis < 2; axis++) {
-				bool isReadingValue =
-					SurviveSensorActivations_isReadingValid(scene, sensor_time_window, timecode, sensor, lh, axis);
-				if (force_pair) {
-					isReadingValue =
-						SurviveSensorActivations_isPairValid(scene, sensor_time_window, timecode, sensor, lh);
-				}
-				if (isReadingValue) {
-					const double *a = scene->angles[sensor][lh];
-					measurements.push_back({});
-					auto meas = &measurements.back();
-					meas->axis = axis;
-					meas->value = a[axis];
-					meas->sensor_idx = sensor;
-					meas->lh = lh;
-					meas->object = poses.size();
-					survive_timecode diff = survive_timecode_difference(timecode, scene->timecode[sensor][lh][axis]);
-					meas->variance = sensor_variance + diff * sensor_variance_per_second / (double)so->timebase_hz;
-					rtn++;
-				}
-			}
-		}
+
+	SurviveSensorActivationsReading readings[SENSORS_PER_OBJECT * NUM_GEN2_LIGHTHOUSES * 2];
+	size_t reading_cnt = SurviveSensorActivations_fresh_readings(scene, sensor_time_window, timecode, readings,
+																 sizeof(readings) / sizeof(readings[0]));
+	std::sort(readings, readings + reading_cnt,
+			  [](const SurviveSensorActivationsReading &a, const SurviveSensorActivationsReading &b) {
+				  return std::make_tuple(a.sensor_idx, a.lh, a.axis) < std::make_tuple(b.sensor_idx, b.lh, b.axis);
+			  });
+
+	for (size_t i = 0; i < reading_cnt; i++) {
+		auto sensor = readings[i].sensor_idx;
+		auto lh = readings[i].lh;
+		auto axis = readings[i].axis;
+		if (sensor >= so->sensor_ct || lh >= so->ctx->activeLighthouses || !so->ctx->bsd[lh].PositionSet)
+			continue;
+
+		auto entry = SurviveSensorActivations_entry(scene, sensor, lh);
+		measurements.push_back({});
+		auto meas = &measurements.back();
+		meas->axis = axis;
+		meas->value = entry->angles[axis];
+		meas->sensor_idx = sensor;
+		meas->lh = lh;
+		meas->object = poses.size();
+		survive_timecode diff = survive_timecode_difference(timecode, entry->timecode[axis]);
+		meas->variance = sensor_variance + diff * sensor_variance_per_second / (double)so->timebase_hz;
+		rtn++;
 	}
 	return rtn;
 }
 
-static void capture_data(SurviveObject *so) {
-	auto cnt = construct_input_from_scene(so, timestamp, SurviveSensorActivations_default_tolerance, 1, 10);
-	if (cnt < 8) {
-		while (!measurements.empty() && measurements.back().object == poses.size())
-			measurements.pop_back();
-	} else {
-		poses.push_back(currentPose);
-	}
-}
+survive_timecode last_timecode = 0;
+bool captured_any = false;
+
+// Every reported pose of the first object, at most one per capture_interval, becomes a frame of the adjustment
+static void pose_process(SurviveObject *so, survive_timecode timecode, SurvivePose *pose) {
+	survive_default_pose_process(so, timecode, pose);
+	if (so != so->ctx->objs[0])
+		return;
+
+	if (captured_any && survive_timecode_difference(timecode, last_timecode) / (FLT)so->timebase_hz < capture_interval)
+		return;
 
-int last_lh = -1, last_acode = -1;
-survive_timecode last_timecode = -1;
-void light_process(SurviveObject *so, int sensor_id, int acode, int timeinsweep, uint32_t timecode, uint32_t length,
-				   uint32_t lighthouse) {
-	survive_default_light_process(so, sensor_id, acode, timeinsweep, timecode, length, lighthouse);
-
-	timestamp = timecode;
-	if (last_lh != lighthouse || last_acode != acode) {
-		if (last_timecode == -1 || survive_timecode_difference(timecode, last_timecode) / (FLT)so->timebase_hz > 1.) {
-			capture_data(so);
-			last_timecode = timecode;
-		}
+	auto cnt = construct_input_from_scene(so, timecode, SurviveSensorActivations_default_tolerance, 1, 10);
+	if (cnt < 8) {
+		measurements.resize(measurements.size() - cnt);
+		return;
 	}
-	last_lh = lighthouse;
-	last_acode = acode;
-}
 
-void raw_pose_process(SurviveObject *so, uint32_t lighthouse, SurvivePose *pose) {
-	survive_default_raw_pose_process(so, lighthouse, pose);
-	currentPose = *pose;
+	poses.push_back(*pose);
+	last_timecode = timecode;
+	captured_any = true;
 }
 
 static double full_bundle_adjustment(SurviveObject *so) {
 	struct SurviveContext *ctx = so->ctx;
-
-	survive_optimizer mpfitctx = {};
-	mpfitctx.so = so;
-	mpfitctx.poseLength = poses.size();
-	mpfitctx.cameraLength = so->ctx->activeLighthouses;
-
-	std::vector<double> parameters(survive_optimizer_get_parameters_count(&mpfitctx));
-	std::vector<mp_par_struct> parameter_infos(survive_optimizer_get_parameters_count(&mpfitctx));
-	mpfitctx.parameters = &parameters.front();
-	mpfitctx.measurements = &measurements.front();
-	mpfitctx.measurementsCnt = measurements.size();
-	mpfitctx.parameters_info = &parameter_infos.front();
-
-	SurvivePose *soLocation = survive_optimizer_get_pose(&mpfitctx);
-	survive_optimizer_setup_cameras(&mpfitctx, ctx, true);
-	int start = survive_optimizer_get_camera_index(&mpfitctx);
-	for (int i = start + 7; i < start + 7 * mpfitctx.cameraLength; i++) {
-		mpfitctx.parameters_info[i].fixed = false;
+	if (poses.empty()) {
+		SV_INFO("No data captured");
+		return -1;
 	}
 
-	int use_jacobian_function = 0;
-	survive_optimizer_setup_pose(&mpfitctx, &poses.front(), false, use_jacobian_function);
-
-	mp_result result = {0};
+	survive_sba sba = {};
+	sba.reprojectModel = ctx->lh_version == 0 ? &survive_reproject_model : &survive_reproject_gen2_model;
+	sba.sensor_locations = so->sensor_locations;
+	sba.poses = &poses.front();
+	sba.poseCnt = poses.size();
+	sba.measurements = &measurements.front();
+	sba.measurementsCnt = measurements.size();
+	sba.lighthouseCnt = ctx->activeLighthouses;
+
+	// The first solved lighthouse anchors the world. For gen 2, a phase offset shared by both axes is the same thing as
+	// turning the lighthouse, so phase is left alone.
+	sba.cal_mask = SURVIVE_SBA_CAL(tilt) | SURVIVE_SBA_CAL(curve) | SURVIVE_SBA_CAL(gibpha) | SURVIVE_SBA_CAL(gibmag);
+	if (ctx->lh_version == 0) {
+		sba.cal_mask |= SURVIVE_SBA_CAL(phase);
+	} else {
+		sba.cal_mask |= SURVIVE_SBA_CAL(ogeephase) | SURVIVE_SBA_CAL(ogeemag);
+	}
 
-	mpfitctx.initialPose = LinmathPose_Identity;
+	int anchor = -1;
+	for (int lh = 0; lh < sba.lighthouseCnt; lh++) {
+		sba.lighthouses[lh] = ctx->bsd[lh].Pose;
+		sba.fcal[lh][0] = ctx->bsd[lh].fcal[0];
+		sba.fcal[lh][1] = ctx->bsd[lh].fcal[1];
+		if (ctx->bsd[lh].PositionSet && anchor == -1)
+			anchor = lh;
+	}
+	sba.fixed_lighthouses = anchor >= 0 ? 1u << anchor : 0;
 
-	int res = survive_optimizer_run(&mpfitctx, &result);
+	survive_sba_result result = {};
+	int res = survive_sba_run(&sba, &result);
+	SV_INFO("Optimization %f/%f (%d poses, %d measurements, %d skipped) %d", result.orignorm, result.bestnorm,
+			(int)poses.size(), (int)measurements.size(), (int)result.skipped_poses, res);
 
-	double rtn = -1;
-	bool status_failure = res <= 0;
+	if (res < 0) {
+		SV_INFO("Optimization failure");
+		return -1;
+	}
 
-	if (!status_failure) {
-		quatnormalize(soLocation->Rot, soLocation->Rot);
-		rtn = result.bestnorm;
+	for (int lh = 0; lh < sba.lighthouseCnt; lh++) {
+		if (!ctx->bsd[lh].PositionSet)
+			continue;
 
-		SurvivePose *cameras = survive_optimizer_get_camera(&mpfitctx);
-		for (int i = 0; i < mpfitctx.cameraLength; i++) {
-			SurvivePose p = InvertPoseRtn(cameras + i);
-			so->ctx->lighthouseposeproc(so->ctx, i, &p, soLocation);
-			SV_INFO("%f %f %f", p.Pos[0], p.Pos[1], p.Pos[2]);
-		}
-	} else {
-		SV_INFO("Optimization failure");
+		ctx->bsd[lh].fcal[0] = sba.fcal[lh][0];
+		ctx->bsd[lh].fcal[1] = sba.fcal[lh][1];
+		ctx->lighthouse_poseproc(ctx, lh, &sba.lighthouses[lh], &poses.front());
+		SV_INFO("LH %d " SurvivePose_format, lh, SURVIVE_POSE_EXPAND(sba.lighthouses[lh]));
 	}
-	SV_INFO("Optimization %f/%f (%d measurements) %d", result.orignorm, result.bestnorm, (int)measurements.size(), res);
 
-	return rtn;
+	return result.bestnorm;
 }
 
 int main(int argc, char **argv) {
@@ -138,8 +136,7 @@ int main(int argc, char **argv) {
 	if (ctx == nullptr)
 		return -1;
 
-	survive_install_light_fn(ctx, light_process);
-	survive_install_pose_fn(ctx, raw_pose_process);
+	survive_install_pose_fn(ctx, pose_process);
 
 	while (survive_poll(ctx) == 0) {
 	}
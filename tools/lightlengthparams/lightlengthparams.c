@@ -31,7 +31,7 @@ void raw_pose_process(SurviveObject *so, uint8_t _lh, SurvivePose *pose2w) {
 		for (size_t sensor_idx = 0; sensor_idx < so->sensor_ct; sensor_idx++) {
 			if (SurviveSensorActivations_isPairValid(scene, SurviveSensorActivations_default_tolerance / 2,
 													 current_timecode, sensor_idx, lh)) {
-				uint32_t *lengths = scene->lengths[sensor_idx][lh];
+				const uint32_t *lengths = SurviveSensorActivations_entry(scene, sensor_idx, lh)->lengths;
 
 				const FLT *sensor_location = so->sensor_locations + 3 * sensor_idx;
 				const FLT *sensor_normals = so->sensor_normals + 3 * sensor_idx;
@@ -55,8 +55,8 @@ static vr::HmdQuaternion_t survive2openvr() {
 LinmathPoint3d lh0position = {};
 
 struct SurviveObjectOpenVRDriver : public vr::ITrackedDeviceServerDriver {
-	explicit SurviveObjectOpenVRDriver(const SurviveSimpleObject *surviveSimpleObject)
-		: surviveSimpleObject(surviveSimpleObject) {}
+	SurviveObjectOpenVRDriver(SurviveSimpleContext *actx, const SurviveSimpleObject *surviveSimpleObject)
+		: actx(actx), surviveSimpleObject(surviveSimpleObject) {}
 
 	vr::EVRInitError Activate(uint32_t unObjectId) override {
 		objectId = unObjectId;
@@ -97,7 +97,10 @@ struct SurviveObjectOpenVRDriver : public vr::ITrackedDeviceServerDriver {
 
 	vr::DriverPose_t Pose() const {
 		SurvivePose sPose;
-		survive_simple_object_get_latest_pose(surviveSimpleObject, &sPose);
+		// Brought forward to now rather than as of the last solve; lighthouses have no history
+		if (!survive_simple_object_get_pose_at(surviveSimpleObject, survive_simple_run_time(actx), &sPose)) {
+			survive_simple_object_get_latest_pose(surviveSimpleObject, &sPose);
+		}
 
 		const char *name = survive_simple_object_name(surviveSimpleObject);
 		if (strcmp(name, "LH0") == 0) {
@@ -132,6 +135,7 @@ struct SurviveObjectOpenVRDriver : public vr::ITrackedDeviceServerDriver {
 	}
 
 	uint32_t objectId = vr::k_unTrackedDeviceIndexInvalid;
+	SurviveSimpleContext *actx;
 	const SurviveSimpleObject *surviveSimpleObject;
 };
 
@@ -164,7 +168,7 @@ class SurviveOpenVRDriver : public vr::IServerTrackedDeviceProvider {
 		for (const SurviveSimpleObject *it = survive_simple_get_first_object(actx); it != 0;
 			 it = survive_simple_get_next_object(actx, it)) {
 			if (objects[it] == nullptr) {
-				objects[it] = std::make_unique<SurviveObjectOpenVRDriver>(it);
+				objects[it] = std::make_unique<SurviveObjectOpenVRDriver>(actx, it);
 				vr::VRServerDriverHost()->TrackedDeviceAdded(survive_simple_object_name(it),
 															 survive_simple_object_get_type(it) ==
 																	 SurviveSimpleObject_LIGHTHOUSE
@@ -192,7 +196,7 @@ class SurviveOpenVRDriver : public vr::IServerTrackedDeviceProvider {
 		for (const SurviveSimpleObject *it = survive_simple_get_next_updated(actx); it != 0;
 			 it = survive_simple_get_next_updated(actx)) {
 			if (objects[it] == nullptr) {
-				objects[it] = std::make_unique<SurviveObjectOpenVRDriver>(it);
+				objects[it] = std::make_unique<SurviveObjectOpenVRDriver>(actx, it);
 				vr::VRServerDriverHost()->TrackedDeviceAdded(survive_simple_object_name(it),
 															 vr::TrackedDeviceClass_Controller, objects[it].get());
 			}
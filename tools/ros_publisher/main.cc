@@ -1,4 +1,5 @@
 #include <libsurvive/survive_api.h>
+#include <libsurvive/survive_stream.h>
 #include <os_generic.h>
 #include <stdio.h>
 #include <string.h>
@@ -6,51 +7,90 @@
 #include "ros/ros.h"
 #include <geometry_msgs/PoseStamped.h>
 
-int main(int argc, char **argv) {
+static std::map<std::string, ros::Publisher> publishers;
+
+static ros::Publisher &get_publisher(ros::NodeHandle &n, const char *name) {
+	auto it = publishers.find(name);
+	if (it != publishers.end())
+		return it->second;
+
+	std::cerr << "Adding " << name << std::endl;
+	publishers[name] = n.advertise<geometry_msgs::PoseStamped>(std::string(name) + "_pose", 1, strpbrk(name, "LH") != 0);
+	return publishers[name];
+}
+
+static void publish_pose(ros::NodeHandle &n, const char *name, const SurvivePose &pose) {
+	static uint32_t seq = 1;
+	geometry_msgs::PoseStamped pose_msg = {};
+
+	pose_msg.header.seq = seq++;
+	pose_msg.header.stamp = ros::Time::now();
+	pose_msg.header.frame_id = "libsurvive_world";
+	pose_msg.pose.position.x = pose.Pos[0];
+	pose_msg.pose.position.y = pose.Pos[1];
+	pose_msg.pose.position.z = pose.Pos[2];
+	pose_msg.pose.orientation.w = pose.Rot[0];
+	pose_msg.pose.orientation.x = pose.Rot[1];
+	pose_msg.pose.orientation.y = pose.Rot[2];
+	pose_msg.pose.orientation.z = pose.Rot[3];
+
+	get_publisher(n, name).publish(pose_msg);
+}
+
+// Republishes poses from a libsurvive running elsewhere with '--stream 1'
+static int run_remote(ros::NodeHandle &n, const char *remote) {
+	std::string host = remote;
+	uint16_t port = 2335;
+	size_t colon = host.rfind(':');
+	if (colon != std::string::npos) {
+		port = atoi(host.c_str() + colon + 1);
+		host = host.substr(0, colon);
+	}
 
-	std::map<std::string, ros::Publisher> publishers;
+	SurviveStreamClient *client = survive_stream_connect(host.c_str(), port);
+	if (client == 0) {
+		std::cerr << "Could not connect to " << remote << std::endl;
+		return -1;
+	}
+
+	SurviveStreamFrame frame;
+	int rtn;
+	while (ros::ok() && (rtn = survive_stream_read(client, &frame, 100)) >= 0) {
+		if (rtn > 0 && frame.type == SURVIVE_STREAM_POSE) {
+			publish_pose(n, frame.object, frame.body.pose);
+		}
+	}
 
+	std::cerr << "Stream ended; " << survive_stream_dropped(client) << " frames were dropped" << std::endl;
+	survive_stream_close(client);
+	return 0;
+}
+
+int main(int argc, char **argv) {
 	ros::init(argc, argv, "libsurvive");
 	ros::NodeHandle n;
 
+	for (int i = 1; i + 1 < argc; i++) {
+		if (strcmp(argv[i], "--remote") == 0)
+			return run_remote(n, argv[i + 1]);
+	}
+
 	SurviveSimpleContext *actx = survive_simple_init(argc, argv);
 	if (actx == 0) // implies -help or similiar
 		return 0;
 
 	survive_simple_start_thread(actx);
 
-	auto get_publisher = [&](const char *name) -> ros::Publisher& {
-		auto it = publishers.find(name);
-		if (it != publishers.end())
-			return it->second;
-
-		std::cerr << "Adding " << name << std::endl;
-		publishers[name] = n.advertise<geometry_msgs::PoseStamped>(std::string(name) + "_pose", 1, strpbrk(name, "LH") != 0);
-		return publishers[name];
-	};
-	
-	uint32_t seq = 1;
-	geometry_msgs::PoseStamped pose_msg = {};
 	while (survive_simple_wait_for_update(actx) && ros::ok()) {
 		SurvivePose pose;
 
 		for (const SurviveSimpleObject *it = survive_simple_get_next_updated(actx); it != 0;
 			 it = survive_simple_get_next_updated(actx)) {
-			uint32_t timecode = survive_simple_object_get_latest_pose(it, &pose);
-			const char *name = survive_simple_object_name(it);
-		       
-			pose_msg.header.seq = seq++;
-			pose_msg.header.stamp = ros::Time::now();
-			pose_msg.header.frame_id = "libsurvive_world";
-			pose_msg.pose.position.x = pose.Pos[0];
-			pose_msg.pose.position.y = pose.Pos[1];
-			pose_msg.pose.position.z = pose.Pos[2];
-			pose_msg.pose.orientation.w = pose.Rot[0];
-			pose_msg.pose.orientation.x = pose.Rot[1];
-			pose_msg.pose.orientation.y = pose.Rot[2];
-			pose_msg.pose.orientation.z = pose.Rot[3];
-
-			get_publisher(name).publish(pose_msg);
+			// Brought forward to now rather than as of the last solve; lighthouses have no history
+			if (!survive_simple_object_get_pose_at(it, survive_simple_run_time(actx), &pose)) {
+				survive_simple_object_get_latest_pose(it, &pose);
+			}
+			publish_pose(n, survive_simple_object_name(it), pose);
 		}
 	}
 
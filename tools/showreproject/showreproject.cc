@@ -82,11 +82,12 @@ static void redraw(SurviveContext *ctx) {
 
 				if (SurviveSensorActivations_isPairValid(scene, SurviveSensorActivations_default_tolerance, timestamp,
 														 sensor, lh)) {
-					const double *a = scene->angles[sensor][lh];
+					auto entry = SurviveSensorActivations_entry(scene, sensor, lh);
+					const double *a = entry->angles;
 					// FLT a[2];
 					// survive_apply_bsd_calibration(so->ctx, lh, _a, a);
 
-					auto l = scene->lengths[sensor][lh];
+					auto l = entry->lengths;
 					double r = std::max(3., (l[0] + l[1]) / 1000.);
 
 					if (region.data)